@@ -0,0 +1,481 @@
+/*
+ * crab-bench: run the forward analyzer with every domain of
+ * tests/crab_dom.hpp on synthetic CFGs and print one JSON object per
+ * (generator, domain) pair:
+ *
+ *  {"generator":"nested_loops","size":10,"vars":8,"depth":3,
+ *   "blocks":..,"statements":..,"domain":"sdbm_domain",
+ *   "wall_ms":..,"peak_rss_kb":..,"widenings":..,"stats":{..}}
+ *
+ * "stats" contains all the CrabStats values collected during the run,
+ * grouped as {"counters":{..},"timers":{..},"averages":{..},
+ * "strings":{..}} (timers in seconds). Each run is executed in its own
+ * process (unless --no-fork) so that peak_rss_kb is the peak of that
+ * run only.
+ */
+
+#include "crab_lang.hpp"
+#include "crab_dom.hpp"
+
+#include <crab/analysis/fwd_analyzer.hpp>
+#include <crab/common/stats.hpp>
+#include <crab/common/os.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+namespace {
+
+  struct bench_params {
+    // number of blocks, loops, or diamonds depending on the generator
+    unsigned size;
+    // number of program variables
+    unsigned vars;
+    // loop nesting depth
+    unsigned depth;
+    unsigned widening_delay;
+    unsigned narrowing_iters;
+    unsigned jump_set_size;
+  };
+
+  string label(const string &prefix, unsigned i) {
+    return prefix + to_string(i);
+  }
+
+  vector<z_var> make_vars(variable_factory_t &vfac, const string &prefix,
+			  unsigned n, crab::variable_type ty = crab::INT_TYPE) {
+    vector<z_var> vs;
+    for (unsigned i = 0; i < n; ++i) {
+      vs.push_back(z_var(vfac[label(prefix, i)], ty, 32));
+    }
+    return vs;
+  }
+
+  /*
+   * Generators. Each one returns a new CFG with entry "entry" and
+   * exit "ret".
+   */
+
+  // Loop k of the nest: pre >> head_k, body_k contains loop k+1, and
+  // the last block of body_k goes back to head_k. Returns the exit
+  // block of loop k.
+  z_basic_block_t& nested_loop(z_cfg_t &cfg, z_basic_block_t &pre, unsigned k,
+			       const vector<z_var> &idx, const vector<z_var> &xs,
+			       unsigned bound) {
+    z_basic_block_t &head = cfg.insert(label("head", k));
+    z_basic_block_t &body = cfg.insert(label("body", k));
+    z_basic_block_t &exit = cfg.insert(label("exit", k));
+    pre.assign(idx[k], 0);
+    pre >> head;
+    head >> body; head >> exit;
+    body.assume(idx[k] <= bound - 1);
+    exit.assume(idx[k] >= bound);
+    z_basic_block_t *last = &body;
+    if (k + 1 < idx.size()) {
+      last = &nested_loop(cfg, body, k + 1, idx, xs, bound);
+    }
+    for (unsigned j = 0; j < xs.size(); ++j) {
+      if (j % (k + 1) == 0) {
+	last->add(xs[j], xs[j], j + 1);
+      }
+    }
+    last->add(idx[k], idx[k], 1);
+    *last >> head;
+    return exit;
+  }
+
+  z_cfg_t* nested_loops(variable_factory_t &vfac, const bench_params &p) {
+    z_cfg_t *cfg = new z_cfg_t("entry", "ret");
+    vector<z_var> idx = make_vars(vfac, "i", std::max(p.depth, 1u));
+    vector<z_var> xs = make_vars(vfac, "x", p.vars);
+    z_basic_block_t &entry = cfg->insert("entry");
+    z_basic_block_t &ret = cfg->insert("ret");
+    for (auto &x : xs) {
+      entry.assign(x, 0);
+    }
+    z_basic_block_t &exit = nested_loop(*cfg, entry, 0, idx, xs, p.size);
+    exit >> ret;
+    return cfg;
+  }
+
+  // A chain of blocks with p.size * p.vars assignments
+  z_cfg_t* straight_line(variable_factory_t &vfac, const bench_params &p) {
+    z_cfg_t *cfg = new z_cfg_t("entry", "ret");
+    vector<z_var> xs = make_vars(vfac, "x", std::max(p.vars, 2u));
+    z_basic_block_t &entry = cfg->insert("entry");
+    z_basic_block_t &ret = cfg->insert("ret");
+    entry.havoc(xs[0]);
+    entry.assume(xs[0] >= 0);
+    entry.assume(xs[0] <= 100);
+    z_basic_block_t *prev = &entry;
+    for (unsigned i = 0; i < p.size; ++i) {
+      z_basic_block_t &bb = cfg->insert(label("bb", i));
+      for (unsigned j = 1; j < xs.size(); ++j) {
+	bb.add(xs[j], xs[j - 1], i + j);
+      }
+      bb.assume(xs[xs.size() - 1] <= 1000 * (i + 1) + 100000);
+      *prev >> bb;
+      prev = &bb;
+    }
+    *prev >> ret;
+    return cfg;
+  }
+
+  // p.size diamonds in sequence, each with p.depth + 1 branches
+  z_cfg_t* wide_diamonds(variable_factory_t &vfac, const bench_params &p) {
+    z_cfg_t *cfg = new z_cfg_t("entry", "ret");
+    vector<z_var> xs = make_vars(vfac, "x", std::max(p.vars, 1u));
+    z_var nd(vfac["nd"], crab::INT_TYPE, 32);
+    z_basic_block_t &entry = cfg->insert("entry");
+    z_basic_block_t &ret = cfg->insert("ret");
+    for (auto &x : xs) {
+      entry.assign(x, 0);
+    }
+    z_basic_block_t *prev = &entry;
+    unsigned width = p.depth + 1;
+    for (unsigned i = 0; i < p.size; ++i) {
+      z_basic_block_t &join = cfg->insert(label("join", i));
+      prev->havoc(nd);
+      for (unsigned w = 0; w < width; ++w) {
+	z_basic_block_t &arm = cfg->insert(label("arm", i * width + w));
+	arm.assume(nd == w);
+	for (unsigned j = 0; j < xs.size(); ++j) {
+	  arm.add(xs[j], xs[j], (j + w) % width);
+	}
+	*prev >> arm;
+	arm >> join;
+      }
+      prev = &join;
+    }
+    *prev >> ret;
+    return cfg;
+  }
+
+  // One loop that updates many related variables
+  z_cfg_t* many_vars(variable_factory_t &vfac, const bench_params &p) {
+    z_cfg_t *cfg = new z_cfg_t("entry", "ret");
+    unsigned n = std::max(p.vars * p.size, 2u);
+    vector<z_var> xs = make_vars(vfac, "x", n);
+    z_var i(vfac["i"], crab::INT_TYPE, 32);
+    z_basic_block_t &entry = cfg->insert("entry");
+    z_basic_block_t &head = cfg->insert("head");
+    z_basic_block_t &body = cfg->insert("body");
+    z_basic_block_t &ret = cfg->insert("ret");
+    entry >> head; head >> body; body >> head; head >> ret;
+    entry.assign(i, 0);
+    for (unsigned j = 0; j < n; ++j) {
+      entry.assign(xs[j], j);
+    }
+    body.assume(i <= 99);
+    body.add(i, i, 1);
+    for (unsigned j = 0; j < n; ++j) {
+      // x_j - i is invariant
+      body.add(xs[j], xs[j], 1);
+    }
+    ret.assume(i >= 100);
+    return cfg;
+  }
+
+  // p.size loops, each initializing and reading p.vars arrays
+  z_cfg_t* array_loops(variable_factory_t &vfac, const bench_params &p) {
+    z_cfg_t *cfg = new z_cfg_t("entry", "ret", ARR);
+    vector<z_var> as = make_vars(vfac, "A", std::max(p.vars, 1u),
+				 crab::ARR_INT_TYPE);
+    vector<z_var> vs = make_vars(vfac, "v", std::max(p.vars, 1u));
+    z_var i(vfac["i"], crab::INT_TYPE, 32);
+    z_var zero(vfac["zero"], crab::INT_TYPE, 32);
+    z_basic_block_t &entry = cfg->insert("entry");
+    z_basic_block_t &ret = cfg->insert("ret");
+    entry.assign(zero, 0);
+    for (auto &a : as) {
+      entry.array_init(a, 1, 0, 99, zero);
+    }
+    z_basic_block_t *prev = &entry;
+    for (unsigned k = 0; k < p.size; ++k) {
+      z_basic_block_t &head = cfg->insert(label("head", k));
+      z_basic_block_t &body = cfg->insert(label("body", k));
+      z_basic_block_t &exit = cfg->insert(label("exit", k));
+      prev->assign(i, 0);
+      *prev >> head; head >> body; body >> head; head >> exit;
+      body.assume(i <= 99);
+      for (unsigned j = 0; j < as.size(); ++j) {
+	body.array_load(vs[j], as[j], i, 1);
+	body.add(vs[j], vs[j], k + 1);
+	body.array_store(as[j], i, vs[j], 1);
+      }
+      body.add(i, i, 1);
+      exit.assume(i >= 100);
+      prev = &exit;
+    }
+    *prev >> ret;
+    return cfg;
+  }
+
+  typedef function<z_cfg_t*(variable_factory_t&, const bench_params&)> generator_t;
+
+  const vector<pair<string, generator_t>>& generators() {
+    static vector<pair<string, generator_t>> gs = {
+      {"nested_loops", nested_loops},
+      {"straight_line", straight_line},
+      {"wide_diamonds", wide_diamonds},
+      {"many_vars", many_vars},
+      {"array_loops", array_loops}};
+    return gs;
+  }
+
+  /*
+   * Domains
+   */
+
+  struct run_result {
+    double wall_ms;
+    unsigned widenings;
+  };
+
+  template<typename Dom>
+  run_result run_domain(z_cfg_t *cfg, const bench_params &p) {
+    auto start = chrono::steady_clock::now();
+    intra_fwd_analyzer<z_cfg_ref_t, Dom> a(*cfg, Dom::top(), nullptr,
+					   p.widening_delay, p.narrowing_iters,
+					   p.jump_set_size);
+    a.run();
+    auto end = chrono::steady_clock::now();
+    run_result r;
+    r.wall_ms = chrono::duration<double, milli>(end - start).count();
+    r.widenings = crab::CrabStats::get("Fixpo.widening");
+    return r;
+  }
+
+  typedef function<run_result(z_cfg_t*, const bench_params&)> runner_t;
+
+  #define BENCH_DOMAIN(NAME) {#NAME, run_domain<z_##NAME##_t>}
+
+  const vector<pair<string, runner_t>>& domains() {
+    static vector<pair<string, runner_t>> ds = {
+      BENCH_DOMAIN(interval_domain),
+      BENCH_DOMAIN(ric_domain),
+      BENCH_DOMAIN(dbm_domain),
+      BENCH_DOMAIN(sdbm_domain),
+      BENCH_DOMAIN(term_domain),
+      BENCH_DOMAIN(term_dis_int),
+      BENCH_DOMAIN(num_domain),
+      BENCH_DOMAIN(bool_num_domain),
+      BENCH_DOMAIN(bool_interval_domain),
+      BENCH_DOMAIN(dis_interval_domain),
+      BENCH_DOMAIN(nullity_domain),
+      BENCH_DOMAIN(wrapped_interval_domain),
+      BENCH_DOMAIN(as_dis_int),
+      BENCH_DOMAIN(as_sdbm),
+      BENCH_DOMAIN(as_num_null),
+      BENCH_DOMAIN(as_bool_num),
+      BENCH_DOMAIN(ag_sdbm_intv),
+      BENCH_DOMAIN(ag_num_null),
+      BENCH_DOMAIN(ae_term_int),
+      #ifdef HAVE_LDD
+      BENCH_DOMAIN(boxes_domain),
+      #endif
+      #ifdef HAVE_APRON
+      BENCH_DOMAIN(box_apron_domain),
+      BENCH_DOMAIN(oct_apron_domain),
+      BENCH_DOMAIN(pk_apron_domain),
+      #endif
+      #ifdef HAVE_ELINA
+      BENCH_DOMAIN(zones_elina_domain),
+      BENCH_DOMAIN(oct_elina_domain),
+      BENCH_DOMAIN(pk_elina_domain),
+      #endif
+    };
+    return ds;
+  }
+
+  /*
+   * Reporting
+   */
+
+  string json_string(const string &s) {
+    string r = "\"";
+    for (char c : s) {
+      switch (c) {
+      case '"':  r += "\\\""; break;
+      case '\\': r += "\\\\"; break;
+      case '\n': r += "\\n"; break;
+      case '\t': r += "\\t"; break;
+      case '\r': r += "\\r"; break;
+      default:
+	if ((unsigned char) c < 0x20) {
+	  char buf[8];
+	  snprintf(buf, sizeof(buf), "\\u%04x", (unsigned) c);
+	  r += buf;
+	} else {
+	  r += c;
+	}
+      }
+    }
+    return r + "\"";
+  }
+
+  template<typename V>
+  string json_object(const map<string, V> &m, function<string(const V&)> value) {
+    string r = "{", sep;
+    for (auto &kv : m) {
+      r += sep + json_string(kv.first) + ":" + value(kv.second);
+      sep = ",";
+    }
+    return r + "}";
+  }
+
+  string json_number(double v) {
+    ostringstream o;
+    o << v;
+    return o.str();
+  }
+
+  // All counters, timers, averages and string values as a JSON
+  // object. Names are taken as they are (they can contain spaces).
+  string json_stats() {
+    map<string, unsigned> counters;
+    map<string, double> timers, averages;
+    map<string, string> strings;
+    crab::CrabStats::get_all(counters, timers, averages, strings);
+    return "{\"counters\":" +
+      json_object<unsigned>(counters, [](const unsigned &v) { return to_string(v); }) +
+      ",\"timers\":" + json_object<double>(timers, json_number) +
+      ",\"averages\":" + json_object<double>(averages, json_number) +
+      ",\"strings\":" + json_object<string>(strings, json_string) + "}";
+  }
+
+  long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+  }
+
+  void run_one(const string &gen_name, const generator_t &gen,
+	       const string &dom_name, const runner_t &run,
+	       const bench_params &p) {
+    crab::CrabStats::reset();
+    variable_factory_t vfac;
+    z_cfg_t *cfg = gen(vfac, p);
+    unsigned blocks = 0, stmts = 0;
+    for (auto &b : *cfg) {
+      ++blocks;
+      stmts += b.size();
+    }
+    run_result r = run(cfg, p);
+    cout << "{\"generator\":" << json_string(gen_name)
+	 << ",\"size\":" << p.size << ",\"vars\":" << p.vars
+	 << ",\"depth\":" << p.depth
+	 << ",\"blocks\":" << blocks << ",\"statements\":" << stmts
+	 << ",\"domain\":" << json_string(dom_name)
+	 << ",\"wall_ms\":" << r.wall_ms
+	 << ",\"peak_rss_kb\":" << peak_rss_kb()
+	 << ",\"widenings\":" << r.widenings
+	 << ",\"stats\":" << json_stats() << "}" << endl;
+    delete cfg;
+  }
+
+  bool selected(const vector<string> &names, const string &n) {
+    return names.empty() ||
+      find(names.begin(), names.end(), "all") != names.end() ||
+      find(names.begin(), names.end(), n) != names.end();
+  }
+
+} // end namespace
+
+int main(int argc, char** argv) {
+  namespace po = boost::program_options;
+
+  bench_params p;
+  vector<string> gen_names, dom_names;
+  bool no_fork = false;
+  po::options_description desc("crab-bench options");
+  desc.add_options()
+    ("help", "Print help message")
+    ("list", "List generators and domains")
+    ("generator,g", po::value<vector<string>>(&gen_names),
+     "Generator to run (default: all)")
+    ("domain,d", po::value<vector<string>>(&dom_names),
+     "Domain to run (default: all)")
+    ("size", po::value<unsigned>(&p.size)->default_value(10),
+     "Number of blocks, loops, or diamonds")
+    ("vars", po::value<unsigned>(&p.vars)->default_value(8),
+     "Number of variables")
+    ("depth", po::value<unsigned>(&p.depth)->default_value(3),
+     "Loop nesting depth (diamond width for wide_diamonds)")
+    ("widening-delay", po::value<unsigned>(&p.widening_delay)->default_value(1),
+     "Widening delay")
+    ("narrowing-iterations", po::value<unsigned>(&p.narrowing_iters)->default_value(2),
+     "Number of descending iterations")
+    ("jump-set-size", po::value<unsigned>(&p.jump_set_size)->default_value(0),
+     "Size of the widening jump set")
+    ("no-fork", po::bool_switch(&no_fork),
+     "Run everything in one process (peak_rss_kb is then cumulative)");
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  po::notify(vm);
+
+  if (vm.count("help")) {
+    cout << desc << "\n";
+    return 0;
+  }
+  if (vm.count("list")) {
+    for (auto &g : generators()) {
+      cout << "generator " << g.first << "\n";
+    }
+    for (auto &d : domains()) {
+      cout << "domain " << d.first << "\n";
+    }
+    return 0;
+  }
+  crab::CrabEnableWarningMsg(false);
+
+  int status = 0;
+  for (auto &g : generators()) {
+    if (!selected(gen_names, g.first)) continue;
+    for (auto &d : domains()) {
+      if (!selected(dom_names, d.first)) continue;
+      if (no_fork) {
+	run_one(g.first, g.second, d.first, d.second, p);
+	continue;
+      }
+      cout.flush();
+      pid_t pid = fork();
+      if (pid == 0) {
+	run_one(g.first, g.second, d.first, d.second, p);
+	cout.flush();
+	_exit(0);
+      } else if (pid < 0) {
+	CRAB_ERROR("crab-bench: fork failed");
+      }
+      int child_status;
+      waitpid(pid, &child_status, 0);
+      if (!WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0) {
+	cerr << "crab-bench: " << g.first << " with " << d.first
+	     << " failed\n";
+	status = 1;
+      }
+    }
+  }
+  return status;
+}
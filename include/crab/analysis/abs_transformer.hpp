@@ -44,6 +44,7 @@
 #include <crab/cfg/cfg.hpp>
 #include <crab/domains/linear_constraints.hpp>
 #include <crab/domains/abstract_domain_operators.hpp>
+#include <crab/domains/abstract_domain_specialized_traits.hpp>
 
 namespace crab {
 
@@ -250,6 +251,29 @@ namespace crab {
       }
     }
 
+    // Apply the transfer functions of all the statements of a basic
+    // block. Constraints of consecutive assume statements are passed
+    // to the abstract domain at once so that it can restore its
+    // internal invariants (e.g., closure) once per run rather than
+    // after each statement.
+    template<typename BasicBlock>
+    void exec_block(BasicBlock& b) {
+      typedef crab::domains::block_domain_traits<abs_dom_t> block_traits_t;
+      auto it = b.begin(), et = b.end();
+      while (it != et) {
+	if (!it->is_assume()) {
+	  it->accept(this);
+	  ++it;
+	  continue;
+	}
+	lin_cst_sys_t csts;
+	for (; it != et && it->is_assume(); ++it) {
+	  csts += static_cast<assume_t&>(*it).constraint();
+	}
+	block_traits_t::add_constraints(*get(), csts);
+      }
+    }
+    
     void exec(bin_op_t& stmt) {      
       bool pre_bot = false;
       if (::crab::CrabSanityCheckFlag) {
@@ -6,8 +6,15 @@
 #include <crab/common/debug.hpp>
 #include <crab/common/types.hpp>
 #include <crab/iterators/killgen_fixpoint_iterator.hpp>
+#include <crab/iterators/block_numbering.hpp>
 
 #include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <bitset>
+#include <cstdint>
+#include <deque>
+#include <vector>
 
 namespace crab {
 
@@ -77,6 +84,83 @@ namespace crab {
       virtual std::string name () { return "liveness";}
    };
 
+   namespace liveness_impl {
+
+     /**
+        A table of fixed-size bit vectors, one row per block, stored
+        contiguously. The loops below operate on whole 64-bit words
+        and have no data-dependent branches so that the compiler can
+        vectorize them.
+     **/
+     class bit_table {
+
+       typedef uint64_t word_t;
+       static const std::size_t word_bits = 64;
+
+       std::size_t _words; // number of words per row
+       std::vector<word_t> _bits;
+
+     public:
+
+       bit_table(std::size_t rows, std::size_t cols)
+	 : _words((cols + word_bits - 1) / word_bits),
+	   _bits(rows * _words, 0) { }
+
+       word_t* row(std::size_t r) { return &_bits[r * _words]; }
+
+       const word_t* row(std::size_t r) const { return &_bits[r * _words]; }
+
+       std::size_t words() const { return _words; }
+
+       void set(std::size_t r, std::size_t c) {
+	 row(r)[c / word_bits] |= ((word_t) 1 << (c % word_bits));
+       }
+
+       void reset(std::size_t r, std::size_t c) {
+	 row(r)[c / word_bits] &= ~((word_t) 1 << (c % word_bits));
+       }
+
+       bool test(std::size_t r, std::size_t c) const {
+	 return (row(r)[c / word_bits] >> (c % word_bits)) & 1;
+       }
+
+       std::size_t count(std::size_t r) const {
+	 const word_t* x = row(r);
+	 std::size_t n = 0;
+	 for (std::size_t i = 0; i < _words; ++i) {
+	   n += std::bitset<word_bits>(x[i]).count();
+	 }
+	 return n;
+       }
+
+       //! dst := dst | src
+       void join(word_t* dst, const word_t* src) const {
+	 for (std::size_t i = 0; i < _words; ++i) {
+	   dst[i] |= src[i];
+	 }
+       }
+
+       //! dst := (src & ~kill) | gen. Return true if dst changed.
+       bool transfer(word_t* dst, const word_t* src,
+		     const word_t* kill, const word_t* gen) const {
+	 word_t change = 0;
+	 for (std::size_t i = 0; i < _words; ++i) {
+	   word_t v = (src[i] & ~kill[i]) | gen[i];
+	   change |= (v ^ dst[i]);
+	   dst[i] = v;
+	 }
+	 return change != 0;
+       }
+
+       void clear(word_t* dst) const {
+	 for (std::size_t i = 0; i < _words; ++i) {
+	   dst[i] = 0;
+	 }
+       }
+     };
+
+   } // end namespace liveness_impl
+
    //! Live variable analysis
    template<typename CFG>
    class liveness:
@@ -88,6 +172,7 @@ namespace crab {
      typedef typename CFG::basic_block_label_t basic_block_label_t;
      typedef typename CFG::statement_t statement_t;
      typedef typename CFG::varname_t varname_t;
+     typedef typename CFG::variable_t variable_t;
      
     private:
 
@@ -108,11 +193,132 @@ namespace crab {
      // variables at the end of the blocks
      boost::unordered_map<basic_block_label_t, liveness_domain_t> _dead_map;
 
+     // maximum number of bits (blocks x variables) for which the
+     // bit-vector solver is used.
+     std::size_t _max_bits;
+
      // statistics 
      unsigned _max_live;
      unsigned _total_live;
      unsigned _total_blks;
 
+     typedef crab::iterators::block_numbering<basic_block_label_t, CFG> block_numbering_t;
+     typedef typename block_numbering_t::id_t id_t;
+     typedef liveness_impl::bit_table bit_table_t;
+
+     // Solve the liveness equations with one bit vector per block
+     // and a worklist. Variables are numbered densely in the order
+     // in which they occur in the CFG. Return false (without
+     // computing anything) if the bit vectors would not fit in
+     // _max_bits.
+     bool run_bitvector () {
+       block_numbering_t numbering (this->_cfg);
+       std::size_t num_blocks = numbering.size ();
+
+       boost::unordered_map<variable_t, std::size_t> var_ids;
+       std::vector<variable_t> vars;
+       auto number = [&var_ids, &vars](const variable_t &v) {
+	 if (var_ids.insert (std::make_pair (v, vars.size ())).second) {
+	   vars.push_back (v);
+	 }
+       };
+       for (auto &b: boost::make_iterator_range(this->_cfg.begin(),this->_cfg.end())) {
+	 for (auto &s: b) {
+	   auto live = s.get_live();
+	   for (auto v: boost::make_iterator_range(live.uses_begin(), live.uses_end())) {
+	     number (v);
+	   }
+	   for (auto v: boost::make_iterator_range(live.defs_begin(), live.defs_end())) {
+	     number (v);
+	   }
+	 }
+       }
+       std::size_t num_vars = vars.size ();
+       if (num_vars > 0 && num_blocks > _max_bits / num_vars) {
+	 return false;
+       }
+
+       crab::ScopedCrabStats __st__("liveness");
+       crab::CrabStats::count ("Liveness.bitvector");
+
+       // -- kill and gen sets
+       bit_table_t kill (num_blocks, num_vars), gen (num_blocks, num_vars);
+       for (auto &b: boost::make_iterator_range(this->_cfg.begin(),this->_cfg.end())) {
+	 id_t i = numbering.id (b.label ());
+	 for (auto &s: boost::make_iterator_range(b.rbegin(),b.rend())) {
+	   auto live = s.get_live();
+	   for (auto d: boost::make_iterator_range(live.defs_begin(), live.defs_end())) {
+	     std::size_t x = var_ids[d];
+	     kill.set (i, x);
+	     gen.reset (i, x);
+	   }
+	   for (auto u: boost::make_iterator_range(live.uses_begin(), live.uses_end())) {
+	     gen.set (i, var_ids[u]);
+	   }
+	 }
+       }
+
+       // -- fixpoint: a block is processed again only if the live-in
+       //    set of one of its successors changed.
+       bit_table_t in (num_blocks, num_vars), out (num_blocks, num_vars);
+       std::deque<id_t> worklist;
+       std::vector<bool> in_worklist (num_blocks, false);
+       for (auto n: crab::analyzer::graph_algo::weak_rev_topo_sort(this->_cfg)) {
+	 id_t i = numbering.id (n);
+	 if (!in_worklist [i]) {
+	   in_worklist [i] = true;
+	   worklist.push_back (i);
+	 }
+       }
+       unsigned iterations = 0;
+       while (!worklist.empty ()) {
+	 id_t i = worklist.front ();
+	 worklist.pop_front ();
+	 in_worklist [i] = false;
+	 ++iterations;
+	 auto succs = numbering.succs (i);
+	 out.clear (out.row (i));
+	 for (auto it = succs.first; it != succs.second; ++it) {
+	   out.join (out.row (i), in.row (*it));
+	 }
+	 if (in.transfer (in.row (i), out.row (i), kill.row (i), gen.row (i))) {
+	   auto preds = numbering.preds (i);
+	   for (auto it = preds.first; it != preds.second; ++it) {
+	     if (!in_worklist [*it]) {
+	       in_worklist [*it] = true;
+	       worklist.push_back (*it);
+	     }
+	   }
+	 }
+       }
+       CRAB_LOG("liveness",
+		crab::outs() << "liveness: fixpoint reached after processing "
+		             << iterations << " blocks.\n");
+
+       // -- collect dead variables at the exit of each block
+       for (id_t i = 0; i < num_blocks; ++i) {
+	 basic_block_label_t bb = numbering.label (i);
+	 std::size_t live_out = out.count (i);
+	 if (live_out > 0) {
+	   liveness_domain_t dead_set;
+	   for (auto v: this->_cfg.get_node(bb).live()) {
+	     auto it = var_ids.find (v);
+	     if (it == var_ids.end () || !out.test (i, it->second)) {
+	       dead_set += v;
+	     }
+	   }
+	   CRAB_LOG("liveness",
+		    crab::outs() << cfg_impl::get_label_str(bb)
+		                 << " dead variables=" << dead_set <<"\n";);
+	   _dead_map.insert (std::make_pair(bb, dead_set));
+	   _total_live += live_out;
+	   _max_live = std::max (_max_live, (unsigned) live_out);
+	   _total_blks ++;
+	 }
+       }
+       return true;
+     }
+
      void process_post (basic_block_label_t bb, 
                         liveness_domain_t live_out) {
        // --- Collect dead variables at the exit of bb
@@ -136,11 +342,17 @@ namespace crab {
           
     public:
 
-     liveness (CFG cfg)
-         : killgen_fixpoint_iterator_t(cfg), 
+     //! max_bits bounds the memory used by the bit-vector solver:
+     //! if the number of blocks times the number of variables is
+     //! greater, the analysis falls back to the kill-gen fixpoint
+     //! iterator over sets of variables.
+     liveness (CFG cfg, std::size_t max_bits = (1 << 26))
+         : killgen_fixpoint_iterator_t(cfg), _max_bits (max_bits),
            _max_live (0), _total_live (0), _total_blks (0) { }
 
      void exec() { 
+       if (run_bitvector ()) return;
+       
        this->run();
        for (auto p : boost::make_iterator_range(this->out_begin(), this->out_end()))
        { process_post (p.first, p.second); } 
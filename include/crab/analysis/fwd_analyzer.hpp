@@ -11,6 +11,8 @@
 #include "boost/range/algorithm/set_algorithm.hpp"
 #include "boost/shared_ptr.hpp"
 
+#include <functional>
+
 namespace crab {
 
   namespace analyzer {
@@ -49,6 +51,9 @@ namespace crab {
       typedef typename fwd_iterator_t::wto_t wto_t;
       typedef typename fwd_iterator_t::iterator iterator;
       typedef typename fwd_iterator_t::const_iterator const_iterator;
+      // Callback on the final invariants at the entry of a block. The
+      // abstract transformer is set to a copy of them.
+      typedef std::function<void(basic_block_label_t, abs_tr_t&)> block_callback_t;
 
      private:
       
@@ -57,8 +62,9 @@ namespace crab {
       abs_tr_t*  m_abs_tr; // the abstract transformer
       const liveness_t* m_live;
       live_set_t m_formals;
+      block_callback_t m_process_pre;
       
-      void prune_dead_variables(abs_dom_t &inv, basic_block_label_t node) {
+      void prune_dead_variables(abs_dom_t &inv, basic_block_label_t node) const {
         if (!m_live) return;
 
 	crab::ScopedCrabStats __st__("Pruning dead variables");
@@ -75,13 +81,37 @@ namespace crab {
       //! the invariant at the exit of the block.
       void analyze(basic_block_label_t node, abs_dom_t &inv) {
         auto &b = this->get_cfg().get_node(node);
-	// XXX: set takes a reference to inv so no copies here
-	m_abs_tr->set(&inv);
-        for (auto &s : b) { s.accept(m_abs_tr); }
+	if (this->get_num_threads() > 1) {
+	  // blocks can be analyzed concurrently so each one gets its
+	  // own (cheap) copy of the abstract transformer.
+	  abs_tr_t abs_tr(*m_abs_tr);
+	  abs_tr.set(&inv);
+	  abs_tr.exec_block(b);
+	} else {
+	  // XXX: set takes a reference to inv so no copies here
+	  m_abs_tr->set(&inv);
+	  m_abs_tr->exec_block(b);
+	}
         prune_dead_variables(inv, node);
       } 
+
+      void replay(basic_block_label_t node, abs_dom_t &inv) const override {
+        auto &b = this->get_cfg().get_node(node);
+	abs_tr_t abs_tr(*m_abs_tr);
+	abs_tr.set(&inv);
+	abs_tr.exec_block(b);
+        prune_dead_variables(inv, node);
+      }
+      
+      void process_pre(basic_block_label_t node, abs_dom_t inv) {
+	if (m_process_pre) {
+	  // inv is already a copy so the callback can modify it
+	  abs_tr_t abs_tr(*m_abs_tr);
+	  abs_tr.set(&inv);
+	  m_process_pre(node, abs_tr);
+	}
+      }
       
-      void process_pre(basic_block_label_t node, abs_dom_t inv) {}
       void process_post(basic_block_label_t node, abs_dom_t inv) {}
       
      public:
@@ -92,10 +122,12 @@ namespace crab {
 		   unsigned int descending_iters,
 		   size_t jump_set_size,
 		   // live can be nullptr if no live info is available
-		   const liveness_t* live)
+		   const liveness_t* live,
+		   // number of threads (> 1 requires a thread-safe abstract domain)
+		   unsigned int num_threads = 1)
 	: fwd_iterator_t(cfg, wto,
 			 widening_delay, descending_iters, jump_set_size,
-			 false /*disable processor*/), 
+			 false /*disable processor*/, num_threads), 
 	  m_abs_tr(abs_tr),
 	  m_live(live) {
 	CRAB_VERBOSE_IF(1, crab::outs() << "Type checking CFG ... ";);
@@ -116,7 +148,9 @@ namespace crab {
         }
 
       }
-      
+
+      // The iterators give access to the stored invariants. In
+      // memory-saving mode the evicted ones are bottom.
       iterator       pre_begin()       { return this->_pre.begin(); } 
       iterator       pre_end()         { return this->_pre.end();   }
       const_iterator pre_begin() const { return this->_pre.begin(); }
@@ -148,6 +182,27 @@ namespace crab {
         this->run(entry, *m_abs_tr->get(), assumptions);         
       }      
 
+      //! Re-stabilize the invariants computed by a previous call to
+      //! Run() after the statements of the blocks in modified have
+      //! changed. Only the parts of the CFG that depend on them are
+      //! analyzed again. The structure of the CFG must not change
+      //! and liveness information, if any, must be up-to-date.
+      void RunIncremental(const std::set<basic_block_label_t> &modified) {
+        // ugly hook to initialize some global state. This needs to be
+        // fixed properly.
+	domains::array_sgraph_domain_traits<abs_dom_t>::do_initialization(this->get_cfg());
+	
+	this->run_incremental(modified);
+      }
+
+      //! Call f on each block reachable from the entry, in WTO order,
+      //! once the fixpoint has been reached. The invariants are
+      //! post-processed only if f is set.
+      void set_process_pre(block_callback_t f) {
+	m_process_pre = f;
+	this->_enable_processor = (bool) f;
+      }
+      
       //! Return the invariants that hold at the entry of b
       inline abs_dom_t operator[](basic_block_label_t b) const {
         return get_pre(b);
@@ -155,31 +210,13 @@ namespace crab {
       
       //! Return the invariants that hold at the entry of b
       abs_dom_t get_pre(basic_block_label_t b) const {
-        auto it = this->_pre.find(b);
-        if (it == this->_pre.end()) {
-          return abs_dom_t::bottom();
-	  // if the basic block is not in the invariant table it must
-	  // be because it was not reached by the analysis. We
-	  // returned top but it never had real effect because
-	  // process_pre made sure that all unreachable blocks were in
-	  // the invariant table with a bottom invariant. This was
-	  // just a waste of space.
- 	  // 
-	  // return abs_dom_t::top();
-	} else {
-          return it->second;
-	}
+	// unreachable blocks are bottom
+        return fwd_iterator_t::get_pre(b);
       }
       
       //! Return the invariants that hold at the exit of b
       abs_dom_t get_post(basic_block_label_t b) const {
-        auto it = this->_post.find(b);
-        if (it == this->_post.end()) {
-          return abs_dom_t::bottom();	  
-          //return abs_dom_t::top();
-	} else {
-          return it->second;
-	}
+        return fwd_iterator_t::get_post(b);
       }
 
       //! Return the WTO of the CFG. The WTO contains also how many
@@ -190,8 +227,7 @@ namespace crab {
 
       // clear all invariants (pre and post)
       void clear() {
-	this->_pre.clear();
-	this->_post.clear();
+	fwd_iterator_t::clear();
       }
       
     }; 
@@ -219,6 +255,7 @@ namespace crab {
       typedef typename fwd_analyzer_t::assumption_map_t assumption_map_t;
       typedef typename fwd_analyzer_t::iterator iterator;
       typedef typename fwd_analyzer_t::const_iterator const_iterator;
+      typedef typename fwd_analyzer_t::block_callback_t block_callback_t;
 
     private:
       
@@ -233,12 +270,13 @@ namespace crab {
 				 // fixpoint parameters
 				 unsigned int widening_delay=1,
 				 unsigned int descending_iters=UINT_MAX,
-				 size_t jump_set_size=0)
+				 size_t jump_set_size=0,
+				 unsigned int num_threads=1)
 	: m_init(AbsDomain::top()),
 	  m_abs_tr(boost::make_shared<abs_tr_t>(&m_init)),
 	  m_analyzer(cfg, nullptr, &*m_abs_tr, 
 		     widening_delay, descending_iters, jump_set_size,
-		     nullptr) { }
+		     nullptr, num_threads) { }
       
       intra_fwd_analyzer_wrapper(CFG cfg, AbsDomain init,
 				 // liveness info
@@ -246,12 +284,13 @@ namespace crab {
 				 // fixpoint parameters
 				 unsigned int widening_delay=1,
 				 unsigned int descending_iters=UINT_MAX,
-				 size_t jump_set_size=0)
+				 size_t jump_set_size=0,
+				 unsigned int num_threads=1)
 	: m_init(init),
 	  m_abs_tr(boost::make_shared<abs_tr_t>(&m_init)),	  
 	  m_analyzer(cfg, nullptr, &*m_abs_tr, 
 		     widening_delay, descending_iters, jump_set_size,
-		     live) { }
+		     live, num_threads) { }
       
       intra_fwd_analyzer_wrapper(CFG cfg,
 				 // avoid precompute wto if already available
@@ -263,12 +302,13 @@ namespace crab {
 				 // fixpoint parameters
 				 unsigned int widening_delay=1,
 				 unsigned int descending_iters=UINT_MAX,
-				 size_t jump_set_size=0)
+				 size_t jump_set_size=0,
+				 unsigned int num_threads=1)
 	: m_init(init),
 	  m_abs_tr(boost::make_shared<abs_tr_t>(&m_init)),	  	  
 	  m_analyzer(cfg, wto, &*m_abs_tr, 
 		     widening_delay, descending_iters, jump_set_size,
-		     live) { }
+		     live, num_threads) { }
       
       
       iterator       pre_begin()       { return m_analyzer.pre_begin();} 
@@ -288,6 +328,19 @@ namespace crab {
       void run(basic_block_label_t entry, assumption_map_t &assumptions) {
 	m_analyzer.Run(entry, assumptions);
       }
+
+      void run_incremental(const std::set<basic_block_label_t> &modified) {
+	m_analyzer.RunIncremental(modified);
+      }
+
+      void set_process_pre(block_callback_t f) {
+	m_analyzer.set_process_pre(f);
+      }
+
+      void set_memory_saving(bool v, const std::set<basic_block_label_t> &extra_checkpoints =
+			     std::set<basic_block_label_t>()) {
+	m_analyzer.set_memory_saving(v, extra_checkpoints);
+      }
       
       abs_dom_t operator[](basic_block_label_t b) const {
 	return m_analyzer[b];
@@ -1,16 +1,34 @@
 #pragma once 
 
 /* 
-   A standard two-phase approach for _context-insensitive_
-   inter-procedural analysis.
+   A standard two-phase approach for inter-procedural analysis.
+
+   By default the analysis is _context-insensitive_: the top-down
+   phase joins all the calling contexts of a function and analyzes
+   it once. If max_call_ctxs > 1 then up to max_call_ctxs calling
+   contexts are kept per function and the function is analyzed once
+   per context. The results are memoised per function keyed by the
+   calling context so that a context subsumed by an already analyzed
+   one reuses its results.
+
+   If num_threads > 1 then independent SCCs of the call graph are
+   analyzed in parallel in both phases.
+
+   If a summary_cache is given then the bottom-up phase reuses the
+   summaries stored in it for the functions that did not change and
+   stores there the new ones.
 */
 
 #include "boost/noncopyable.hpp"
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
 
 #include <crab/common/debug.hpp>
 #include <crab/common/stats.hpp>
+#include <crab/common/thread_pool.hpp>
 #include <crab/cfg/cfg.hpp>
 #include <crab/cg/cg.hpp>
 #include <crab/analysis/graphs/sccg.hpp>
@@ -56,6 +74,7 @@ namespace crab {
       typedef fwd_analyzer<cfg_t, td_abs_tr> td_analyzer;
       typedef typename summ_tbl_t::Summary summary_t;
       typedef boost::shared_ptr<summary_t> summary_ptr;
+      typedef summary_cache<cfg_t, BU_Dom> summ_cache_t;
       // for checkers
       typedef TD_Dom abs_dom_t;
       typedef td_abs_tr abs_tr_t;
@@ -63,7 +82,21 @@ namespace crab {
      private:
 
       typedef boost::shared_ptr <td_analyzer> td_analyzer_ptr;
-      typedef boost::unordered_map <std::size_t, td_analyzer_ptr> invariant_map_t;
+      typedef typename cfg_t::fdecl_t fdecl_t;
+
+      // The result of analyzing a function under a calling context
+      struct td_result {
+        TD_Dom m_ctx;
+        td_analyzer_ptr m_analyzer;
+        // last call to Run that used this result
+        unsigned int m_last_run;
+        
+        td_result(TD_Dom ctx, td_analyzer_ptr analyzer, unsigned int last_run)
+          : m_ctx(ctx), m_analyzer(analyzer), m_last_run(last_run) { }
+      };
+      
+      typedef std::vector <td_result> td_results_t;
+      typedef boost::unordered_map <std::size_t, td_results_t> invariant_map_t;
 
       CG m_cg;
       const liveness_map_t* m_live;
@@ -73,6 +106,12 @@ namespace crab {
       unsigned int m_widening_delay;
       unsigned int m_descending_iters;
       size_t m_jump_set_size; // max size of the jump set (=0 if jump set disabled)
+      unsigned int m_max_call_ctxs; // max number of calling contexts per function
+      unsigned int m_run; // number of calls to Run
+      unsigned int m_num_threads; // analyze independent SCCs in parallel if > 1
+      summ_cache_t* m_summ_cache; // persistent summaries (optional)
+      // cache key of each function
+      boost::unordered_map<std::size_t, typename summ_cache_t::key_t> m_summ_keys;
       
       const liveness_t* get_live(const cfg_t& c) {
         if (m_live) {
@@ -82,20 +121,304 @@ namespace crab {
         }
         return nullptr;
       }
+
+      // Run the top-down analysis of cfg under the calling context
+      // ctx unless there are already results for a context that
+      // subsumes ctx.
+      void analyze_td(cfg_t cfg, const fdecl_t &fdecl, TD_Dom ctx) {
+        auto it = m_inv_map.find(crab::cfg::cfg_hasher<cfg_t>::hash(fdecl));
+        assert(it != m_inv_map.end());
+        td_results_t &results = it->second;
+        if (m_max_call_ctxs > 1) {
+          for (auto &r: results) {
+            if (ctx <= r.m_ctx) {
+              CRAB_LOG("inter",
+                       crab::outs() << "    Reusing analysis of " << fdecl
+                                    << " with " << r.m_ctx << "\n");
+              crab::CrabStats::count("Inter.TopDown.reused");
+              r.m_last_run = m_run;
+              return;
+            }
+          }
+        }
+        
+        CRAB_LOG("inter",
+                 crab::outs() << "    Starting analysis of "
+                              << fdecl <<  " with " << ctx << "\n");
+        
+        auto abs_tr = boost::make_shared<td_abs_tr>(&ctx, &m_summ_tbl, &m_call_tbl);
+        auto a = boost::make_shared<td_analyzer>(cfg, nullptr, &*abs_tr,
+                                                 m_widening_delay,
+                                                 m_descending_iters,
+                                                 m_jump_set_size,
+                                                 get_live(cfg));
+        a->Run();
+        results.push_back(td_result(ctx, a, m_run));
+
+        // Evict the least recently used results which were not used
+        // by the current run.
+        const std::size_t max_results = std::max(m_max_call_ctxs, 1U);
+        while (results.size() > max_results) {
+          auto lru = results.end();
+          for (auto it = results.begin(); it != results.end(); ++it) {
+            if (it->m_last_run != m_run &&
+                (lru == results.end() || it->m_last_run < lru->m_last_run)) {
+              lru = it;
+            }
+          }
+          if (lru == results.end()) break;
+          crab::CrabStats::count("Inter.TopDown.evicted");
+          results.erase(lru);
+        }
+      }
+
+      // Join the invariants computed by f in all the results of cfg
+      // used by the last run.
+      template<typename F>
+      TD_Dom join_results(const cfg_t &cfg, F f) const {
+        if (auto fdecl = cfg.get_func_decl()) {
+          auto const it = m_inv_map.find(crab::cfg::cfg_hasher<cfg_t>::hash(*fdecl));
+          if (it != m_inv_map.end()) {
+            boost::optional<TD_Dom> res;
+            for (auto const &r: it->second) {
+              if (r.m_last_run != m_run) continue;
+              if (!res) {
+                res = f(*(r.m_analyzer));
+              } else {
+                *res = *res | f(*(r.m_analyzer));
+              }
+            }
+            if (res) return *res;
+          }
+        }
+        return TD_Dom::top();
+      }
+
+      // Compute the cache key of each function. The key depends on
+      // the code of the function and the other members of its SCC,
+      // on the keys of the SCCs it calls and on the analysis
+      // parameters so that a cached summary is not used if anything
+      // it depends on has changed.
+      void compute_summary_keys(graph_algo::scc_graph<CG> &Scc_g,
+                                const std::vector<cg_node_t> &rev_order) {
+        typedef typename summ_cache_t::key_t key_t;
+        key_t params = summ_cache_t::hash(BU_Dom::getDomainName());
+        params = summ_cache_t::hash(m_widening_delay, params);
+        params = summ_cache_t::hash(m_descending_iters, params);
+        params = summ_cache_t::hash(m_jump_set_size, params);
+        
+        boost::unordered_map<cg_node_t, key_t> scc_keys;
+        for (auto n: rev_order) {
+          std::vector<cg_node_t> &scc_mems = Scc_g.get_component_members(n);
+          std::vector<key_t> code_keys, callee_keys;
+          for (auto m: scc_mems) {
+            crab::crab_string_os o;
+            o << m.get_cfg();
+            code_keys.push_back(summ_cache_t::hash(o.str()));
+          }
+          for (auto e: boost::make_iterator_range(Scc_g.succs(n))) {
+            callee_keys.push_back(scc_keys[e.Dest()]);
+          }
+          std::sort(code_keys.begin(), code_keys.end());
+          std::sort(callee_keys.begin(), callee_keys.end());
+          key_t h = params;
+          for (auto k: code_keys) h = summ_cache_t::hash(k, h);
+          for (auto k: callee_keys) h = summ_cache_t::hash(k, h);
+          scc_keys[n] = h;
+          
+          for (auto m: scc_mems) {
+            auto fdecl = m.get_cfg().get_func_decl();
+            assert(fdecl);
+            m_summ_keys[crab::cfg::cfg_hasher<cfg_t>::hash(*fdecl)] =
+              summ_cache_t::hash((*fdecl).get_func_name(), h);
+          }
+        }
+      }
+      
+      // Compute the summaries of the functions of an SCC
+      void run_bottom_up(const std::vector<cg_node_t> &scc_mems) {
+        crab::ScopedCrabStats __st__("Inter.BottomUp");
+        for (auto m: scc_mems) {
+
+          auto cfg = m.get_cfg();
+          auto fdecl = cfg.get_func_decl();            
+          assert(fdecl);
+
+          std::string fun_name = (*fdecl).get_func_name();
+          if (fun_name != "main" && cfg.has_exit()) {
+	    CRAB_VERBOSE_IF(1, crab::outs() << "++ Analyzing function "
+	                                    << (*fdecl).get_func_name() << "\n";);
+            // --- build the summary
+            std::vector<variable_t> formals, inputs, outputs;
+            formals.reserve((*fdecl).get_num_inputs() +(*fdecl).get_num_outputs());
+            inputs.reserve((*fdecl).get_num_inputs());
+            outputs.reserve((*fdecl).get_num_outputs());
+
+            for (unsigned i=0; i < (*fdecl).get_num_inputs();i++) {
+              inputs.push_back((*fdecl).get_input_name(i));
+              formals.push_back((*fdecl).get_input_name(i));
+            }
+            for (unsigned i=0; i < (*fdecl).get_num_outputs();i++) {
+              outputs.push_back((*fdecl).get_output_name(i));
+              formals.push_back((*fdecl).get_output_name(i));
+            }
+	    
+            // --- reuse the summary from the cache
+            typename summ_cache_t::key_t key = 0;
+            if (m_summ_cache) {
+              auto it = m_summ_keys.find(crab::cfg::cfg_hasher<cfg_t>::hash(*fdecl));
+              assert(it != m_summ_keys.end());
+              key = it->second;
+              BU_Dom inv = BU_Dom::top();
+              if (m_summ_cache->get(key, inputs, outputs, inv)) {
+                crab::CrabStats::count("Inter.BottomUp.cache_hits");
+                m_summ_tbl.insert(*fdecl, inv, inputs, outputs);
+                continue;
+              }
+            }
+            
+            // --- run the analysis
+	    auto init_inv = BU_Dom::top();
+	    bu_abs_tr abs_tr(&init_inv, &m_summ_tbl);
+            bu_analyzer a(cfg, nullptr, &abs_tr, 
+                           m_widening_delay, m_descending_iters, m_jump_set_size,
+			   get_live(cfg)) ; 
+            a.Run();
+	      
+            // --- project onto formal parameters and return values
+            auto inv = a.get_post(cfg.exit());
+            //crab::CrabStats::count(BU_Dom::getDomainName() + ".count.project");
+	    inv.project(formals);
+            m_summ_tbl.insert(*fdecl, inv, inputs, outputs);
+            if (m_summ_cache) {
+              m_summ_cache->insert(key, inv, inputs, outputs);
+            }
+          }
+        }
+      }
+
+      // Analyze the functions of the SCC n under their calling
+      // contexts. The calling contexts are complete only if all the
+      // callers of n have been already analyzed.
+      void run_top_down(cg_node_t n, const std::vector<cg_node_t> &scc_mems,
+                        bool is_root, const TD_Dom &init) {
+        crab::ScopedCrabStats __st__("Inter.TopDown");
+	// The SCC is recursive if it has more than one element or
+	// there is only one that calls directly to itself.
+	bool is_recursive = (scc_mems.size() > 1) ||
+	  std::any_of(m_cg.succs(n).first, m_cg.succs(n).second,
+	              [n](const cg_edge_t& e) {
+	                return (n == e.dest());
+	              });
+
+        for (auto m: scc_mems) {
+          auto cfg = m.get_cfg();
+          auto fdecl = cfg.get_func_decl();
+          assert(fdecl);
+	  CRAB_VERBOSE_IF(1, crab::outs() << "++ Analyzing function " 
+	                                  << (*fdecl).get_func_name() << "\n";);
+          if (is_recursive) {
+            // If the SCC is recursive then what we have in
+            // m_call_tbl is incomplete and therefore it is unsound
+            // to use it. To remedy it, we insert another calling
+            // context with top value that approximates all the
+            // possible calling contexts during the recursive calls.
+            m_call_tbl.insert(*fdecl, TD_Dom::top());
+          }
+	 
+          if (is_root) {
+            // only the first member of the root SCC is analyzed with
+            // the initial state
+            is_root = false;
+            analyze_td(cfg, *fdecl, init);
+	  } else {
+            for (auto ctx: m_call_tbl.get_call_ctxs(*fdecl)) {
+              analyze_td(cfg, *fdecl, ctx);
+            }
+          }
+        }
+      }
+
+      // Run f on every SCC of Scc_g using a thread pool. If bottom_up
+      // then an SCC is run as soon as all the SCCs it calls are done,
+      // otherwise as soon as all the SCCs that call it are done.
+      //
+      // The summary and calling context tables are thread-safe but
+      // the abstract domains must be thread-safe as well.
+      template<typename F>
+      void run_parallel(graph_algo::scc_graph<CG> &Scc_g,
+                        const std::vector<cg_node_t> &sccs,
+                        bool bottom_up, F f) {
+        unsigned num_sccs = sccs.size();
+        boost::unordered_map<cg_node_t, unsigned> index;
+        for (unsigned i = 0; i < num_sccs; ++i) {
+          index[sccs[i]] = i;
+        }
+        // waiting[i] are the SCCs that depend on i
+        std::vector<std::vector<unsigned>> waiting(num_sccs);
+        std::vector<const std::vector<cg_node_t>*> members(num_sccs);
+        std::unique_ptr<std::atomic<unsigned>[]>
+          num_deps(new std::atomic<unsigned>[num_sccs]);
+        for (unsigned i = 0; i < num_sccs; ++i) {
+          num_deps[i] = 0;
+        }
+        for (unsigned i = 0; i < num_sccs; ++i) {
+          members[i] = &Scc_g.get_component_members(sccs[i]);
+          for (auto e: boost::make_iterator_range(Scc_g.succs(sccs[i]))) {
+            // sccs[i] calls sccs[j]
+            unsigned j = index[e.Dest()];
+            if (bottom_up) {
+              waiting[j].push_back(i);
+              ++num_deps[i];
+            } else {
+              waiting[i].push_back(j);
+              ++num_deps[j];
+            }
+          }
+        }
+
+        CRAB_VERBOSE_IF(1, crab::outs() << "Analyzing " << num_sccs
+                        << " SCCs with " << m_num_threads << " threads\n";);
+        
+        crab::work_stealing_thread_pool pool(m_num_threads);
+        std::function<void(unsigned)> run_scc = [&](unsigned i) {
+          f(sccs[i], *members[i]);
+          for (unsigned j : waiting[i]) {
+            if (--num_deps[j] == 0) {
+              pool.submit([&run_scc, j] { run_scc(j); });
+            }
+          }
+        };
+        for (unsigned i = 0; i < num_sccs; ++i) {
+          if (num_deps[i] == 0) {
+            pool.submit([&run_scc, i] { run_scc(i); });
+          }
+        }
+        pool.wait();
+      }
       
      public:
       
       inter_fwd_analyzer(CG cg, const liveness_map_t* live,
                           unsigned int widening_delay=1,
                           unsigned int descending_iters=UINT_MAX,
-                          size_t jump_set_size=0)
+                          size_t jump_set_size=0,
+                          unsigned int max_call_ctxs=0,
+                          unsigned int num_threads=1,
+                          summ_cache_t* summ_cache=nullptr)
           : m_cg(cg), m_live(live),
+            m_call_tbl(max_call_ctxs),
             m_widening_delay(widening_delay), 
             m_descending_iters(descending_iters),
-            m_jump_set_size(jump_set_size) { }
+            m_jump_set_size(jump_set_size),
+            m_max_call_ctxs(max_call_ctxs),
+            m_run(0),
+            m_num_threads(num_threads),
+            m_summ_cache(summ_cache) { }
       
       //! Trigger the whole analysis
       void Run(TD_Dom init = TD_Dom::top())  {
+        ++m_run;
 
 	CRAB_VERBOSE_IF(1, crab::outs() << "Started inter-procedural analysis\n";);
         CRAB_LOG("inter", 
@@ -134,15 +457,7 @@ namespace crab {
 		      crab::outs() << "++ Analyzing function "
 		                   << (*fdecl).get_func_name() << "\n");
 
-	    auto abs_tr = boost::make_shared<td_abs_tr>(&init, &m_summ_tbl, &m_call_tbl);
-            auto a = boost::make_shared<td_analyzer>(cfg, nullptr, &*abs_tr,
-                                                      m_widening_delay,
-                                                      m_descending_iters,
-                                                      m_jump_set_size,
-						      get_live(cfg));
-						      
-            a->Run();
-            m_inv_map.insert(std::make_pair(crab::cfg::cfg_hasher<cfg_t>::hash(*fdecl), a));
+            analyze_td(cfg, *fdecl, init);
           }
           return;
         }
@@ -152,101 +467,43 @@ namespace crab {
 	graph_algo::scc_graph<CG> Scc_g(m_cg);
         graph_algo::rev_topo_sort<graph_algo::scc_graph<CG>>(Scc_g, rev_order);
 
+        if (m_summ_cache) {
+          compute_summary_keys(Scc_g, rev_order);
+        }
+        
         CRAB_VERBOSE_IF(1,crab::outs() << "== Bottom-up phase ...\n";);	
-        for (auto n: rev_order) {
-          crab::ScopedCrabStats __st__("Inter.BottomUp");
-          std::vector<cg_node_t> &scc_mems = Scc_g.get_component_members(n);
-          for (auto m: scc_mems) {
-
-            auto cfg = m.get_cfg();
-            auto fdecl = cfg.get_func_decl();            
-            assert(fdecl);
-
-            std::string fun_name = (*fdecl).get_func_name();
-            if (fun_name != "main" && cfg.has_exit()) {
-	      CRAB_VERBOSE_IF(1, crab::outs() << "++ Analyzing function "
-			                      << (*fdecl).get_func_name() << "\n";);
-              // --- run the analysis
-	      auto init_inv = BU_Dom::top();
-	      bu_abs_tr abs_tr(&init_inv, &m_summ_tbl);
-              bu_analyzer a(cfg, nullptr, &abs_tr, 
-                             m_widening_delay, m_descending_iters, m_jump_set_size,
-			     get_live(cfg)) ; 
-              a.Run();
-	      
-              // --- build the summary
-              std::vector<variable_t> formals, inputs, outputs;
-              formals.reserve((*fdecl).get_num_inputs() +(*fdecl).get_num_outputs());
-              inputs.reserve((*fdecl).get_num_inputs());
-              outputs.reserve((*fdecl).get_num_outputs());
-
-              for (unsigned i=0; i < (*fdecl).get_num_inputs();i++) {
-                inputs.push_back((*fdecl).get_input_name(i));
-                formals.push_back((*fdecl).get_input_name(i));
-              }
-              for (unsigned i=0; i < (*fdecl).get_num_outputs();i++) {
-                outputs.push_back((*fdecl).get_output_name(i));
-                formals.push_back((*fdecl).get_output_name(i));
-              }
-	      
-              // --- project onto formal parameters and return values
-              auto inv = a.get_post(cfg.exit());
-              //crab::CrabStats::count(BU_Dom::getDomainName() + ".count.project");
-	      inv.project(formals);
-              m_summ_tbl.insert(*fdecl, inv, inputs, outputs);
-            }
+        if (m_num_threads > 1) {
+          run_parallel(Scc_g, rev_order, true /*bottom-up*/,
+                       [this](cg_node_t n, const std::vector<cg_node_t> &scc_mems) {
+                         run_bottom_up(scc_mems);
+                       });
+        } else {
+          for (auto n: rev_order) {
+            run_bottom_up(Scc_g.get_component_members(n));
           }
-        } 
+        }
+        if (m_summ_cache) {
+          m_summ_cache->save();
+        }
 
         CRAB_VERBOSE_IF(1, crab::outs() << "== Top-down phase ...\n";);
-        bool is_root = true;
-        for (auto n: boost::make_iterator_range(rev_order.rbegin(),
-                                                 rev_order.rend())) {
-          crab::ScopedCrabStats __st__("Inter.TopDown");
-          std::vector<cg_node_t> &scc_mems = Scc_g.get_component_members(n);
-	  
-	  // The SCC is recursive if it has more than one element or
-	  // there is only one that calls directly to itself.
-	  bool is_recursive = (scc_mems.size() > 1) ||
-	    std::any_of(m_cg.succs(n).first, m_cg.succs(n).second,
-	  		[n](const cg_edge_t& e) {
-	  		  return (n == e.dest());
-	  		});
-
-          for (auto m: scc_mems) {
-            auto cfg = m.get_cfg();
-            auto fdecl = cfg.get_func_decl();
-            assert(fdecl);
-	    CRAB_VERBOSE_IF(1, crab::outs() << "++ Analyzing function " 
-			                    << (*fdecl).get_func_name() << "\n";);
-            if (is_recursive) {
-              // If the SCC is recursive then what we have in
-              // m_call_tbl is incomplete and therefore it is unsound
-              // to use it. To remedy it, we insert another calling
-              // context with top value that approximates all the
-              // possible calling contexts during the recursive calls.
-              m_call_tbl.insert(*fdecl, TD_Dom::top());
-            }
-	   
-	    auto init_inv = init;	    
-            if (is_root) {
-              is_root = false;
-	    } else {
-	      init_inv = m_call_tbl.get_call_ctx(*fdecl);
-            }
-	    
-	    CRAB_LOG("inter",
-		     crab::outs() << "    Starting analysis of "
-  		                  << *fdecl <<  " with " << init_inv << "\n");
-
-	    auto abs_tr = boost::make_shared<td_abs_tr>(&init_inv, &m_summ_tbl, &m_call_tbl);
-            auto a = boost::make_shared<td_analyzer>(cfg, nullptr, &*abs_tr, 
-                                                      m_widening_delay,
-						      m_descending_iters,
-						      m_jump_set_size,
-						      get_live(cfg));
-	    a->Run();
-            m_inv_map.insert(std::make_pair(crab::cfg::cfg_hasher<cfg_t>::hash(*fdecl), a));
+        // Create the entries of all functions so that m_inv_map is
+        // not restructured while functions are analyzed in parallel.
+        for (auto &v: boost::make_iterator_range(vertices(m_cg))) {
+          auto fdecl = v.get_cfg().get_func_decl();
+          assert(fdecl);
+          m_inv_map[crab::cfg::cfg_hasher<cfg_t>::hash(*fdecl)];
+        }
+        cg_node_t root = rev_order.back();
+        if (m_num_threads > 1) {
+          run_parallel(Scc_g, rev_order, false /*top-down*/,
+                       [this, &init, &root](cg_node_t n, const std::vector<cg_node_t> &scc_mems) {
+                         run_top_down(n, scc_mems, n == root, init);
+                       });
+        } else {
+          for (auto n: boost::make_iterator_range(rev_order.rbegin(),
+                                                   rev_order.rend())) {
+            run_top_down(n, Scc_g.get_component_members(n), n == root, init);
           }
         }
 	CRAB_VERBOSE_IF(1,crab::outs() << "Finished inter-procedural analysis\n";);	
@@ -258,23 +515,30 @@ namespace crab {
       }
 
       //! Return the invariants that hold at the entry of b in cfg
+      //! If cfg was analyzed under several calling contexts then
+      //! return the join of the invariants for each context.
       TD_Dom get_pre(const cfg_t &cfg, typename cfg_t::basic_block_label_t b) const { 
-        if (auto fdecl = cfg.get_func_decl()) {
-          auto const it = m_inv_map.find(crab::cfg::cfg_hasher<cfg_t>::hash(*fdecl));
-          if (it != m_inv_map.end())
-            return it->second->get_pre(b);
-        }
-        return TD_Dom::top();
+        return join_results(cfg, [b](const td_analyzer &a) { return a.get_pre(b); });
       }
       
       //! Return the invariants that hold at the exit of b in cfg
       TD_Dom get_post(const cfg_t &cfg, typename cfg_t::basic_block_label_t b) const { 
+        return join_results(cfg, [b](const td_analyzer &a) { return a.get_post(b); });
+      }
+
+      //! Return the number of calling contexts under which cfg was
+      //! analyzed by the last run.
+      std::size_t get_num_call_ctxs(const cfg_t &cfg) const {
+        std::size_t res = 0;
         if (auto fdecl = cfg.get_func_decl()) {
           auto const it = m_inv_map.find(crab::cfg::cfg_hasher<cfg_t>::hash(*fdecl));
-          if (it != m_inv_map.end())
-            return it->second->get_post(b);
+          if (it != m_inv_map.end()) {
+            for (auto const &r: it->second) {
+              if (r.m_last_run == m_run) ++res;
+            }
+          }
         }
-        return TD_Dom::top();
+        return res;
       }
 
       // clear all invariants
@@ -5,8 +5,19 @@
 #include <boost/range/iterator_range.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include <crab/common/types.hpp>
+#include <crab/common/stats.hpp>
+#include <crab/common/binary_io.hpp>
 #include <crab/cfg/cfg.hpp>
 
 /* 
@@ -17,10 +28,9 @@ namespace crab {
 
   namespace analyzer {
 
-    // XXX: Currently we assume a _contex-insensitive_ approach so we
-    // store a single summary per function. For implementing a
-    // context-sensitive approach we would need to allow multiple
-    // summaries per function.
+    // XXX: We store a single summary per function. The calling
+    // contexts are merged into one per function unless the table is
+    // built with a bound on the number of contexts.
 
     /* Store the calling contexts of each function */  
     template <typename CFG, typename AbsDomain>
@@ -33,26 +43,56 @@ namespace crab {
       typedef typename CFG::variable_t variable_t;      
       typedef AbsDomain abs_domain_t;
 
+      typedef std::vector<abs_domain_t> call_ctx_vector_t;
+
      private:
-      typedef boost::unordered_map <std::size_t, abs_domain_t> call_table_t;
+      typedef boost::unordered_map <std::size_t, call_ctx_vector_t> call_table_t;
       
       call_table_t m_call_table;
+      // max number of calling contexts kept per function. If it is 0
+      // or 1 the table is context-insensitive.
+      unsigned m_max_ctxs;
+      // the table can be updated by several functions analyzed in parallel
+      mutable std::mutex m_mutex;
 
-      // XXX: assume context-insensitive analysis so it will merge all
-      // calling contexts using abstract domain's join keeping a
-      // single calling context per function.
       void insert_helper (std::size_t func_key, AbsDomain inv) {
-        auto it = m_call_table.find (func_key);
-        if (it != m_call_table.end ()) {
-          it->second = it->second | inv;
+        std::lock_guard<std::mutex> lock (m_mutex);
+        call_ctx_vector_t &ctxs = m_call_table [func_key];
+        if (m_max_ctxs <= 1) {
+          // merge all calling contexts using abstract domain's join
+          // keeping a single calling context per function.
+          if (ctxs.empty ()) {
+            ctxs.push_back (inv);
+          } else {
+            ctxs [0] = ctxs [0] | inv;
+          }
+          return;
+        }
+
+        // keep only the maximal calling contexts
+        for (auto &ctx: ctxs) {
+          if (inv <= ctx) {
+            crab::CrabStats::count ("CallCtx.subsumed");
+            return;
+          }
+        }
+        ctxs.erase (std::remove_if (ctxs.begin (), ctxs.end (),
+                                    [&inv](abs_domain_t &ctx) { return ctx <= inv; }),
+                    ctxs.end ());
+        if (ctxs.size () < m_max_ctxs) {
+          ctxs.push_back (inv);
         } else {
-          m_call_table.insert (std::make_pair (func_key, inv));
-	}
+          // the table is full: merge the new context with the oldest
+          // one which then becomes the newest.
+          crab::CrabStats::count ("CallCtx.merged");
+          ctxs.front () = ctxs.front () | inv;
+          std::rotate (ctxs.begin (), ctxs.begin () + 1, ctxs.end ());
+        }
       }
 
      public:
       
-      call_ctx_table() { }
+      call_ctx_table (unsigned max_ctxs = 0): m_max_ctxs (max_ctxs) { }
 
       
       void insert (callsite_t cs, AbsDomain inv) {
@@ -63,12 +103,28 @@ namespace crab {
         insert_helper (crab::cfg::cfg_hasher<CFG>::hash (d), inv);
       }
 
+      //! Return the join of all calling contexts of d
       AbsDomain get_call_ctx (fdecl_t d) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        auto it = m_call_table.find (crab::cfg::cfg_hasher<CFG>::hash (d));
+        if (it != m_call_table.end () && !it->second.empty ()) {
+          AbsDomain res (it->second [0]);
+          for (unsigned i = 1; i < it->second.size (); ++i) {
+            res = res | it->second [i];
+          }
+          return res;
+        } else 
+          return AbsDomain::top ();
+      }
+
+      //! Return all the calling contexts of d
+      call_ctx_vector_t get_call_ctxs (fdecl_t d) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_call_table.find (crab::cfg::cfg_hasher<CFG>::hash (d));
-        if (it != m_call_table.end ())
+        if (it != m_call_table.end () && !it->second.empty ())
           return it->second;
         else 
-          return AbsDomain::top ();
+          return call_ctx_vector_t { AbsDomain::top () };
       }
 
     };
@@ -231,6 +287,10 @@ namespace crab {
       typedef boost::unordered_map <std::size_t, summary_ptr> summary_table_t;
       
       summary_table_t m_sum_table;
+      // Summaries can be inserted and looked up by several functions
+      // analyzed in parallel. Summaries are never removed so the
+      // references returned by get remain valid.
+      mutable std::mutex m_mutex;
       
      public:
 
@@ -244,23 +304,28 @@ namespace crab {
 
         std::vector<variable_t> ins(inputs.begin(), inputs.end ());
         std::vector<variable_t> outs(outputs.begin(), outputs.end ());
+        // the summary creates fresh variables
+        std::lock_guard<std::mutex> lock (m_mutex);
         summary_ptr sum_tuple (new Summary (d, sum, ins, outs));
         m_sum_table.insert (std::make_pair (crab::cfg::cfg_hasher<CFG>::hash (d), sum_tuple));
       }
 
       // return true if there is a summary
       bool hasSummary (callsite_t cs) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_sum_table.find (crab::cfg::cfg_hasher<CFG>::hash (cs));
         return (it != m_sum_table.end ());
       }
 
       bool hasSummary (fdecl_t d) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_sum_table.find (crab::cfg::cfg_hasher<CFG>::hash (d));
         return (it != m_sum_table.end ());
       }
 
       // get the summary
       Summary& get (callsite_t cs) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_sum_table.find (crab::cfg::cfg_hasher<CFG>::hash (cs));
         assert (it != m_sum_table.end ());
         
@@ -268,6 +333,7 @@ namespace crab {
       }
 
       Summary& get (fdecl_t d) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         auto it = m_sum_table.find (crab::cfg::cfg_hasher<CFG>::hash (d));
         assert (it != m_sum_table.end ());
         
@@ -275,6 +341,7 @@ namespace crab {
       }
       
       void write (crab_os &o) const {
+        std::lock_guard<std::mutex> lock (m_mutex);
         o << "--- Begin summary table: \n";
         for (auto const &p: m_sum_table) {
           p.second->write (o);
@@ -297,6 +364,284 @@ namespace crab {
       
     };
 
+    /* 
+       Persistent cache of summaries stored in a binary file.
+
+       A summary is stored as a linear constraint system whose
+       variables are indexes into the inputs followed by the outputs
+       of the function. The key of a summary is a stable hash that
+       must change whenever the function or any function it calls
+       changes (see inter_fwd_analyzer).
+
+       File format (integers are LEB128 varints, numbers and strings
+       are length-prefixed):
+         magic "CRABSUMM", version, number of summaries
+         for each summary:
+           key, num_inputs, num_outputs, number of constraints
+           for each constraint:
+             kind, signedness, constant, number of terms
+             for each term: coefficient, variable index
+    */
+    template<typename CFG, typename AbsDomain>
+    class summary_cache: boost::noncopyable {
+
+     public:
+
+      typedef typename CFG::number_t number_t;
+      typedef typename CFG::varname_t varname_t;
+      typedef typename CFG::variable_t variable_t;
+      typedef AbsDomain abs_domain_t;
+      typedef ikos::linear_expression<number_t, varname_t> linear_expression_t;
+      typedef ikos::linear_constraint<number_t, varname_t> linear_constraint_t;
+      typedef uint64_t key_t;
+
+     private:
+
+      struct term_entry {
+        std::string m_coef;
+        uint64_t m_var;
+      };
+      
+      struct cst_entry {
+        uint64_t m_kind;
+        bool m_signed;
+        std::string m_cst;
+        std::vector<term_entry> m_terms;
+      };
+      
+      struct summary_entry {
+        uint64_t m_num_inputs;
+        uint64_t m_num_outputs;
+        std::vector<cst_entry> m_csts;
+      };
+
+      typedef boost::unordered_map<key_t, summary_entry> cache_table_t;
+      
+      std::string m_filename;
+      cache_table_t m_table;
+      bool m_modified;
+      mutable std::atomic<unsigned> m_hits;
+      mutable std::atomic<unsigned> m_misses;
+      // summaries can be looked up and inserted by several functions
+      // analyzed in parallel
+      mutable std::mutex m_mutex;
+
+      static const char* magic() { return "CRABSUMM"; }
+      static const uint64_t version = 1;
+      
+      // Read one summary and check that it can be decoded: the kind
+      // of each constraint is valid, numbers are well formed, and
+      // variables are indexes into the inputs and outputs.
+      static bool read_entry(const char *&p, const char *end,
+                             key_t &key, summary_entry &e) {
+        using namespace binary_io;
+        uint64_t num_csts;
+        if (!get_varint(p, end, key) ||
+            !get_varint(p, end, e.m_num_inputs) ||
+            !get_varint(p, end, e.m_num_outputs) ||
+            !get_varint(p, end, num_csts)) {
+          return false;
+        }
+        for (uint64_t i = 0; i < num_csts; ++i) {
+          cst_entry c;
+          uint64_t is_signed, num_terms;
+          if (!get_varint(p, end, c.m_kind) ||
+              c.m_kind > linear_constraint_t::STRICT_INEQUALITY ||
+              !get_varint(p, end, is_signed) || is_signed > 1 ||
+              !get_string(p, end, c.m_cst) ||
+              !is_number<number_t>(c.m_cst) ||
+              !get_varint(p, end, num_terms)) {
+            return false;
+          }
+          c.m_signed = is_signed;
+          for (uint64_t j = 0; j < num_terms; ++j) {
+            term_entry t;
+            if (!get_string(p, end, t.m_coef) ||
+                !is_number<number_t>(t.m_coef) ||
+                !get_varint(p, end, t.m_var) ||
+                (t.m_var >= e.m_num_inputs &&
+                 t.m_var - e.m_num_inputs >= e.m_num_outputs))
+              return false;
+            c.m_terms.push_back(t);
+          }
+          e.m_csts.push_back(c);
+        }
+        return true;
+      }
+
+      void load() {
+        std::ifstream in(m_filename.c_str(), std::ios::binary);
+        if (!in) {
+          // the cache does not exist yet
+          return;
+        }
+        std::string buf((std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>());
+        const char *p = buf.data();
+        const char *end = p + buf.size();
+        std::string m(magic());
+        uint64_t v, num_entries;
+        if (buf.compare(0, m.size(), m) != 0 ||
+            !(p += m.size(), binary_io::get_varint(p, end, v)) || v != version ||
+            !binary_io::get_varint(p, end, num_entries)) {
+          CRAB_WARN("ignoring invalid summary cache ", m_filename);
+          return;
+        }
+        for (uint64_t i = 0; i < num_entries; ++i) {
+          key_t key;
+          summary_entry e;
+          if (!read_entry(p, end, key, e)) {
+            CRAB_WARN("ignoring corrupted summary cache ", m_filename);
+            m_table.clear();
+            return;
+          }
+          m_table[key] = e;
+        }
+      }
+
+     public:
+
+      // Read the summaries from filename if it exists
+      summary_cache(std::string filename)
+        : m_filename(filename), m_modified(false), m_hits(0), m_misses(0) {
+        load();
+      }
+
+      // Combine v into the stable hash h (64-bit FNV-1a)
+      static key_t hash(const std::string &v, key_t h = 14695981039346656037ULL) {
+        for (unsigned char c: v) {
+          h ^= c;
+          h *= 1099511628211ULL;
+        }
+        return h;
+      }
+
+      static key_t hash(key_t v, key_t h) {
+        return hash(std::to_string(v), h);
+      }
+      
+      // Return true and set sum if there is a summary for key.
+      bool get(key_t key,
+               const std::vector<variable_t> &inputs,
+               const std::vector<variable_t> &outputs,
+               abs_domain_t &sum) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_table.find(key);
+        if (it == m_table.end() ||
+            it->second.m_num_inputs != inputs.size() ||
+            it->second.m_num_outputs != outputs.size()) {
+          ++m_misses;
+          return false;
+        }
+        std::vector<variable_t> formals(inputs);
+        formals.insert(formals.end(), outputs.begin(), outputs.end());
+        
+        sum = abs_domain_t::top();
+        for (auto const &c: it->second.m_csts) {
+          linear_expression_t e(number_t(c.m_cst));
+          // read_entry checked that m_var < formals.size()
+          for (auto const &t: c.m_terms) {
+            e = e + number_t(t.m_coef) * formals[t.m_var];
+          }
+          auto kind = static_cast<typename linear_constraint_t::kind_t>(c.m_kind);
+          if (kind == linear_constraint_t::INEQUALITY ||
+              kind == linear_constraint_t::STRICT_INEQUALITY) {
+            sum += linear_constraint_t(e, kind, c.m_signed);
+          } else {
+            sum += linear_constraint_t(e, kind);
+          }
+        }
+        ++m_hits;
+        return true;
+      }
+      
+      // Store the summary sum for key. Constraints involving other
+      // variables than inputs and outputs are not stored.
+      void insert(key_t key, abs_domain_t sum,
+                  const std::vector<variable_t> &inputs,
+                  const std::vector<variable_t> &outputs) {
+        std::vector<variable_t> formals(inputs);
+        formals.insert(formals.end(), outputs.begin(), outputs.end());
+        
+        summary_entry e;
+        e.m_num_inputs = inputs.size();
+        e.m_num_outputs = outputs.size();
+        for (auto const &c: sum.to_linear_constraint_system()) {
+          cst_entry ce;
+          ce.m_kind = c.kind();
+          ce.m_signed = (c.is_inequality() || c.is_strict_inequality()) ?
+                        c.is_signed() : true;
+          ce.m_cst = c.expression().constant().get_str();
+          bool ok = true;
+          for (auto t: c) {
+            auto it = std::find(formals.begin(), formals.end(), t.second);
+            if (it == formals.end()) {
+              ok = false;
+              break;
+            }
+            ce.m_terms.push_back({t.first.get_str(),
+                  static_cast<uint64_t>(it - formals.begin())});
+          }
+          if (ok) {
+            e.m_csts.push_back(ce);
+          }
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_table[key] = e;
+        m_modified = true;
+      }
+
+      // Write the summaries to the file if there are new ones. The
+      // file is replaced atomically.
+      bool save() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_modified) return true;
+        std::string buf(magic());
+        binary_io::put_varint(buf, version);
+        binary_io::put_varint(buf, m_table.size());
+        for (auto const &kv: m_table) {
+          const summary_entry &e = kv.second;
+          binary_io::put_varint(buf, kv.first);
+          binary_io::put_varint(buf, e.m_num_inputs);
+          binary_io::put_varint(buf, e.m_num_outputs);
+          binary_io::put_varint(buf, e.m_csts.size());
+          for (auto const &c: e.m_csts) {
+            binary_io::put_varint(buf, c.m_kind);
+            binary_io::put_varint(buf, c.m_signed);
+            binary_io::put_string(buf, c.m_cst);
+            binary_io::put_varint(buf, c.m_terms.size());
+            for (auto const &t: c.m_terms) {
+              binary_io::put_string(buf, t.m_coef);
+              binary_io::put_varint(buf, t.m_var);
+            }
+          }
+        }
+        std::string tmp = m_filename + ".tmp";
+        {
+          std::ofstream out(tmp.c_str(), std::ios::binary | std::ios::trunc);
+          if (!out.write(buf.data(), buf.size())) {
+            CRAB_WARN("cannot write summary cache ", tmp);
+            return false;
+          }
+        }
+        if (std::rename(tmp.c_str(), m_filename.c_str()) != 0) {
+          CRAB_WARN("cannot write summary cache ", m_filename);
+          return false;
+        }
+        m_modified = false;
+        return true;
+      }
+
+      std::size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_table.size();
+      }
+
+      // number of lookups that found (resp. did not find) a summary
+      unsigned get_num_hits() const { return m_hits; }
+      unsigned get_num_misses() const { return m_misses; }
+      
+    };
+
   } // end namespace
 } // end namespace
-
@@ -0,0 +1,632 @@
+#pragma once
+
+/*
+   Compact binary serialization of the invariants computed by a
+   forward analysis.
+
+   Each invariant is stored as the set of constraints returned by
+   to_linear_constraint_system(). Variable names, constants and
+   constraints are stored only once in dictionaries so an invariant is
+   just a sorted list of constraint ids. The invariant at the entry of
+   a block is delta-encoded against the one at the entry of its
+   immediate dominator, and the invariant at the exit against the one
+   at the entry, when that is smaller.
+
+   The file ends with a fixed-size footer that points to tables of
+   fixed-size offsets so the reader can memory-map the file and decode
+   the invariants of one block without reading the rest.
+
+   File layout:
+
+     magic version
+     variables    (name, type, bitwidth)*                             table
+     constants    (decimal string)*                                   table
+     constraints  (kind, signedness, constant id,
+                   [coefficient id, variable id]*)*                   table
+     records      (bottom | full list of ids |
+                   base record + removed ids + added ids)*            table
+     block index  number of blocks (label, pre record, post record)*
+     footer       offsets of the four tables and of the block index
+
+   where each table is the number of entries followed by the offset
+   of each entry.
+ */
+
+#include <crab/common/types.hpp>
+#include <crab/common/debug.hpp>
+#include <crab/common/stats.hpp>
+#include <crab/common/binary_io.hpp>
+#include <crab/cfg/cfg_bgl.hpp>
+#include <crab/analysis/graphs/dominance.hpp>
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crab {
+
+  namespace analyzer {
+
+    namespace inv_table_impl {
+
+      using binary_io::put_varint;
+      using binary_io::put_string;
+      using binary_io::get_varint;
+      using binary_io::get_string;
+
+      inline const char* magic() { return "CRABINVT"; }
+      inline uint64_t version() { return 1; }
+      // size of the footer: five 64-bit offsets
+      inline std::size_t footer_size() { return 5 * 8; }
+
+      typedef enum { _BOTTOM = 0, _FULL = 1, _DELTA = 2 } record_kind_t;
+
+      // fixed-size little-endian integer
+      inline void put_u64(std::string &buf, uint64_t v) {
+        for (unsigned i = 0; i < 8; ++i) {
+          buf.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+        }
+      }
+
+      // a sorted list of ids is stored as the differences between
+      // consecutive ids
+      inline void put_ids(std::string &buf, const std::vector<uint64_t> &ids) {
+        put_varint(buf, ids.size());
+        uint64_t prev = 0;
+        for (uint64_t id : ids) {
+          put_varint(buf, id - prev);
+          prev = id;
+        }
+      }
+
+      inline uint64_t get_u64(const char *p) {
+        uint64_t v = 0;
+        for (unsigned i = 0; i < 8; ++i) {
+          v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        return v;
+      }
+
+      inline bool get_ids(const char *&p, const char *end, std::vector<uint64_t> &ids) {
+        uint64_t n, prev = 0;
+        // each id takes at least one byte
+        if (!get_varint(p, end, n) || n > static_cast<uint64_t>(end - p)) return false;
+        ids.reserve(ids.size() + n);
+        for (uint64_t i = 0; i < n; ++i) {
+          uint64_t d;
+          if (!get_varint(p, end, d)) return false;
+          prev += d;
+          ids.push_back(prev);
+        }
+        return true;
+      }
+
+    } // end namespace inv_table_impl
+
+    /**
+     * Write the invariants at the entry and exit of each block
+     * computed by a forward analyzer (e.g., intra_fwd_analyzer).
+     **/
+    template<typename Analyzer>
+    class inv_table_writer: boost::noncopyable {
+
+      typedef typename Analyzer::cfg_t cfg_t;
+      typedef typename Analyzer::abs_dom_t abs_dom_t;
+      typedef typename cfg_t::basic_block_label_t basic_block_label_t;
+      typedef std::vector<uint64_t> id_vector_t;
+
+      // a dictionary of encoded entries
+      struct dictionary {
+        boost::unordered_map<std::string, uint64_t> m_ids;
+        std::vector<std::string> m_entries;
+
+        uint64_t insert(const std::string &e) {
+          auto it = m_ids.find(e);
+          if (it != m_ids.end()) return it->second;
+          uint64_t id = m_entries.size();
+          m_ids.insert(std::make_pair(e, id));
+          m_entries.push_back(e);
+          return id;
+        }
+      };
+
+      struct record {
+        bool m_is_bottom;
+        id_vector_t m_ids;  // sorted constraint ids
+        // delta encoding
+        bool m_is_delta;
+        uint64_t m_base;
+        id_vector_t m_removed, m_added;
+        unsigned m_depth;   // length of the chain of bases
+
+        record(): m_is_bottom(false), m_is_delta(false), m_base(0), m_depth(0) { }
+      };
+
+      Analyzer &m_analyzer;
+      // maximum length of a chain of deltas so that decoding a block
+      // does not need to decode too many other records
+      unsigned m_max_delta_depth;
+      dictionary m_vars, m_consts, m_csts;
+      std::vector<record> m_records;
+
+      uint64_t encode_const(const typename abs_dom_t::number_t &n) {
+        std::string e;
+        inv_table_impl::put_string(e, n.get_str());
+        return m_consts.insert(e);
+      }
+
+      template<typename Variable>
+      uint64_t encode_var(const Variable &v) {
+        std::string e;
+        inv_table_impl::put_string(e, v.name().str());
+        inv_table_impl::put_varint(e, v.get_type());
+        inv_table_impl::put_varint(e, v.get_bitwidth());
+        return m_vars.insert(e);
+      }
+
+      template<typename Constraint>
+      uint64_t encode_cst(const Constraint &c) {
+        std::string e;
+        inv_table_impl::put_varint(e, c.kind());
+        inv_table_impl::put_varint(e, (c.is_inequality() || c.is_strict_inequality()) ?
+                                   c.is_signed() : true);
+        inv_table_impl::put_varint(e, encode_const(c.expression().constant()));
+        std::vector<std::pair<uint64_t, uint64_t>> terms;
+        for (auto t: c) {
+          terms.push_back(std::make_pair(encode_const(t.first), encode_var(t.second)));
+        }
+        inv_table_impl::put_varint(e, terms.size());
+        for (auto &t: terms) {
+          inv_table_impl::put_varint(e, t.first);
+          inv_table_impl::put_varint(e, t.second);
+        }
+        return m_csts.insert(e);
+      }
+
+      uint64_t add_record(abs_dom_t inv) {
+        record r;
+        if (inv.is_bottom()) {
+          r.m_is_bottom = true;
+        } else {
+          for (auto const &c: inv.to_linear_constraint_system()) {
+            r.m_ids.push_back(encode_cst(c));
+          }
+          std::sort(r.m_ids.begin(), r.m_ids.end());
+          r.m_ids.erase(std::unique(r.m_ids.begin(), r.m_ids.end()), r.m_ids.end());
+        }
+        m_records.push_back(r);
+        return m_records.size() - 1;
+      }
+
+      // Encode record i as a delta against base if that is smaller
+      void try_delta(uint64_t i, uint64_t base) {
+        record &r = m_records[i];
+        const record &b = m_records[base];
+        if (r.m_is_bottom || b.m_is_bottom || b.m_depth >= m_max_delta_depth) {
+          return;
+        }
+        id_vector_t removed, added;
+        std::set_difference(b.m_ids.begin(), b.m_ids.end(),
+                            r.m_ids.begin(), r.m_ids.end(),
+                            std::back_inserter(removed));
+        std::set_difference(r.m_ids.begin(), r.m_ids.end(),
+                            b.m_ids.begin(), b.m_ids.end(),
+                            std::back_inserter(added));
+        if (removed.size() + added.size() < r.m_ids.size()) {
+          r.m_is_delta = true;
+          r.m_base = base;
+          r.m_removed = std::move(removed);
+          r.m_added = std::move(added);
+          r.m_depth = b.m_depth + 1;
+          crab::CrabStats::count("InvTable.delta_records");
+        }
+      }
+
+      static void write_table(std::string &buf, std::vector<uint64_t> &table_offsets,
+                              const std::vector<std::string> &entries) {
+        std::vector<uint64_t> offsets;
+        for (auto const &e: entries) {
+          offsets.push_back(buf.size());
+          buf.append(e);
+        }
+        table_offsets.push_back(buf.size());
+        inv_table_impl::put_u64(buf, offsets.size());
+        for (uint64_t o : offsets) {
+          inv_table_impl::put_u64(buf, o);
+        }
+      }
+
+     public:
+
+      inv_table_writer(Analyzer &analyzer, unsigned max_delta_depth = 8)
+        : m_analyzer(analyzer), m_max_delta_depth(max_delta_depth) { }
+
+      // Write the invariants to filename. Return false if the file
+      // cannot be written.
+      bool write(const std::string &filename) {
+        crab::ScopedCrabStats __st__("InvTable.write");
+        cfg_t cfg = m_analyzer.get_cfg();
+
+        // -- collect the invariants of all blocks
+        boost::unordered_map<basic_block_label_t, basic_block_label_t> idom;
+        graph_algo::dominator_tree(cfg, cfg.entry(), idom);
+        std::vector<basic_block_label_t> blocks;
+        for (auto &bb: cfg) {
+          blocks.push_back(bb.label());
+        }
+        boost::unordered_map<basic_block_label_t, uint64_t> pre_record;
+        std::vector<std::pair<uint64_t, uint64_t>> block_records;
+        for (auto const &b: blocks) {
+          uint64_t pre = add_record(m_analyzer.get_pre(b));
+          uint64_t post = add_record(m_analyzer.get_post(b));
+          pre_record[b] = pre;
+          block_records.push_back(std::make_pair(pre, post));
+        }
+        // visit the dominator tree top-down so that the base of a
+        // delta is always encoded before
+        std::vector<basic_block_label_t> worklist;
+        boost::unordered_map<basic_block_label_t, std::vector<basic_block_label_t>> children;
+        for (auto const &b: blocks) {
+          auto it = idom.find(b);
+          if (it != idom.end() && pre_record.count(it->second)) {
+            children[it->second].push_back(b);
+          } else {
+            worklist.push_back(b);
+          }
+        }
+        boost::unordered_map<basic_block_label_t, uint64_t> block_pos;
+        for (uint64_t i = 0; i < blocks.size(); ++i) {
+          block_pos[blocks[i]] = i;
+        }
+        while (!worklist.empty()) {
+          basic_block_label_t b = worklist.back();
+          worklist.pop_back();
+          auto const &recs = block_records[block_pos[b]];
+          auto it = idom.find(b);
+          if (it != idom.end() && pre_record.count(it->second)) {
+            try_delta(recs.first, pre_record[it->second]);
+          }
+          try_delta(recs.second, recs.first);
+          auto cit = children.find(b);
+          if (cit != children.end()) {
+            worklist.insert(worklist.end(), cit->second.begin(), cit->second.end());
+          }
+        }
+
+        // -- serialize
+        std::string buf(inv_table_impl::magic());
+        inv_table_impl::put_varint(buf, inv_table_impl::version());
+        std::vector<std::string> records;
+        for (auto const &r: m_records) {
+          std::string e;
+          if (r.m_is_bottom) {
+            inv_table_impl::put_varint(e, inv_table_impl::_BOTTOM);
+          } else if (r.m_is_delta) {
+            inv_table_impl::put_varint(e, inv_table_impl::_DELTA);
+            inv_table_impl::put_varint(e, r.m_base);
+            inv_table_impl::put_ids(e, r.m_removed);
+            inv_table_impl::put_ids(e, r.m_added);
+          } else {
+            inv_table_impl::put_varint(e, inv_table_impl::_FULL);
+            inv_table_impl::put_ids(e, r.m_ids);
+          }
+          records.push_back(e);
+        }
+        std::vector<uint64_t> table_offsets;
+        write_table(buf, table_offsets, m_vars.m_entries);
+        write_table(buf, table_offsets, m_consts.m_entries);
+        write_table(buf, table_offsets, m_csts.m_entries);
+        write_table(buf, table_offsets, records);
+        uint64_t index_offset = buf.size();
+        inv_table_impl::put_varint(buf, blocks.size());
+        for (uint64_t i = 0; i < blocks.size(); ++i) {
+          inv_table_impl::put_string(buf, crab::cfg_impl::get_label_str(blocks[i]));
+          inv_table_impl::put_varint(buf, block_records[i].first);
+          inv_table_impl::put_varint(buf, block_records[i].second);
+        }
+        for (uint64_t o : table_offsets) {
+          inv_table_impl::put_u64(buf, o);
+        }
+        inv_table_impl::put_u64(buf, index_offset);
+
+        crab::CrabStats::uset("InvTable.bytes", buf.size());
+        std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out.write(buf.data(), buf.size())) {
+          CRAB_WARN("cannot write invariants to ", filename);
+          return false;
+        }
+        return true;
+      }
+    };
+
+    /**
+     * Read the invariants written by inv_table_writer. The file is
+     * memory-mapped and only the block index is decoded when it is
+     * opened. The invariants of a block are decoded on demand.
+     *
+     * VariableFactory is used to get the variable names from strings.
+     **/
+    template<typename AbsDomain, typename VariableFactory>
+    class inv_table_reader: boost::noncopyable {
+
+     public:
+
+      typedef AbsDomain abs_dom_t;
+      typedef typename abs_dom_t::number_t number_t;
+      typedef typename abs_dom_t::variable_t variable_t;
+      typedef typename abs_dom_t::linear_expression_t linear_expression_t;
+      typedef typename abs_dom_t::linear_constraint_t linear_constraint_t;
+
+     private:
+
+      typedef std::vector<uint64_t> id_vector_t;
+
+      VariableFactory &m_vfac;
+      std::string m_filename;
+      const char *m_data;
+      std::size_t m_size;
+      // offsets of the tables of variables, constants, constraints and
+      // records
+      uint64_t m_tables[4];
+      boost::unordered_map<std::string, std::pair<uint64_t, uint64_t>> m_index;
+
+      enum { _VARS = 0, _CONSTS = 1, _CSTS = 2, _RECORDS = 3 };
+
+      void close() {
+        if (m_data) {
+          munmap(const_cast<char*>(m_data), m_size);
+          m_data = nullptr;
+        }
+        m_index.clear();
+      }
+
+      bool open(const std::string &filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+          ::close(fd);
+          return false;
+        }
+        m_size = st.st_size;
+        if (m_size < std::string(inv_table_impl::magic()).size() +
+                     inv_table_impl::footer_size()) {
+          ::close(fd);
+          return false;
+        }
+        void *p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        m_data = static_cast<const char*>(p);
+
+        std::string m(inv_table_impl::magic());
+        const char *it = m_data + m.size();
+        const char *end = m_data + m_size;
+        uint64_t v;
+        if (std::string(m_data, m.size()) != m ||
+            !inv_table_impl::get_varint(it, end, v) || v != inv_table_impl::version()) {
+          return false;
+        }
+        const char *footer = end - inv_table_impl::footer_size();
+        for (unsigned i = 0; i < 4; ++i) {
+          m_tables[i] = inv_table_impl::get_u64(footer + 8 * i);
+          if (m_tables[i] + 8 > m_size) return false;
+        }
+        uint64_t index_offset = inv_table_impl::get_u64(footer + 32);
+        if (index_offset > m_size) return false;
+        it = m_data + index_offset;
+        uint64_t num_blocks;
+        if (!inv_table_impl::get_varint(it, footer, num_blocks)) return false;
+        for (uint64_t i = 0; i < num_blocks; ++i) {
+          std::string label;
+          uint64_t pre, post;
+          if (!inv_table_impl::get_string(it, footer, label) ||
+              !inv_table_impl::get_varint(it, footer, pre) ||
+              !inv_table_impl::get_varint(it, footer, post)) {
+            return false;
+          }
+          m_index[label] = std::make_pair(pre, post);
+        }
+        return true;
+      }
+
+      // Set p to the start of the i-th entry of table t
+      bool entry(unsigned t, uint64_t i, const char *&p) const {
+        const char *table = m_data + m_tables[t];
+        uint64_t n = inv_table_impl::get_u64(table);
+        if (i >= n || i > (m_size - m_tables[t]) / 8 ||
+            m_tables[t] + 8 * (i + 2) > m_size) {
+          return false;
+        }
+        uint64_t o = inv_table_impl::get_u64(table + 8 * (i + 1));
+        if (o >= m_size) {
+          return false;
+        }
+        p = m_data + o;
+        return true;
+      }
+
+      const char *end() const { return m_data + m_size; }
+
+      bool get_const(uint64_t i, number_t &n) const {
+        const char *p;
+        std::string s;
+        if (!entry(_CONSTS, i, p) ||
+            !inv_table_impl::get_string(p, end(), s) ||
+            !binary_io::is_number<number_t>(s)) {
+          return false;
+        }
+        n = number_t(s);
+        return true;
+      }
+
+      boost::optional<variable_t> get_var(uint64_t i) const {
+        const char *p;
+        std::string name;
+        uint64_t type, bitwidth;
+        if (!entry(_VARS, i, p) ||
+            !inv_table_impl::get_string(p, end(), name) ||
+            !inv_table_impl::get_varint(p, end(), type) || type > crab::UNK_TYPE ||
+            !inv_table_impl::get_varint(p, end(), bitwidth) || bitwidth > UINT_MAX) {
+          return boost::none;
+        }
+        return variable_t(m_vfac[name], static_cast<crab::variable_type>(type), bitwidth);
+      }
+
+      bool get_cst(uint64_t i, linear_constraint_t &c) const {
+        const char *p;
+        uint64_t kind, is_signed, cst, num_terms;
+        number_t n;
+        if (!entry(_CSTS, i, p) ||
+            !inv_table_impl::get_varint(p, end(), kind) ||
+            kind > linear_constraint_t::STRICT_INEQUALITY ||
+            !inv_table_impl::get_varint(p, end(), is_signed) || is_signed > 1 ||
+            !inv_table_impl::get_varint(p, end(), cst) ||
+            !inv_table_impl::get_varint(p, end(), num_terms) ||
+            !get_const(cst, n)) {
+          return false;
+        }
+        linear_expression_t e(n);
+        for (uint64_t j = 0; j < num_terms; ++j) {
+          uint64_t coef, var;
+          boost::optional<variable_t> v;
+          if (!inv_table_impl::get_varint(p, end(), coef) ||
+              !inv_table_impl::get_varint(p, end(), var) ||
+              !get_const(coef, n) || !(v = get_var(var))) {
+            return false;
+          }
+          e = e + n * (*v);
+        }
+        auto k = static_cast<typename linear_constraint_t::kind_t>(kind);
+        if (k == linear_constraint_t::INEQUALITY ||
+            k == linear_constraint_t::STRICT_INEQUALITY) {
+          c = linear_constraint_t(e, k, is_signed);
+        } else {
+          c = linear_constraint_t(e, k);
+        }
+        return true;
+      }
+
+      // Decode the constraint ids of record i. Return false if the
+      // record is corrupted.
+      bool get_record(uint64_t i, bool &is_bottom, id_vector_t &ids,
+                      unsigned depth = 0) const {
+        const char *p;
+        uint64_t kind;
+        if (!entry(_RECORDS, i, p) ||
+            !inv_table_impl::get_varint(p, end(), kind)) {
+          return false;
+        }
+        is_bottom = false;
+        switch (kind) {
+        case inv_table_impl::_BOTTOM:
+          is_bottom = true;
+          return true;
+        case inv_table_impl::_FULL:
+          return inv_table_impl::get_ids(p, end(), ids);
+        case inv_table_impl::_DELTA: {
+          uint64_t base;
+          bool base_is_bottom;
+          id_vector_t base_ids, removed, added;
+          // the writer bounds the length of the chains of deltas and
+          // never uses bottom as a base
+          if (depth >= 64 ||
+              !inv_table_impl::get_varint(p, end(), base) ||
+              !inv_table_impl::get_ids(p, end(), removed) ||
+              !inv_table_impl::get_ids(p, end(), added) ||
+              !get_record(base, base_is_bottom, base_ids, depth + 1) ||
+              base_is_bottom) {
+            return false;
+          }
+          id_vector_t tmp;
+          std::set_difference(base_ids.begin(), base_ids.end(),
+                              removed.begin(), removed.end(),
+                              std::back_inserter(tmp));
+          std::set_union(tmp.begin(), tmp.end(), added.begin(), added.end(),
+                         std::back_inserter(ids));
+          return true;
+        }
+        default:
+          return false;
+        }
+      }
+
+      // Decode the invariant of record. If the file is corrupted then
+      // warn, close the reader and return false.
+      bool get_inv(uint64_t record, abs_dom_t &inv) {
+        crab::ScopedCrabStats __st__("InvTable.read");
+        id_vector_t ids;
+        bool is_bottom;
+        bool ok = get_record(record, is_bottom, ids);
+        if (ok && is_bottom) {
+          inv = abs_dom_t::bottom();
+          return true;
+        }
+        abs_dom_t res = abs_dom_t::top();
+        for (auto it = ids.begin(); ok && it != ids.end(); ++it) {
+          linear_constraint_t c;
+          ok = get_cst(*it, c);
+          if (ok) res += c;
+        }
+        if (!ok) {
+          CRAB_WARN("corrupted invariants file ", m_filename);
+          close();
+          return false;
+        }
+        inv = res;
+        return true;
+      }
+
+     public:
+
+      inv_table_reader(const std::string &filename, VariableFactory &vfac)
+        : m_vfac(vfac), m_filename(filename), m_data(nullptr), m_size(0) {
+        if (!open(filename)) {
+          CRAB_WARN("cannot read invariants from ", filename);
+          close();
+        }
+      }
+
+      ~inv_table_reader() { close(); }
+
+      bool is_open() const { return m_data != nullptr; }
+
+      // Return true if the file has the invariants of block
+      bool has_block(const std::string &block) const {
+        return m_index.count(block) > 0;
+      }
+
+      std::size_t size() const { return m_index.size(); }
+
+      //! Set inv to the invariants that hold at the entry of block.
+      //! Return false if the reader is closed, there is no such block
+      //! or the file is corrupted (then the reader is closed).
+      bool get_pre(const std::string &block, abs_dom_t &inv) {
+        auto it = m_index.find(block);
+        return (it != m_index.end() && get_inv(it->second.first, inv));
+      }
+
+      //! Set inv to the invariants that hold at the exit of block.
+      //! Return false as get_pre.
+      bool get_post(const std::string &block, abs_dom_t &inv) {
+        auto it = m_index.find(block);
+        return (it != m_index.end() && get_inv(it->second.second, inv));
+      }
+    };
+
+  } // end namespace
+} // end namespace
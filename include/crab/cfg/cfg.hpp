@@ -50,12 +50,14 @@
 #include <boost/unordered_map.hpp>
 
 #include <crab/common/types.hpp>
+#include <crab/common/stats.hpp>
 #include <crab/common/bignums.hpp>
 #include <crab/domains/linear_constraints.hpp>
 #include <crab/domains/interval.hpp>
 #include <crab/domains/discrete_domains.hpp>
 
 #include <functional> // for wrapper_reference
+#include <memory>
 
 namespace crab {
 
@@ -300,7 +302,9 @@ namespace crab {
       }
       
      public:
-      
+
+      stmt_code get_stmt_code() const { return m_stmt_code; }
+
       const live_t& get_live() const { return m_live; }
 
       const debug_info& get_debug_info() const { return m_dbg_info; }
@@ -1985,9 +1989,17 @@ namespace crab {
       typedef boost::shared_ptr<bool_assert_t> bool_assert_ptr;
       
       
+      // Adjacency lists with more elements than this are also kept in
+      // a hash set so that checking membership is not linear.
+      static const std::size_t adjacency_index_threshold = 16;
+      typedef boost::unordered_set< BasicBlockLabel > bb_id_index_t;
+      typedef std::unique_ptr< bb_id_index_t > bb_id_index_ptr;
+      
       BasicBlockLabel m_bb_id;
       stmt_list_t m_stmts;
       bb_id_set_t m_prev, m_next;
+      // null or the same elements as m_prev and m_next
+      bb_id_index_ptr m_prev_index, m_next_index;
       tracked_precision m_track_prec;    
       // Ideally it should be size_t to indicate any position within the
       // block. For now, we only allow to insert either at front or at
@@ -1999,16 +2011,38 @@ namespace crab {
       // set of used/def variables 
       live_domain_t m_live; 
       
-      void insert_adjacent(bb_id_set_t &c, BasicBlockLabel e)
+      void insert_adjacent(bb_id_set_t &c, bb_id_index_ptr &index, BasicBlockLabel e)
       { 
-        if (std::find(c.begin(), c.end(), e) == c.end())
+        if (!index && c.size() >= adjacency_index_threshold)
+          index.reset(new bb_id_index_t(c.begin(), c.end()));
+        
+        if (index) {
+          if (index->insert(e).second)
+            c.push_back(e);
+        } else if (std::find(c.begin(), c.end(), e) == c.end()) {
           c.push_back(e);
+        }
       }
       
-      void remove_adjacent(bb_id_set_t &c, BasicBlockLabel e)
+      void remove_adjacent(bb_id_set_t &c, bb_id_index_ptr &index, BasicBlockLabel e)
       {
-        if(std::find(c.begin(), c.end(), e) != c.end())
+        if (index) {
+          if (index->erase(e) > 0)
+            c.erase(std::remove(c.begin(), c.end(), e), c.end());
+        } else if (std::find(c.begin(), c.end(), e) != c.end()) {
           c.erase(std::remove(c.begin(), c.end(), e), c.end());
+        }
+      }
+
+      // Remove all the elements of c that satisfy f in one pass
+      template<typename Pred>
+      void remove_adjacent_if(bb_id_set_t &c, bb_id_index_ptr &index, Pred f)
+      {
+        auto it = std::remove_if(c.begin(), c.end(), f);
+        if (it == c.end()) return;
+        c.erase(it, c.end());
+        if (index)
+          index.reset(new bb_id_index_t(c.begin(), c.end()));
       }
       
       basic_block(BasicBlockLabel bb_id, tracked_precision track_prec): 
@@ -2137,15 +2171,15 @@ namespace crab {
       // Add a cfg edge from *this to b
       void operator>>(basic_block_t& b) 
       {
-        insert_adjacent(m_next, b.m_bb_id);
-        insert_adjacent(b.m_prev, m_bb_id);
+        insert_adjacent(m_next, m_next_index, b.m_bb_id);
+        insert_adjacent(b.m_prev, b.m_prev_index, m_bb_id);
       }
       
       // Remove a cfg edge from *this to b
       void operator-=(basic_block_t &b)
       {
-        remove_adjacent(m_next, b.m_bb_id);
-        remove_adjacent(b.m_prev, m_bb_id);       
+        remove_adjacent(m_next, m_next_index, b.m_bb_id);
+        remove_adjacent(b.m_prev, b.m_prev_index, m_bb_id);       
       }
       
       // insert all statements of other at the front
@@ -3187,14 +3221,17 @@ namespace crab {
         return o;
       }
       
+      // The simplifications are not recursive and they are linear on
+      // the size of the cfg (except for blocks with many successors or
+      // predecessors).
       void simplify() {
-        merge_blocks();        
+        crab::ScopedCrabStats __st__("CFG.simplify");
+        merge_blocks();
         remove_unreachable_blocks();
         remove_useless_blocks();
         //after removing useless blocks there can be opportunities to
         //merge more blocks.
         merge_blocks();
-        merge_blocks();
       }
 
     private:
@@ -3254,45 +3291,70 @@ namespace crab {
         auto rng = prev_nodes(b);
         return get_node(*(rng.begin()));
       }
-      
-      void merge_blocks_rec(BasicBlockLabel curId, 
-                           visited_t& visited)
+
+      // Whether cur can be merged into its predecessor. The entry and
+      // exit blocks are never merged.
+      bool can_be_merged(basic_block_t &cur)
       {
+        BasicBlockLabel curId = cur.label();
+        if (curId == m_entry || (m_has_exit && curId == m_exit))
+          return false;
         
-        if (visited.find(curId) != visited.end()) return;
-        visited.insert(curId);
-        
-        basic_block_t &cur = get_node(curId);
+        if (!has_one_child(curId) || !has_one_parent(curId))
+          return false;
+
+        if (get_parent(curId).label() == curId || get_child(curId).label() == curId)
+          return false;
         
-        if (has_one_child(curId) && has_one_parent(curId))
+        donot_simplify_visitor vis;
+        for (auto it = cur.begin(); it != cur.end(); ++it)
+          it->accept(&vis);
+        return !vis._do_not_simplify;
+      }
+      
+      // Merges a basic block into its predecessor if the block has
+      // only one predecessor and one successor.
+      //
+      // Blocks are visited in depth-first order from the entry. After
+      // a merge, the predecessor and the successor of the merged block
+      // are checked again so no more merges are possible at the end.
+      void merge_blocks()
+      {
+        visited_t visited;
+        std::vector<BasicBlockLabel> worklist;
+        worklist.push_back(entry());
+        while (!worklist.empty())
         {
-          basic_block_t &parent = get_parent(curId);
-          basic_block_t &child  = get_child(curId);
+          BasicBlockLabel curId = worklist.back();
+          worklist.pop_back();
           
-          donot_simplify_visitor vis;
-          for (auto it = cur.begin(); it != cur.end(); ++it)
-            it->accept(&vis);
+          auto it = m_blocks.find(curId);
+          if (it == m_blocks.end()) continue; // already merged
+          basic_block_t &cur = *(it->second);
           
-          if (!vis._do_not_simplify)
+          if (can_be_merged(cur))
           {
+            basic_block_t &parent = get_parent(curId);
+            basic_block_t &child  = get_child(curId);
             parent.merge_back(cur);
             remove(curId);
-            parent >> child;        
-            merge_blocks_rec(child.label(), visited); 
-            return;
+            parent >> child;
+            // the child is visited first
+            worklist.push_back(parent.label());
+            worklist.push_back(child.label());
+            continue;
+          }
+          
+          if (!visited.insert(curId).second) continue;
+          
+          auto succs = cur.next_blocks();
+          for (auto sit = succs.second; sit != succs.first; )
+          {
+            --sit;
+            if (visited.count(*sit) == 0)
+              worklist.push_back(*sit);
           }
         }
-        
-        for (auto n : boost::make_iterator_range(cur.next_blocks()))
-          merge_blocks_rec(n, visited);
-      }
-      
-      // Merges a basic block into its predecessor if there is only one
-      // and the predecessor only has one successor.
-      void merge_blocks()
-      {
-        visited_t visited;
-        merge_blocks_rec(entry(), visited);
       }
       
       // mark reachable blocks from curId
@@ -3301,10 +3363,45 @@ namespace crab {
                             AnyCfg& cfg,
                             visited_t& visited)
       {
-        if (visited.count(curId) > 0) return;
-        visited.insert(curId);
-        for (auto child : cfg.next_nodes(curId))
-          mark_alive_blocks(child, cfg, visited);
+        if (!visited.insert(curId).second) return;
+        std::vector<BasicBlockLabel> worklist;
+        worklist.push_back(curId);
+        while (!worklist.empty())
+        {
+          BasicBlockLabel n = worklist.back();
+          worklist.pop_back();
+          for (auto child : cfg.next_nodes(n))
+            if (visited.insert(child).second)
+              worklist.push_back(child);
+        }
+      }
+
+      // Same as calling remove on each block of dead but the
+      // adjacency lists of each block are only traversed once.
+      void remove_blocks(const visited_t &dead)
+      {
+        if (dead.empty()) return;
+        
+        visited_t touched;
+        for (auto bb_id: dead)
+        {
+          basic_block_t &bb = get_node(bb_id);
+          for (auto id : boost::make_iterator_range(bb.prev_blocks()))
+            if (dead.count(id) == 0) touched.insert(id);
+          for (auto id : boost::make_iterator_range(bb.next_blocks()))
+            if (dead.count(id) == 0) touched.insert(id);
+        }
+        
+        auto is_dead = [&dead](const BasicBlockLabel &id) { return dead.count(id) > 0; };
+        for (auto bb_id: touched)
+        {
+          basic_block_t &bb = get_node(bb_id);
+          bb.remove_adjacent_if(bb.m_prev, bb.m_prev_index, is_dead);
+          bb.remove_adjacent_if(bb.m_next, bb.m_next_index, is_dead);
+        }
+        
+        for (auto bb_id: dead)
+          m_blocks.erase(bb_id);
       }
       
       // remove unreachable blocks
@@ -3317,8 +3414,7 @@ namespace crab {
           if (!(alive.count(bb.label()) > 0))
             dead.insert(bb.label());
         
-        for (auto bb_id: dead)
-          remove(bb_id);
+        remove_blocks(dead);
       }
       
       // remove blocks that cannot reach the exit block
@@ -3335,8 +3431,7 @@ namespace crab {
           if (!(useful.count(bb.label()) > 0))
             useless.insert(bb.label());
         
-        for (auto bb_id: useless)
-          remove(bb_id);
+        remove_blocks(useless);
       }
       
     }; 
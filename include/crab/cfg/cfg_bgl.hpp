@@ -8,6 +8,7 @@
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <crab/cfg/cfg.hpp>
+#include <crab/cfg/cfg_frozen.hpp>
 
 namespace crab {
   namespace cfg {
@@ -165,6 +166,46 @@ namespace boost {
                                          typename graph_t::succ_iterator> out_edge_iterator; 
      }; // end class graph_traits
 
+
+     // cfg_frozen
+     template<class CFG>
+     struct graph_traits<crab::cfg::cfg_frozen<CFG> >  {
+       typedef crab::cfg::cfg_frozen<CFG> graph_t;
+       typedef typename graph_t::basic_block_label_t vertex_descriptor;
+       typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
+       typedef std::pair<const vertex_descriptor, 
+			 const vertex_descriptor> const_edge_descriptor;
+       
+       typedef disallow_parallel_edge_tag edge_parallel_category;
+       typedef bidirectional_tag directed_category;
+       struct  this_graph_tag : virtual bidirectional_graph_tag, 
+                                virtual vertex_list_graph_tag {};
+       typedef this_graph_tag traversal_category;
+       
+       typedef size_t vertices_size_type;
+       typedef size_t edges_size_type;
+       typedef size_t degree_size_type;
+
+       static vertex_descriptor null_vertex() {
+	 if (std::is_pointer<vertex_descriptor>::value)
+	   return nullptr;
+	 else {
+	   // XXX: if vertex_descriptor is a basic type then
+	   // null_vertex will return an undefined value, otherwise it
+	   // will return the result of calling the default
+	   // constructor.	   
+	   vertex_descriptor n;
+	   return n;
+	 }
+       }    
+
+       typedef typename graph_t::label_iterator vertex_iterator;
+       typedef boost::transform_iterator<crab::cfg::graph::mk_in_edge<graph_t>, 
+                                         typename graph_t::pred_iterator> in_edge_iterator;
+       typedef boost::transform_iterator<crab::cfg::graph::mk_out_edge<graph_t>, 
+                                         typename graph_t::succ_iterator> out_edge_iterator; 
+     }; // end class graph_traits
+
 } // end namespace
 
 
@@ -402,6 +443,73 @@ namespace crab {
        return out_degree (v, g) + in_degree (v, g);
      }
 
+     // cfg_frozen
+
+     template<class CFG>
+     inline std::pair<typename boost::graph_traits<cfg_frozen<CFG> >::vertex_iterator, 
+		      typename boost::graph_traits<cfg_frozen<CFG> >::vertex_iterator> 
+     vertices (cfg_frozen<CFG> g) {
+       return std::make_pair (g.label_begin (), g.label_end ());
+     }
+   
+     template<class CFG>
+     inline std::pair<typename boost::graph_traits<cfg_frozen<CFG> >::out_edge_iterator, 
+		      typename boost::graph_traits<cfg_frozen<CFG> >::out_edge_iterator>
+     out_edges (typename boost::graph_traits<cfg_frozen<CFG> >::vertex_descriptor v, 
+                cfg_frozen<CFG> g) {
+       typedef cfg_frozen<CFG> G;
+       auto &node = g.get_node (v);
+       auto p = node.next_blocks ();
+       return std::make_pair (boost::make_transform_iterator
+			      (p.first, graph::mk_out_edge<G> (v)),
+                              boost::make_transform_iterator
+			      (p.second, 
+			       graph::mk_out_edge<G> (v)));
+     }
+   
+     template<class CFG>
+     inline std::pair<typename boost::graph_traits<cfg_frozen<CFG> >::in_edge_iterator, 
+		      typename boost::graph_traits<cfg_frozen<CFG> >::in_edge_iterator>
+     in_edges (typename boost::graph_traits<cfg_frozen<CFG> >::vertex_descriptor v, 
+               cfg_frozen<CFG> g) {
+       typedef cfg_frozen<CFG> G;
+       auto &node = g.get_node (v);
+       auto p = node.prev_blocks ();
+       return std::make_pair (boost::make_transform_iterator
+			      (p.first, graph::mk_in_edge<G> (v)),
+                              boost::make_transform_iterator
+			      (p.second, graph::mk_in_edge<G> (v)));
+     }
+   
+     template<class CFG>
+     typename boost::graph_traits<cfg_frozen<CFG> >::vertices_size_type
+     num_vertices (cfg_frozen<CFG> g) {
+       return std::distance (g.label_begin (), g.label_end ());
+     }
+   
+     template<class CFG>
+     typename boost::graph_traits<cfg_frozen<CFG> >::degree_size_type
+     in_degree (typename boost::graph_traits<cfg_frozen<CFG> >::vertex_descriptor v, 
+                cfg_frozen<CFG> g) {
+       auto preds = g.prev_nodes (v);
+       return std::distance (preds.begin (), preds.end ());
+     }
+   
+     template<class CFG>
+     typename boost::graph_traits<cfg_frozen<CFG> >::degree_size_type
+     out_degree (typename boost::graph_traits<cfg_frozen<CFG> >::vertex_descriptor v, 
+                 cfg_frozen<CFG> g) {
+       auto succs = g.next_nodes (v);
+       return std::distance (succs.begin (), succs.end ());
+     }
+   
+     template<class CFG>
+     typename boost::graph_traits<cfg_frozen<CFG> >::degree_size_type
+     degree (typename boost::graph_traits<cfg_frozen<CFG> >::vertex_descriptor v, 
+             cfg_frozen<CFG> g) {
+       return out_degree (v, g) + in_degree (v, g);
+     }
+
  } // namespace cfg
 } // namespace crab
 
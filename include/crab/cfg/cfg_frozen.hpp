@@ -0,0 +1,530 @@
+#pragma once
+
+/*
+ * A frozen CFG laid out in flat arrays.
+ *
+ * Once a CFG has been built and simplified it can be frozen into a
+ * cfg_frozen object which cannot be modified anymore:
+ *
+ * - blocks are kept in a dense vector indexed by block id,
+ * - the statements of all blocks are copied, in block order, into a
+ *   single contiguous arena. The code of each statement is used as
+ *   the tag to copy it with its dynamic type.
+ * - predecessors and successors are stored in CSR form: one array
+ *   with all the labels and an offset per block id.
+ *
+ * A cfg_frozen provides the same interface as cfg_ref so that the
+ * fixpoint iterators (and the analyses built on them) can run on
+ * it. Copies of a cfg_frozen share the same storage.
+ */
+
+#include <crab/cfg/cfg.hpp>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/iterator/indirect_iterator.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <iterator>
+#include <new>
+#include <vector>
+
+namespace crab {
+  namespace cfg {
+
+    template<class CFG> class cfg_frozen;
+
+    namespace cfg_frozen_impl {
+
+      // Call op.apply<S>(s) where S is the dynamic type of s
+      template<class BasicBlock, class Op>
+      inline void dispatch(const typename BasicBlock::statement_t &s, Op &op) {
+	typedef BasicBlock B;
+	switch (s.get_stmt_code()) {
+	case BIN_OP:          op.template apply<typename B::bin_op_t>(s); break;
+	case ASSIGN:          op.template apply<typename B::assign_t>(s); break;
+	case ASSUME:          op.template apply<typename B::assume_t>(s); break;
+	case UNREACH:         op.template apply<typename B::unreach_t>(s); break;
+	case SELECT:          op.template apply<typename B::select_t>(s); break;
+	case ASSERT:          op.template apply<typename B::assert_t>(s); break;
+	case ARR_INIT:        op.template apply<typename B::arr_init_t>(s); break;
+	case ARR_STORE:       op.template apply<typename B::arr_store_t>(s); break;
+	case ARR_LOAD:        op.template apply<typename B::arr_load_t>(s); break;
+	case ARR_ASSIGN:      op.template apply<typename B::arr_assign_t>(s); break;
+	case PTR_LOAD:        op.template apply<typename B::ptr_load_t>(s); break;
+	case PTR_STORE:       op.template apply<typename B::ptr_store_t>(s); break;
+	case PTR_ASSIGN:      op.template apply<typename B::ptr_assign_t>(s); break;
+	case PTR_OBJECT:      op.template apply<typename B::ptr_object_t>(s); break;
+	case PTR_FUNCTION:    op.template apply<typename B::ptr_function_t>(s); break;
+	case PTR_NULL:        op.template apply<typename B::ptr_null_t>(s); break;
+	case PTR_ASSUME:      op.template apply<typename B::ptr_assume_t>(s); break;
+	case PTR_ASSERT:      op.template apply<typename B::ptr_assert_t>(s); break;
+	case CALLSITE:        op.template apply<typename B::callsite_t>(s); break;
+	case RETURN:          op.template apply<typename B::return_t>(s); break;
+	case HAVOC:           op.template apply<typename B::havoc_t>(s); break;
+	case BOOL_BIN_OP:     op.template apply<typename B::bool_bin_op_t>(s); break;
+	case BOOL_ASSIGN_CST: op.template apply<typename B::bool_assign_cst_t>(s); break;
+	case BOOL_ASSIGN_VAR: op.template apply<typename B::bool_assign_var_t>(s); break;
+	case BOOL_ASSUME:     op.template apply<typename B::bool_assume_t>(s); break;
+	case BOOL_SELECT:     op.template apply<typename B::bool_select_t>(s); break;
+	case BOOL_ASSERT:     op.template apply<typename B::bool_assert_t>(s); break;
+	case INT_CAST:        op.template apply<typename B::int_cast_t>(s); break;
+	default:
+	  CRAB_ERROR("cfg_frozen: unexpected statement code ", (int) s.get_stmt_code());
+	}
+      }
+
+      template<class Statement>
+      struct stmt_sizer {
+	std::size_t m_offset;
+	stmt_sizer(): m_offset(0) { }
+	template<class S>
+	void apply(const Statement &s) {
+	  m_offset = (m_offset + alignof(S) - 1) / alignof(S) * alignof(S);
+	  m_offset += sizeof(S);
+	}
+      };
+
+      template<class Statement>
+      struct stmt_copier {
+	char *m_base;
+	std::size_t m_offset;
+	Statement *m_res;
+	stmt_copier(char *base): m_base(base), m_offset(0), m_res(nullptr) { }
+	template<class S>
+	void apply(const Statement &s) {
+	  m_offset = (m_offset + alignof(S) - 1) / alignof(S) * alignof(S);
+	  m_res = new (m_base + m_offset) S(static_cast<const S&>(s));
+	  m_offset += sizeof(S);
+	}
+      };
+    } // end namespace cfg_frozen_impl
+
+    // A basic block of a cfg_frozen. Its statements and its
+    // predecessors and successors are ranges of the cfg_frozen
+    // arrays.
+    template<class CFG>
+    class basic_block_frozen {
+      friend class cfg_frozen<CFG>;
+      typedef typename CFG::basic_block_t orig_basic_block_t;
+
+     public:
+
+      typedef typename CFG::number_t number_t;
+      typedef typename CFG::varname_t varname_t;
+      typedef typename CFG::variable_t variable_t;
+      typedef typename CFG::basic_block_label_t basic_block_label_t;
+      typedef typename CFG::statement_t statement_t;
+
+      typedef typename orig_basic_block_t::havoc_t havoc_t;
+      typedef typename orig_basic_block_t::unreach_t unreach_t;
+      typedef typename orig_basic_block_t::bin_op_t bin_op_t;
+      typedef typename orig_basic_block_t::assign_t assign_t;
+      typedef typename orig_basic_block_t::assume_t assume_t;
+      typedef typename orig_basic_block_t::select_t select_t;
+      typedef typename orig_basic_block_t::assert_t assert_t;
+      typedef typename orig_basic_block_t::int_cast_t int_cast_t;
+      typedef typename orig_basic_block_t::callsite_t callsite_t;
+      typedef typename orig_basic_block_t::return_t return_t;
+      typedef typename orig_basic_block_t::arr_init_t arr_init_t;
+      typedef typename orig_basic_block_t::arr_store_t arr_store_t;
+      typedef typename orig_basic_block_t::arr_load_t arr_load_t;
+      typedef typename orig_basic_block_t::arr_assign_t arr_assign_t;
+      typedef typename orig_basic_block_t::ptr_store_t ptr_store_t;
+      typedef typename orig_basic_block_t::ptr_load_t ptr_load_t;
+      typedef typename orig_basic_block_t::ptr_assign_t ptr_assign_t;
+      typedef typename orig_basic_block_t::ptr_object_t ptr_object_t;
+      typedef typename orig_basic_block_t::ptr_function_t ptr_function_t;
+      typedef typename orig_basic_block_t::ptr_null_t ptr_null_t;
+      typedef typename orig_basic_block_t::ptr_assume_t ptr_assume_t;
+      typedef typename orig_basic_block_t::ptr_assert_t ptr_assert_t;
+      typedef typename orig_basic_block_t::bool_bin_op_t bool_bin_op_t;
+      typedef typename orig_basic_block_t::bool_assign_cst_t bool_assign_cst_t;
+      typedef typename orig_basic_block_t::bool_assign_var_t bool_assign_var_t;
+      typedef typename orig_basic_block_t::bool_assume_t bool_assume_t;
+      typedef typename orig_basic_block_t::bool_select_t bool_select_t;
+      typedef typename orig_basic_block_t::bool_assert_t bool_assert_t;
+
+     private:
+
+      typedef typename std::vector<statement_t*>::const_iterator stmt_ptr_iterator;
+      typedef std::reverse_iterator<stmt_ptr_iterator> stmt_ptr_reverse_iterator;
+      typedef typename std::vector<basic_block_label_t>::const_iterator label_iterator;
+
+     public:
+
+      typedef label_iterator succ_iterator;
+      typedef label_iterator const_succ_iterator;
+      typedef label_iterator pred_iterator;
+      typedef label_iterator const_pred_iterator;
+
+      typedef boost::indirect_iterator<stmt_ptr_iterator, statement_t> iterator;
+      typedef boost::indirect_iterator<stmt_ptr_iterator, const statement_t> const_iterator;
+      typedef boost::indirect_iterator<stmt_ptr_reverse_iterator, statement_t> reverse_iterator;
+      typedef boost::indirect_iterator<stmt_ptr_reverse_iterator, const statement_t>
+      const_reverse_iterator;
+      typedef ikos::discrete_domain<variable_t> live_domain_t;
+
+     private:
+
+      basic_block_label_t m_label;
+      std::size_t m_id;
+      stmt_ptr_iterator m_stmts_begin;
+      stmt_ptr_iterator m_stmts_end;
+      label_iterator m_succs_begin;
+      label_iterator m_succs_end;
+      label_iterator m_preds_begin;
+      label_iterator m_preds_end;
+      live_domain_t m_live;
+
+     public:
+
+      basic_block_frozen(basic_block_label_t label, std::size_t id, live_domain_t live)
+	: m_label(label), m_id(id), m_live(live) { }
+
+      basic_block_label_t label() const { return m_label; }
+
+      //! Return the position of the block in the cfg_frozen
+      std::size_t id() const { return m_id; }
+
+      std::string name() const { return cfg_impl::get_label_str(m_label); }
+
+      iterator begin() { return iterator(m_stmts_begin); }
+      iterator end() { return iterator(m_stmts_end); }
+      const_iterator begin() const { return const_iterator(m_stmts_begin); }
+      const_iterator end() const { return const_iterator(m_stmts_end); }
+
+      reverse_iterator rbegin() {
+	return reverse_iterator(stmt_ptr_reverse_iterator(m_stmts_end));
+      }
+      reverse_iterator rend() {
+	return reverse_iterator(stmt_ptr_reverse_iterator(m_stmts_begin));
+      }
+      const_reverse_iterator rbegin() const {
+	return const_reverse_iterator(stmt_ptr_reverse_iterator(m_stmts_end));
+      }
+      const_reverse_iterator rend() const {
+	return const_reverse_iterator(stmt_ptr_reverse_iterator(m_stmts_begin));
+      }
+
+      std::size_t size() const { return std::distance(m_stmts_begin, m_stmts_end); }
+
+      live_domain_t& live() { return m_live; }
+
+      live_domain_t live() const { return m_live; }
+
+      void accept(statement_visitor<number_t, varname_t> *v) {
+	for (auto &s: *this) {
+	  s.accept(v);
+	}
+      }
+
+      std::pair<succ_iterator, succ_iterator> next_blocks() const
+      { return std::make_pair(m_succs_begin, m_succs_end); }
+
+      std::pair<pred_iterator, pred_iterator> prev_blocks() const
+      { return std::make_pair(m_preds_begin, m_preds_end); }
+
+      void write(crab_os& o) const {
+        o << cfg_impl::get_label_str(m_label) << ":\n";
+        for (auto const &s: *this) {
+          o << "  " << s << ";\n";
+	}
+	succ_iterator it = m_succs_begin;
+	succ_iterator et = m_succs_end;
+	if (it != et) {
+	  o << "  " << "goto ";
+	  for (; it != et; ) {
+	    o << cfg_impl::get_label_str(*it);
+	    ++it;
+	    if (it == et) {
+	      o << ";";
+	    } else {
+	      o << ",";
+	    }
+	  }
+	}
+	o << "\n";
+      }
+
+      friend crab_os& operator<<(crab_os &o, const basic_block_frozen<CFG> &b) {
+        o << cfg_impl::get_label_str(b.label());
+        return o;
+      }
+    };
+
+    template<class CFG>
+    class cfg_frozen {
+     public:
+
+      typedef typename CFG::basic_block_label_t basic_block_label_t;
+      typedef basic_block_label_t node_t; // for Bgl graphs
+      typedef typename CFG::varname_t varname_t;
+      typedef typename CFG::number_t number_t;
+      typedef typename CFG::variable_t variable_t;
+      typedef typename CFG::fdecl_t fdecl_t;
+      typedef typename CFG::statement_t statement_t;
+      typedef basic_block_frozen<CFG> basic_block_t;
+
+      typedef typename basic_block_t::succ_iterator succ_iterator;
+      typedef typename basic_block_t::pred_iterator pred_iterator;
+      typedef typename basic_block_t::const_succ_iterator const_succ_iterator;
+      typedef typename basic_block_t::const_pred_iterator const_pred_iterator;
+      typedef boost::iterator_range<succ_iterator> succ_range;
+      typedef boost::iterator_range<pred_iterator> pred_range;
+      typedef boost::iterator_range<const_succ_iterator> const_succ_range;
+      typedef boost::iterator_range<const_pred_iterator> const_pred_range;
+
+      typedef typename std::vector<basic_block_t>::iterator iterator;
+      typedef typename std::vector<basic_block_t>::const_iterator const_iterator;
+      typedef typename std::vector<basic_block_label_t>::const_iterator label_iterator;
+      typedef label_iterator const_label_iterator;
+      typedef typename CFG::var_iterator var_iterator;
+      typedef typename CFG::const_var_iterator const_var_iterator;
+
+     private:
+
+      typedef typename CFG::basic_block_t orig_basic_block_t;
+      typedef cfg_frozen<CFG> cfg_frozen_t;
+
+      struct storage: public boost::noncopyable {
+	basic_block_label_t m_entry;
+	boost::optional<basic_block_label_t> m_exit;
+	boost::optional<fdecl_t> m_func_decl;
+	// indexed by block id
+	std::vector<basic_block_t> m_blocks;
+	std::vector<basic_block_label_t> m_labels;
+	boost::unordered_map<basic_block_label_t, std::size_t> m_ids;
+	// CSR: the successors of block i are m_succs[m_succ_offsets[i],
+	// m_succ_offsets[i+1]), and similarly for predecessors.
+	std::vector<std::size_t> m_succ_offsets;
+	std::vector<basic_block_label_t> m_succs;
+	std::vector<std::size_t> m_pred_offsets;
+	std::vector<basic_block_label_t> m_preds;
+	// statements in block order, pointing into m_arena
+	std::vector<statement_t*> m_stmts;
+	std::vector<std::size_t> m_stmt_offsets;
+	char *m_arena;
+
+	storage(): m_arena(nullptr) { }
+
+	~storage() {
+	  for (statement_t *s: m_stmts) {
+	    s->~statement_t();
+	  }
+	  ::operator delete(m_arena);
+	}
+      };
+
+      boost::shared_ptr<storage> m_s;
+
+      std::size_t id_of(basic_block_label_t bb) const {
+	auto it = m_s->m_ids.find(bb);
+	if (it == m_s->m_ids.end()) {
+          CRAB_ERROR("Basic block ", bb, " not found in the CFG: ",__LINE__);
+	}
+	return it->second;
+      }
+
+      void freeze(CFG &cfg) {
+	typedef cfg_frozen_impl::stmt_sizer<statement_t> sizer_t;
+	typedef cfg_frozen_impl::stmt_copier<statement_t> copier_t;
+
+	storage &s = *m_s;
+	s.m_entry = cfg.entry();
+	if (cfg.has_exit()) {
+	  s.m_exit = cfg.exit();
+	}
+	s.m_func_decl = cfg.get_func_decl();
+
+	std::size_t num_blocks = cfg.size();
+	s.m_labels.reserve(num_blocks);
+	for (auto &b: boost::make_iterator_range(cfg.begin(), cfg.end())) {
+	  s.m_ids.insert(std::make_pair(b.label(), s.m_labels.size()));
+	  s.m_labels.push_back(b.label());
+	}
+
+	// size of the arena and CSR offsets
+	sizer_t sizer;
+	s.m_succ_offsets.reserve(num_blocks + 1);
+	s.m_pred_offsets.reserve(num_blocks + 1);
+	s.m_stmt_offsets.reserve(num_blocks + 1);
+	s.m_succ_offsets.push_back(0);
+	s.m_pred_offsets.push_back(0);
+	s.m_stmt_offsets.push_back(0);
+	for (auto &b: boost::make_iterator_range(cfg.begin(), cfg.end())) {
+	  for (auto &stmt: b) {
+	    cfg_frozen_impl::dispatch<orig_basic_block_t>(stmt, sizer);
+	  }
+	  auto succs = b.next_blocks();
+	  auto preds = b.prev_blocks();
+	  s.m_succ_offsets.push_back(s.m_succ_offsets.back() +
+				     std::distance(succs.first, succs.second));
+	  s.m_pred_offsets.push_back(s.m_pred_offsets.back() +
+				     std::distance(preds.first, preds.second));
+	  s.m_stmt_offsets.push_back(s.m_stmt_offsets.back() + b.size());
+	}
+
+	s.m_succs.reserve(s.m_succ_offsets.back());
+	s.m_preds.reserve(s.m_pred_offsets.back());
+	s.m_stmts.reserve(s.m_stmt_offsets.back());
+	s.m_arena = static_cast<char*>(::operator new(sizer.m_offset));
+	copier_t copier(s.m_arena);
+	for (auto &b: boost::make_iterator_range(cfg.begin(), cfg.end())) {
+	  for (auto &stmt: b) {
+	    cfg_frozen_impl::dispatch<orig_basic_block_t>(stmt, copier);
+	    s.m_stmts.push_back(copier.m_res);
+	  }
+	  for (auto succ: boost::make_iterator_range(b.next_blocks())) {
+	    id_of(succ); // check that the block exists
+	    s.m_succs.push_back(succ);
+	  }
+	  for (auto pred: boost::make_iterator_range(b.prev_blocks())) {
+	    id_of(pred);
+	    s.m_preds.push_back(pred);
+	  }
+	}
+
+	// the arrays are complete so the blocks can keep iterators
+	// to them
+	s.m_blocks.reserve(num_blocks);
+	for (auto &b: boost::make_iterator_range(cfg.begin(), cfg.end())) {
+	  std::size_t i = s.m_blocks.size();
+	  basic_block_t fb(b.label(), i, b.live());
+	  fb.m_stmts_begin = s.m_stmts.begin() + s.m_stmt_offsets[i];
+	  fb.m_stmts_end   = s.m_stmts.begin() + s.m_stmt_offsets[i+1];
+	  fb.m_succs_begin = s.m_succs.begin() + s.m_succ_offsets[i];
+	  fb.m_succs_end   = s.m_succs.begin() + s.m_succ_offsets[i+1];
+	  fb.m_preds_begin = s.m_preds.begin() + s.m_pred_offsets[i];
+	  fb.m_preds_end   = s.m_preds.begin() + s.m_pred_offsets[i+1];
+	  s.m_blocks.push_back(fb);
+	}
+      }
+
+      // same preorder traversal as cfg::dfs but without recursion
+      template<typename T>
+      void dfs(T f) const {
+	std::vector<bool> visited(size(), false);
+	std::vector<std::pair<std::size_t, succ_iterator> > stack;
+	std::size_t cur = id_of(entry());
+	visited[cur] = true;
+	f(m_s->m_blocks[cur]);
+	stack.push_back(std::make_pair(cur, m_s->m_blocks[cur].m_succs_begin));
+	while (!stack.empty()) {
+	  const basic_block_t &b = m_s->m_blocks[stack.back().first];
+	  if (stack.back().second == b.m_succs_end) {
+	    stack.pop_back();
+	    continue;
+	  }
+	  std::size_t next = id_of(*stack.back().second++);
+	  if (!visited[next]) {
+	    visited[next] = true;
+	    f(m_s->m_blocks[next]);
+	    stack.push_back(std::make_pair(next, m_s->m_blocks[next].m_succs_begin));
+	  }
+	}
+      }
+
+      struct print_block {
+        crab_os &m_o;
+        print_block(crab_os& o) : m_o(o) { }
+        void operator()(const basic_block_t& B){ B.write(m_o); }
+      };
+
+     public:
+
+      // --- hook needed by crab::cg::CallGraph<CFG>::CgNode
+      cfg_frozen() { }
+
+      //! Freeze cfg. Later changes to cfg are not visible from the
+      //! frozen copy.
+      cfg_frozen(CFG &cfg): m_s(new storage()) {
+	crab::ScopedCrabStats __st__("CFG.freeze");
+	freeze(cfg);
+      }
+
+      basic_block_label_t entry() const {
+	return m_s->m_entry;
+      }
+
+      bool has_exit() const {
+	return (bool) m_s->m_exit;
+      }
+
+      basic_block_label_t exit() const {
+	if (has_exit()) return *(m_s->m_exit);
+        CRAB_ERROR("cfg does not have an exit block");
+      }
+
+      boost::optional<fdecl_t> get_func_decl() const {
+	return m_s->m_func_decl;
+      }
+
+      //! Return the id of a block: blocks are numbered from 0 to
+      //! size()-1
+      std::size_t id(basic_block_label_t bb) const {
+	return id_of(bb);
+      }
+
+      const_succ_range next_nodes(basic_block_label_t bb) const {
+	return boost::make_iterator_range(get_node(bb).next_blocks());
+      }
+
+      const_pred_range prev_nodes(basic_block_label_t bb) const {
+	return boost::make_iterator_range(get_node(bb).prev_blocks());
+      }
+
+      basic_block_t& get_node(basic_block_label_t bb) {
+	return m_s->m_blocks[id_of(bb)];
+      }
+
+      const basic_block_t& get_node(basic_block_label_t bb) const {
+	return m_s->m_blocks[id_of(bb)];
+      }
+
+      std::size_t size() const {
+	return m_s->m_blocks.size();
+      }
+
+      iterator begin() { return m_s->m_blocks.begin(); }
+      iterator end() { return m_s->m_blocks.end(); }
+      const_iterator begin() const { return m_s->m_blocks.begin(); }
+      const_iterator end() const { return m_s->m_blocks.end(); }
+
+      label_iterator label_begin() const { return m_s->m_labels.begin(); }
+      label_iterator label_end() const { return m_s->m_labels.end(); }
+
+      void write(crab_os& o) const {
+        if (get_func_decl()) {
+          o << *get_func_decl() << "\n";
+	}
+        print_block f(o);
+        dfs(f);
+      }
+
+      friend crab_os& operator<<(crab_os &o, const cfg_frozen_t &cfg) {
+        cfg.write(o);
+        return o;
+      }
+
+      // a frozen cfg cannot be modified
+      void simplify() { }
+    };
+
+    template<class CFG>
+    std::size_t hash_value(cfg_frozen<CFG> const& _cfg) {
+      auto fdecl = _cfg.get_func_decl();
+      if (!fdecl)
+        CRAB_ERROR("cannot hash a cfg because function declaration is missing");
+
+      return cfg_hasher<cfg_frozen<CFG> >::hash(*fdecl);
+    }
+
+    template<class CFG>
+    bool operator==(cfg_frozen<CFG> const& a, cfg_frozen<CFG> const& b) {
+      return hash_value(a) == hash_value(b);
+    }
+
+  } // end namespace cfg
+} // end namespace crab
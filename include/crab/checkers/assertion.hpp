@@ -36,6 +36,10 @@ namespace crab {
       
       assert_property_checker (int verbose = 0): base_checker_t (verbose) { }
       
+      virtual boost::shared_ptr<base_checker_t> clone () const override {
+        return boost::make_shared<assert_property_checker<Analyzer>> (this->m_verbose);
+      }
+
       virtual std::string get_property_name () const override {
         return "user-defined assertion checker using " + abs_dom_t::getDomainName ();
       }
@@ -85,7 +89,7 @@ namespace crab {
 	  LOG_WARN(this->m_verbose, inv, cst, s.get_debug_info());
 	  //LOG_ERR(this->m_verbose, inv, cst, s.get_debug_info());	  
         }
-        s.accept(&*this->m_abs_tr); // propagate invariants to the next stmt
+        this->propagate(s); // propagate invariants to the next stmt
       }
 
 
@@ -109,7 +113,7 @@ namespace crab {
 	  inv2.assume_bool(bvar, false /*is_negated*/);
 	  LOG_WARN(this->m_verbose, inv2, s, s.get_debug_info());
 	}
-        s.accept (&*this->m_abs_tr); // propagate invariants to the next stmt
+        this->propagate(s); // propagate invariants to the next stmt
       }
       
     }; 
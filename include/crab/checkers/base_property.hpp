@@ -196,140 +196,150 @@ namespace crab {
     abs_tr_t* m_abs_tr; // it can be null
     int m_verbose;
     checks_db m_db; // Store debug information about the checks
+    // If false then the statements are checked but m_abs_tr is not
+    // executed. Used when several checkers share the same transformer.
+    bool m_propagate;
+
+    template<typename Stmt>
+    void propagate(Stmt& s) {
+      if (m_propagate) {
+        s.accept(&*m_abs_tr);
+      }
+    }
    
     virtual void check(assert_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
 
     virtual void check(bin_op_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     } 
       
     virtual void check(assign_t& s) { 
       if(!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(assume_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
 
     virtual void check(select_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
 
     virtual void check(int_cast_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
     
     virtual void check(havoc_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(unreach_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
             
     virtual void check(callsite_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(return_t& s) {
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt 
+        this->propagate(s); // propagate m_inv to the next stmt 
     }
       
     virtual void check(arr_init_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
     
     virtual void check(arr_store_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(arr_load_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(ptr_store_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(ptr_load_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(ptr_assign_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(ptr_object_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(ptr_function_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(ptr_null_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(ptr_assume_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
       
     virtual void check(ptr_assert_t&s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
 
     virtual void check(bool_assert_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
 
     virtual void check(bool_bin_op_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     } 
       
     virtual void check(bool_assign_cst_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
 
     virtual void check(bool_assign_var_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
     
     virtual void check(bool_assume_t& s) { 
       if(!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
 
     virtual void check(bool_select_t& s) { 
       if (!this->m_abs_tr) return;        
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
     }
     
    public: 
@@ -364,14 +374,27 @@ namespace crab {
     
     property_checker(int verbose)
       : m_abs_tr(nullptr)
-      , m_verbose(verbose) { }
+      , m_verbose(verbose)
+      , m_propagate(true) { }
       
     
     void set(abs_tr_t* abs_tr) {
       m_abs_tr = abs_tr;
     }
+
+    void set_propagate(bool v) {
+      m_propagate = v;
+    }
+
+    // Return a fresh checker for the same property with an empty
+    // database or null if the checker cannot be copied.
+    virtual boost::shared_ptr<property_checker<Analyzer>> clone() const {
+      return nullptr;
+    }
     
     const checks_db& get_db() const { return m_db; }
+
+    void merge_db(const checks_db& db) { m_db += db; }
     
     checks_db get_db() { return m_db; }
 
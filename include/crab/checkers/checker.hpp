@@ -9,6 +9,10 @@
 #include <crab/checkers/base_property.hpp>
 #include <crab/analysis/fwd_analyzer.hpp>
 #include <crab/analysis/inter_fwd_analyzer.hpp>
+#include <crab/common/thread_pool.hpp>
+
+#include <algorithm>
+#include <functional>
 
 namespace crab {
 
@@ -22,6 +26,11 @@ namespace crab {
       checking for the properties. The analysis results are shared by
       all the property checkers so the analysis needs to be run only
       once.
+
+      If num_threads > 1 then blocks are checked concurrently. In that
+      mode all the property checkers are run in a single pass over
+      each block so the abstract transformer executes each statement
+      only once rather than once per checker.
      */
 
     checker(const checker<Analyzer>& other); // non construction copyable
@@ -35,10 +44,83 @@ namespace crab {
    protected:
 
     prop_checker_vector m_checkers;
+    unsigned int m_num_threads;
+
+    // Return a fresh copy of each property checker or an empty vector
+    // if some checker cannot be copied.
+    prop_checker_vector clone_checkers() const {
+      prop_checker_vector res;
+      for (auto prop_checker: m_checkers) {
+        auto c = prop_checker->clone();
+        if (!c) return prop_checker_vector();
+        res.push_back(c);
+      }
+      return res;
+    }
+
+    // Check all the properties in one pass over bb. abs_tr must be
+    // set to the invariants at the entry of bb.
+    template<typename BasicBlock, typename AbsTr>
+    static void check_block(BasicBlock& bb, AbsTr& abs_tr,
+			    prop_checker_vector& checkers) {
+      for (auto prop_checker: checkers) {
+	prop_checker->set(&abs_tr);
+	prop_checker->set_propagate(false);
+      }
+      for (auto &stmt: bb) {
+	for (auto prop_checker: checkers) {
+	  stmt.accept(&*prop_checker);
+	}
+	// propagate the invariants to the next statement
+	stmt.accept(&abs_tr);
+      }
+    }
+
+    // Call f(i, checkers) for all i in [0,n) using m_num_threads
+    // threads. Each task has its own copy of the checkers. Their
+    // databases are merged into m_checkers at the end. Return false
+    // (and do nothing) if the checkers cannot be copied.
+    bool run_parallel(std::size_t n,
+		      std::function<void(std::size_t, prop_checker_vector&)> f) {
+      std::size_t num_chunks = std::min<std::size_t>(n, 4 * m_num_threads);
+      std::vector<prop_checker_vector> chunk_checkers;
+      for (std::size_t c = 0; c < num_chunks; ++c) {
+	prop_checker_vector checkers = clone_checkers();
+	if (checkers.empty() && !m_checkers.empty()) {
+	  return false;
+	}
+	chunk_checkers.push_back(checkers);
+      }
+
+      CRAB_VERBOSE_IF(1, crab::outs() << "Checking " << n << " blocks with "
+		      << m_num_threads << " threads\n";);
+      {
+	crab::work_stealing_thread_pool pool(m_num_threads);
+	for (std::size_t c = 0; c < num_chunks; ++c) {
+	  pool.submit([&f, &chunk_checkers, c, n, num_chunks] {
+	      for (std::size_t i = c * n / num_chunks;
+		   i < (c + 1) * n / num_chunks; ++i) {
+		f(i, chunk_checkers[c]);
+	      }
+	    });
+	}
+	pool.wait();
+      }
+      
+      // merge in chunk order so that the result does not depend on
+      // the scheduling
+      for (auto &checkers: chunk_checkers) {
+	for (unsigned k = 0; k < m_checkers.size(); ++k) {
+	  m_checkers[k]->merge_db(checkers[k]->get_db());
+	}
+      }
+      return true;
+    }
     
    public:
 
-    checker(prop_checker_vector checkers): m_checkers(checkers) { }
+    checker(prop_checker_vector checkers, unsigned int num_threads = 1)
+      : m_checkers(checkers), m_num_threads(num_threads) { }
 
     virtual ~checker(){ }
     
@@ -74,14 +156,61 @@ namespace crab {
     typedef typename Analyzer::cfg_t cfg_t;
     typedef typename Analyzer::abs_dom_t abs_dom_t;
     typedef typename Analyzer::abs_tr_t abs_tr_t;
+    typedef typename cfg_t::basic_block_t basic_block_t;
 
     Analyzer& m_analyzer;
+    // whether the checks are made by the fixpoint
+    bool m_during_fixpoint;
 
+    bool run_parallel(cfg_t& cfg) {
+      std::vector<basic_block_t*> blocks;
+      for (auto &bb: cfg) {
+	blocks.push_back(&bb);
+      }
+      // each block gets its own copy of the abstract transformer
+      abs_dom_t top = abs_dom_t::top();
+      boost::shared_ptr<abs_tr_t> abs_tr = m_analyzer.get_abs_transformer(&top);
+      abs_tr_t proto(*abs_tr);
+      return base_checker_t::run_parallel
+	(blocks.size(),
+	 [this, &blocks, &proto](std::size_t i, prop_checker_vector& checkers) {
+	  basic_block_t& bb = *blocks[i];
+	  abs_dom_t inv = m_analyzer[bb.label()];
+	  abs_tr_t abs_tr(proto);
+	  abs_tr.set(&inv);
+	  base_checker_t::check_block(bb, abs_tr, checkers);
+	});
+    }
+    
    public:
 
-    intra_checker(Analyzer& analyzer, prop_checker_vector checkers)
-      : base_checker_t(checkers)
-      , m_analyzer(analyzer) { }
+    intra_checker(Analyzer& analyzer, prop_checker_vector checkers,
+		  unsigned int num_threads = 1)
+      : base_checker_t(checkers, num_threads)
+      , m_analyzer(analyzer)
+      , m_during_fixpoint(false) { }
+
+    virtual ~intra_checker() {
+      if (m_during_fixpoint) {
+	m_analyzer.set_process_pre(nullptr);
+      }
+    }
+
+    // Check the properties while the analyzer post-processes the
+    // invariants of its next runs. The checks are made from the
+    // invariants already computed by the fixpoint, with all the
+    // checkers in a single pass over each block, so run() must not
+    // be called. Blocks that are not reachable from the entry are
+    // not checked.
+    void check_during_fixpoint() {
+      m_during_fixpoint = true;
+      cfg_t cfg = m_analyzer.get_cfg();
+      m_analyzer.set_process_pre([this, cfg](typename cfg_t::basic_block_label_t b,
+					     abs_tr_t& abs_tr) mutable {
+	  crab::ScopedCrabStats __st__("Checker");
+	  base_checker_t::check_block(cfg.get_node(b), abs_tr, this->m_checkers);
+	});
+    }
       
     
     virtual void run() override {
@@ -89,6 +218,14 @@ namespace crab {
       crab::ScopedCrabStats __st__("Checker");
       cfg_t cfg = m_analyzer.get_cfg();
 
+      if (this->m_num_threads > 1) {
+	if (run_parallel(cfg)) {
+	  CRAB_VERBOSE_IF(1, crab::outs() << "Finished property checker.\n";);
+	  return;
+	}
+	CRAB_WARN("some property checker cannot be copied: checking sequentially");
+      }
+      
       for (auto &bb: cfg) {
         for (auto checker: this->m_checkers) {
           crab::ScopedCrabStats __st__("Checker." + checker->get_property_name());
@@ -122,17 +259,52 @@ namespace crab {
     typedef typename Analyzer::abs_dom_t abs_dom_t;
     typedef typename Analyzer::abs_tr_t abs_tr_t;
     
+    typedef typename cfg_t::basic_block_t basic_block_t;
+    
     Analyzer& m_analyzer;
+
+    bool run_parallel(cg_t& cg) {
+      std::vector<std::pair<cfg_t, basic_block_t*>> blocks;
+      for (auto &v: boost::make_iterator_range(vertices(cg))) {
+        cfg_t cfg = v.get_cfg();
+        for (auto &bb: cfg) {
+	  blocks.push_back(std::make_pair(cfg, &bb));
+	}
+      }
+      // each block gets its own copy of the abstract transformer
+      abs_dom_t top = abs_dom_t::top();
+      boost::shared_ptr<abs_tr_t> abs_tr = m_analyzer.get_abs_transformer(&top);
+      abs_tr_t proto(*abs_tr);
+      return base_checker_t::run_parallel
+	(blocks.size(),
+	 [this, &blocks, &proto](std::size_t i, prop_checker_vector& checkers) {
+	  basic_block_t& bb = *blocks[i].second;
+	  abs_dom_t inv = m_analyzer.get_pre(blocks[i].first, bb.label());
+	  abs_tr_t abs_tr(proto);
+	  abs_tr.set(&inv);
+	  base_checker_t::check_block(bb, abs_tr, checkers);
+	});
+    }
     
    public:
 
-    inter_checker(Analyzer& analyzer, prop_checker_vector checkers)
-        : base_checker_t(checkers), m_analyzer(analyzer) { }
+    inter_checker(Analyzer& analyzer, prop_checker_vector checkers,
+		  unsigned int num_threads = 1)
+        : base_checker_t(checkers, num_threads), m_analyzer(analyzer) { }
     
     virtual void run() override {
       CRAB_VERBOSE_IF(1, crab::outs() << "Started property checker.\n";);
       crab::ScopedCrabStats __st__("Checker");
       cg_t& cg = m_analyzer.get_call_graph(); 
+
+      if (this->m_num_threads > 1) {
+	if (run_parallel(cg)) {
+	  CRAB_VERBOSE_IF(1, crab::outs() << "Finished property checker.";);
+	  return;
+	}
+	CRAB_WARN("some property checker cannot be copied: checking sequentially");
+      }
+      
       for (auto &v: boost::make_iterator_range(vertices(cg))) {
         cfg_t cfg = v.get_cfg();
 
@@ -31,6 +31,10 @@ namespace crab {
       div_zero_property_checker(int verbose = 0)
           : base_checker_t(verbose) { }
       
+      boost::shared_ptr<base_checker_t> clone() const override {
+        return boost::make_shared<div_zero_property_checker<Analyzer>>(this->m_verbose);
+      }
+
       std::string get_property_name() const override {
         return "integer division by zero checker";
       }
@@ -77,7 +81,7 @@ namespace crab {
             CRAB_ERROR("DivZero only supports constant or single var as divisor.");
         }
 
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
       }      
 
   }; 
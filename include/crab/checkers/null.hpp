@@ -112,6 +112,10 @@ namespace crab {
       
       null_property_checker(int verbose = 0): base_checker_t(verbose) { }
       
+      boost::shared_ptr<base_checker_t> clone() const override {
+        return boost::make_shared<null_property_checker<Analyzer>>(this->m_verbose);
+      }
+
       std::string get_property_name() const override {
         return "null-dereference checker";
       }
@@ -137,7 +141,7 @@ namespace crab {
           //this->m_db.add(_WARN);
         }
         
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
       }
       
       void check(ptr_load_t &s) override { 
@@ -158,7 +162,7 @@ namespace crab {
           LOG_WARN(this->m_verbose, inv, checked_prop_str(ptr), s.get_debug_info());
         }
         
-        s.accept(&*this->m_abs_tr); // propagate m_inv to the next stmt
+        this->propagate(s); // propagate m_inv to the next stmt
       }
 
       
@@ -44,164 +44,283 @@
 #include <crab/common/debug.hpp>
 
 #include <climits>
+#include <string>
+#include <utility>
 #include <gmpxx.h>
 #include <boost/functional/hash.hpp>
 
 
 namespace ikos {
 
+/*
+ * Integers are stored inline in a signed long and only promoted to an
+ * mpz_class when they do not fit. The representation is canonical:
+ * _big is non-null iff the value does not fit into a signed long.
+ * Thus, most values never allocate and most operations never call
+ * GMP: the inline arithmetic is overflow-checked and falls back to
+ * mpz_class when it overflows.
+ */
 class z_number {
   friend class q_number;
 
 private:
-  mpz_class _n;
+  long _small;
+  mpz_class* _big;
+
+  static bool add_overflow(long x, long y, long* r) {
+    return __builtin_add_overflow(x, y, r);
+  }
+
+  static bool sub_overflow(long x, long y, long* r) {
+    return __builtin_sub_overflow(x, y, r);
+  }
+
+  static bool mul_overflow(long x, long y, long* r) {
+    return __builtin_mul_overflow(x, y, r);
+  }
+
+  static int sign(const mpz_class& n) { return sgn(n); }
+
+  bool is_small() const { return !_big; }
+
+  void set(const mpz_class& n) {
+    if (n.fits_slong_p()) {
+      delete _big;
+      _big = nullptr;
+      _small = n.get_si();
+    } else if (_big) {
+      *_big = n;
+    } else {
+      _big = new mpz_class(n);
+    }
+  }
+
+  mpz_class to_mpz() const {
+    if (is_small()) {
+      return mpz_class(_small);
+    } else {
+      return *_big;
+    }
+  }
+
+  // -1, 0, or 1 if this is smaller, equal, or greater than x
+  int compare(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return (_small < x._small ? -1 : (_small > x._small ? 1 : 0));
+    } else if (!is_small() && !x.is_small()) {
+      return cmp(*_big, *x._big);
+    } else if (!is_small()) {
+      // a big number is beyond any small one
+      return sign(*_big);
+    } else {
+      return -sign(*x._big);
+    }
+  }
 
 public:
 
-  z_number(mpz_class n) : _n(n) {}
+  z_number(mpz_class n) : _small(0), _big(nullptr) { set(n); }
 
   static z_number from_ulong(unsigned long n) {
-    mpz_class b(n);
-    return z_number(b);
+    if (n <= (unsigned long) LONG_MAX) {
+      return z_number((signed long long) n);
+    } else {
+      mpz_class b(n);
+      return z_number(b);
+    }
   }
 
   static z_number from_slong(signed long n) {
-    mpz_class b(n);
-    return z_number(b);
+    return z_number((signed long long) n);
   }
 
   // overloaded typecast operators
   explicit operator long() const { 
-    if (_n.fits_slong_p ()) {
-      return _n.get_si ();
+    if (is_small()) {
+      return _small;
     }
     else {
-      CRAB_ERROR("mpz_class ", _n.get_str(), " does not fit into a signed long integer");
+      CRAB_ERROR("mpz_class ", get_str(), " does not fit into a signed long integer");
     }
   } 
 
   explicit operator int() const { 
-    if (_n.fits_sint_p ()) {
-      // get_si returns a signed long so we cast it to int
-      return (int) _n.get_si ();
+    if (fits_sint()) {
+      return (int) _small;
     }
     else {
-      CRAB_ERROR("mpz_class ", _n.get_str(), " does not fit into a signed integer");
+      CRAB_ERROR("mpz_class ", get_str(), " does not fit into a signed integer");
     }
   } 
 
   explicit operator mpz_class() const { 
-    return _n;
+    return to_mpz();
   } 
 
 public:
 
-  z_number() : _n(0) {}
+  z_number() : _small(0), _big(nullptr) {}
 
-  z_number(std::string s) {
+  z_number(std::string s) : _small(0), _big(nullptr) {
     try {
-      this->_n = s;
+      set(mpz_class(s));
     } catch (std::invalid_argument& e) {
       CRAB_ERROR ("z_number: invalid string in constructor", s);
     }
   }
 
-  z_number(signed long long int n) : _n((signed long int) n) {
-    if (n > LONG_MAX) {
+  z_number(signed long long int n) : _small((signed long int) n), _big(nullptr) {
+    if (n > LONG_MAX || n < LONG_MIN) {
       CRAB_ERROR(n, " cannot fit into a signed long int: use another mpz_class constructor");
     }
   }
 
+  z_number(const z_number& o)
+    : _small(o._small), _big(o._big ? new mpz_class(*o._big) : nullptr) {}
+
+  z_number(z_number&& o) : _small(o._small), _big(o._big) {
+    o._big = nullptr;
+  }
+
+  z_number& operator=(const z_number& o) {
+    if (o.is_small()) {
+      delete _big;
+      _big = nullptr;
+      _small = o._small;
+    } else {
+      set(*o._big);
+    }
+    return *this;
+  }
+
+  z_number& operator=(z_number&& o) {
+    std::swap(_small, o._small);
+    std::swap(_big, o._big);
+    return *this;
+  }
+
+  ~z_number() { delete _big; }
+
   std::string get_str () const {
-    return _n.get_str();
+    return is_small() ? std::to_string(_small) : _big->get_str();
   }
 
   bool fits_sint() const {
-    return _n.fits_sint_p();
+    return is_small() && _small >= INT_MIN && _small <= INT_MAX;
   }
 
   bool fits_slong() const {
-    return _n.fits_slong_p();
+    return is_small();
   }
 
-  z_number operator+(z_number x) const {
-    mpz_class r = this->_n + x._n;
-    return z_number(r);
+  z_number operator+(const z_number& x) const {
+    long r;
+    if (is_small() && x.is_small() && !add_overflow(_small, x._small, &r)) {
+      return z_number((signed long long) r);
+    }
+    mpz_class b = to_mpz() + x.to_mpz();
+    return z_number(b);
   }
 
-  z_number operator*(z_number x) const {
-    mpz_class r = this->_n * x._n;
-    return z_number(r);
+  z_number operator*(const z_number& x) const {
+    long r;
+    if (is_small() && x.is_small() && !mul_overflow(_small, x._small, &r)) {
+      return z_number((signed long long) r);
+    }
+    mpz_class b = to_mpz() * x.to_mpz();
+    return z_number(b);
   }
 
-  z_number operator-(z_number x) const {
-    mpz_class r = this->_n - x._n;
-    return z_number(r);
+  z_number operator-(const z_number& x) const {
+    long r;
+    if (is_small() && x.is_small() && !sub_overflow(_small, x._small, &r)) {
+      return z_number((signed long long) r);
+    }
+    mpz_class b = to_mpz() - x.to_mpz();
+    return z_number(b);
   }
 
   z_number operator-() const {
-    mpz_class r = -this->_n;
-    return z_number(r);
+    if (is_small() && _small != LONG_MIN) {
+      return z_number((signed long long) -_small);
+    }
+    mpz_class b = -to_mpz();
+    return z_number(b);
   }
 
-  z_number operator/(z_number x) const {
-    if (x._n == 0) {
+  z_number operator/(const z_number& x) const {
+    if (x == 0) {
       CRAB_ERROR("z_number: division by zero [1]");
+    } else if (is_small() && x.is_small() && 
+	       !(_small == LONG_MIN && x._small == -1)) {
+      // both truncate towards zero
+      return z_number((signed long long) (_small / x._small));
     } else {
-      mpz_class r = this->_n / x._n;
-      return z_number(r);
+      mpz_class b = to_mpz() / x.to_mpz();
+      return z_number(b);
     }
   }
 
-  z_number operator%(z_number x) const {
-    if (x._n == 0) {
+  z_number operator%(const z_number& x) const {
+    if (x == 0) {
       CRAB_ERROR("z_number: division by zero [2]");
+    } else if (is_small() && x.is_small()) {
+      // the remainder has the sign of the dividend in both cases
+      return z_number((signed long long) (x._small == -1 ? 0 : _small % x._small));
     } else {
-      mpz_class r = this->_n % x._n;
-      return z_number(r);
+      mpz_class b = to_mpz() % x.to_mpz();
+      return z_number(b);
     }
   }
 
-  z_number& operator+=(z_number x) {
-    this->_n += x._n;
+  z_number& operator+=(const z_number& x) {
+    *this = *this + x;
     return *this;
   }
 
-  z_number& operator*=(z_number x) {
-    this->_n *= x._n;
+  z_number& operator*=(const z_number& x) {
+    *this = *this * x;
     return *this;
   }
 
-  z_number& operator-=(z_number x) {
-    this->_n -= x._n;
+  z_number& operator-=(const z_number& x) {
+    *this = *this - x;
     return *this;
   }
 
-  z_number& operator/=(z_number x) {
-    if (x._n == 0) {
+  z_number& operator/=(const z_number& x) {
+    if (x == 0) {
       CRAB_ERROR("z_number: division by zero [3]");
     } else {
-      this->_n /= x._n;
+      *this = *this / x;
       return *this;
     }
   }
 
-  z_number& operator%=(z_number x) {
-    if (x._n == 0) {
+  z_number& operator%=(const z_number& x) {
+    if (x == 0) {
       CRAB_ERROR("z_number: division by zero [4]");
     } else {
-      this->_n %= x._n;
+      *this = *this % x;
       return *this;
     }
   }
 
   z_number& operator--() {
-    --(this->_n);
+    if (is_small() && _small != LONG_MIN) {
+      --_small;
+    } else {
+      set(to_mpz() - 1);
+    }
     return *this;
   }
 
   z_number& operator++() {
-    ++(this->_n);
+    if (is_small() && _small != LONG_MAX) {
+      ++_small;
+    } else {
+      set(to_mpz() + 1);
+    }
     return *this;
   }
 
@@ -217,50 +336,102 @@ public:
     return r;
   }
 
-  bool operator==(z_number x) const { return this->_n == x._n; }
+  bool operator==(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return _small == x._small;
+    } else {
+      return compare(x) == 0;
+    }
+  }
 
-  bool operator!=(z_number x) const { return this->_n != x._n; }
+  bool operator!=(const z_number& x) const { return !operator==(x); }
 
-  bool operator<(z_number x) const { return this->_n < x._n; }
+  bool operator<(const z_number& x) const { return compare(x) < 0; }
 
-  bool operator<=(z_number x) const { return this->_n <= x._n; }
+  bool operator<=(const z_number& x) const { return compare(x) <= 0; }
 
-  bool operator>(z_number x) const { return this->_n > x._n; }
+  bool operator>(const z_number& x) const { return compare(x) > 0; }
 
-  bool operator>=(z_number x) const { return this->_n >= x._n; }
+  bool operator>=(const z_number& x) const { return compare(x) >= 0; }
 
-  z_number operator&(z_number x) const { return z_number(this->_n & x._n); }
+  // bitwise operations follow two's complement semantics as mpz_class
+  z_number operator&(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return z_number((signed long long) (_small & x._small));
+    }
+    mpz_class b = to_mpz() & x.to_mpz();
+    return z_number(b);
+  }
 
-  z_number operator|(z_number x) const { return z_number(this->_n | x._n); }
+  z_number operator|(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return z_number((signed long long) (_small | x._small));
+    }
+    mpz_class b = to_mpz() | x.to_mpz();
+    return z_number(b);
+  }
 
-  z_number operator^(z_number x) const { return z_number(this->_n ^ x._n); }
+  z_number operator^(const z_number& x) const {
+    if (is_small() && x.is_small()) {
+      return z_number((signed long long) (_small ^ x._small));
+    }
+    mpz_class b = to_mpz() ^ x.to_mpz();
+    return z_number(b);
+  }
 
-  z_number operator<<(z_number x) const {
+  z_number operator<<(const z_number& x) const {
+    long r;
+    if (is_small() && x.is_small() && x._small >= 0 && 
+	x._small < (long) (sizeof(long) * CHAR_BIT - 1) &&
+	!mul_overflow(_small, 1L << x._small, &r)) {
+      return z_number((signed long long) r);
+    }
     mpz_t tmp;
     mpz_init(tmp);
-    mpz_mul_2exp(tmp, this->_n.get_mpz_t(), mpz_get_ui(x._n.get_mpz_t()));
+    mpz_class n = to_mpz();
+    mpz_class s = x.to_mpz();
+    mpz_mul_2exp(tmp, n.get_mpz_t(), mpz_get_ui(s.get_mpz_t()));
     mpz_class result(tmp);
+    mpz_clear(tmp);
     return z_number(result);
   }
 
-  z_number operator>>(z_number x) const {
-    mpz_class tmp(this->_n);
-    return z_number(tmp.operator>>=(mpz_get_ui(x._n.get_mpz_t())));
+  z_number operator>>(const z_number& x) const {
+    if (is_small() && x.is_small() && x._small >= 0) {
+      // mpz_class rounds towards minus infinity
+      if (x._small >= (long) (sizeof(long) * CHAR_BIT)) {
+	return z_number((signed long long) (_small < 0 ? -1 : 0));
+      } else if (_small >= 0) {
+	return z_number((signed long long) (_small >> x._small));
+      } else {
+	return z_number((signed long long) (~(~_small >> x._small)));
+      }
+    }
+    mpz_class tmp = to_mpz();
+    mpz_class s = x.to_mpz();
+    return z_number(tmp.operator>>=(mpz_get_ui(s.get_mpz_t())));
   }
 
   z_number fill_ones() const {
-    assert(this->_n >= 0);
-    if (this->_n == 0) {
+    assert(*this >= 0);
+    if (*this == 0) {
       return z_number(0);
     }
 
+    mpz_class n = to_mpz();
     mpz_class result;
-    for (result = 1; result < this->_n; result = 2 * result + 1)
+    for (result = 1; result < n; result = 2 * result + 1)
       ;
     return z_number(result);
   }
 
-  void write(crab::crab_os& o) { o << this->_n.get_str(); }
+  void write(crab::crab_os& o) { 
+    if (is_small()) {
+      o << _small;
+    } else {
+      o << _big->get_str();
+    }
+  }
 
 }; // class z_number
 
@@ -270,8 +441,12 @@ inline crab::crab_os& operator<<(crab::crab_os& o, z_number z) {
 }
 
 inline std::size_t hash_value(const z_number& n) {
-  boost::hash<std::string> hasher;
-  return hasher(n.get_str());
+  if (n.fits_slong()) {
+    return boost::hash_value((long) n);
+  } else {
+    boost::hash<std::string> hasher;
+    return hasher(n.get_str());
+  }
 }
 
 class q_number {
@@ -295,9 +470,11 @@ public:
 
   q_number(double n): _n(n) { this->_n.canonicalize(); }
   
-  q_number(z_number n) : _n(n._n) { this->_n.canonicalize(); }
+  q_number(z_number n) : _n(n.to_mpz()) { this->_n.canonicalize(); }
 
-  q_number(z_number n, z_number d) : _n(n._n, d._n) { this->_n.canonicalize(); }
+  q_number(z_number n, z_number d) : _n(n.to_mpz(), d.to_mpz()) {
+    this->_n.canonicalize();
+  }
 
   explicit operator mpq_class() const { 
     return _n;
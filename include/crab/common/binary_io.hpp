@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+   Helpers to encode and decode the binary files written by crab
+   (e.g., the summary cache and the invariant tables).
+
+   Integers are LEB128 varints and strings are length-prefixed. The
+   decoding functions never read past end and return false if the
+   input is truncated or malformed.
+ */
+
+#include <crab/common/bignums.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace crab {
+
+  namespace binary_io {
+
+    inline void put_varint(std::string &buf, uint64_t v) {
+      while (v >= 0x80) {
+        buf.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+      }
+      buf.push_back(static_cast<char>(v));
+    }
+
+    inline void put_string(std::string &buf, const std::string &s) {
+      put_varint(buf, s.size());
+      buf.append(s);
+    }
+
+    inline bool get_varint(const char *&p, const char *end, uint64_t &v) {
+      v = 0;
+      for (unsigned shift = 0; p != end && shift < 64; shift += 7) {
+        uint64_t b = static_cast<unsigned char>(*p++);
+        v |= (b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+      }
+      return false;
+    }
+
+    inline bool get_string(const char *&p, const char *end, std::string &s) {
+      uint64_t n;
+      if (!get_varint(p, end, n) || n > static_cast<uint64_t>(end - p))
+        return false;
+      s.assign(p, n);
+      p += n;
+      return true;
+    }
+
+    // Return true if s is a decimal integer as printed by get_str()
+    inline bool is_integer(const std::string &s) {
+      std::size_t i = (!s.empty() && s[0] == '-') ? 1 : 0;
+      if (i == s.size()) return false;
+      for (; i < s.size(); ++i) {
+        if (s[i] < '0' || s[i] > '9') return false;
+      }
+      return true;
+    }
+
+    // Return true if s is an integer or a fraction with a non-zero
+    // denominator
+    inline bool is_rational(const std::string &s) {
+      std::size_t d = s.find('/');
+      if (d == std::string::npos) return is_integer(s);
+      std::string den = s.substr(d + 1);
+      return is_integer(s.substr(0, d)) && is_integer(den) && den[0] != '-' &&
+             den.find_first_not_of('0') != std::string::npos;
+    }
+
+    // Return true if a Number can be built from s without error
+    template<typename Number>
+    inline bool is_number(const std::string &s);
+
+    template<>
+    inline bool is_number<ikos::z_number>(const std::string &s) {
+      return is_integer(s);
+    }
+
+    template<>
+    inline bool is_number<ikos::q_number>(const std::string &s) {
+      return is_rational(s);
+    }
+
+  } // end namespace binary_io
+} // end namespace crab
@@ -39,11 +39,15 @@ inline void ___print___(ArgTypes... args) {
   (void)expand_variadic_pack{0, ((crab::errs() << args), void(), 0)... };
 }
 
+// outs() is flushed first so that the message is printed after
+// any buffered output.
 #define CRAB_ERROR(...)              \
   do {                               \
+    crab::outs().flush();            \
     crab::errs() << "CRAB ERROR: ";  \
     crab::___print___(__VA_ARGS__);  \
     crab::errs() << "\n";            \
+    crab::errs().flush();            \
     std::exit (EXIT_FAILURE);        \
   } while (0)
 
@@ -54,6 +58,7 @@ void CrabEnableWarningMsg(bool b);
 #define CRAB_WARN(...)                  \
   do {				        \
     if (::crab::CrabWarningFlag) {	\
+      crab::outs().flush();		\
       crab::errs() << "CRAB WARNING: ";	\
       crab::___print___(__VA_ARGS__);	\
       crab::errs() << "\n";		\
@@ -1,6 +1,7 @@
 #pragma once 
 
 #include <iosfwd>
+#include <string>
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
 
@@ -8,6 +9,10 @@ namespace crab {
   
   // An adaptor for std::ostream that avoids polluting all crab header
   // files with iostream stuff
+  //
+  // By default, the stream is flushed after each write. In buffered
+  // mode, it is only flushed by flush(), on destruction, and before
+  // any message is printed by CRAB_ERROR and CRAB_WARN.
   class crab_os: boost::noncopyable {
      
    private:
@@ -20,9 +25,18 @@ namespace crab {
     static boost::shared_ptr<crab_os> cout();
     static boost::shared_ptr<crab_os> cerr();
 
+    // Redirect outs() to os. If os is null then outs() prints again
+    // to std::cout.
+    static void set_cout(boost::shared_ptr<crab_os> os);
+
    private:
     
     std::ostream* m_os;
+    bool m_buffered;
+    
+    void write_done();
+
+    friend class crab_file_os;
     
    protected:
 
@@ -30,9 +44,15 @@ namespace crab {
 
    public:
 
-    crab_os(std::ostream* os);    
+    crab_os(std::ostream* os, bool buffered = false);
 
     virtual ~crab_os();
+
+    void set_buffered(bool b);
+
+    bool is_buffered() const { return m_buffered; }
+
+    virtual void flush();
     
     virtual crab_os& operator<<(char C);
     virtual crab_os& operator<<(unsigned char C);
@@ -52,6 +72,22 @@ namespace crab {
   extern crab_os& outs();
   extern crab_os& errs();
 
+  // An adaptor for std::ofstream. The output is buffered.
+  class crab_file_os: public crab_os {
+
+    std::ofstream* m_file_os;
+
+    crab_file_os(std::ofstream* os);
+
+   public:
+
+    crab_file_os(const std::string& filename);
+
+    ~crab_file_os();
+
+    bool is_open() const;
+  };
+
   // An adaptor for std::ostringstream
   class crab_string_os: public crab_os {
 
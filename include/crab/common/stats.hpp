@@ -3,8 +3,8 @@
 /* Code from SeaHorn */
 
 #include <map>
-#include <sys/time.h>
-#include <sys/resource.h>
+#include <string>
+#include <time.h>
 
 #include <crab/config.h>
 #include <crab/common/types.hpp>
@@ -12,6 +12,9 @@
 namespace crab
 {
 
+  /** Interned name of a counter or timer **/
+  typedef unsigned stats_id_t;
+
 #ifdef HAVE_STATS
   class Stopwatch
   {
@@ -22,11 +25,10 @@ namespace crab
 
     long systemTime () const
     {
-      struct rusage ru;
-      getrusage (RUSAGE_SELF, &ru);
-      long r = ru.ru_utime.tv_sec * 1000000L + ru.ru_utime.tv_usec;
+      struct timespec ts;
+      clock_gettime (CLOCK_MONOTONIC, &ts);
+      long r = ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
       return r;
-
     }
 
   public:
@@ -91,6 +93,8 @@ namespace crab
       return avg;
     }
 
+    double get () const { return avg; }
+
     void Print (crab_os &out) const;
 
   };
@@ -111,6 +115,7 @@ namespace crab
   public :
    Averager () {}
    double add (double k) { return 0.0;}
+   double get () const { return 0.0;}
    void Print (crab_os &out) const {}
   };
 
@@ -135,36 +140,61 @@ namespace crab
     return OS;
   }
 
+  /**
+   * Counters and timers are identified by interned names
+   * (stats_id_t). Each thread updates its own counters and timers
+   * without any synchronization and the values of all threads are
+   * merged when they are read (get, Print, PrintBrunch).
+   *
+   * Timers use a monotonic clock. Besides the flat timers, each
+   * thread keeps a tree of the timers that are active at the same
+   * time (e.g., a domain operation called while Fixpo.analyze_block
+   * is running) which is printed by Print.
+   *
+   * The methods taking a string intern the name on every call (this
+   * is cheap but not free). Hot code should use CRAB_STATS_ID so that
+   * the name is interned only once.
+   **/
   class CrabStats
   {
-  private:
-    static std::map<std::string,unsigned> counters;
-    static std::map<std::string,Stopwatch> sw;
-    static std::map<std::string,Averager> av;
-    static std::map<std::string,std::string> ss;
-
   public:
+    /** Return the unique id of name **/
+    static stats_id_t intern (const std::string &name);
+    static std::string name (stats_id_t id);
+    
     static void reset();
     static unsigned  get (const std::string &n);
+    static unsigned  get (stats_id_t id);
     static double avg (const std::string &n, double v);
     static unsigned uset (const std::string &n, unsigned v);
+    static unsigned uset (stats_id_t id, unsigned v);
 
     static void sset (const std::string &n, std::string v);
     static std::string& sget (const std::string &n);
     
     static void count (const std::string &name);
+    static void count (stats_id_t id);
     static void count_max (const std::string &name, unsigned v);
+    static void count_max (stats_id_t id, unsigned v);
 
     static void start (const std::string &name);
+    static void start (stats_id_t id);
     static void stop (const std::string &name);
+    static void stop (stats_id_t id);
     static void resume (const std::string &name);
+    static void resume (stats_id_t id);
 
     /** Outputs all statistics to std output */
     static void Print (crab_os &OS);
     static void PrintBrunch (crab_os &OS);
-  };
-
 
+    /** All statistics by kind, without going through their printed
+        form. Timers are in seconds. **/
+    static void get_all (std::map<std::string, unsigned> &counters,
+			 std::map<std::string, double> &timers,
+			 std::map<std::string, double> &averages,
+			 std::map<std::string, std::string> &strings);
+  };
 
   /**
       Usage: add
@@ -203,39 +233,57 @@ namespace crab
   
   class ScopedCrabStats 
   {
-    std::string m_name;
+    stats_id_t m_id;
   public:
-    ScopedCrabStats (const std::string &name, bool reset = false) : m_name(name) 
+    ScopedCrabStats (const std::string &name, bool reset = false)
     { 
       if (reset) 
         { 
-          m_name += ".last";
-          CrabStats::start (m_name);
+          m_id = CrabStats::intern (name + ".last");
+          CrabStats::start (m_id);
         }
       else
-        CrabStats::resume (m_name); 
+	{
+	  m_id = CrabStats::intern (name);
+	  CrabStats::resume (m_id);
+	}
     }
-    ~ScopedCrabStats () { CrabStats::stop (m_name); }
+    ScopedCrabStats (stats_id_t id) : m_id(id)
+    { CrabStats::resume (m_id); }
+    ~ScopedCrabStats () { CrabStats::stop (m_id); }
   };  
 #else
   inline crab_os &operator<< (crab_os &OS, const Stopwatch &sw){ return OS;}
   inline crab_os &operator<< (crab_os &OS, const Averager &av){ return OS;}
   struct CrabStats
   {
+    static stats_id_t intern (const std::string &name) { return 0;}
+    static std::string name (stats_id_t id) { return "";}
     static void reset(){}    
     static unsigned  get (const std::string &n){ return 0;}
+    static unsigned  get (stats_id_t id){ return 0;}
     static double avg (const std::string &n, double v){ return 0.0;}
     static unsigned uset (const std::string &n, unsigned v){return 0;}
+    static unsigned uset (stats_id_t id, unsigned v){return 0;}
     static void sset (const std::string &n, std::string v){}
     static std::string& sget (const std::string &n)
     { CRAB_ERROR("Stats::sget not implemented");}
     static void count (const std::string &name){}
+    static void count (stats_id_t id){}
     static void count_max (const std::string &name, unsigned v){}
+    static void count_max (stats_id_t id, unsigned v){}
     static void start (const std::string &name){}
+    static void start (stats_id_t id){}
     static void stop (const std::string &name){}
+    static void stop (stats_id_t id){}
     static void resume (const std::string &name){}
+    static void resume (stats_id_t id){}
     static void Print (crab_os &OS){}
     static void PrintBrunch (crab_os &OS){}
+    static void get_all (std::map<std::string, unsigned> &counters,
+			 std::map<std::string, double> &timers,
+			 std::map<std::string, double> &averages,
+			 std::map<std::string, std::string> &strings) {}
   };
   template <typename Output>
   struct TimeIt
@@ -245,10 +293,26 @@ namespace crab
   struct ScopedCrabStats 
   {
     ScopedCrabStats (const std::string &name, bool reset = false) {}
+    ScopedCrabStats (stats_id_t id) {}
   };  
 #endif 
 }
 
+/**
+ * CRAB_STATS_ID(NAME) interns NAME the first time the expression is
+ * evaluated and returns the cached id afterwards. NAME must not
+ * change between evaluations (e.g., getDomainName() + ".join" is fine
+ * since it is fixed for each template instance).
+ **/
+#ifdef HAVE_STATS
+#define CRAB_STATS_ID(NAME)                                                  \
+  ([&]() -> crab::stats_id_t {                                               \
+    static const crab::stats_id_t __id__ = crab::CrabStats::intern(NAME);    \
+    return __id__; }())
+#else
+#define CRAB_STATS_ID(NAME) crab::stats_id_t(0)
+#endif 
+
 #define CRAB_MEASURE_FN crab::ScopedCrabStats __stats__(__FUNCTION__)
 #define CRAB_MEASURE_FN_LAST crab::ScopedCrabStats __stats_last__(__FUNCTION__, true)
 
@@ -0,0 +1,164 @@
+#pragma once
+
+/* A small work-stealing thread pool */
+
+#include <crab/common/debug.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace crab {
+
+  /**
+   * Each worker owns a deque of tasks. A worker pops from the back
+   * of its own deque (LIFO, good locality for tasks spawned by the
+   * task that just finished) and, when its deque is empty, steals
+   * from the front of the other workers' deques.
+   *
+   * Tasks submitted from a worker go to that worker's deque. Tasks
+   * submitted from outside the pool are distributed round-robin.
+   **/
+  class work_stealing_thread_pool: public boost::noncopyable {
+  public:
+    typedef std::function<void()> task_t;
+
+  private:
+    struct worker_queue {
+      std::mutex m_mutex;
+      std::deque<task_t> m_tasks;
+    };
+
+    std::vector<std::unique_ptr<worker_queue>> m_queues;
+    std::vector<std::thread> m_workers;
+    // protect sleeping workers and waiters
+    std::mutex m_mutex;
+    std::condition_variable m_task_cv;
+    std::condition_variable m_done_cv;
+    // number of tasks sitting in some deque
+    std::atomic<unsigned> m_queued;
+    // number of tasks submitted but not finished yet
+    std::atomic<unsigned> m_pending;
+    std::atomic<unsigned> m_next_queue;
+    bool m_shutdown;
+
+    // pool and index of the worker running in the current thread
+    static std::pair<const work_stealing_thread_pool*, unsigned>& current_worker() {
+      static thread_local std::pair<const work_stealing_thread_pool*, unsigned>
+	w(nullptr, 0);
+      return w;
+    }
+
+    bool pop(unsigned i, task_t &task) {
+      { // own deque first
+	worker_queue &q = *m_queues[i];
+	std::lock_guard<std::mutex> lock(q.m_mutex);
+	if (!q.m_tasks.empty()) {
+	  task = std::move(q.m_tasks.back());
+	  q.m_tasks.pop_back();
+	  --m_queued;
+	  return true;
+	}
+      }
+      for (unsigned k = 1, n = m_queues.size(); k < n; ++k) {
+	worker_queue &q = *m_queues[(i + k) % n];
+	std::lock_guard<std::mutex> lock(q.m_mutex);
+	if (!q.m_tasks.empty()) {
+	  task = std::move(q.m_tasks.front());
+	  q.m_tasks.pop_front();
+	  --m_queued;
+	  return true;
+	}
+      }
+      return false;
+    }
+
+    void run_worker(unsigned i) {
+      current_worker() = std::make_pair(this, i);
+      while (true) {
+	task_t task;
+	if (pop(i, task)) {
+	  task();
+	  if (--m_pending == 0) {
+	    std::lock_guard<std::mutex> lock(m_mutex);
+	    m_done_cv.notify_all();
+	  }
+	} else {
+	  std::unique_lock<std::mutex> lock(m_mutex);
+	  m_task_cv.wait(lock, [this] { return m_shutdown || m_queued > 0; });
+	  if (m_shutdown && m_queued == 0) {
+	    break;
+	  }
+	}
+      }
+    }
+
+  public:
+
+    explicit work_stealing_thread_pool(unsigned num_threads)
+      : m_queued(0), m_pending(0), m_next_queue(0), m_shutdown(false) {
+      if (num_threads == 0) {
+	CRAB_ERROR("thread pool needs at least one thread");
+      }
+      for (unsigned i = 0; i < num_threads; ++i) {
+	m_queues.emplace_back(new worker_queue());
+      }
+      for (unsigned i = 0; i < num_threads; ++i) {
+	m_workers.emplace_back(&work_stealing_thread_pool::run_worker, this, i);
+      }
+    }
+
+    ~work_stealing_thread_pool() {
+      {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_shutdown = true;
+      }
+      m_task_cv.notify_all();
+      for (auto &w : m_workers) {
+	w.join();
+      }
+    }
+
+    unsigned size() const {
+      return m_workers.size();
+    }
+
+    void submit(task_t task) {
+      unsigned i;
+      if (current_worker().first == this) {
+	i = current_worker().second;
+      } else {
+	i = m_next_queue++ % m_queues.size();
+      }
+      ++m_pending;
+      {
+	// taking the lock avoids a lost wake-up between the check of
+	// m_queued and the wait in run_worker.
+	std::lock_guard<std::mutex> lock(m_mutex);
+	++m_queued;
+      }
+      {
+	worker_queue &q = *m_queues[i];
+	std::lock_guard<std::mutex> lock(q.m_mutex);
+	q.m_tasks.push_back(std::move(task));
+      }
+      m_task_cv.notify_one();
+    }
+
+    // Block until all submitted tasks (and the tasks they submit)
+    // have finished. Must not be called from a worker.
+    void wait() {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_done_cv.wait(lock, [this] { return m_pending == 0; });
+    }
+
+  }; // class work_stealing_thread_pool
+
+} // end namespace crab
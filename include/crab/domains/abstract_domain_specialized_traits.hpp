@@ -203,6 +203,43 @@ namespace crab {
      }
    };
 
+   // Special operations for applying the transfer functions of a
+   // whole basic block at once.
+   template<typename Domain>
+   class block_domain_traits {
+    public:
+     typedef typename Domain::linear_constraint_system_t linear_constraint_system_t;
+
+     // Add the constraints of a run of consecutive assume
+     // statements. By default, they are added one by one so the
+     // result is exactly the one of applying each statement
+     // separately. Domains that can add a constraint system more
+     // efficiently without changing the result should specialize
+     // this.
+     static void add_constraints(Domain& dom, const linear_constraint_system_t& csts) {
+       for (auto const& cst: csts) {
+	 dom += cst;
+       }
+     }
+   };
+
+   // Special operations for weak updates of summarized variables.
+   template<typename Domain>
+   class weak_update_domain_traits {
+    public:
+     typedef typename Domain::variable_t variable_t;
+     typedef typename Domain::linear_expression_t linear_expression_t;
+
+     // Join dom with the result of x := e in dom. By default, the
+     // whole state is copied and joined back. Domains that can join
+     // only the constraints on x should specialize this.
+     static void weak_assign(Domain& dom, const variable_t& x, const linear_expression_t& e) {
+       Domain other(dom);
+       other.assign(x, e);
+       dom = dom | other;
+     }
+   };
+
    // Experimental (TO BE REMOVED):
    // 
    // Special operations needed by array_sparse_graph domain's
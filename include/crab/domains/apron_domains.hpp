@@ -784,8 +784,8 @@ namespace crab {
             m_apstate(apPtr(get_man(), ap_abstract0_copy(get_man(), &*(o.m_apstate)))),
             m_var_map(o.m_var_map)
         {  
-          crab::CrabStats::count(getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
         }
 
         apron_domain_(apron_domain_t&& o): 
@@ -793,8 +793,8 @@ namespace crab {
             m_var_map(std::move(o.m_var_map)) { }
         
         apron_domain_t& operator=(const apron_domain_t& o) {
-          crab::CrabStats::count(getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
           if (this != &o) {
             m_apstate = apPtr(get_man(), ap_abstract0_copy(get_man(), &*(o.m_apstate)));
             m_var_map = o.m_var_map;
@@ -829,8 +829,8 @@ namespace crab {
         }
 
         bool operator<=(apron_domain_t o) { 
-          crab::CrabStats::count(getDomainName() + ".count.leq");
-          crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
 
           if (is_bottom()) 
             return true;
@@ -850,8 +850,8 @@ namespace crab {
         }
 
         void operator|=(apron_domain_t o) {
-          crab::CrabStats::count(getDomainName() + ".count.join");
-          crab::ScopedCrabStats __st__(getDomainName() + ".join");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
 
           if (is_bottom() || o.is_top())
             *this = o;
@@ -866,8 +866,8 @@ namespace crab {
         }
         
         apron_domain_t operator|(apron_domain_t o) {
-          crab::CrabStats::count(getDomainName() + ".count.join");
-          crab::ScopedCrabStats __st__(getDomainName() + ".join");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
 
           if(is_bottom() || o.is_top())
             return o;
@@ -883,8 +883,8 @@ namespace crab {
         }        
         
         apron_domain_t operator&(apron_domain_t o) {
-          crab::CrabStats::count(getDomainName() + ".count.meet");
-          crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
 
           if (is_bottom() || o.is_bottom())
             return apron_domain_t::bottom();
@@ -902,8 +902,8 @@ namespace crab {
         }        
         
         apron_domain_t operator||(apron_domain_t o) {
-          crab::CrabStats::count(getDomainName() + ".count.widening");
-          crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
           if (is_bottom())
             return o;
@@ -927,8 +927,8 @@ namespace crab {
 	
         template<typename Thresholds>
         apron_domain_t widening_thresholds(apron_domain_t o, const Thresholds &ts) {
-          crab::CrabStats::count(getDomainName() + ".count.widening");
-          crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
           if (is_bottom())
             return o;
@@ -971,8 +971,8 @@ namespace crab {
         }
 
         apron_domain_t operator&&(apron_domain_t o) {
-          crab::CrabStats::count(getDomainName() + ".count.narrowing");
-          crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
 
 	  if (is_bottom() || o.is_bottom())
             return apron_domain_t::bottom();
@@ -1001,8 +1001,8 @@ namespace crab {
         }        
 
         void forget(const variable_vector_t& vars) {
-          crab::CrabStats::count(getDomainName() + ".count.forget");
-          crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 
           std::vector<ap_dim_t> vector_dims;
           std::set<ap_dim_t> set_dims;
@@ -1065,8 +1065,8 @@ namespace crab {
 
         // remove all variables except vars
         void project(const variable_vector_t& vars) {
-          crab::CrabStats::count(getDomainName() + ".count.project");
-          crab::ScopedCrabStats __st__(getDomainName() + ".project");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
           if (is_bottom()) return;
           std::set<variable_t> s1,s2;
@@ -1078,8 +1078,8 @@ namespace crab {
         }
 
         interval_t operator[](variable_t v) {
-          crab::CrabStats::count(getDomainName() + ".count.to_intervals");
-          crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.to_intervals"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_intervals"));
 
           if(is_bottom()) 
             return interval_t::bottom();
@@ -1157,8 +1157,8 @@ namespace crab {
         }
 
         void set(variable_t v, interval_t ival) {
-          crab::CrabStats::count(getDomainName() + ".count.assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
 	  variable_t vv(v);
 	  
@@ -1187,8 +1187,8 @@ namespace crab {
         }
 
         void operator+=(linear_constraint_system_t _csts) {
-          crab::CrabStats::count(getDomainName() + ".count.add_constraints");
-          crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
 
           if(is_bottom()) return;
 
@@ -1271,8 +1271,8 @@ namespace crab {
         }
        
         void assign(variable_t x, linear_expression_t e) {
-          crab::CrabStats::count(getDomainName() + ".count.assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
           if(is_bottom()) return;
 
@@ -1290,8 +1290,8 @@ namespace crab {
         }
           
         void apply(operation_t op, variable_t x, variable_t y, number_t z) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
           if(is_bottom()) return;
 
@@ -1334,8 +1334,8 @@ namespace crab {
         }
         
         void apply(operation_t op, variable_t x, variable_t y, variable_t z) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
           if(is_bottom()) return;
 
@@ -1384,8 +1384,8 @@ namespace crab {
 	}
 
         void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
           // Convert to intervals and perform the operation
           interval_t yi = operator[](y);
@@ -1404,8 +1404,8 @@ namespace crab {
         }
         
         void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
           // Convert to intervals and perform the operation
           interval_t yi = operator[](y);
@@ -1425,8 +1425,8 @@ namespace crab {
         
         void backward_assign(variable_t x, linear_expression_t e,
 			      apron_domain_t invariant) {
-          crab::CrabStats::count(getDomainName() + ".count.backward_assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".backward_assign");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_assign"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_assign"));
 
           if(is_bottom()) return;
 
@@ -1452,8 +1452,8 @@ namespace crab {
           
         void backward_apply(operation_t op, variable_t x, variable_t y, number_t z,
 			    apron_domain_t invariant) {
-          crab::CrabStats::count(getDomainName() + ".count.backward_apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".backward_apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_apply"));
 
           if(is_bottom()) return;
 
@@ -1504,8 +1504,8 @@ namespace crab {
         void backward_apply(operation_t op,
 			    variable_t x, variable_t y, variable_t z,
 			    apron_domain_t invariant)  {
-          crab::CrabStats::count(getDomainName() + ".count.backward_apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".backward_apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_apply"));
 
           if(is_bottom()) return;
 
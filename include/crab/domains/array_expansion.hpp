@@ -812,19 +812,19 @@ namespace domains {
     
     array_expansion_domain(const array_expansion_domain_t& other)
       : _inv(other._inv) {  
-      crab::CrabStats::count(getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
     }
 
     array_expansion_domain(const array_expansion_domain_t&& other)
       : _inv(std::move(other._inv)) {  
-      crab::CrabStats::count(getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
     }
     
     array_expansion_domain_t& operator=(const array_expansion_domain_t& other) {
-      crab::CrabStats::count(getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
       if(this != &other) {
 	_inv = other._inv;
       }
@@ -832,8 +832,8 @@ namespace domains {
     }
 
     array_expansion_domain_t& operator=(const array_expansion_domain_t&& other) {
-      crab::CrabStats::count(getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
       if (this != &other) {
 	_inv = std::move(other._inv);
       }
@@ -849,8 +849,8 @@ namespace domains {
     }
        
     bool operator<=(array_expansion_domain_t other) {
-      crab::CrabStats::count(getDomainName() + ".count.leq");
-      crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
       
       return (_inv <= other._inv);
     }
@@ -860,27 +860,27 @@ namespace domains {
     }
     
     void operator|=(array_expansion_domain_t other) {
-      crab::CrabStats::count(getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
       _inv |= other._inv;
     }
        
     array_expansion_domain_t operator|(array_expansion_domain_t other) {
-      crab::CrabStats::count(getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
       return array_expansion_domain_t(_inv | other._inv);
     }
        
     array_expansion_domain_t operator&(array_expansion_domain_t other) {
-      crab::CrabStats::count(getDomainName() + ".count.meet");
-      crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
       
       return array_expansion_domain_t(_inv & other._inv);
     }
        
     array_expansion_domain_t operator||(array_expansion_domain_t other) {
-      crab::CrabStats::count(getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
       
       return array_expansion_domain_t(_inv || other._inv);
     }
@@ -888,21 +888,21 @@ namespace domains {
     template<typename Thresholds>
     array_expansion_domain_t widening_thresholds(array_expansion_domain_t other, 
 						  const Thresholds &ts) {
-      crab::CrabStats::count(getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
       return array_expansion_domain_t(_inv.widening_thresholds(other._inv, ts));
     }
     
     array_expansion_domain_t operator&&(array_expansion_domain_t other) {
-      crab::CrabStats::count(getDomainName() + ".count.narrowing");
-      crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
       return array_expansion_domain_t(_inv && other._inv);
     }
         
        
     void forget(const variable_vector_t& variables) {
-      crab::CrabStats::count(getDomainName() + ".count.forget");
-      crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 
       if (is_bottom() || is_top()) {
 	return;
@@ -918,8 +918,8 @@ namespace domains {
     }
        
     void project(const variable_vector_t& variables) {
-      crab::CrabStats::count(getDomainName() + ".count.project");
-      crab::ScopedCrabStats __st__(getDomainName() + ".project");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
       if (is_bottom() || is_top()) {
 	return;
@@ -943,8 +943,8 @@ namespace domains {
     }
     
     void operator +=(linear_constraint_system_t csts) {
-      crab::CrabStats::count(getDomainName() + ".count.add_constraints");
-      crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
       
       _inv += csts;
       
@@ -953,8 +953,8 @@ namespace domains {
     }
        
     void operator-=(variable_t var) {
-      crab::CrabStats::count(getDomainName() + ".count.forget");
-      crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
       
       if (var.is_array_type()) {
 	remove_array_map(var);
@@ -964,8 +964,8 @@ namespace domains {
     }
        
     void assign(variable_t x, linear_expression_t e) {
-      crab::CrabStats::count(getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
       
       _inv.assign(x, e);
          
@@ -974,8 +974,8 @@ namespace domains {
     }
        
     void apply(operation_t op, variable_t x, variable_t y, number_t z) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
       
       _inv.apply(op, x, y, z);
          
@@ -985,8 +985,8 @@ namespace domains {
     }
        
     void apply(operation_t op, variable_t x, variable_t y, variable_t z) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
       
       _inv.apply(op, x, y, z);
           
@@ -1013,15 +1013,15 @@ namespace domains {
     }
        
     void apply(int_conv_operation_t op, variable_t dst, variable_t src) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
       
       _inv.apply(op, dst, src);
     }
        
     void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
       
       _inv.apply(op, x, y, z);
 	 
@@ -1031,8 +1031,8 @@ namespace domains {
     }
        
     void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
       
       _inv.apply(op, x, y, k);
 	 
@@ -1120,8 +1120,8 @@ namespace domains {
 			     linear_expression_t lb_idx,
 			     linear_expression_t ub_idx, 
 			     linear_expression_t val) override {
-      crab::CrabStats::count(getDomainName() + ".count.array_init");
-      crab::ScopedCrabStats __st__(getDomainName() + ".array_init");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.array_init"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".array_init"));
 
       if (is_bottom()) return;
       
@@ -1137,8 +1137,8 @@ namespace domains {
     virtual void array_load(variable_t lhs, variable_t a,
 			     linear_expression_t elem_size,
 			     linear_expression_t i) override {
-      crab::CrabStats::count(getDomainName() + ".count.load");
-      crab::ScopedCrabStats __st__(getDomainName() + ".load");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.load"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".load"));
 
       if (is_bottom()) return;
 
@@ -1191,8 +1191,8 @@ namespace domains {
     virtual void array_store(variable_t a, linear_expression_t elem_size,
 			      linear_expression_t i, linear_expression_t val, 
 			      bool /*is_singleton*/) override {
-      crab::CrabStats::count(getDomainName() + ".count.store");
-      crab::ScopedCrabStats __st__(getDomainName() + ".store");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.store"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".store"));
 
       if (is_bottom()) return;
 
@@ -1256,8 +1256,8 @@ namespace domains {
 				   linear_expression_t ub_idx, 
 				   linear_expression_t val) override {
 
-      crab::CrabStats::count(getDomainName() + ".count.array_store");
-      crab::ScopedCrabStats __st__(getDomainName() + ".array_store");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.array_store"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".array_store"));
 
       if (is_bottom()) return;
       
@@ -1313,8 +1313,8 @@ namespace domains {
     }
        
     linear_constraint_system_t to_linear_constraint_system(){
-      crab::CrabStats::count(getDomainName() + ".count.to_linear_constraints");
-      crab::ScopedCrabStats __st__(getDomainName() + ".to_linear_constraints");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.to_linear_constraints"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_linear_constraints"));
       
       return _inv.to_linear_constraint_system();
     }
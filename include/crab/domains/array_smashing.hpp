@@ -77,6 +77,13 @@ namespace crab {
         }
         
         void weak_update(variable_t a, linear_expression_t rhs) {
+	  if (a.get_type() == ARR_INT_TYPE || a.get_type() == ARR_REAL_TYPE) {
+	    // Only the constraints on a change so the domain can join
+	    // them without copying the whole state.
+	    weak_update_domain_traits<NumDomain>::weak_assign(_inv, a, rhs);
+	    return;
+	  }
+
           NumDomain other(_inv);
 
 	  if (a.get_type() == ARR_BOOL_TYPE) {
@@ -88,8 +95,6 @@ namespace crab {
 	    } else if (auto rhs_v = rhs.get_variable()) {
 	      other.assign_bool_var(a,(*rhs_v), false);
 	    }
-	  } else if (a.get_type() == ARR_INT_TYPE || a.get_type() == ARR_REAL_TYPE) {
-            other.assign(a, rhs);
 	  } else if (a.get_type() == ARR_PTR_TYPE) {
 	    if(rhs.is_constant() && rhs.constant() == number_t(0))
 	      other.pointer_mk_null(a);
@@ -116,13 +121,13 @@ namespace crab {
         
         array_smashing(const array_smashing_t& other): 
 	  _inv(other._inv) { 
-          crab::CrabStats::count(getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
         }
         
         array_smashing_t& operator=(const array_smashing_t& other) {
-          crab::CrabStats::count(getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
           if (this != &other)
             _inv = other._inv;
           return *this;
@@ -354,8 +359,8 @@ namespace crab {
         virtual void array_load(variable_t lhs,
 				 variable_t a, linear_expression_t /*elem_size*/,
                                  linear_expression_t i) override {
-          crab::CrabStats::count(getDomainName() + ".count.load");
-          crab::ScopedCrabStats __st__(getDomainName() + ".load");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.load"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".load"));
 
           // We need to be careful when assigning a summarized variable a
           // into a non-summarized variable lhs. Simply _inv.assign(lhs,
@@ -382,8 +387,8 @@ namespace crab {
         virtual void array_store(variable_t a, linear_expression_t /*elem_size*/,
                                   linear_expression_t i, linear_expression_t val, 
                                   bool is_singleton) override {
-          crab::CrabStats::count(getDomainName() + ".count.store");
-          crab::ScopedCrabStats __st__(getDomainName() + ".store");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.store"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".store"));
 
           if (is_singleton) {
             strong_update(a, val);
@@ -399,8 +404,8 @@ namespace crab {
         virtual void array_store_range(variable_t a, linear_expression_t /*elem_size*/,
 				       linear_expression_t i, linear_expression_t j,
 				       linear_expression_t val) override {
-          crab::CrabStats::count(getDomainName() + ".count.store");
-          crab::ScopedCrabStats __st__(getDomainName() + ".store");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.store"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".store"));
 	  weak_update(a, val);
           
           CRAB_LOG("smashing",
@@ -1808,12 +1808,12 @@ namespace crab {
       void array_init(variable_t arr, T1 src, T2 dst, linear_expression_t val)
       {
         if (!is_landmark(src)) {
-          crab::outs() << "WARNING no landmark found for " << src << "\n";
+          CRAB_WARN("no landmark found for ", src);
           return;
         }
 
         if (!is_landmark(dst)) {
-          crab::outs() << "WARNING no landmark found for " << dst << "\n";
+          CRAB_WARN("no landmark found for ", dst);
           return;
         }
        
@@ -1843,8 +1843,8 @@ namespace crab {
       // whenever an edge becomes bottom closure is also happening.
       // Return false if bottom is detected during the reduction.
       bool reduce(NumDom &scalar, array_sgraph_t &g) {
-        crab::CrabStats::count(getDomainName() + ".count.reduce");
-        crab::ScopedCrabStats __st__(getDomainName() + ".reduce");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.reduce"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".reduce"));
 
         scalar.normalize();
         g.normalize();
@@ -1912,8 +1912,8 @@ namespace crab {
 
       array_sparse_graph_domain(const array_sgraph_domain_t&o)
           : _scalar(o._scalar), _expressions(o._expressions), _g(o._g) { 
-        crab::CrabStats::count(getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
       }
 
       array_sparse_graph_domain(array_sgraph_domain_t &&o)
@@ -1923,8 +1923,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t& operator=(const array_sgraph_domain_t& o) {
-        crab::CrabStats::count(getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
         if(this != &o) {
           _scalar = o._scalar;
           _expressions = o._expressions;
@@ -1949,8 +1949,8 @@ namespace crab {
       }
 
       bool operator<=(array_sgraph_domain_t o) {
-        crab::CrabStats::count(getDomainName() + ".count.leq");
-        crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs() << "Leq " << *this << " and\n"  << o << "=\n";);
@@ -1966,8 +1966,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t operator|(array_sgraph_domain_t o){
-        crab::CrabStats::count(getDomainName() + ".count.join");
-        crab::ScopedCrabStats __st__(getDomainName() + ".join");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs() << "Join " << *this << " and "  << o << "=\n");
@@ -1981,8 +1981,8 @@ namespace crab {
       template<typename Thresholds>
       array_sgraph_domain_t widening_thresholds(array_sgraph_domain_t& o, 
                                                  const Thresholds & ts) {
-        crab::CrabStats::count(getDomainName() + ".count.widening");
-        crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
           CRAB_LOG("array-sgraph-domain",
                    crab::outs() << "Widening (w/ thresholds) " << *this << " and "
@@ -2001,8 +2001,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t operator||(array_sgraph_domain_t o){
-        crab::CrabStats::count(getDomainName() + ".count.widening");
-        crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs() << "Widening " << *this << " and "  << o << "=\n");        
@@ -2020,8 +2020,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t operator&(array_sgraph_domain_t o){
-        crab::CrabStats::count(getDomainName() + ".count.meet");
-        crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs() << "Meet " << *this << " and "  << o << "=\n");
@@ -2039,8 +2039,8 @@ namespace crab {
       }
 
       array_sgraph_domain_t operator&&(array_sgraph_domain_t o){
-        crab::CrabStats::count(getDomainName() + ".count.narrowing");
-        crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
 
         CRAB_LOG("array-sgraph-domain",
                  crab::outs() << "Narrowing " << *this << " and "  << o << "=\n");
@@ -2058,8 +2058,8 @@ namespace crab {
       }
 
       void operator-=(variable_t v) {
-        crab::CrabStats::count(getDomainName() + ".count.forget");
-        crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 
         if (is_bottom())
           return;
@@ -2078,8 +2078,8 @@ namespace crab {
 
 
       void project(const variable_vector_t& variables) {
-        crab::CrabStats::count(getDomainName() + ".count.project");
-        crab::ScopedCrabStats __st__(getDomainName() + ".project");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
         if (is_bottom() || is_top()) {
 	  return;
@@ -2121,8 +2121,8 @@ namespace crab {
       
       void operator+=(linear_constraint_system_t csts) 
       {
-        crab::CrabStats::count(getDomainName() + ".count.add_constraints");
-        crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
 
         if (is_bottom()) return;
         
@@ -2148,8 +2148,8 @@ namespace crab {
       // will lose precision in the array graph. This kind of
       // assignments should be managed by the apply methods instead.
       void assign(variable_t x, linear_expression_t e, bool update_expressions)  {
-        crab::CrabStats::count(getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
         if (is_bottom()) return;
 
@@ -2184,8 +2184,8 @@ namespace crab {
 
       void apply(operation_t op, variable_t x, variable_t y, number_t z) {
         if(x == y) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
           _expressions.apply(op, x, y, z);
           apply_one_variable<number_t>(op, x, z);
           CRAB_LOG("array-sgraph-domain",
@@ -2211,8 +2211,8 @@ namespace crab {
       
       void apply(operation_t op, variable_t x, variable_t y, variable_t z)  {
         if (x==y) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
           _expressions.apply(op, x, y, z);
           apply_one_variable<variable_t>(op, x, z);
           CRAB_LOG("array-sgraph-domain", 
@@ -2306,8 +2306,8 @@ namespace crab {
       // bitwise operations
       
       void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-        crab::CrabStats::count(getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         _expressions.apply(op, x, y, z);
         // XXX: we give up soundly in the graph domain
@@ -2315,8 +2315,8 @@ namespace crab {
       }
       
       void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-        crab::CrabStats::count(getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         _expressions.apply(op, x, y, k);
         // XXX: we give up soundly in the graph domain
@@ -2388,8 +2388,8 @@ namespace crab {
       virtual void array_load(variable_t lhs,
 			       variable_t a, linear_expression_t elem_size,
                                linear_expression_t i) override  {
-        crab::CrabStats::count(getDomainName() + ".count.load");
-        crab::ScopedCrabStats __st__(getDomainName() + ".load");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.load"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".load"));
 
         auto vi = i.get_variable();
         if (!vi) {
@@ -2454,8 +2454,8 @@ namespace crab {
       virtual void array_store(variable_t a, linear_expression_t elem_size,
                                 linear_expression_t i, linear_expression_t val, 
 				bool /*is_singleton*/) override {
-        crab::CrabStats::count(getDomainName() + ".count.store");
-        crab::ScopedCrabStats __st__(getDomainName() + ".store");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.store"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".store"));
 
         auto vi = i.get_variable();
         if (!vi) {
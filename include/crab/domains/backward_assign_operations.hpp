@@ -46,8 +46,8 @@ namespace crab {
       // pre: dom is not bottom
       static void assign(AbsDom& dom, variable_t x, linear_expression_t e,
 			 AbsDom inv) {
-	crab::CrabStats::count (AbsDom::getDomainName() + ".count.backward_assign");
-	crab::ScopedCrabStats __st__(AbsDom::getDomainName() + ".backward_assign");
+	crab::CrabStats::count (CRAB_STATS_ID(AbsDom::getDomainName() + ".count.backward_assign"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID(AbsDom::getDomainName() + ".backward_assign"));
 	
 	if(dom.is_bottom()) return;
 	
@@ -65,8 +65,8 @@ namespace crab {
       // pre: dom is not bottom
       static void apply(AbsDom& dom, operation_t op, variable_t x, variable_t y, number_t k,
 			AbsDom inv) {
-	crab::CrabStats::count (AbsDom::getDomainName() + ".count.backward_apply");
-	crab::ScopedCrabStats __st__(AbsDom::getDomainName() + ".backward_apply");
+	crab::CrabStats::count (CRAB_STATS_ID(AbsDom::getDomainName() + ".count.backward_apply"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID(AbsDom::getDomainName() + ".backward_apply"));
 	
 	if(dom.is_bottom()) {
 	  return;
@@ -124,8 +124,8 @@ namespace crab {
       static void apply(AbsDom& dom, operation_t op,
 			variable_t x, variable_t y, variable_t z,
 			AbsDom inv) {
-	crab::CrabStats::count (AbsDom::getDomainName() + ".count.backward_apply");
-	crab::ScopedCrabStats __st__(AbsDom::getDomainName() + ".backward_apply");
+	crab::CrabStats::count (CRAB_STATS_ID(AbsDom::getDomainName() + ".count.backward_apply"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID(AbsDom::getDomainName() + ".backward_apply"));
 	
 	if(dom.is_bottom()) {
 	  return;
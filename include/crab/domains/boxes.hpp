@@ -401,8 +401,8 @@ namespace crab {
 	  if (!x) {
 	    // XXX: if we copy the SPECIAL var to v we forget the SPECIAL
 	    //      var after we copy.
-	    crab::CrabStats::count(getDomainName() + ".count.forget");
-	    crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+	    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+	    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 	    int dim = 0; // SPECIAL variable is dim 0
 	    m_ldd =  lddPtr(get_ldd_man(), 
 			     Ldd_ExistsAbstract(get_ldd_man(), &*m_ldd, dim));
@@ -692,8 +692,8 @@ namespace crab {
         }
 
 	interval_domain_t to_intervals(LddNodePtr &ldd) {
-          crab::CrabStats::count(getDomainName() + ".count.to_intervals");
-          crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.to_intervals"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_intervals"));
 
           if (&*ldd == Ldd_GetFalse(get_ldd_man())) 
             return interval_domain_t::bottom();
@@ -929,16 +929,16 @@ namespace crab {
         boxes_domain_(const boxes_domain_t& other): 
 	  m_ldd(other.m_ldd)
 	  /* m_ldd(lddPtr(get_ldd_man(), &(*other.m_ldd))) */{ 
-          crab::CrabStats::count(getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
         }
 
         boxes_domain_(boxes_domain_t&& other):
 	  m_ldd(std::move(other.m_ldd)) { }  
 	
         boxes_domain_t& operator=(const boxes_domain_t& other) {
-          crab::CrabStats::count(getDomainName() + ".count.copy");
-          crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
           if (this != &other) {
 	    m_ldd = other.m_ldd;	    
             //m_ldd = lddPtr(get_ldd_man(), &(*other.m_ldd));
@@ -955,8 +955,8 @@ namespace crab {
         }
         
         bool operator<=(boxes_domain_t other) {
-          crab::CrabStats::count(getDomainName() + ".count.leq");
-          crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
 
           bool res = Ldd_TermLeq(get_ldd_man(), &(*m_ldd), &(*other.m_ldd));
 
@@ -971,15 +971,15 @@ namespace crab {
         }
         
         boxes_domain_t operator|(boxes_domain_t other) {
-          crab::CrabStats::count(getDomainName() + ".count.join");
-          crab::ScopedCrabStats __st__(getDomainName() + ".join");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
 
           return boxes_domain_t(join(m_ldd, other.m_ldd));
         }
         
         boxes_domain_t operator&(boxes_domain_t other) {
-          crab::CrabStats::count(getDomainName() + ".count.meet");
-          crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
 
           return boxes_domain_t(lddPtr(get_ldd_man(), 
                                          Ldd_And(get_ldd_man(),
@@ -987,8 +987,8 @@ namespace crab {
         }
 
         boxes_domain_t operator||(boxes_domain_t other) {
-          crab::CrabStats::count(getDomainName() + ".count.widening");
-          crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
           // It is not necessarily true that the new value is bigger
           // than the old value so we apply 
@@ -1026,8 +1026,8 @@ namespace crab {
         }
         
         boxes_domain_t operator&&(boxes_domain_t other) {
-          crab::CrabStats::count(getDomainName() + ".count.narrowing");
-          crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
 
           boxes_domain_t res(*this & other);
           //CRAB_WARN(" boxes narrowing operator replaced with meet");
@@ -1040,8 +1040,8 @@ namespace crab {
         }
 
 	boxes_domain_t complement() const {
-          crab::CrabStats::count(getDomainName() + ".count.complement");
-          crab::ScopedCrabStats __st__(getDomainName() + ".complement");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.complement"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".complement"));
 	  LddNodePtr w = lddPtr(get_ldd_man(), Ldd_Not(&*m_ldd));
 	  boxes_domain_t res(w);
           CRAB_LOG("boxes",
@@ -1054,8 +1054,8 @@ namespace crab {
 	}
 	
         void operator-=(variable_t var) {
-          crab::CrabStats::count(getDomainName() + ".count.forget");
-          crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 
           if (is_bottom() || is_top()) return;
 
@@ -1065,8 +1065,8 @@ namespace crab {
         }
 
         void forget(const variable_vector_t& variables) {
-          crab::CrabStats::count(getDomainName() + ".count.forget");
-          crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 	  
           if (is_bottom() || is_top()) return;
 
@@ -1082,8 +1082,8 @@ namespace crab {
         }
 
         void project(const variable_vector_t& variables) {
-          crab::CrabStats::count(getDomainName() + ".count.project");
-          crab::ScopedCrabStats __st__(getDomainName() + ".project");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
           if (is_bottom() || is_top()) return;
 
@@ -1096,8 +1096,8 @@ namespace crab {
         }
 
 	void expand(variable_t v, variable_t new_v) {
-          crab::CrabStats::count(getDomainName() + ".count.expand");
-          crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
 
           if (is_top() || is_bottom()) return ;
 	  
@@ -1114,8 +1114,8 @@ namespace crab {
 	}
 	  
         void operator+=(linear_constraint_t cst) {
-          crab::CrabStats::count(getDomainName() + ".count.add_constraints");
-          crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
 
           if (is_bottom() || cst.is_tautology())  
             return;
@@ -1170,8 +1170,8 @@ namespace crab {
         }
 
         void set(variable_t v, interval_t ival) {
-          crab::CrabStats::count(getDomainName() + ".count.assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
           
           if (is_bottom()) return ;
 
@@ -1192,8 +1192,8 @@ namespace crab {
         }
 
         interval_t operator[](variable_t v) {
-          crab::CrabStats::count(getDomainName() + ".count.to_intervals");
-          crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.to_intervals"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_intervals"));
 
           if (is_bottom()) 
             return interval_t::bottom();
@@ -1212,8 +1212,8 @@ namespace crab {
                 
 	// x := e
         void assign(variable_t x, linear_expression_t e) {
-          crab::CrabStats::count(getDomainName() + ".count.assign");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 	  
           if (is_bottom()) 
             return;
@@ -1245,8 +1245,8 @@ namespace crab {
 
 	// x := y op k
         void apply(operation_t op, variable_t x, variable_t y, number_t k) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
           if (is_bottom()) {
             return;
@@ -1297,8 +1297,8 @@ namespace crab {
 
 	// x := y op z
         void apply(operation_t op, variable_t x, variable_t y, variable_t z) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 	  
           if (is_bottom()) {
 	    return;
@@ -1434,8 +1434,8 @@ namespace crab {
         }
 	
         void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
           if (is_bottom()) 
             return;
@@ -1456,8 +1456,8 @@ namespace crab {
         }
         
         void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-          crab::CrabStats::count(getDomainName() + ".count.apply");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
           if (is_bottom()) 
             return;
@@ -1484,8 +1484,8 @@ namespace crab {
 	{
 	  if (!m_bool_reasoning) return;
 	  
-          crab::CrabStats::count(getDomainName() + ".count.assign_bool_cst");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign_bool_cst");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign_bool_cst"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign_bool_cst"));
 	  
 	  if (is_bottom()) return;
 	  
@@ -1540,8 +1540,8 @@ namespace crab {
 	void assign_bool_var(variable_t x, variable_t y, bool is_not_y) override {
 	  if (!m_bool_reasoning) return;
 	  
-          crab::CrabStats::count(getDomainName() + ".count.assign_bool_var");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assign_bool_var");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign_bool_var"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign_bool_var"));
 
 	  if (is_not_y)
 	    apply_ldd(x, y, number_t(-1), number_t(1));
@@ -1561,8 +1561,8 @@ namespace crab {
 			       variable_t y, variable_t z) override {
 	  if (!m_bool_reasoning) return;
 	  
-          crab::CrabStats::count(getDomainName() + ".count.apply_bin_bool");
-          crab::ScopedCrabStats __st__(getDomainName() + ".apply_bin_bool");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply_bin_bool"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply_bin_bool"));
 	  
 	  // XXX: if *lhs is null then it represents the SPECIAL
 	  // variable $0.
@@ -1595,8 +1595,8 @@ namespace crab {
 	void assume_bool(variable_t x, bool is_negated) override {
 	  if (!m_bool_reasoning) return;
 	  
-          crab::CrabStats::count(getDomainName() + ".count.assume_bool");
-          crab::ScopedCrabStats __st__(getDomainName() + ".assume_bool");
+          crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assume_bool"));
+          crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assume_bool"));
 	  
 	  m_ldd = lddPtr(get_ldd_man(),
 			  Ldd_And(get_ldd_man(), &*m_ldd,
@@ -664,8 +664,8 @@ namespace crab {
       }
 
       void reduce_variable(const variable_t& v) {
-        crab::CrabStats::count(getDomainName() + ".count.reduce");
-        crab::ScopedCrabStats __st__(getDomainName() + ".reduce");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.reduce"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".reduce"));
 
         if(!is_bottom() && !Params::disable_reduction) {
 	  
@@ -1359,8 +1359,8 @@ namespace crab {
           _product(product) {}
       
       void reduce_variable(const variable_t& v) {
-        crab::CrabStats::count(getDomainName() + ".count.reduce");
-        crab::ScopedCrabStats __st__(getDomainName() + ".reduce");
+        crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.reduce"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".reduce"));
 
         if (is_bottom())
           return;
@@ -195,11 +195,18 @@ public:
     }
   }
 
-  bool operator==(congruence_t o) {
-    return _a == o._a && _b == o._b && is_bottom() == o.is_bottom();
+  bool operator==(const congruence_t& o) const {
+    return _a == o._a && _b == o._b && _is_bottom == o._is_bottom;
   }
 
-  bool operator!=(congruence_t x) { return !this->operator==(x); }
+  bool operator!=(const congruence_t& x) const { return !this->operator==(x); }
+
+  friend std::size_t hash_value(const congruence_t& c) {
+    std::size_t h = boost::hash_value(c._is_bottom);
+    boost::hash_combine(h, c._a);
+    boost::hash_combine(h, c._b);
+    return h;
+  }
 
   // Lattice Operations
 
@@ -842,13 +849,13 @@ public:
 
   congruence_domain(const congruence_domain_t& e)
       : _env(e._env) {
-    crab::CrabStats::count (getDomainName() + ".count.copy");
-    crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
   }
 
   congruence_domain_t& operator=(const congruence_domain_t& o) {
-    crab::CrabStats::count (getDomainName() + ".count.copy");
-    crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
     if (this != &o)
       this->_env = o._env;
     return *this;
@@ -863,32 +870,32 @@ public:
   bool is_top() { return this->_env.is_top(); }
 
   bool operator<=(congruence_domain_t e) { 
-    crab::CrabStats::count (getDomainName() + ".count.leq");
-    crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.leq"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
     return this->_env <= e._env; 
   }
 
   void operator|=(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.join");
-    crab::ScopedCrabStats __st__(getDomainName() + ".join");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.join"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
     this->_env = this->_env | e._env;
   }
 
   congruence_domain_t operator|(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.join");
-    crab::ScopedCrabStats __st__(getDomainName() + ".join");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.join"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
     return this->_env | e._env;
   }
 
   congruence_domain_t operator&(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.meet");
-    crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.meet"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
     return this->_env & e._env;
   }
 
   congruence_domain_t operator||(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.widening");
-    crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.widening"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
     return this->_env || e._env;
   }
 
@@ -899,26 +906,26 @@ public:
   }
 
   congruence_domain_t operator&&(congruence_domain_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.narrowing");
-    crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
     return this->_env && e._env;
   }
 
   void set(variable_t v, congruence_t i) { 
-    crab::CrabStats::count (getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
     this->_env.set(v, i); 
   }
 
   void set(variable_t v, number_t n) {
-    crab::CrabStats::count (getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
     this->_env.set(v, congruence_t(n)); 
   }
 
   void operator-=(variable_t v) { 
-    crab::CrabStats::count (getDomainName() + ".count.forget");
-    crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.forget"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
     this->_env -= v; 
   }
 
@@ -943,8 +950,8 @@ public:
   }
 
   void add(linear_constraint_system_t csts) {
-    crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-    crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
     const std::size_t threshold = 10;
     if (!this->is_bottom()) {
       solver_t solver(csts, threshold);
@@ -963,8 +970,8 @@ public:
   }
 
   void assign(variable_t x, linear_expression_t e) {
-    crab::CrabStats::count (getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
     congruence_t r = e.constant();
     for (typename linear_expression_t::iterator it = e.begin(); it != e.end();
@@ -975,8 +982,8 @@ public:
   }
 
   void apply(operation_t op, variable_t x, variable_t y, variable_t z) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
     congruence_t yi = this->_env[y];
     congruence_t zi = this->_env[z];
@@ -1011,8 +1018,8 @@ public:
   }
 
   void apply(operation_t op, variable_t x, variable_t y, number_t k) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
     congruence_t yi = this->_env[y];
     congruence_t zi(k);
@@ -1078,8 +1085,8 @@ public:
   // bitwise operations
   
   void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
     congruence_t yi = this->_env[y];
     congruence_t zi = this->_env[z];
@@ -1116,8 +1123,8 @@ public:
   }
 
   void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-    crab::CrabStats::count (getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
     congruence_t yi = this->_env[y];
     congruence_t zi(k);
@@ -1203,8 +1210,8 @@ public:
   }
 
   void project(const variable_vector_t& variables){
-    crab::CrabStats::count(getDomainName() + ".count.project");
-    crab::ScopedCrabStats __st__(getDomainName() + ".project");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
     
     if (is_bottom() || is_top()) {
       return;
@@ -1218,8 +1225,8 @@ public:
   }
   
   void expand(variable_t x, variable_t new_x) {
-    crab::CrabStats::count(getDomainName() + ".count.expand");
-    crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
     
     if (is_bottom() || is_top()) {
       return;
@@ -1117,13 +1117,13 @@ namespace crab {
 
      dis_interval_domain(const dis_interval_domain_t& o): 
        _env(o._env) { 
-       crab::CrabStats::count(getDomainName() + ".count.copy");
-       crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
      }
      
      dis_interval_domain_t& operator=(const dis_interval_domain_t& o) {
-       crab::CrabStats::count(getDomainName() + ".count.copy");
-       crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
        if (this != &o)
          this->_env = o._env;
        return *this;
@@ -1146,8 +1146,8 @@ namespace crab {
      }
 
      bool operator<=(dis_interval_domain_t e) {
-       crab::CrabStats::count(getDomainName() + ".count.leq");
-       crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
 
        //crab::outs() << "*** Leq " << *this << " and " << e << "\n";
        bool res = this->_env <= e._env;
@@ -1160,8 +1160,8 @@ namespace crab {
      }
      
      dis_interval_domain_t operator|(dis_interval_domain_t e) {
-       crab::CrabStats::count(getDomainName() + ".count.join");
-       crab::ScopedCrabStats __st__(getDomainName() + ".join");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
 
        //crab::outs() << "*** Join " << *this << " and " << e << "\n";
        dis_interval_domain_t res(this->_env | e._env);
@@ -1170,8 +1170,8 @@ namespace crab {
      }
      
      dis_interval_domain_t operator&(dis_interval_domain_t e) {
-       crab::CrabStats::count(getDomainName() + ".count.meet");
-       crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
 
        //crab::outs() << "*** Meet " << *this << " and " << e << "\n";
        dis_interval_domain_t res(this->_env & e._env);
@@ -1180,8 +1180,8 @@ namespace crab {
      }
 
      dis_interval_domain_t operator||(dis_interval_domain_t e) {
-       crab::CrabStats::count(getDomainName() + ".count.widening");
-       crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
        //crab::outs() << "*** Widening " << *this << " and " << e << "\n";
        dis_interval_domain_t res(this->_env || e._env);
@@ -1191,8 +1191,8 @@ namespace crab {
      
      template<typename Thresholds>
      dis_interval_domain_t widening_thresholds(dis_interval_domain_t e, const Thresholds &ts) {
-       crab::CrabStats::count(getDomainName() + ".count.widening");
-       crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
        //crab::outs() << "*** Widening w/ thresholds " << *this << " and " << e << "\n";
        dis_interval_domain_t res = this->_env.widening_thresholds(e._env, ts);
@@ -1201,8 +1201,8 @@ namespace crab {
      }
      
      dis_interval_domain_t operator&&(dis_interval_domain_t e) {
-       crab::CrabStats::count(getDomainName() + ".count.narrowing");
-       crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
 
        //crab::outs() << "*** Narrowing " << *this << " and " << e << "\n";
        dis_interval_domain_t res(this->_env && e._env);
@@ -1211,30 +1211,30 @@ namespace crab {
      }
      
      void operator-=(variable_t v) {
-       crab::CrabStats::count(getDomainName() + ".count.forget");
-       crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 
        this->_env -= v;
      }
 
      interval_t operator[](variable_t v)  {
-       crab::CrabStats::count(getDomainName() + ".count.to_intervals");
-       crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.to_intervals"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_intervals"));
 
        dis_interval_t x = this->_env [v];
        return x.approx();
      }
      
      void set(variable_t v, interval_t intv) {
-       crab::CrabStats::count(getDomainName() + ".count.assign");
-       crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
        this->_env.set(v, dis_interval_t(intv));
      }
      
      void operator+=(linear_constraint_system_t csts) {
-       crab::CrabStats::count(getDomainName() + ".count.add_constraints");
-       crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
 
        if (!this->is_bottom()) {
          //crab::outs() << "*** add constraints " << csts << " in " << *this << "\n";
@@ -1255,8 +1255,8 @@ namespace crab {
      }
 
      void assign(variable_t x, linear_expression_t e)  {
-       crab::CrabStats::count(getDomainName() + ".count.assign");
-       crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
        //crab::outs() << "*** " <<  x << ":=" << e << " in " << *this << "\n";
        if (boost::optional<variable_t> v = e.get_variable()) {
@@ -1272,8 +1272,8 @@ namespace crab {
      }
      
      void apply(operation_t op, variable_t x, variable_t y, number_t z) {
-       crab::CrabStats::count(getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
        //crab::outs() << "*** " << x << ":=" << y << op << z << " in " << *this << "\n";
        dis_interval_t yi = this->_env[y];
@@ -1293,8 +1293,8 @@ namespace crab {
      }
 
      void apply(operation_t op, variable_t x, variable_t y, variable_t z) {
-       crab::CrabStats::count(getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
        //crab::outs() << "*** " << x << ":=" << y << op << z << " in " << *this << "\n";
        dis_interval_t yi = this->_env[y];
@@ -1339,8 +1339,8 @@ namespace crab {
      }
           
      void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-       crab::CrabStats::count(getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
        dis_interval_t yi = this->_env[y];
        dis_interval_t zi = this->_env[z];
@@ -1357,8 +1357,8 @@ namespace crab {
      }
         
      void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-       crab::CrabStats::count(getDomainName() + ".count.apply");
-       crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
        dis_interval_t yi = this->_env[y];
        dis_interval_t zi(k);
@@ -1414,8 +1414,8 @@ namespace crab {
       /* End unimplemented operations */
      
      void expand(variable_t x, variable_t new_x) {
-       crab::CrabStats::count(getDomainName() + ".count.expand");
-       crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
 
        if (is_bottom() || is_top()) {
 	 return;
@@ -1424,8 +1424,8 @@ namespace crab {
      }
 
      void project(const variable_vector_t& variables) {
-       crab::CrabStats::count(getDomainName() + ".count.project");
-       crab::ScopedCrabStats __st__(getDomainName() + ".project");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
        if (is_bottom() || is_top()) {
 	 return;
@@ -1449,8 +1449,8 @@ namespace crab {
      }
      
      void normalize() {
-       crab::CrabStats::count(getDomainName() + ".count.normalize");
-       crab::ScopedCrabStats __st__(getDomainName() + ".normalize");
+       crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.normalize"));
+       crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".normalize"));
        if (is_bottom() || is_top()) return;
        separate_domain_t env;
        for (auto p : boost::make_iterator_range(_env.begin(), _env.end())) {
@@ -993,8 +993,8 @@ namespace domains {
     elina_domain_(const elina_domain_t& o): 
       m_apstate(elinaPtr(get_man(), elina_abstract0_copy(get_man(), &*(o.m_apstate)))),
       m_var_map(o.m_var_map) {
-      crab::CrabStats::count(getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
     }
     
     elina_domain_(elina_domain_t&& o): 
@@ -1002,8 +1002,8 @@ namespace domains {
       m_var_map(std::move(o.m_var_map)) { }
     
     elina_domain_t& operator=(const elina_domain_t& o) {
-      crab::CrabStats::count(getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
       if(this != &o) {
 	m_apstate = elinaPtr(get_man(), elina_abstract0_copy(get_man(), &*(o.m_apstate)));
 	m_var_map = o.m_var_map;
@@ -1038,8 +1038,8 @@ namespace domains {
     }
     
     bool operator<=(elina_domain_t o) { 
-      crab::CrabStats::count(getDomainName() + ".count.leq");
-      crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
       
       if (is_bottom()) 
 	return true;
@@ -1059,8 +1059,8 @@ namespace domains {
     }
     
     void operator|=(elina_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
       
       if (is_bottom() || o.is_top())
 	*this = o;
@@ -1079,8 +1079,8 @@ namespace domains {
     }
     
     elina_domain_t operator|(elina_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
       
       if (is_bottom() || o.is_top())
 	return o;
@@ -1096,8 +1096,8 @@ namespace domains {
     }        
     
     elina_domain_t operator&(elina_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.meet");
-      crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
       
       if (is_bottom() || o.is_bottom())
 	return elina_domain_t::bottom();
@@ -1115,8 +1115,8 @@ namespace domains {
     }        
     
     elina_domain_t operator||(elina_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
       
       if (is_bottom())
 	return o;
@@ -1140,8 +1140,8 @@ namespace domains {
     
     template<typename Thresholds>
     elina_domain_t widening_thresholds(elina_domain_t o, const Thresholds &ts) {
-      crab::CrabStats::count(getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
       
       if (is_bottom())
 	return o;
@@ -1184,8 +1184,8 @@ namespace domains {
     }
     
     elina_domain_t operator&&(elina_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.narrowing");
-      crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
       
       if (is_bottom() || o.is_bottom())
 	return elina_domain_t::bottom();
@@ -1214,8 +1214,8 @@ namespace domains {
     }        
 
     void project(const variable_vector_t& vars) {
-      crab::CrabStats::count(getDomainName() + ".count.project");
-      crab::ScopedCrabStats __st__(getDomainName() + ".project");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
       
       if (is_bottom() || is_top()) return;
       std::set<variable_t> s1,s2;
@@ -1227,8 +1227,8 @@ namespace domains {
     }
     
     void forget(const variable_vector_t& vars) {
-      crab::CrabStats::count(getDomainName() + ".count.forget");
-      crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 
       if (is_bottom() || is_top()) return;
       
@@ -1278,8 +1278,8 @@ namespace domains {
     }
     
     void operator-=(variable_t var) {
-      crab::CrabStats::count(getDomainName() + ".count.forget");
-      crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
       
       if (is_bottom() || is_top())
 	return;
@@ -1315,8 +1315,8 @@ namespace domains {
     }
         
     interval_t operator[](variable_t v) {
-      crab::CrabStats::count(getDomainName() + ".count.to_intervals");
-      crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.to_intervals"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_intervals"));
       
       if (is_bottom()) {
 	return interval_t::bottom();
@@ -1399,8 +1399,8 @@ namespace domains {
     }
     
     void set(variable_t v, interval_t ival) {
-      crab::CrabStats::count(getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
       if (is_bottom()) {
 	return;
@@ -1438,8 +1438,8 @@ namespace domains {
     }
     
     void operator+=(linear_constraint_system_t _csts) {
-      crab::CrabStats::count(getDomainName() + ".count.add_constraints");
-      crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
       
       if(is_bottom()) return;
       
@@ -1500,8 +1500,8 @@ namespace domains {
     }
     
     void assign(variable_t x, linear_expression_t e) {
-      crab::CrabStats::count(getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
       
       if(is_bottom()) return;
 
@@ -1524,8 +1524,8 @@ namespace domains {
     }
     
     void apply(operation_t op, variable_t x, variable_t y, number_t z) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
       
       if(is_bottom()) return;
 
@@ -1567,8 +1567,8 @@ namespace domains {
     }
     
     void apply(operation_t op, variable_t x, variable_t y, variable_t z) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
       
       if(is_bottom()) return;
 
@@ -1617,8 +1617,8 @@ namespace domains {
     }
     
     void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
       if (is_bottom()) {
 	return;
@@ -1641,8 +1641,8 @@ namespace domains {
     }
     
     void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-      crab::CrabStats::count(getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
       if (is_bottom()) {
 	return;
@@ -1666,8 +1666,8 @@ namespace domains {
            
     void backward_assign(variable_t x, linear_expression_t e,
 			  elina_domain_t invariant) {
-      crab::CrabStats::count(getDomainName() + ".count.backward_assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".backward_assign");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_assign"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_assign"));
       
       if(is_bottom()) return;
       
@@ -1694,8 +1694,8 @@ namespace domains {
     void backward_apply(operation_t op,
 			 variable_t x, variable_t y, number_t z,
 			 elina_domain_t invariant) {
-      crab::CrabStats::count(getDomainName() + ".count.backward_apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".backward_apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_apply"));
       
       if(is_bottom()) return;
       
@@ -1741,8 +1741,8 @@ namespace domains {
     void backward_apply(operation_t op,
 			variable_t x, variable_t y, variable_t z,
 			elina_domain_t invariant)  {
-      crab::CrabStats::count(getDomainName() + ".count.backward_apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".backward_apply");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_apply"));
       
       if(is_bottom()) return;
       
@@ -238,13 +238,13 @@ namespace crab {
 
     flat_boolean_domain(const flat_boolean_domain_t& e) : 
       _env(e._env) {
-      crab::CrabStats::count(getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");      
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));      
     }
     
     flat_boolean_domain_t& operator=(const flat_boolean_domain_t& o) {
-      crab::CrabStats::count(getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
       if (this != &o)
         _env = o._env;
       return *this;
@@ -265,14 +265,14 @@ namespace crab {
     bool is_top() { return _env.is_top(); }
     
     bool operator<=(flat_boolean_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.leq");
-      crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
       return (_env <= o._env);
     }
     
     flat_boolean_domain_t operator|(flat_boolean_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
       
       flat_boolean_domain_t res(_env | o._env);
       CRAB_LOG("flat-boolean",
@@ -282,8 +282,8 @@ namespace crab {
     }
 
     void operator|=(flat_boolean_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
       
       CRAB_LOG("flat-boolean",
 	       crab::outs() << "After join " << *this << " and "
@@ -293,8 +293,8 @@ namespace crab {
     }
 
     flat_boolean_domain_t operator&(flat_boolean_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.meet");
-      crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
       
       flat_boolean_domain_t res(_env & o._env);
       CRAB_LOG("flat-boolean",
@@ -304,8 +304,8 @@ namespace crab {
     }
     
     flat_boolean_domain_t operator||(flat_boolean_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
       
       flat_boolean_domain_t res(_env || o._env);
       CRAB_LOG("flat-boolean",
@@ -326,14 +326,14 @@ namespace crab {
     }
     
     flat_boolean_domain_t operator&&(flat_boolean_domain_t o) {
-      crab::CrabStats::count(getDomainName() + ".count.narrowing");
-      crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
       return (_env && o._env);
     }
       
     void operator-=(variable_t v) {
-      crab::CrabStats::count(getDomainName() + ".count.forget");
-      crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
       if (!is_bottom())
         _env -= v; 
     }
@@ -351,8 +351,8 @@ namespace crab {
     }    
 
     void assign_bool_var(variable_t x, variable_t y, bool is_not_y) {
-      crab::CrabStats::count(getDomainName() + ".count.assign_bool_var");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign_bool_var");          
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign_bool_var"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign_bool_var"));          
       _env.set(x,(is_not_y ? _env[y].Negate() : _env [y]));
       CRAB_LOG("flat-boolean",
 	       auto bx = _env[x];
@@ -366,8 +366,8 @@ namespace crab {
 
     void apply_binary_bool(bool_operation_t op,
 			   variable_t x, variable_t y, variable_t z) {
-      crab::CrabStats::count(getDomainName() + ".count.apply_binary_bool");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply_binary_bool");          
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply_binary_bool"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply_binary_bool"));          
       
       switch (op) {
       case OP_BAND:
@@ -390,8 +390,8 @@ namespace crab {
     }
 
     void assume_bool(variable_t x, bool is_negated) {
-      crab::CrabStats::count(getDomainName() + ".count.assume_bool");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assume_bool");          
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assume_bool"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assume_bool"));          
       
       if (!is_negated)
 	_env.set(x,  _env[x] & boolean_value::get_true());
@@ -422,8 +422,8 @@ namespace crab {
     // backward boolean operators
     void backward_assign_bool_cst(variable_t lhs, linear_constraint_t rhs,
 				  flat_boolean_domain_t inv){
-      crab::CrabStats::count(getDomainName() + ".count.backward_assign_bool_cst");
-      crab::ScopedCrabStats __st__(getDomainName() + ".backward_assign_bool_cst");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_assign_bool_cst"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_assign_bool_cst"));
       if(is_bottom()) return;
       
       /* nothing to do: flat_boolean_domain ignores this */
@@ -432,8 +432,8 @@ namespace crab {
     
     void backward_assign_bool_var(variable_t lhs, variable_t rhs, bool is_not_rhs,
 				  flat_boolean_domain_t inv) {
-      crab::CrabStats::count(getDomainName() + ".count.backward_assign_bool_var");
-      crab::ScopedCrabStats __st__(getDomainName() + ".backward_assign_bool_var");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_assign_bool_var"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_assign_bool_var"));
 	
       if(is_bottom()) return;
       /** TODO  **/
@@ -448,8 +448,8 @@ namespace crab {
     void backward_apply_binary_bool(bool_operation_t op,
 				    variable_t x,variable_t y,variable_t z,
 				    flat_boolean_domain_t inv) {
-      crab::CrabStats::count(getDomainName() + ".count.backward_apply_binary_bool");
-      crab::ScopedCrabStats __st__(getDomainName() + ".backward_apply_binary_bool");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.backward_apply_binary_bool"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".backward_apply_binary_bool"));
       
       if(is_bottom()) return;
 
@@ -579,8 +579,8 @@ namespace crab {
     }
 
     void project(const variable_vector_t& variables){
-      crab::CrabStats::count(getDomainName() + ".count.project");
-      crab::ScopedCrabStats __st__(getDomainName() + ".project");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
       if (is_bottom() || is_top()) {
 	return;
@@ -594,8 +594,8 @@ namespace crab {
     }
          
     void expand(variable_t x, variable_t new_x) {
-      crab::CrabStats::count(getDomainName() + ".count.expand");
-      crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
 
       if (is_bottom() || is_top()) {
 	return;
@@ -1393,8 +1393,8 @@ namespace crab {
       }
       
       void forget(const variable_vector_t& variables){
-	crab::CrabStats::count(getDomainName() + ".count.forget");
-	crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+	crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 	
 	if (is_bottom() || is_top()) {
 	  return;
@@ -1408,8 +1408,8 @@ namespace crab {
       }
       
       void project(const variable_vector_t& variables) {
-	crab::CrabStats::count(getDomainName() + ".count.project");
-	crab::ScopedCrabStats __st__(getDomainName() + ".project");
+	crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 	
 	if (is_bottom() || is_top()) {
 	  return;
@@ -1430,8 +1430,8 @@ namespace crab {
       }
       
       void expand(variable_t x, variable_t new_x) {
-	crab::CrabStats::count(getDomainName() + ".count.expand");
-	crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+	crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
 	
 	if (is_bottom() || is_top()) {
 	  return;
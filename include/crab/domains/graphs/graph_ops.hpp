@@ -2,6 +2,11 @@
 
 #include <crab/domains/graphs/util/Heap.h>
 #include <boost/optional.hpp>
+#include <limits>
+#include <type_traits>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 //============================
 // A set of utility algorithms for manipulating graphs.
 
@@ -507,6 +512,43 @@ namespace crab {
     V& A;
   };
 
+  namespace graph_ops_impl {
+    // ri[j] = min(ri[j], dik + rk[j]) for all j < n.
+    // Written without branches so that the compiler can vectorize it.
+    template<class Wt>
+    inline void min_plus_row(Wt* __restrict__ ri, const Wt* __restrict__ rk,
+			     Wt dik, unsigned n) {
+      for(unsigned j = 0; j < n; j++)
+      {
+        Wt v = dik + rk[j];
+        ri[j] = (v < ri[j]) ? v : ri[j];
+      }
+    }
+
+#ifdef __AVX2__
+    // AVX2 has no 64-bit min so it is done with a compare and a blend.
+    inline void min_plus_row(long* __restrict__ ri, const long* __restrict__ rk,
+			     long dik, unsigned n) {
+      static_assert(sizeof(long) == 8, "min_plus_row expects 64-bit long");
+      const __m256i vdik = _mm256_set1_epi64x(dik);
+      unsigned j = 0;
+      for(; j + 4 <= n; j += 4)
+      {
+        __m256i vk = _mm256_loadu_si256((const __m256i*) (rk + j));
+        __m256i vi = _mm256_loadu_si256((const __m256i*) (ri + j));
+        __m256i v = _mm256_add_epi64(vdik, vk);
+        __m256i lt = _mm256_cmpgt_epi64(vi, v);
+        _mm256_storeu_si256((__m256i*) (ri + j), _mm256_blendv_epi8(vi, v, lt));
+      }
+      for(; j < n; j++)
+      {
+        long v = dik + rk[j];
+        ri[j] = (v < ri[j]) ? v : ri[j];
+      }
+    }
+#endif 
+  } // end namespace graph_ops_impl
+
   // GKG - What's the best way to split this out?
   template<class Gr>
   class GraphOps {
@@ -534,50 +576,86 @@ namespace crab {
     enum SMarkT { V_UNSTABLE = 0, V_STABLE = 1 };
     // Whether a vertex is in the current SCC/queue for Bellman-Ford.
     enum QMarkT { BF_NONE = 0, BF_SCC = 1, BF_QUEUED = 2 };
+    // Largest number of vertices supported by close_dense
+    enum { dense_max_size = 256 };
     // ===========================================
     // Scratch space needed by the graph algorithms.
-    // Should really switch to some kind of arena allocator, rather
-    // than having all these static structures.
+    // Each thread has its own scratch space so that the graph
+    // algorithms can be used concurrently by different threads.
+    // It is reused across calls and only grows.
     // ===========================================
-    static char* edge_marks;
-
-    // Used for Bellman-Ford queueing
-    static vert_id* dual_queue;
-    static int* vert_marks;
-    static unsigned int scratch_sz;
-
-    // For locality, should combine dists & dist_ts.
-    // Wt must have an empty constructor, but does _not_
-    // need a top or infty element.
-    // dist_ts tells us which distances are current,
-    // and ts_idx prevents wraparound problems, in the unlikely
-    // circumstance that we have more than 2^sizeof(uint) iterations.
-    static std::vector<Wt> dists;
-    static std::vector<Wt> dists_alt;
-    static std::vector<unsigned int> dist_ts;
-    static unsigned int ts; 
-    static unsigned int ts_idx;
-
-    static void grow_scratch(unsigned int sz) {
-      if(sz <= scratch_sz)
-        return;
+    class scratch_space {
+    public:
+      char* edge_marks;
+
+      // Used for Bellman-Ford queueing
+      vert_id* dual_queue;
+      int* vert_marks;
+      unsigned int scratch_sz;
+
+      // For locality, should combine dists & dist_ts.
+      // Wt must have an empty constructor, but does _not_
+      // need a top or infty element.
+      // dist_ts tells us which distances are current,
+      // and ts_idx prevents wraparound problems, in the unlikely
+      // circumstance that we have more than 2^sizeof(uint) iterations.
+      std::vector<Wt> dists;
+      std::vector<Wt> dists_alt;
+      std::vector<unsigned int> dist_ts;
+      unsigned int ts;
+      unsigned int ts_idx;
+
+      // Used by close_dense: row-major distance matrix, the vertex
+      // of each row and the row of each vertex.
+      std::vector<Wt> dense_mat;
+      std::vector<vert_id> dense_verts;
+      std::vector<unsigned int> dense_idx;
+
+      scratch_space()
+	: edge_marks(NULL), dual_queue(NULL), vert_marks(NULL),
+	  scratch_sz(0), ts(0), ts_idx(0) { }
+
+      ~scratch_space() {
+	free(edge_marks);
+	free(dual_queue);
+	free(vert_marks);
+      }
 
-      if(scratch_sz == 0)
-        scratch_sz = 10; // Introduce enums for init_sz and growth_factor
-      while(scratch_sz < sz)
-        scratch_sz *= 1.5;
+      scratch_space(const scratch_space&) = delete;
+      scratch_space& operator=(const scratch_space&) = delete;
+
+      void grow(unsigned int sz) {
+	if(sz <= scratch_sz)
+	  return;
+
+	if(scratch_sz == 0)
+	  scratch_sz = 10; // Introduce enums for init_sz and growth_factor
+	while(scratch_sz < sz)
+	  scratch_sz *= 1.5;
+
+	edge_marks = (char*) realloc(edge_marks, sizeof(char)*scratch_sz*scratch_sz);
+	dual_queue = (vert_id*) realloc(dual_queue, sizeof(vert_id)*2*scratch_sz);
+	vert_marks = (int*) realloc(vert_marks, sizeof(int)*scratch_sz);
+
+	// Initialize new elements as necessary.
+	while(dists.size() < scratch_sz)
+	{
+	  dists.push_back(Wt());
+	  dists_alt.push_back(Wt());
+	  dist_ts.push_back(ts-1);
+	}
+      }
+    };
 
-      edge_marks = (char*) realloc(edge_marks, sizeof(char)*scratch_sz*scratch_sz);
-      dual_queue = (vert_id*) realloc(dual_queue, sizeof(vert_id)*2*scratch_sz);
-      vert_marks = (int*) realloc(vert_marks, sizeof(int)*scratch_sz);
+    static scratch_space& scratch() {
+      static thread_local scratch_space s;
+      return s;
+    }
 
-      // Initialize new elements as necessary.
-      while(dists.size() < scratch_sz)
-      {
-        dists.push_back(Wt());
-        dists_alt.push_back(Wt());
-        dist_ts.push_back(ts-1);
-      }
+    static scratch_space& grow_scratch(unsigned int sz) {
+      scratch_space& s = scratch();
+      s.grow(sz);
+      return s;
     }
 
     // Syntactic join.
@@ -677,12 +755,13 @@ r_not_dom:
     // Duped pretty much verbatim from Wikipedia
     // Abuses 'dual_queue' to store indices.
     template<class G>
-    static void strong_connect(G& x, std::vector<vert_id>& stack, int& index,
+    static void strong_connect(G& x, scratch_space& ws,
+			       std::vector<vert_id>& stack, int& index,
 			       vert_id v, std::vector< std::vector<vert_id> >& sccs)
     {
-      vert_marks[v] = (index<<1)|1;
+      ws.vert_marks[v] = (index<<1)|1;
       // assert(vert_marks[v]&1);
-      dual_queue[v] = index;
+      ws.dual_queue[v] = index;
       index++;
 
       stack.push_back(v);
@@ -690,18 +769,18 @@ r_not_dom:
       // Consider successors of v
       for(vert_id w : x.succs(v))
       {
-        if(!vert_marks[w])
+        if(!ws.vert_marks[w])
         {
-          strong_connect(x, stack, index, w, sccs);
-          dual_queue[v] = std::min(dual_queue[v], dual_queue[w]);
-        } else if(vert_marks[w]&1) {
+          strong_connect(x, ws, stack, index, w, sccs);
+          ws.dual_queue[v] = std::min(ws.dual_queue[v], ws.dual_queue[w]);
+        } else if(ws.vert_marks[w]&1) {
           // W is on the stack
-          dual_queue[v] = std::min(dual_queue[v], (vert_id) (vert_marks[w]>>1));
+          ws.dual_queue[v] = std::min(ws.dual_queue[v], (vert_id) (ws.vert_marks[w]>>1));
         }
       }
 
       // If v is a root node, pop the stack and generate an SCC
-      if(dual_queue[v] == (vert_marks[v]>>1))
+      if(ws.dual_queue[v] == (ws.vert_marks[v]>>1))
       {
         sccs.push_back(std::vector<vert_id>()); 
         std::vector<vert_id>& scc(sccs.back());
@@ -710,7 +789,7 @@ r_not_dom:
         {
           w = stack.back();
           stack.pop_back();
-          vert_marks[w] &= (~1);
+          ws.vert_marks[w] &= (~1);
           scc.push_back(w);
         } while (v != w);
       }
@@ -720,16 +799,16 @@ r_not_dom:
     static void compute_sccs(G& x, std::vector< std::vector<vert_id> >& out_scc)
     {
       int sz = x.size();
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
 
       for(vert_id v : x.verts())
-        vert_marks[v] = 0;
+        ws.vert_marks[v] = 0;
       int index = 1;
       std::vector<vert_id> stack;
       for(vert_id v : x.verts())
       {
-        if(!vert_marks[v])
-          strong_connect(x, stack, index, v, out_scc);
+        if(!ws.vert_marks[v])
+          strong_connect(x, ws, stack, index, v, out_scc);
       }
       /*
       printf("[");
@@ -744,7 +823,7 @@ r_not_dom:
       */
 
       for(vert_id v : x.verts())
-        vert_marks[v] = 0;
+        ws.vert_marks[v] = 0;
     }
 
     // Run Bellman-Ford to compute a valid model of a set of difference constraints.
@@ -754,7 +833,7 @@ r_not_dom:
     {
       int sz = g.size();
       assert(potentials.size() >= sz);
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
 
       std::vector< std::vector<vert_id> > sccs;
       compute_sccs(g, sccs);
@@ -780,16 +859,16 @@ r_not_dom:
       {
         std::vector<vert_id>& scc(*it);
 
-        vert_id* qhead = dual_queue;
+        vert_id* qhead = ws.dual_queue;
         vert_id* qtail = qhead;
 
-        vert_id* next_head = dual_queue+sz;
+        vert_id* next_head = ws.dual_queue+sz;
         vert_id* next_tail = next_head;
 
         for(vert_id v : scc)
         {
           *qtail = v;
-          vert_marks[v] = BF_SCC|BF_QUEUED;
+          ws.vert_marks[v] = BF_SCC|BF_QUEUED;
           qtail++;
         }
 
@@ -799,7 +878,7 @@ r_not_dom:
           {
             vert_id s = *(--qtail); 
             // If it _was_ on the queue, it must be in the SCC
-            vert_marks[s] = BF_SCC; 
+            ws.vert_marks[s] = BF_SCC; 
             
             Wt s_pot = potentials[s];
 
@@ -810,10 +889,10 @@ r_not_dom:
               if(sd_pot < potentials[d])
               {
                 potentials[d] = sd_pot;
-                if(vert_marks[d] == BF_SCC)
+                if(ws.vert_marks[d] == BF_SCC)
                 {
                   *next_tail = d;
-                  vert_marks[d] = (BF_SCC|BF_QUEUED);
+                  ws.vert_marks[d] = (BF_SCC|BF_QUEUED);
                   next_tail++;
                 }
               }
@@ -838,7 +917,7 @@ r_not_dom:
             {
               // Cleanup vertex marks
               for(vert_id v : g.verts())
-                vert_marks[v] = BF_NONE;
+                ws.vert_marks[v] = BF_NONE;
               return false;
             }
           }
@@ -855,7 +934,7 @@ r_not_dom:
       // We just want to restore closure.
       assert(l.size() == r.size());
       unsigned int sz = l.size();
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
       delta.clear();
       
       std::vector< std::vector<vert_id> > colour_succs(2*sz);
@@ -888,7 +967,7 @@ r_not_dom:
             default:
               break;
           }
-          edge_marks[sz*s + d] = mark;
+          ws.edge_marks[sz*s + d] = mark;
         }
       }
 
@@ -926,25 +1005,25 @@ r_not_dom:
       unsigned int sz = g.size();
       if(sz == 0)
         return;
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
 
       // Reset all vertices to infty.
-      dist_ts[ts_idx] = ts++;
-      ts_idx = (ts_idx+1) % dists.size();
+      ws.dist_ts[ws.ts_idx] = ws.ts++;
+      ws.ts_idx = (ws.ts_idx+1) % ws.dists.size();
 
-      dists[src] = Wt(0);
-      dist_ts[src] = ts;
+      ws.dists[src] = Wt(0);
+      ws.dist_ts[src] = ws.ts;
 
-      WtComp comp(dists);
+      WtComp comp(ws.dists);
       WtHeap heap(comp);
 
       for(auto e : g.e_succs(src))
       {
         vert_id dest = e.vert;
-        dists[dest] = p[src] + e.val - p[dest];
-        dist_ts[dest] = ts;
+        ws.dists[dest] = p[src] + e.val - p[dest];
+        ws.dist_ts[dest] = ws.ts;
 
-        vert_marks[dest] = edge_marks[sz*src + dest];
+        ws.vert_marks[dest] = ws.edge_marks[sz*src + dest];
         heap.insert(dest);
       }
 
@@ -952,7 +1031,7 @@ r_not_dom:
       while(!heap.empty())
       {
         int es = heap.removeMin();
-        Wt es_cost = dists[es] + p[es]; // If it's on the queue, distance is not infinite.
+        Wt es_cost = ws.dists[es] + p[es]; // If it's on the queue, distance is not infinite.
         Wt es_val = es_cost - p[src];
         if(!g.lookup(src, es, &w) || w.get() > es_val)
           out.push_back( std::make_pair(es, es_val) );
@@ -961,10 +1040,10 @@ r_not_dom:
         {
           vert_id ed(e_ed.vert);
           Wt v = es_cost + e_ed.val - p[ed];
-          if(dist_ts[ed] != ts || v < dists[ed])
+          if(ws.dist_ts[ed] != ws.ts || v < ws.dists[ed])
           {
-            dists[ed] = v;
-            dist_ts[ed] = ts;
+            ws.dists[ed] = v;
+            ws.dist_ts[ed] = ws.ts;
 
             if(heap.inHeap(ed))
             {
@@ -990,6 +1069,89 @@ r_not_dom:
       }
     }
 
+    // Dense closure for small graphs: copy g into a contiguous
+    // matrix, run Floyd-Warshall with min-plus row updates, and
+    // return the edges that improve g in delta (as close_johnson).
+    //
+    // Only available if Wt is an integral type. Returns false
+    // (leaving delta unchanged) if it is not or if some weight is too
+    // large to be used with the sentinel value for infinity. In that
+    // case, the caller should use one of the sparse algorithms.
+    template<class G>
+    static bool close_dense(G& g, edge_vector& delta)
+    {
+      return close_dense(g, delta, std::is_integral<Wt>());
+    }
+
+    template<class G>
+    static bool close_dense(G& g, edge_vector& delta, std::false_type)
+    { return false; }
+
+    template<class G>
+    static bool close_dense(G& g, edge_vector& delta, std::true_type)
+    {
+      // Any path has at most dense_max_size edges so finite distances
+      // are always below dense_inf/2 in absolute value.
+      const Wt dense_inf = std::numeric_limits<Wt>::max() / 4;
+      const Wt max_wt = dense_inf / (4 * dense_max_size);
+      
+      unsigned int sz = g.size();
+      scratch_space& ws = grow_scratch(sz);
+      std::vector<vert_id>& verts = ws.dense_verts;
+      std::vector<unsigned int>& idx = ws.dense_idx;
+      verts.clear();
+      if(idx.size() < sz)
+        idx.resize(sz);
+      for(vert_id v : g.verts())
+      {
+        idx[v] = verts.size();
+        verts.push_back(v);
+      }
+      unsigned int n = verts.size();
+      if(n > dense_max_size)
+        return false;
+
+      std::vector<Wt>& mat = ws.dense_mat;
+      mat.assign(n*n, dense_inf);
+      for(unsigned int i = 0; i < n; i++)
+      {
+        mat[i*n + i] = Wt(0);
+        for(auto e : g.e_succs(verts[i]))
+        {
+          if(e.val > max_wt || e.val < -max_wt)
+            return false;
+          Wt& m = mat[i*n + idx[e.vert]];
+          m = std::min(m, (Wt) e.val);
+        }
+      }
+
+      for(unsigned int k = 0; k < n; k++)
+      {
+        const Wt* rk = &mat[k*n];
+        for(unsigned int i = 0; i < n; i++)
+        {
+          Wt dik = mat[i*n + k];
+          if(i == k || dik >= dense_inf/2)
+            continue;
+          graph_ops_impl::min_plus_row(&mat[i*n], rk, dik, n);
+        }
+      }
+
+      mut_val_ref_t w;
+      for(unsigned int i = 0; i < n; i++)
+      {
+        for(unsigned int j = 0; j < n; j++)
+        {
+          Wt d = mat[i*n + j];
+          if(i == j || d >= dense_inf/2)
+            continue;
+          if(!g.lookup(verts[i], verts[j], &w) || w.get() > d)
+            delta.push_back( std::make_pair(std::make_pair(verts[i], verts[j]), d) );
+        }
+      }
+      return true;
+    }
+
     // P is some vector-alike holding a valid system of potentials.
     // Don't need to clear/initialize 
     template<class G, class P>
@@ -1000,25 +1162,25 @@ r_not_dom:
       unsigned int sz = g.size();
       if(sz == 0)
         return;
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
 
       // Reset all vertices to infty.
-      dist_ts[ts_idx] = ts++;
-      ts_idx = (ts_idx+1) % dists.size();
+      ws.dist_ts[ws.ts_idx] = ws.ts++;
+      ws.ts_idx = (ws.ts_idx+1) % ws.dists.size();
 
-      dists[src] = Wt(0);
-      dist_ts[src] = ts;
+      ws.dists[src] = Wt(0);
+      ws.dist_ts[src] = ws.ts;
 
-      WtComp comp(dists);
+      WtComp comp(ws.dists);
       WtHeap heap(comp);
 
       for(auto e : g.e_succs(src))
       {
         vert_id dest = e.vert;
-        dists[dest] = p[src] + e.val - p[dest];
-        dist_ts[dest] = ts;
+        ws.dists[dest] = p[src] + e.val - p[dest];
+        ws.dist_ts[dest] = ws.ts;
 
-        vert_marks[dest] = edge_marks[sz*src + dest];
+        ws.vert_marks[dest] = ws.edge_marks[sz*src + dest];
         heap.insert(dest);
       }
 
@@ -1026,25 +1188,25 @@ r_not_dom:
       while(!heap.empty())
       {
         int es = heap.removeMin();
-        Wt es_cost = dists[es] + p[es]; // If it's on the queue, distance is not infinite.
+        Wt es_cost = ws.dists[es] + p[es]; // If it's on the queue, distance is not infinite.
         Wt es_val = es_cost - p[src];
         if(!g.lookup(src, es, &w) || w.get() > es_val)
           out.push_back( std::make_pair(es, es_val) );
 
-        if(vert_marks[es] == (E_LEFT|E_RIGHT))
+        if(ws.vert_marks[es] == (E_LEFT|E_RIGHT))
           continue;
 
         // Pick the appropriate set of successors
-        std::vector<vert_id>& es_succs = (vert_marks[es] == E_LEFT) ?
+        std::vector<vert_id>& es_succs = (ws.vert_marks[es] == E_LEFT) ?
           colour_succs[2*es+1] : colour_succs[2*es];
         for(vert_id ed : es_succs)
         {
           Wt v = es_cost + g.edge_val(es, ed) - p[ed];
-          if(dist_ts[ed] != ts || v < dists[ed])
+          if(ws.dist_ts[ed] != ws.ts || v < ws.dists[ed])
           {
-            dists[ed] = v;
-            dist_ts[ed] = ts;
-            vert_marks[ed] = edge_marks[sz*es+ed];
+            ws.dists[ed] = v;
+            ws.dist_ts[ed] = ws.ts;
+            ws.vert_marks[ed] = ws.edge_marks[sz*es+ed];
 
             if(heap.inHeap(ed))
             {
@@ -1052,8 +1214,8 @@ r_not_dom:
             } else {
               heap.insert(ed);
             }
-          } else if(v == dists[ed]) {
-            vert_marks[ed] |= edge_marks[sz*es+ed];
+          } else if(v == ws.dists[ed]) {
+            ws.vert_marks[ed] |= ws.edge_marks[sz*es+ed];
           }
         }
       }
@@ -1072,25 +1234,25 @@ r_not_dom:
       if(is_stable[src])
         return;
 
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
 
       // Reset all vertices to infty.
-      dist_ts[ts_idx] = ts++;
-      ts_idx = (ts_idx+1) % dists.size();
+      ws.dist_ts[ws.ts_idx] = ws.ts++;
+      ws.ts_idx = (ws.ts_idx+1) % ws.dists.size();
 
-      dists[src] = Wt(0);
-      dist_ts[src] = ts;
+      ws.dists[src] = Wt(0);
+      ws.dist_ts[src] = ws.ts;
 
-      WtComp comp(dists);
+      WtComp comp(ws.dists);
       WtHeap heap(comp);
 
       for(auto e : g.e_succs(src))
       {
         vert_id dest = e.vert;
-        dists[dest] = p[src] + e.val - p[dest];
-        dist_ts[dest] = ts;
+        ws.dists[dest] = p[src] + e.val - p[dest];
+        ws.dist_ts[dest] = ws.ts;
 
-        vert_marks[dest] = V_UNSTABLE;
+        ws.vert_marks[dest] = V_UNSTABLE;
         heap.insert(dest);
       }
 
@@ -1098,12 +1260,12 @@ r_not_dom:
       while(!heap.empty())
       {
         int es = heap.removeMin();
-        Wt es_cost = dists[es] + p[es]; // If it's on the queue, distance is not infinite.
+        Wt es_cost = ws.dists[es] + p[es]; // If it's on the queue, distance is not infinite.
         Wt es_val = es_cost - p[src];
         if(!g.lookup(src, es, &w) || w.get() > es_val)
           out.push_back( std::make_pair(es, es_val) );
 
-        if(vert_marks[es] == V_STABLE)
+        if(ws.vert_marks[es] == V_STABLE)
           continue;
 
         char es_mark = is_stable[es] ? V_STABLE : V_UNSTABLE;
@@ -1113,11 +1275,11 @@ r_not_dom:
         {
           vert_id ed = e.vert;
           Wt v = es_cost + e.val - p[ed];
-          if(dist_ts[ed] != ts || v < dists[ed])
+          if(ws.dist_ts[ed] != ws.ts || v < ws.dists[ed])
           {
-            dists[ed] = v;
-            dist_ts[ed] = ts;
-            vert_marks[ed] = es_mark;
+            ws.dists[ed] = v;
+            ws.dist_ts[ed] = ws.ts;
+            ws.vert_marks[ed] = es_mark;
 
             if(heap.inHeap(ed))
             {
@@ -1125,8 +1287,8 @@ r_not_dom:
             } else {
               heap.insert(ed);
             }
-          } else if(v == dists[ed]) {
-            vert_marks[ed] |= es_mark;
+          } else if(v == ws.dists[ed]) {
+            ws.vert_marks[ed] |= es_mark;
           }
         }
       }
@@ -1164,19 +1326,19 @@ r_not_dom:
       // Ensure there's enough scratch space. 
       unsigned int sz = g.size();
 //      assert(src < (int) sz && dest < (int) sz);
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
 
       for(vert_id vi : g.verts())
       {
-        dists[vi] = Wt(0);
-        dists_alt[vi] = p[vi];
+        ws.dists[vi] = Wt(0);
+        ws.dists_alt[vi] = p[vi];
       }
-      dists[jj] = p[ii] + g.edge_val(ii, jj) - p[jj];
+      ws.dists[jj] = p[ii] + g.edge_val(ii, jj) - p[jj];
 
-      if(dists[jj] >= Wt(0))
+      if(ws.dists[jj] >= Wt(0))
         return true;
 
-      WtComp comp(dists);
+      WtComp comp(ws.dists);
       WtHeap heap(comp);
 
       heap.insert(jj);
@@ -1185,17 +1347,17 @@ r_not_dom:
       {
         int es = heap.removeMin();
 
-        dists_alt[es] = p[es] + dists[es];
+        ws.dists_alt[es] = p[es] + ws.dists[es];
 
         for(auto e : g.e_succs(es))
         {
           vert_id ed = e.vert;
-          if(dists_alt[ed] == p[ed])
+          if(ws.dists_alt[ed] == p[ed])
           {
-            Wt gnext_ed = dists_alt[es] + e.val - dists_alt[ed];
-            if(gnext_ed < dists[ed])
+            Wt gnext_ed = ws.dists_alt[es] + e.val - ws.dists_alt[ed];
+            if(gnext_ed < ws.dists[ed])
             {
-              dists[ed] = gnext_ed;
+              ws.dists[ed] = gnext_ed;
               if(heap.inHeap(ed))
               {
                 heap.decrease(ed);
@@ -1207,11 +1369,11 @@ r_not_dom:
           }
         }
       }
-      if(dists[ii] < 0)
+      if(ws.dists[ii] < 0)
         return false;
 
       for(vert_id v : g.verts())
-        p[v] = dists_alt[v];
+        p[v] = ws.dists_alt[v];
 
       return true;
     }
@@ -1220,23 +1382,23 @@ r_not_dom:
     static void close_after_widen(G& g, P& p, const V& is_stable, edge_vector& delta)
     {
       unsigned int sz = g.size();
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
 //      assert(orig.size() == sz);
       
       for(vert_id v : g.verts())
       {
         // We're abusing edge_marks to store _vertex_ flags.
         // Should really just switch this to allocating regions of a fixed-size buffer.
-        edge_marks[v] = is_stable[v] ? V_STABLE : V_UNSTABLE;
+        ws.edge_marks[v] = is_stable[v] ? V_STABLE : V_UNSTABLE;
       }
       
       std::vector< std::pair<vert_id, Wt> > aux;
       for(vert_id v : g.verts())
       {
-        if(!edge_marks[v])
+        if(!ws.edge_marks[v])
         {
           aux.clear();
-          dijkstra_recover(g, p, edge_marks, v, aux); 
+          dijkstra_recover(g, p, ws.edge_marks, v, aux); 
           for(auto p : aux)
             delta.push_back( std::make_pair( std::make_pair(v, p.first), p.second ) );   
         }
@@ -1249,21 +1411,22 @@ r_not_dom:
     template<class P>
     class AdjCmp {
     public: 
-      AdjCmp(const P& _p)
-        : p(_p)
+      AdjCmp(const std::vector<Wt>& _dists, const P& _p)
+        : dists(_dists), p(_p)
       { }
 
       bool operator()(vert_id d1, vert_id d2) const {
        return (dists[d1] - p[d1]) < (dists[d2] - p[d2]);
       }
     protected:
+      const std::vector<Wt>& dists;
       const P& p;
     };
 
     template<class P>
-    static AdjCmp<P> make_adjcmp(const P& p)
+    static AdjCmp<P> make_adjcmp(const std::vector<Wt>& dists, const P& p)
     {
-      return AdjCmp<P>(p);
+      return AdjCmp<P>(dists, p);
     }
 
     template<class P>
@@ -1283,58 +1446,58 @@ r_not_dom:
     // Compute the transitive closure of edges reachable from v, assuming
     // (1) the subgraph G \ {v} is closed, and (2) P is a valid model of G.
     template<class G, class P>
-    static void close_after_assign_fwd(G& g, const P& p, vert_id v,
+    static void close_after_assign_fwd(G& g, scratch_space& ws, const P& p, vert_id v,
 				       std::vector< std::pair<vert_id, Wt> >& aux)
     {
       // Initialize the queue and distances.
       for(vert_id u : g.verts())
-        vert_marks[u] = 0;
+        ws.vert_marks[u] = 0;
 
-      vert_marks[v] = BF_QUEUED;
-      dists[v] = Wt(0);
-      vert_id* adj_head = dual_queue;
+      ws.vert_marks[v] = BF_QUEUED;
+      ws.dists[v] = Wt(0);
+      vert_id* adj_head = ws.dual_queue;
       vert_id* adj_tail = adj_head;
       for(auto e : g.e_succs(v))
       {
         vert_id d = e.vert;
-        vert_marks[d] = BF_QUEUED;
-        dists[d] = e.val;
+        ws.vert_marks[d] = BF_QUEUED;
+        ws.dists[d] = e.val;
 //        assert(p[v] + dists[d] - p[d] >= Wt(0));
         *adj_tail = d;
         adj_tail++;
       }
 
       // Sort the immediate edges by increasing slack.
-      std::sort(adj_head, adj_tail, make_adjcmp(p));
+      std::sort(adj_head, adj_tail, make_adjcmp(ws.dists, p));
 
       vert_id* reach_tail = adj_tail;
       for(; adj_head < adj_tail; adj_head++)
       {
         vert_id d = *adj_head;  
         
-        Wt d_wt = dists[d];
+        Wt d_wt = ws.dists[d];
         for(auto edge : g.e_succs(d))
         {
           vert_id e = edge.vert;
           Wt e_wt = d_wt + edge.val;
-          if(!vert_marks[e])
+          if(!ws.vert_marks[e])
           {
-            dists[e] = e_wt;
-            vert_marks[e] = BF_QUEUED;
+            ws.dists[e] = e_wt;
+            ws.vert_marks[e] = BF_QUEUED;
             *reach_tail = e;
             reach_tail++;
           } else {
-            dists[e] = std::min(e_wt, dists[e]);
+            ws.dists[e] = std::min(e_wt, ws.dists[e]);
           }
         }
       }
 
       // Now collect the adjacencies, and clear vertex flags
       // FIXME: This collects _all_ edges from x, not just new ones.
-      for(adj_head = dual_queue; adj_head < reach_tail; adj_head++)
+      for(adj_head = ws.dual_queue; adj_head < reach_tail; adj_head++)
       {
-        aux.push_back(std::make_pair(*adj_head, dists[*adj_head]));
-        vert_marks[*adj_head] = 0;
+        aux.push_back(std::make_pair(*adj_head, ws.dists[*adj_head]));
+        ws.vert_marks[*adj_head] = 0;
       }
     }
     
@@ -1342,46 +1505,21 @@ r_not_dom:
     static void close_after_assign(G& g, P& p, vert_id v, edge_vector& delta)
     {
       unsigned int sz = g.size();
-      grow_scratch(sz);
+      scratch_space& ws = grow_scratch(sz);
 
       std::vector< std::pair<vert_id, Wt> > aux;
 
-      close_after_assign_fwd(g, p, v, aux);
+      close_after_assign_fwd(g, ws, p, v, aux);
       for(auto p : aux)
         delta.push_back( std::make_pair( std::make_pair(v, p.first), p.second ) );   
 
       aux.clear();
       GraphRev<G> g_rev(g);
-      close_after_assign_fwd(g_rev, make_negp(p), v, aux);
+      close_after_assign_fwd(g_rev, ws, make_negp(p), v, aux);
       for(auto p : aux)
         delta.push_back( std::make_pair( std::make_pair(p.first, v), p.second ) );
     }
   };
 
-  // Static data allocation
-  template<class Wt>
-  char* GraphOps<Wt>::edge_marks = NULL;
-
-  // Used for Bellman-Ford queueing
-  template<class Wt>
-  typename GraphOps<Wt>::vert_id* GraphOps<Wt>::dual_queue = NULL;
-
-  template<class Wt>
-  int* GraphOps<Wt>::vert_marks = NULL;
-
-  template<class Wt>
-  unsigned int GraphOps<Wt>::scratch_sz = 0;
-
-  template<class G>
-  std::vector<typename G::Wt> GraphOps<G>::dists;
-  template<class G>
-  std::vector<typename G::Wt> GraphOps<G>::dists_alt;
-  template<class G>
-  std::vector<unsigned int> GraphOps<G>::dist_ts;
-  template<class G>
-  unsigned int GraphOps<G>::ts = 0;
-  template<class G>
-  unsigned int GraphOps<G>::ts_idx = 0;
-
 } // namespace crab
 #pragma GCC diagnostic pop
@@ -0,0 +1,843 @@
+#pragma once
+
+/*
+ * Hash-consed Patricia trees.
+ *
+ * hc_patricia_tree has the same interface as patricia_tree but all
+ * trees are built from maximally shared nodes: two trees are
+ * structurally equal if and only if they are the same node. Hence,
+ * equality is a pointer comparison and merge/compare skip any
+ * subtree shared by both arguments, not only the ones that happen to
+ * come from the same copy.
+ *
+ * Nodes are not polymorphic (a tag distinguishes leaves from internal
+ * nodes), carry an intrusive reference count, and are recycled
+ * through a pool owned by the table of the (Key, Value) pair.
+ *
+ * Value must provide operator== and a hash_value function that can
+ * be found by argument-dependent lookup.
+ */
+
+#include <crab/domains/patricia_trees.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <boost/functional/hash.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace ikos {
+
+namespace hc_patricia_trees_impl {
+
+using patricia_trees_impl::compute_branching_bit;
+using patricia_trees_impl::mask;
+using patricia_trees_impl::zero_bit;
+using patricia_trees_impl::match_prefix;
+using patricia_trees_impl::failed;
+
+template < typename Key, typename Value >
+class node;
+
+template < typename Key, typename Value >
+class node_table;
+
+// Owning reference to a node. The empty tree is the null pointer.
+template < typename Key, typename Value >
+class tree_ptr {
+  typedef node< Key, Value > node_t;
+  typedef tree_ptr< Key, Value > tree_ptr_t;
+
+  node_t* m_node;
+
+public:
+  tree_ptr() : m_node(nullptr) {}
+
+  // adopt a node whose reference count already accounts for this
+  explicit tree_ptr(node_t* n) : m_node(n) {}
+
+  tree_ptr(const tree_ptr_t& o) : m_node(o.m_node) {
+    if (m_node) {
+      m_node->acquire();
+    }
+  }
+
+  tree_ptr(tree_ptr_t&& o) : m_node(o.m_node) { o.m_node = nullptr; }
+
+  tree_ptr_t& operator=(const tree_ptr_t& o) {
+    tree_ptr_t tmp(o);
+    std::swap(m_node, tmp.m_node);
+    return *this;
+  }
+
+  tree_ptr_t& operator=(tree_ptr_t&& o) {
+    std::swap(m_node, o.m_node);
+    return *this;
+  }
+
+  ~tree_ptr() {
+    if (m_node && m_node->release()) {
+      node_table< Key, Value >::get().free(m_node);
+    }
+  }
+
+  explicit operator bool() const { return m_node != nullptr; }
+
+  const node_t* operator->() const { return m_node; }
+
+  const node_t* get() const { return m_node; }
+
+  bool operator==(const tree_ptr_t& o) const { return m_node == o.m_node; }
+
+  bool operator!=(const tree_ptr_t& o) const { return m_node != o.m_node; }
+
+}; // class tree_ptr
+
+template < typename Key, typename Value >
+class node : private boost::noncopyable {
+  friend class node_table< Key, Value >;
+
+public:
+  typedef tree_ptr< Key, Value > tree_ptr_t;
+  struct binding_t {
+    const Key& first;
+    const Value& second;
+    binding_t(const Key& first_, const Value& second_)
+        : first(first_), second(second_) {}
+  };
+
+private:
+  typedef std::pair< Key, Value > pair_t;
+
+  std::atomic< unsigned > m_refcount;
+  bool m_is_leaf;
+  // key index if leaf
+  index_t m_prefix;
+  index_t m_branching_bit;
+  std::size_t m_size;
+  std::size_t m_hash;
+  tree_ptr_t m_left_branch;
+  tree_ptr_t m_right_branch;
+  // next node in the same bucket or in the free list
+  node* m_next;
+  // key and value if leaf
+  typename std::aligned_storage< sizeof(pair_t), alignof(pair_t) >::type
+      m_binding;
+
+  const pair_t& pair() const {
+    return *reinterpret_cast< const pair_t* >(&m_binding);
+  }
+
+  node(std::size_t hash, const Key& key, const Value& value)
+      : m_refcount(1),
+        m_is_leaf(true),
+        m_prefix(key.index()),
+        m_branching_bit(0),
+        m_size(1),
+        m_hash(hash),
+        m_next(nullptr) {
+    new (&m_binding) pair_t(key, value);
+  }
+
+  node(std::size_t hash,
+       index_t prefix,
+       index_t branching_bit,
+       const tree_ptr_t& left_branch,
+       const tree_ptr_t& right_branch)
+      : m_refcount(1),
+        m_is_leaf(false),
+        m_prefix(prefix),
+        m_branching_bit(branching_bit),
+        m_size(left_branch->size() + right_branch->size()),
+        m_hash(hash),
+        m_left_branch(left_branch),
+        m_right_branch(right_branch),
+        m_next(nullptr) {}
+
+  ~node() {
+    if (m_is_leaf) {
+      reinterpret_cast< pair_t* >(&m_binding)->~pair_t();
+    }
+  }
+
+public:
+  void acquire() const {
+    const_cast< node* >(this)->m_refcount.fetch_add(1,
+                                                    std::memory_order_relaxed);
+  }
+
+  // return true if this was the last reference
+  bool release() const {
+    return const_cast< node* >(this)->m_refcount.fetch_sub(
+               1, std::memory_order_acq_rel) == 1;
+  }
+
+  bool is_leaf() const { return m_is_leaf; }
+
+  bool is_node() const { return !m_is_leaf; }
+
+  std::size_t size() const { return m_size; }
+
+  index_t prefix() const { return m_prefix; }
+
+  index_t branching_bit() const { return m_branching_bit; }
+
+  const tree_ptr_t& left_branch() const { return m_left_branch; }
+
+  const tree_ptr_t& right_branch() const { return m_right_branch; }
+
+  const Key& key() const { return pair().first; }
+
+  const Value& value() const { return pair().second; }
+
+  binding_t binding() const { return binding_t(key(), value()); }
+
+  const Value* lookup(index_t k) const {
+    const node* n = this;
+    while (n->is_node()) {
+      n = (k <= n->m_prefix ? n->m_left_branch : n->m_right_branch).get();
+    }
+    return (n->m_prefix == k ? &n->value() : nullptr);
+  }
+
+}; // class node
+
+/*
+ * Unique table and pool of all the nodes of a (Key, Value) pair.
+ *
+ * The table is shared by all threads. A node is looked up only if
+ * its reference count is not zero: a node whose last reference is
+ * being dropped is never handed out again, so a node is unlinked and
+ * recycled only by the thread that dropped its last reference.
+ */
+template < typename Key, typename Value >
+class node_table : private boost::noncopyable {
+public:
+  typedef node< Key, Value > node_t;
+  typedef tree_ptr< Key, Value > tree_ptr_t;
+
+private:
+  enum { chunk_size = 256 };
+  typedef typename std::aligned_storage< sizeof(node_t),
+                                         alignof(node_t) >::type slot_t;
+
+  std::mutex m_mutex;
+  std::vector< node_t* > m_buckets;
+  std::size_t m_num_nodes;
+  node_t* m_free;
+  std::vector< slot_t* > m_chunks;
+
+  node_table() : m_buckets(1024, nullptr), m_num_nodes(0), m_free(nullptr) {}
+
+  static bool try_acquire(node_t* n) {
+    unsigned c = n->m_refcount.load(std::memory_order_relaxed);
+    while (c != 0) {
+      if (n->m_refcount.compare_exchange_weak(c, c + 1,
+                                              std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void* allocate() {
+    if (!m_free) {
+      slot_t* chunk = new slot_t[chunk_size];
+      m_chunks.push_back(chunk);
+      for (unsigned i = 0; i < chunk_size; ++i) {
+        node_t* n = reinterpret_cast< node_t* >(&chunk[i]);
+        n->m_next = m_free;
+        m_free = n;
+      }
+    }
+    node_t* n = m_free;
+    m_free = n->m_next;
+    return n;
+  }
+
+  void link(node_t* n) {
+    if (m_num_nodes >= 2 * m_buckets.size()) {
+      std::vector< node_t* > buckets(2 * m_buckets.size(), nullptr);
+      for (node_t* b : m_buckets) {
+        while (b) {
+          node_t* next = b->m_next;
+          node_t*& head = buckets[b->m_hash & (buckets.size() - 1)];
+          b->m_next = head;
+          head = b;
+          b = next;
+        }
+      }
+      std::swap(m_buckets, buckets);
+    }
+    node_t*& head = m_buckets[n->m_hash & (m_buckets.size() - 1)];
+    n->m_next = head;
+    head = n;
+    ++m_num_nodes;
+  }
+
+public:
+  static node_table& get() {
+    // never destroyed: trees can still be alive while static
+    // destructors run.
+    static node_table* table = new node_table();
+    return *table;
+  }
+
+  tree_ptr_t make_leaf(const Key& key, const Value& value) {
+    std::size_t h = hash_value(value);
+    boost::hash_combine(h, key.index());
+    std::lock_guard< std::mutex > lock(m_mutex);
+    for (node_t* n = m_buckets[h & (m_buckets.size() - 1)]; n;
+         n = n->m_next) {
+      if (n->m_hash == h && n->m_is_leaf && n->m_prefix == key.index() &&
+          n->value() == value && try_acquire(n)) {
+        return tree_ptr_t(n);
+      }
+    }
+    node_t* n = new (allocate()) node_t(h, key, value);
+    link(n);
+    return tree_ptr_t(n);
+  }
+
+  // left_branch and right_branch are not empty
+  tree_ptr_t make_node(index_t prefix,
+                       index_t branching_bit,
+                       const tree_ptr_t& left_branch,
+                       const tree_ptr_t& right_branch) {
+    std::size_t h = 0;
+    boost::hash_combine(h, prefix);
+    boost::hash_combine(h, branching_bit);
+    boost::hash_combine(h, left_branch.get());
+    boost::hash_combine(h, right_branch.get());
+    std::lock_guard< std::mutex > lock(m_mutex);
+    for (node_t* n = m_buckets[h & (m_buckets.size() - 1)]; n;
+         n = n->m_next) {
+      if (n->m_hash == h && !n->m_is_leaf && n->m_prefix == prefix &&
+          n->m_branching_bit == branching_bit &&
+          n->m_left_branch == left_branch &&
+          n->m_right_branch == right_branch && try_acquire(n)) {
+        return tree_ptr_t(n);
+      }
+    }
+    node_t* n = new (allocate())
+        node_t(h, prefix, branching_bit, left_branch, right_branch);
+    link(n);
+    return tree_ptr_t(n);
+  }
+
+  // n has no references left
+  void free(const node_t* cn) {
+    node_t* n = const_cast< node_t* >(cn);
+    tree_ptr_t left_branch, right_branch;
+    {
+      std::lock_guard< std::mutex > lock(m_mutex);
+      node_t** p = &m_buckets[n->m_hash & (m_buckets.size() - 1)];
+      while (*p != n) {
+        p = &(*p)->m_next;
+      }
+      *p = n->m_next;
+      --m_num_nodes;
+      // the children are released outside of the lock
+      left_branch = std::move(n->m_left_branch);
+      right_branch = std::move(n->m_right_branch);
+      n->~node_t();
+      n->m_next = m_free;
+      m_free = n;
+    }
+  }
+
+  // number of live nodes
+  std::size_t size() {
+    std::lock_guard< std::mutex > lock(m_mutex);
+    return m_num_nodes;
+  }
+
+}; // class node_table
+
+template < typename Key, typename Value >
+class tree {
+public:
+  typedef node< Key, Value > node_t;
+  typedef node_table< Key, Value > node_table_t;
+  typedef tree_ptr< Key, Value > ptr;
+  typedef unary_op< Value > unary_op_t;
+  typedef binary_op< Value > binary_op_t;
+  typedef key_binary_op< Key, Value > key_binary_op_t;
+  typedef partial_order< Value > partial_order_t;
+  typedef typename node_t::binding_t binding_t;
+
+private:
+  static boost::optional< Value > apply(binary_op_t& op,
+                                        const Key&,
+                                        const Value& x,
+                                        const Value& y) {
+    return op.apply(x, y);
+  }
+
+  static boost::optional< Value > apply(key_binary_op_t& op,
+                                        const Key& k,
+                                        const Value& x,
+                                        const Value& y) {
+    return op.apply(k, x, y);
+  }
+
+  // apply op on the two values of key; the result is s if it does
+  // not change the value of s.
+  template < typename Op >
+  static ptr combine(const ptr& s,
+                     const Value& y,
+                     Op& op,
+                     bool combine_left_to_right) {
+    const Value& x = s->value();
+    boost::optional< Value > new_value =
+        combine_left_to_right ? apply(op, s->key(), x, y)
+                              : apply(op, s->key(), y, x);
+    if (new_value) {
+      if (*new_value == x) {
+        return s;
+      } else {
+        return make_leaf(s->key(), *new_value);
+      }
+    } else {
+      return ptr();
+    }
+  }
+
+public:
+  static ptr make_leaf(const Key& key, const Value& value) {
+    return node_table_t::get().make_leaf(key, value);
+  }
+
+  static ptr make_node(index_t prefix,
+                       index_t branching_bit,
+                       const ptr& left_branch,
+                       const ptr& right_branch) {
+    if (left_branch) {
+      if (right_branch) {
+        return node_table_t::get().make_node(prefix, branching_bit,
+                                             left_branch, right_branch);
+      } else {
+        return left_branch;
+      }
+    } else {
+      return right_branch;
+    }
+  }
+
+  static ptr join(const ptr& t0, const ptr& t1) {
+    index_t p0 = t0->prefix();
+    index_t p1 = t1->prefix();
+    index_t m =
+        compute_branching_bit(p0, t0->branching_bit(), p1, t1->branching_bit());
+    if (zero_bit(p0, m)) {
+      return make_node(mask(p0, m), m, t0, t1);
+    } else {
+      return make_node(mask(p0, m), m, t1, t0);
+    }
+  }
+
+  template < typename Op >
+  static ptr insert(const ptr& t,
+                    const Key& key_,
+                    const Value& value_,
+                    Op& op,
+                    bool combine_left_to_right) {
+    if (!t) {
+      return op.default_is_absorbing() ? ptr() : make_leaf(key_, value_);
+    }
+    index_t id = key_.index();
+    if (t->is_node()) {
+      index_t branching_bit = t->branching_bit();
+      index_t prefix = t->prefix();
+      if (match_prefix(id, prefix, branching_bit)) {
+        const ptr& lb = t->left_branch();
+        const ptr& rb = t->right_branch();
+        if (zero_bit(id, branching_bit)) {
+          ptr new_lb = insert(lb, key_, value_, op, combine_left_to_right);
+          return (new_lb == lb ? t
+                               : make_node(prefix, branching_bit, new_lb, rb));
+        } else {
+          ptr new_rb = insert(rb, key_, value_, op, combine_left_to_right);
+          return (new_rb == rb ? t
+                               : make_node(prefix, branching_bit, lb, new_rb));
+        }
+      }
+    } else if (t->prefix() == id) {
+      return combine(t, value_, op, combine_left_to_right);
+    }
+    if (op.default_is_absorbing()) {
+      return t;
+    } else {
+      return join(make_leaf(key_, value_), t);
+    }
+  }
+
+  static ptr transform(const ptr& t, unary_op_t& op) {
+    if (!t) {
+      return t;
+    } else if (t->is_node()) {
+      const ptr& lb = t->left_branch();
+      const ptr& rb = t->right_branch();
+      ptr new_lb = transform(lb, op);
+      ptr new_rb = transform(rb, op);
+      if (lb == new_lb && rb == new_rb) {
+        return t;
+      } else {
+        return make_node(t->prefix(), t->branching_bit(), new_lb, new_rb);
+      }
+    } else {
+      boost::optional< Value > new_value = op.apply(t->value());
+      if (new_value) {
+        if (*new_value == t->value()) {
+          return t;
+        } else {
+          return make_leaf(t->key(), *new_value);
+        }
+      } else {
+        return ptr();
+      }
+    }
+  }
+
+  static ptr remove(const ptr& t, const Key& key_) {
+    index_t id = key_.index();
+    if (!t) {
+      return t;
+    } else if (t->is_node()) {
+      index_t branching_bit = t->branching_bit();
+      index_t prefix = t->prefix();
+      if (match_prefix(id, prefix, branching_bit)) {
+        const ptr& lb = t->left_branch();
+        const ptr& rb = t->right_branch();
+        if (zero_bit(id, branching_bit)) {
+          ptr new_lb = remove(lb, key_);
+          return (new_lb == lb ? t
+                               : make_node(prefix, branching_bit, new_lb, rb));
+        } else {
+          ptr new_rb = remove(rb, key_);
+          return (new_rb == rb ? t
+                               : make_node(prefix, branching_bit, lb, new_rb));
+        }
+      } else {
+        return t;
+      }
+    } else {
+      return (t->prefix() == id ? ptr() : t);
+    }
+  }
+
+  template < typename Op >
+  static ptr merge(const ptr& s,
+                   const ptr& t,
+                   Op& op,
+                   bool combine_left_to_right) {
+    if (!s || !t) {
+      if (op.default_is_absorbing()) {
+        return ptr();
+      } else {
+        return (s ? s : t);
+      }
+    } else if (s == t) {
+      // structurally equal and op is idempotent
+      return s;
+    } else if (s->is_leaf()) {
+      if (op.default_is_absorbing()) {
+        const Value* value = t->lookup(s->prefix());
+        return (value ? combine(s, *value, op, combine_left_to_right)
+                      : ptr());
+      } else {
+        return insert(t, s->key(), s->value(), op, !combine_left_to_right);
+      }
+    } else if (t->is_leaf()) {
+      if (op.default_is_absorbing()) {
+        const Value* value = s->lookup(t->prefix());
+        return (value ? combine(t, *value, op, !combine_left_to_right)
+                      : ptr());
+      } else {
+        return insert(s, t->key(), t->value(), op, combine_left_to_right);
+      }
+    } else if (s->branching_bit() == t->branching_bit() &&
+               s->prefix() == t->prefix()) {
+      ptr new_lb = merge(s->left_branch(), t->left_branch(), op,
+                         combine_left_to_right);
+      ptr new_rb = merge(s->right_branch(), t->right_branch(), op,
+                         combine_left_to_right);
+      if (new_lb == s->left_branch() && new_rb == s->right_branch()) {
+        return s;
+      } else if (new_lb == t->left_branch() && new_rb == t->right_branch()) {
+        return t;
+      } else {
+        return make_node(s->prefix(), s->branching_bit(), new_lb, new_rb);
+      }
+    } else if (s->branching_bit() > t->branching_bit() &&
+               match_prefix(t->prefix(), s->prefix(), s->branching_bit())) {
+      return merge_below(s, t, op, combine_left_to_right);
+    } else if (s->branching_bit() < t->branching_bit() &&
+               match_prefix(s->prefix(), t->prefix(), t->branching_bit())) {
+      return merge_below(t, s, op, !combine_left_to_right);
+    } else if (op.default_is_absorbing()) {
+      return ptr();
+    } else {
+      return join(s, t);
+    }
+  }
+
+  // merge t into the subtree of s whose prefix t matches
+  template < typename Op >
+  static ptr merge_below(const ptr& s,
+                         const ptr& t,
+                         Op& op,
+                         bool combine_left_to_right) {
+    const ptr& lb = s->left_branch();
+    const ptr& rb = s->right_branch();
+    ptr new_lb, new_rb;
+    if (zero_bit(t->prefix(), s->branching_bit())) {
+      new_lb = merge(lb, t, op, combine_left_to_right);
+      if (!op.default_is_absorbing()) {
+        new_rb = rb;
+      }
+    } else {
+      if (!op.default_is_absorbing()) {
+        new_lb = lb;
+      }
+      new_rb = merge(rb, t, op, combine_left_to_right);
+    }
+    if (new_lb == lb && new_rb == rb) {
+      return s;
+    } else {
+      return make_node(s->prefix(), s->branching_bit(), new_lb, new_rb);
+    }
+  }
+
+  static void compare(const node_t* s,
+                      const node_t* t,
+                      partial_order_t& po,
+                      bool compare_left_to_right) {
+    // whether a key bound only in t (resp. only in s) makes the
+    // comparison fail
+    bool left_missing_fails =
+        (compare_left_to_right && po.default_is_top()) ||
+        (!compare_left_to_right && !po.default_is_top());
+    bool right_missing_fails = !left_missing_fails;
+    if (s == t) {
+      // s and t are structurally equal (possibly both empty)
+      return;
+    } else if (!s) {
+      if (left_missing_fails) {
+        throw failed();
+      }
+    } else if (!t) {
+      if (right_missing_fails) {
+        throw failed();
+      }
+    } else if (s->is_leaf()) {
+      const Value* value_ = t->lookup(s->prefix());
+      if (value_) {
+        const Value& left = compare_left_to_right ? s->value() : *value_;
+        const Value& right = compare_left_to_right ? *value_ : s->value();
+        if (!po.leq(left, right)) {
+          throw failed();
+        }
+      } else if (right_missing_fails) {
+        throw failed();
+      }
+      if (t->is_node() && left_missing_fails) {
+        throw failed();
+      }
+    } else if (t->is_leaf()) {
+      compare(t, s, po, !compare_left_to_right);
+    } else if (s->branching_bit() == t->branching_bit() &&
+               s->prefix() == t->prefix()) {
+      compare(s->left_branch().get(), t->left_branch().get(), po,
+              compare_left_to_right);
+      compare(s->right_branch().get(), t->right_branch().get(), po,
+              compare_left_to_right);
+    } else if (s->branching_bit() > t->branching_bit() &&
+               match_prefix(t->prefix(), s->prefix(), s->branching_bit())) {
+      if (right_missing_fails) {
+        throw failed();
+      }
+      if (zero_bit(t->prefix(), s->branching_bit())) {
+        compare(s->left_branch().get(), t, po, compare_left_to_right);
+      } else {
+        compare(s->right_branch().get(), t, po, compare_left_to_right);
+      }
+    } else if (s->branching_bit() < t->branching_bit() &&
+               match_prefix(s->prefix(), t->prefix(), t->branching_bit())) {
+      if (left_missing_fails) {
+        throw failed();
+      }
+      if (zero_bit(s->prefix(), t->branching_bit())) {
+        compare(s, t->left_branch().get(), po, compare_left_to_right);
+      } else {
+        compare(s, t->right_branch().get(), po, compare_left_to_right);
+      }
+    } else {
+      throw failed();
+    }
+  }
+
+  class iterator : public boost::iterator_facade< iterator,
+                                                  binding_t,
+                                                  boost::forward_traversal_tag,
+                                                  binding_t > {
+    friend class boost::iterator_core_access;
+
+  private:
+    typedef std::pair< const node_t*, int > branching_t;
+    typedef std::vector< branching_t > branching_stack_t;
+
+    // keep the nodes alive while iterating
+    ptr _root;
+    const node_t* _current;
+    branching_stack_t _stack;
+
+  public:
+    iterator() : _current(nullptr) {}
+
+    iterator(const ptr& t) : _root(t), _current(nullptr) {
+      if (t) {
+        this->look_for_next_leaf(t.get());
+      }
+    }
+
+  private:
+    void look_for_next_leaf(const node_t* t) {
+      while (t->is_node()) {
+        this->_stack.push_back(branching_t(t, 0));
+        t = t->left_branch().get();
+      }
+      this->_current = t;
+    }
+
+    void increment() {
+      if (this->_current) {
+        this->_current = nullptr;
+        while (!this->_stack.empty() && this->_stack.back().second == 1) {
+          this->_stack.pop_back();
+        }
+        if (!this->_stack.empty()) {
+          this->_stack.back().second = 1;
+          this->look_for_next_leaf(
+              this->_stack.back().first->right_branch().get());
+        }
+      } else {
+        CRAB_ERROR("Patricia tree: trying to increment an empty iterator");
+      }
+    }
+
+    bool equal(const iterator& it) const {
+      return this->_current == it._current && this->_stack == it._stack;
+    }
+
+    binding_t dereference() const {
+      if (this->_current) {
+        return this->_current->binding();
+      } else {
+        CRAB_ERROR("Patricia tree: trying to dereference an empty iterator");
+      }
+    }
+
+  }; // class iterator
+
+}; // class tree
+
+} // namespace hc_patricia_trees_impl
+
+template < typename Key, typename Value >
+class hc_patricia_tree {
+private:
+  typedef hc_patricia_trees_impl::tree< Key, Value > tree_t;
+  typedef typename tree_t::ptr tree_ptr;
+
+public:
+  typedef hc_patricia_tree< Key, Value > patricia_tree_t;
+  typedef typename tree_t::unary_op_t unary_op_t;
+  typedef typename tree_t::binary_op_t binary_op_t;
+  typedef typename tree_t::key_binary_op_t key_binary_op_t;
+  typedef typename tree_t::partial_order_t partial_order_t;
+  typedef typename tree_t::binding_t binding_t;
+  typedef typename tree_t::iterator iterator;
+
+private:
+  tree_ptr _tree;
+
+  class insert_op : public binary_op_t {
+  public:
+    boost::optional< Value > apply(Value /* old_value */, Value new_value) {
+      return boost::optional< Value >(new_value);
+    }
+
+    bool default_is_absorbing() { return false; }
+
+  }; // class insert_op
+
+public:
+  hc_patricia_tree() {}
+
+  std::size_t size() const { return this->_tree ? this->_tree->size() : 0; }
+
+  iterator begin() const { return iterator(this->_tree); }
+
+  iterator end() const { return iterator(); }
+
+  boost::optional< Value > lookup(const Key& key) const {
+    if (this->_tree) {
+      const Value* v = this->_tree->lookup(key.index());
+      if (v) {
+        return boost::optional< Value >(*v);
+      }
+    }
+    return boost::optional< Value >();
+  }
+
+  void merge_with(const patricia_tree_t& t, binary_op_t& op) {
+    this->_tree = tree_t::merge(this->_tree, t._tree, op, true);
+  }
+
+  void merge_with(const patricia_tree_t& t, key_binary_op_t& op) {
+    this->_tree = tree_t::merge(this->_tree, t._tree, op, true);
+  }
+
+  void insert(const Key& key, const Value& value) {
+    insert_op op;
+    this->_tree = tree_t::insert(this->_tree, key, value, op, true);
+  }
+
+  void transform(unary_op_t& op) {
+    this->_tree = tree_t::transform(this->_tree, op);
+  }
+
+  void remove(const Key& key) {
+    this->_tree = tree_t::remove(this->_tree, key);
+  }
+
+  void clear() { this->_tree = tree_ptr(); }
+
+  bool empty() const { return !this->_tree; }
+
+  bool leq(const patricia_tree_t& t, partial_order_t& po) const {
+    try {
+      tree_t::compare(this->_tree.get(), t._tree.get(), po, true);
+      return true;
+    } catch (hc_patricia_trees_impl::failed& e) {
+      return false;
+    }
+  }
+
+  // Structural equality in constant time
+  bool operator==(const patricia_tree_t& t) const {
+    return this->_tree == t._tree;
+  }
+
+  bool operator!=(const patricia_tree_t& t) const {
+    return this->_tree != t._tree;
+  }
+
+}; // class hc_patricia_tree
+
+} // namespace ikos
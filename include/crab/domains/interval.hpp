@@ -8,6 +8,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <boost/functional/hash.hpp>
 #include <crab/common/types.hpp>
 #include <crab/common/stats.hpp>
 #include <crab/common/bignums.hpp>
@@ -197,6 +198,12 @@ namespace ikos {
     bool operator!=(bound_t x) const {
       return !operator==(x);
     }
+
+    friend std::size_t hash_value(const bound_t& b) {
+      std::size_t h = boost::hash_value(b._is_infinite);
+      boost::hash_combine(h, b._n);
+      return h;
+    }
     
     /*	operator<= and operator>= use a somewhat optimized implementation.
      *	results include up to 20% improvements in performance in the octagon domain
@@ -380,6 +387,15 @@ namespace ikos {
       return !operator==(x);
     }
 
+    friend std::size_t hash_value(const interval_t& i) {
+      if (i.is_bottom()) {
+        return 0;
+      }
+      std::size_t h = hash_value(i._lb);
+      boost::hash_combine(h, i._ub);
+      return h;
+    }
+
     bool operator<=(interval_t x) const {
       if (is_bottom()) {
         return true;
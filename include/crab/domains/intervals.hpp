@@ -48,6 +48,7 @@
 #include <crab/domains/linear_interval_solver.hpp>
 #include <crab/domains/separate_domains.hpp>
 #include <crab/domains/abstract_domain.hpp>
+#include <crab/domains/abstract_domain_specialized_traits.hpp>
 #include <crab/domains/backward_assign_operations.hpp>
 
 namespace ikos {
@@ -96,6 +97,12 @@ namespace ikos {
     inline q_interval upper_half_line(q_interval i, bool /*is_signed*/) {
       return i.upper_half_line();
     }
+
+    template<>
+    struct has_independent_bounds<z_interval> { enum { value = 1 }; };
+
+    template<>
+    struct has_independent_bounds<q_interval> { enum { value = 1 }; };
   } // namespace linear_interval_solver_impl
 
   template<typename Number, typename VariableName, std::size_t max_reduction_cycles = 10>
@@ -129,6 +136,13 @@ namespace ikos {
 
     interval_domain(separate_domain_t env): _env(env) { }
 
+    // The solver is reused across calls to avoid allocating its
+    // tables each time constraints are added.
+    static solver_t& get_solver() {
+      static thread_local solver_t solver(max_reduction_cycles);
+      return solver;
+    }
+
   public:
     
     void set_to_top() {
@@ -145,13 +159,13 @@ namespace ikos {
 
     interval_domain(const interval_domain_t& e): 
       _env(e._env) { 
-      crab::CrabStats::count (getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
     }
 
     interval_domain_t& operator=(const interval_domain_t& o) {
-      crab::CrabStats::count (getDomainName() + ".count.copy");
-      crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
       if (this != &o)
         this->_env = o._env;
       return *this;
@@ -174,63 +188,63 @@ namespace ikos {
     }
 
     bool operator<=(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.leq");
-      crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.leq"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
       return (this->_env <= e._env);
     }
 
     void operator|=(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.join"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
       this->_env = this->_env | e._env;
     }
 
     interval_domain_t operator|(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.join");
-      crab::ScopedCrabStats __st__(getDomainName() + ".join");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.join"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
       return (this->_env | e._env);
     }
 
     interval_domain_t operator&(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.meet");
-      crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.meet"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
       return (this->_env & e._env);
     }
 
     interval_domain_t operator||(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.widening"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
       return (this->_env || e._env);
     }
 
     template<typename Thresholds>
     interval_domain_t widening_thresholds (interval_domain_t e, const Thresholds &ts) {
-      crab::CrabStats::count (getDomainName() + ".count.widening");
-      crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.widening"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
       return this->_env.widening_thresholds (e._env, ts);
     }
 
     interval_domain_t operator&&(interval_domain_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.narrowing");
-      crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
       return (this->_env && e._env);
     }
 
     void set(variable_t v, interval_t i) {
-      crab::CrabStats::count (getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
       this->_env.set(v, i);
     }
 
     void set(variable_t v, number_t n) {
-      crab::CrabStats::count (getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
       this->_env.set(v, interval_t(n));
     }
 
     void operator-=(variable_t v) {
-      crab::CrabStats::count (getDomainName() + ".count.forget");
-      crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.forget"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
       this->_env -= v;
     }
     
@@ -249,8 +263,8 @@ namespace ikos {
     }
     
     void operator+=(linear_constraint_system_t csts) {
-      crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-      crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
       this->add(csts);
     }
 
@@ -266,7 +280,8 @@ namespace ikos {
 	  }
 	  signed_csts += c;
 	}
-	solver_t solver(signed_csts, threshold);
+	solver_t& solver = get_solver();
+	solver.reset(signed_csts, threshold);
 	solver.run(this->_env);
       }
     }
@@ -278,8 +293,8 @@ namespace ikos {
     }
     
     void assign(variable_t x, linear_expression_t e) {
-      crab::CrabStats::count (getDomainName() + ".count.assign");
-      crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
       if (boost::optional<variable_t> v = e.get_variable ()) {
         this->_env.set(x, this->_env [(*v)]);
@@ -294,9 +309,20 @@ namespace ikos {
       }
     }
 
+    // Join of the state before and after x := e
+    void weak_assign(variable_t x, linear_expression_t e) {
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.weak_assign"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".weak_assign"));
+
+      if (this->is_bottom()) {
+	return;
+      }
+      this->_env.set(x, this->_env[x] | this->operator[](e));
+    }
+
     void apply(operation_t op, variable_t x, variable_t y, variable_t z) {
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
       interval_t yi = this->_env[y];
       interval_t zi = this->_env[z];
@@ -331,8 +357,8 @@ namespace ikos {
     }
 
     void apply(operation_t op, variable_t x, variable_t y, number_t k) {
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
       interval_t yi = this->_env[y];
       interval_t zi(k);
@@ -436,8 +462,8 @@ namespace ikos {
 
     // bitwise operations
     void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z){
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
       interval_t yi = this->_env[y];
       interval_t zi = this->_env[z];
@@ -475,8 +501,8 @@ namespace ikos {
     }
     
     void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k){
-      crab::CrabStats::count (getDomainName() + ".count.apply");
-      crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+      crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
       interval_t yi = this->_env[y];
       interval_t zi(k);
@@ -522,8 +548,8 @@ namespace ikos {
     }
     
     void project(const variable_vector_t& variables){
-      crab::CrabStats::count(getDomainName() + ".count.project");
-      crab::ScopedCrabStats __st__(getDomainName() + ".project");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
       
       if (is_bottom() || is_top()) {
 	return;
@@ -537,8 +563,8 @@ namespace ikos {
     }
   
     void expand (variable_t x, variable_t new_x) {
-      crab::CrabStats::count(getDomainName() + ".count.expand");
-      crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
       
       if (is_bottom() || is_top()) {
 	return;
@@ -599,6 +625,19 @@ namespace domains {
     typedef VariableName varname_t;       
   };
   
+  template <typename Number, typename VariableName>
+  class weak_update_domain_traits<ikos::interval_domain<Number, VariableName>> {
+  public:
+    typedef ikos::interval_domain<Number, VariableName> interval_domain_t;
+    typedef typename interval_domain_t::variable_t variable_t;
+    typedef typename interval_domain_t::linear_expression_t linear_expression_t;
+
+    static void weak_assign(interval_domain_t& dom, const variable_t& x,
+			    const linear_expression_t& e) {
+      dom.weak_assign(x, e);
+    }
+  };
+
 }
 }
 
@@ -46,9 +46,9 @@
 #pragma once
 
 #include <vector>
-#include <set>
-#include <map>
+#include <type_traits>
 #include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
 #include <crab/common/types.hpp>
 #include <crab/common/debug.hpp>
 #include <crab/common/stats.hpp>
@@ -76,6 +76,84 @@ namespace ikos {
 
     template<typename Interval>
     Interval upper_half_line(Interval i, bool is_signed);
+
+    // If value is true then the lower and upper bounds of Interval
+    // can be summed independently (i.e., classical intervals) and the
+    // solver computes the residuals of all the variables of a
+    // constraint in one pass.
+    template<typename Interval>
+    struct has_independent_bounds { enum { value = 0 }; };
+
+    // Residuals of the variables of a constraint sum_i a_i*x_i op c.
+    // The residual of x_p is c - sum_{i != p} a_i*x_i. The lower and
+    // upper bounds of all terms are summed once and infinite bounds
+    // are counted rather than added so the sum without one term is
+    // obtained in constant time.
+    template<typename Interval, typename Number>
+    class linear_residuals {
+      std::vector<Interval> _terms;
+      Number _cst;
+      Number _lb_sum;
+      Number _ub_sum;
+      unsigned int _lb_inf;
+      unsigned int _ub_inf;
+
+      void add_bounds(const Interval& t) {
+	auto lb = t.lb();
+	auto ub = t.ub();
+	if (lb.is_finite()) _lb_sum += *(lb.number()); else ++_lb_inf;
+	if (ub.is_finite()) _ub_sum += *(ub.number()); else ++_ub_inf;
+      }
+
+      void remove_bounds(const Interval& t) {
+	auto lb = t.lb();
+	auto ub = t.ub();
+	if (lb.is_finite()) _lb_sum -= *(lb.number()); else --_lb_inf;
+	if (ub.is_finite()) _ub_sum -= *(ub.number()); else --_ub_inf;
+      }
+
+    public:
+      linear_residuals(): _cst(0), _lb_sum(0), _ub_sum(0), _lb_inf(0), _ub_inf(0) {}
+
+      void clear(Number cst) {
+	_terms.clear();
+	_cst = cst;
+	_lb_sum = 0;
+	_ub_sum = 0;
+	_lb_inf = 0;
+	_ub_inf = 0;
+      }
+
+      // add the term a_i*x_i
+      void add(const Interval& t) {
+	_terms.push_back(t);
+	add_bounds(t);
+      }
+
+      // replace the i-th term
+      void update(unsigned int i, const Interval& t) {
+	remove_bounds(_terms[i]);
+	_terms[i] = t;
+	add_bounds(t);
+      }
+
+      Interval residual(unsigned int i) const {
+	const Interval& t = _terms[i];
+	auto lb = t.lb();
+	auto ub = t.ub();
+	typedef decltype(lb) bound_t;
+	// c - sum has the opposite bounds of sum
+	bound_t res_lb = bound_t::minus_infinity();
+	bound_t res_ub = bound_t::plus_infinity();
+	if (_ub_inf == (ub.is_finite() ? 0 : 1)) {
+	  res_lb = bound_t(_cst - (ub.is_finite() ? _ub_sum - *(ub.number()) : _ub_sum));
+	}
+	if (_lb_inf == (lb.is_finite() ? 0 : 1)) {
+	  res_ub = bound_t(_cst - (lb.is_finite() ? _lb_sum - *(lb.number()) : _lb_sum));
+	}
+	return Interval(res_lb, res_ub);
+      }
+    };
   } 
 
   template< typename Number, typename VariableName, typename IntervalCollection >
@@ -91,9 +169,14 @@ namespace ikos {
     
   private:
     typedef std::vector< linear_constraint_t > cst_table_t;
-    typedef std::set< unsigned int > uint_set_t;
-    typedef std::map< variable_t, uint_set_t > trigger_table_t;
-    typedef typename linear_constraint_t::variable_set_t variable_set_t;
+    typedef std::vector< unsigned int > uint_vector_t;
+    // variables are numbered densely per system of constraints
+    typedef boost::unordered_map< variable_t, unsigned int > var_index_t;
+    // for each variable, the constraints where it occurs
+    typedef std::vector< uint_vector_t > trigger_table_t;
+    typedef linear_interval_solver_impl::linear_residuals<Interval, Number> residuals_t;
+    typedef std::integral_constant<bool, linear_interval_solver_impl::
+				   has_independent_bounds<Interval>::value> linear_residuals_t;
 
   private:
     class bottom_found { };
@@ -104,18 +187,27 @@ namespace ikos {
     bool _is_contradiction;
     bool _is_large_system;
     cst_table_t _cst_table;
+    // for each constraint, the indexes of its variables in the same
+    // order as its terms
+    std::vector< uint_vector_t > _cst_vars;
+    var_index_t _var_index;
     trigger_table_t _trigger_table;
-    variable_set_t _refined_variables;
+    // constraints pending to be propagated
+    uint_vector_t _worklist;
+    std::vector<bool> _in_worklist;
+    residuals_t _residuals;
+    bool _refined;
     std::size_t _op_count;
     
   private:
     static const std::size_t _large_system_cst_threshold = 3;
     // cost of one propagation cycle for a dense 3x3 system of constraints 
     static const std::size_t _large_system_op_threshold = 27; 
-
+    
   private:
-    void refine(variable_t v, Interval i, IntervalCollection& env) {
-      crab::ScopedCrabStats __st__("Linear Interval Solver.Solving refinement");
+    // Return true if the interval of v has been refined
+    bool refine(variable_t v, unsigned int v_idx, Interval i, IntervalCollection& env) {
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Linear Interval Solver.Solving refinement"));
       CRAB_LOG("integer-solver",
 	       crab::outs() << "\tRefine " << v << " with " << i << "\n";);
       Interval old_i = env[v];
@@ -127,14 +219,27 @@ namespace ikos {
       }
       if (!(old_i == new_i)) {
 	env.set(v, new_i);
-	this->_refined_variables += v;
-	++(this->_op_count);
+	refined(v_idx);
+	return true;
+      }
+      return false;
+    }
+
+    void refined(unsigned int v_idx) {
+      this->_refined = true;
+      if (this->_is_large_system) {
+	for (unsigned int c: this->_trigger_table[v_idx]) {
+	  if (!this->_in_worklist[c]) {
+	    this->_in_worklist[c] = true;
+	    this->_worklist.push_back(c);
+	  }
+	}
       }
     }
 
     Interval compute_residual(const linear_constraint_t &cst, variable_t pivot, 
                               IntervalCollection& env) {
-      crab::ScopedCrabStats __st__("Linear Interval Solver.Solving computing residual");
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Linear Interval Solver.Solving computing residual"));
       namespace interval_traits = linear_interval_solver_impl;      
       bitwidth_t w = pivot.get_bitwidth();
       Interval residual= interval_traits::mk_interval<Interval>(cst.constant(), w);
@@ -142,107 +247,186 @@ namespace ikos {
 	variable_t v = it->second;
 	if (!(v == pivot)) {
 	  residual = residual - (interval_traits::mk_interval<Interval>(it->first, w) * env[v]);
-	  ++(this->_op_count);
 	  if (residual.is_top()) break;
 	}
       }
       return residual;
     }
-    
-    void propagate(const linear_constraint_t &cst, IntervalCollection& env) {
-      crab::ScopedCrabStats __st__("Linear Interval Solver.Solving propagation");
-      namespace interval_traits = linear_interval_solver_impl;
 
-      CRAB_LOG("integer-solver",
-	       linear_constraint_t tmp(cst);
-	       crab::outs() << "Integer solver processing " << tmp << "\n";);
-	       
+    // Refine the pivot given the residual of the rest of the
+    // constraint. Return true if the interval of the pivot changed.
+    bool refine_pivot(const linear_constraint_t& cst, Number c, variable_t pivot,
+		      unsigned int pivot_idx, Interval res, IntervalCollection& env) {
+      namespace interval_traits = linear_interval_solver_impl;
+      Interval rhs = Interval::top();
+      if (!res.is_top()) {
+	Interval ic = interval_traits::mk_interval<Interval>(c, pivot.get_bitwidth());
+	rhs = res / ic;
+      }
       
+      if (cst.is_equality()) {
+	return refine(pivot, pivot_idx, rhs, env);
+      } else if (cst.is_inequality()) {
+	if (c > 0) {
+	  return refine(pivot, pivot_idx,
+			interval_traits::lower_half_line(rhs, cst.is_signed()), env);
+	} else {
+	  return refine(pivot, pivot_idx,
+			interval_traits::upper_half_line(rhs, cst.is_signed()), env);
+	}
+      } else if (cst.is_strict_inequality()) {
+	// do nothing
+	return false;
+      } else {
+	// cst is a disequation
+	Interval old_i = env[pivot];
+	Interval new_i = interval_traits::trim_interval(old_i, rhs);
+	if (new_i.is_bottom()) {
+	  throw bottom_found();
+	}
+	if (!(old_i == new_i)) {
+	  env.set(pivot, new_i);
+	  refined(pivot_idx);
+	  return true;
+	}
+	return false;
+      }
+    }
+    
+    // Each residual is computed from scratch: quadratic in the size
+    // of the constraint.
+    void propagate(unsigned int cst_idx, IntervalCollection& env, std::false_type) {
+      const linear_constraint_t& cst = this->_cst_table[cst_idx];
+      const uint_vector_t& vars = this->_cst_vars[cst_idx];
+      unsigned int i = 0;
+      for (typename linear_constraint_t::iterator it = cst.begin(), et = cst.end();
+	   it != et; ++it, ++i) {
+	Interval res = compute_residual(cst, it->second, env);
+	refine_pivot(cst, it->first, it->second, vars[i], res, env);
+      }
+    }
+
+    // All residuals are computed in one pass and updated as the
+    // pivots are refined: linear in the size of the constraint.
+    void propagate(unsigned int cst_idx, IntervalCollection& env, std::true_type) {
+      namespace interval_traits = linear_interval_solver_impl;
+      const linear_constraint_t& cst = this->_cst_table[cst_idx];
+      const uint_vector_t& vars = this->_cst_vars[cst_idx];
+      {
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID("Linear Interval Solver.Solving computing residual"));
+	this->_residuals.clear(cst.constant());
+	for (auto const& kv: cst) {
+	  bitwidth_t w = kv.second.get_bitwidth();
+	  this->_residuals.add(interval_traits::mk_interval<Interval>(kv.first, w) * env[kv.second]);
+	}
+      }
+      unsigned int i = 0;
       for (typename linear_constraint_t::iterator it = cst.begin(), et = cst.end();
-	   it != et; ++it) {
+	   it != et; ++it, ++i) {
 	Number c = it->first;
 	variable_t pivot = it->second;
-	Interval res = compute_residual(cst, pivot, env);
-	Interval rhs = Interval::top();
-	if (!res.is_top()) {
+	if (refine_pivot(cst, c, pivot, vars[i], this->_residuals.residual(i), env)) {
 	  Interval ic = interval_traits::mk_interval<Interval>(c, pivot.get_bitwidth());
-	  rhs = res / ic;
-	}
-	
-	if (cst.is_equality()) {
-	  refine(pivot, rhs, env);
-	} else if (cst.is_inequality()) {
-	  if (c > 0) {
-	    refine(pivot, interval_traits::lower_half_line(rhs, cst.is_signed()), env);
-	  } else {
-	    refine(pivot, interval_traits::upper_half_line(rhs, cst.is_signed()), env);
-	  }
-	} else if (cst.is_strict_inequality()) {
-	  // do nothing
-	} else {
-	  // cst is a disequation
-	  Interval old_i = env[pivot];
-	  Interval new_i = interval_traits::trim_interval(old_i, rhs);
-	  if (new_i.is_bottom()) {
-	    throw bottom_found();
-	  }
-	  if (!(old_i == new_i)) {
-	    env.set(pivot, new_i);
-	    this->_refined_variables += pivot;
-	  }
-	  ++(this->_op_count);
+	  this->_residuals.update(i, ic * env[pivot]);
 	}
       }
     }
     
+    void propagate(unsigned int cst_idx, IntervalCollection& env) {
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Linear Interval Solver.Solving propagation"));
+      CRAB_LOG("integer-solver",
+	       linear_constraint_t tmp(this->_cst_table[cst_idx]);
+	       crab::outs() << "Integer solver processing " << tmp << "\n";);
+      // the budget of a large system is measured in number of terms
+      // so that it does not depend on how the residuals are computed
+      this->_op_count += this->_cst_vars[cst_idx].size();
+      propagate(cst_idx, env, linear_residuals_t());
+    }
+    
     void solve_large_system(IntervalCollection& env) {
       this->_op_count = 0;
-      this->_refined_variables.clear();
-      for (typename cst_table_t::iterator it = this->_cst_table.begin(); 
-           it != this->_cst_table.end(); ++it) {
-	this->propagate(*it, env);
+      this->_worklist.clear();
+      this->_in_worklist.assign(this->_cst_table.size(), true);
+      for (unsigned int i = 0; i < this->_cst_table.size(); ++i) {
+	this->_worklist.push_back(i);
       }
-      do {
-	variable_set_t vars_to_process(this->_refined_variables);
-	this->_refined_variables.clear();
-	for (typename variable_set_t::iterator it = vars_to_process.begin(); 
-               it != vars_to_process.end(); ++it) {
-	  uint_set_t& csts = this->_trigger_table[*it];
-	  for (typename uint_set_t::iterator cst_it = csts.begin(); 
-                 cst_it != csts.end(); ++cst_it) {
-	    this->propagate(this->_cst_table.at(*cst_it), env);
-	  }
+      std::size_t head = 0;
+      while (head < this->_worklist.size() && this->_op_count <= this->_max_op) {
+	unsigned int i = this->_worklist[head++];
+	this->_in_worklist[i] = false;
+	this->propagate(i, env);
+	if (head == this->_worklist.size()) {
+	  this->_worklist.clear();
+	  head = 0;
 	}
       }
-      while (!this->_refined_variables.empty() && 
-             this->_op_count <= this->_max_op);
     }
 
     void solve_small_system(IntervalCollection& env) {
       std::size_t cycle = 0;
       do {
 	++cycle;
-	this->_refined_variables.clear();
-	for (typename cst_table_t::iterator it = this->_cst_table.begin(); 
-               it != this->_cst_table.end(); ++it) {
-	  this->propagate(*it, env);
+	this->_refined = false;
+	for (unsigned int i = 0; i < this->_cst_table.size(); ++i) {
+	  this->propagate(i, env);
 	}
       }
-      while (!this->_refined_variables.empty() &&  cycle <= this->_max_cycles);
+      while (this->_refined &&  cycle <= this->_max_cycles);
+    }
+
+    unsigned int get_var_index(const variable_t& v) {
+      auto it = this->_var_index.find(v);
+      if (it != this->_var_index.end()) {
+	return it->second;
+      }
+      unsigned int idx = this->_var_index.size();
+      this->_var_index.insert(std::make_pair(v, idx));
+      return idx;
     }
     
+    void add_constraint(const linear_constraint_t& cst) {
+      unsigned int cst_idx = this->_cst_table.size();
+      this->_cst_table.push_back(cst);
+      if (this->_cst_vars.size() <= cst_idx) {
+	this->_cst_vars.resize(cst_idx + 1);
+      }
+      uint_vector_t& vars = this->_cst_vars[cst_idx];
+      vars.clear();
+      for (auto const& kv: cst) {
+	vars.push_back(get_var_index(kv.second));
+      }
+    }
     
   public:
 
-    linear_interval_solver(const linear_constraint_system_t &csts, std::size_t max_cycles)
-      : _max_cycles(max_cycles), 
+    // Create a solver without constraints. It can be reused for
+    // several systems of constraints by calling reset so the
+    // internal tables are not allocated each time.
+    linear_interval_solver(std::size_t max_cycles)
+      : _max_cycles(max_cycles),
+	_max_op(0),
         _is_contradiction(false), 
-        _is_large_system(false), 
-        _op_count(0) {
+        _is_large_system(false),
+	_refined(false),
+        _op_count(0) { }
+    
+    linear_interval_solver(const linear_constraint_system_t &csts, std::size_t max_cycles)
+      : linear_interval_solver(max_cycles) {
+      reset(csts, max_cycles);
+    }
 
-      crab::ScopedCrabStats __st_a__("Linear Interval Solver");
-      crab::ScopedCrabStats __st_b__("Linear Interval Solver.Preprocessing");      
+    void reset(const linear_constraint_system_t &csts, std::size_t max_cycles) {
+      crab::ScopedCrabStats __st_a__(CRAB_STATS_ID("Linear Interval Solver"));
+      crab::ScopedCrabStats __st_b__(CRAB_STATS_ID("Linear Interval Solver.Preprocessing"));      
+      this->_max_cycles = max_cycles;
+      this->_is_contradiction = false;
+      this->_is_large_system = false;
+      this->_op_count = 0;
+      this->_cst_table.clear();
+      this->_var_index.clear();
+      
       std::size_t op_per_cycle = 0;
+      std::size_t terms_per_cycle = 0;
       for (typename linear_constraint_system_t::iterator it = csts.begin(); 
            it != csts.end(); ++it) {
 	const linear_constraint_t &cst = *it;
@@ -257,11 +441,13 @@ namespace ikos {
 	    // convert e < c into {e <= c, e != c}
 	    linear_constraint_t c1(cst.expression(), linear_constraint_t::kind_t::INEQUALITY);
 	    linear_constraint_t c2(cst.expression(), linear_constraint_t::kind_t::DISEQUATION);
-	    this->_cst_table.push_back(c1);
-	    this->_cst_table.push_back(c2);
+	    add_constraint(c1);
+	    add_constraint(c2);
 	    cst_size = c1.size() + c2.size();
+	    terms_per_cycle += cst_size;
 	  } else {
-	    this->_cst_table.push_back(cst);
+	    add_constraint(cst);
+	    terms_per_cycle += cst_size;
 	  }
 	  // cost of one reduction step on the constraint in terms
 	  // of accesses to the interval collection
@@ -274,20 +460,25 @@ namespace ikos {
           (op_per_cycle > _large_system_op_threshold);
       
       if (!this->_is_contradiction && this->_is_large_system) {
-	this->_max_op = op_per_cycle * max_cycles;
+	this->_max_op = terms_per_cycle * max_cycles;
+	std::size_t num_vars = this->_var_index.size();
+	if (this->_trigger_table.size() < num_vars) {
+	  this->_trigger_table.resize(num_vars);
+	}
+	for (std::size_t v = 0; v < num_vars; ++v) {
+	  this->_trigger_table[v].clear();
+	}
 	for (unsigned int i = 0; i < this->_cst_table.size(); ++i) {
-	  const linear_constraint_t& cst = this->_cst_table.at(i);
-	  variable_set_t vars = cst.variables();
-	  for (typename variable_set_t::iterator it = vars.begin(); it != vars.end(); ++it) {
-	    this->_trigger_table[*it].insert(i);
+	  for (unsigned int v: this->_cst_vars[i]) {
+	    this->_trigger_table[v].push_back(i);
 	  }
 	}
       }
     }
     
     void run(IntervalCollection& env) {
-      crab::ScopedCrabStats __st_a__("Linear Interval Solver");
-      crab::ScopedCrabStats __st_b__("Linear Interval Solver.Solving");
+      crab::ScopedCrabStats __st_a__(CRAB_STATS_ID("Linear Interval Solver"));
+      crab::ScopedCrabStats __st_b__(CRAB_STATS_ID("Linear Interval Solver.Solving"));
       if (this->_is_contradiction) {
         env.set_to_bottom();
       } else {
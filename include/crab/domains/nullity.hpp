@@ -77,10 +77,14 @@ namespace crab {
       return false;
     }
 
-    bool operator==(nullity_value other) {
+    bool operator==(const nullity_value& other) const {
       return (_value == other._value);
     }
 
+    friend std::size_t hash_value(const nullity_value& v) {
+      return boost::hash_value(static_cast< int >(v._value));
+    }
+
     nullity_value operator|(nullity_value other) {
       return nullity_value(static_cast< kind_t >(
           static_cast< int >(this->_value) | static_cast< int >(other._value)));
@@ -425,8 +429,8 @@ namespace crab {
     }
     
     void project(const variable_vector_t& variables){
-      crab::CrabStats::count(getDomainName() + ".count.project");
-      crab::ScopedCrabStats __st__(getDomainName() + ".project");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
       
       if (is_bottom() || is_top()) {
 	return;
@@ -440,8 +444,8 @@ namespace crab {
     }
     
     void expand(variable_t x, variable_t new_x) {
-      crab::CrabStats::count(getDomainName() + ".count.expand");
-      crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+      crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
       
       if(is_bottom() || is_top()) {
 	return;
@@ -42,20 +42,23 @@
 
 #include <crab/common/types.hpp>
 #include <crab/domains/patricia_trees.hpp>
+#include <crab/domains/hc_patricia_trees.hpp>
 
 namespace ikos {
   
-  template < typename Key, typename Value >
+  // Tree is either patricia_tree or hc_patricia_tree
+  template < typename Key, typename Value,
+             typename Tree = patricia_tree< Key, Value > >
   class separate_domain: public writeable {
     
   private:
-    typedef patricia_tree< Key, Value > patricia_tree_t;
+    typedef Tree patricia_tree_t;
     typedef typename patricia_tree_t::unary_op_t unary_op_t;
     typedef typename patricia_tree_t::binary_op_t binary_op_t;
     typedef typename patricia_tree_t::partial_order_t partial_order_t;
 
   public:
-    typedef separate_domain< Key, Value > separate_domain_t;
+    typedef separate_domain< Key, Value, Tree > separate_domain_t;
     typedef typename patricia_tree_t::iterator iterator;
     typedef Key key_type;
     typedef Value value_type;
@@ -381,6 +384,13 @@ namespace ikos {
     }
     
   }; // class separate_domain
+
+  // Separate domain whose environments are hash-consed: environments
+  // that share most of their bindings are joined and compared without
+  // visiting the shared parts.
+  template < typename Key, typename Value >
+  using hc_separate_domain =
+      separate_domain< Key, Value, hc_patricia_tree< Key, Value > >;
   
 } // namespace ikos
 
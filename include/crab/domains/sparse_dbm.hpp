@@ -23,6 +23,8 @@
 #include <crab/domains/abstract_domain.hpp>
 #include <crab/domains/abstract_domain_specialized_traits.hpp>
 
+#include <algorithm>
+
 #include <boost/optional.hpp>
 #include <boost/unordered_set.hpp>
 #include <boost/container/flat_map.hpp>
@@ -236,6 +238,47 @@ namespace crab {
         bool default_is_absorbing() { return false; }
       };
 
+      typedef std::vector<std::pair<vert_id, Wt>> wt_edges_t;
+
+      // Collect the edges of v sorted by vertex
+      void edges_of(vert_id v, wt_edges_t& succs, wt_edges_t& preds) {
+        for(auto e : g.e_succs(v))
+          succs.push_back(std::make_pair(e.vert, e.val));
+        for(auto e : g.e_preds(v))
+          preds.push_back(std::make_pair(e.vert, e.val));
+        std::sort(succs.begin(), succs.end());
+        std::sort(preds.begin(), preds.end());
+      }
+
+      // Keep the edges present in both olds and news with the
+      // maximum of their weights
+      static void join_edges(const wt_edges_t& olds, const wt_edges_t& news,
+			     wt_edges_t& res) {
+        auto i = olds.begin();
+        auto j = news.begin();
+        while(i != olds.end() && j != news.end()) {
+          if(i->first < j->first) {
+            ++i;
+          } else if(j->first < i->first) {
+            ++j;
+          } else {
+            res.push_back(std::make_pair(i->first, std::max(i->second, j->second)));
+            ++i; ++j;
+          }
+        }
+      }
+
+      void forget_isolated(const wt_edges_t& edges) {
+        for(auto const& p : edges) {
+          vert_id v = p.first;
+          if(v != 0 && rev_map[v] && g.succs(v).size() == 0 && g.preds(v).size() == 0) {
+            g.forget(v);
+            vert_map.erase(*(rev_map[v]));
+            rev_map[v] = boost::none;
+          }
+        }
+      }
+
       vert_id get_vert(variable_t v)
       {
         auto it = vert_map.find(v);
@@ -846,8 +889,8 @@ namespace crab {
           _is_bottom(false)
       {
 
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
 
         if(o._is_bottom)
           set_to_bottom();
@@ -889,8 +932,8 @@ namespace crab {
 
       SparseDBM_& operator=(const SparseDBM_& o)
       {
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
 
         if(this != &o)
         {
@@ -956,8 +999,8 @@ namespace crab {
       }
     
       bool operator<=(DBM_t o)  {
-        crab::CrabStats::count (getDomainName() + ".count.leq");
-        crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.leq"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
 
         // cover all trivial cases to avoid allocating a dbm matrix
         if (is_bottom()) 
@@ -1019,8 +1062,8 @@ namespace crab {
       }
 
       DBM_t operator|(DBM_t o) {
-        crab::CrabStats::count (getDomainName() + ".count.join");
-        crab::ScopedCrabStats __st__(getDomainName() + ".join");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.join"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
 
         if (is_bottom() || o.is_top ())
           return o;
@@ -1110,8 +1153,8 @@ namespace crab {
       }
 
       DBM_t operator||(DBM_t o) {	
-        crab::CrabStats::count (getDomainName() + ".count.widening");
-        crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.widening"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
         if (is_bottom())
           return o;
@@ -1172,8 +1215,8 @@ namespace crab {
       }
 
       DBM_t operator&(DBM_t o) {
-        crab::CrabStats::count (getDomainName() + ".count.meet");
-        crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.meet"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
 
         if (is_bottom() || o.is_bottom())
           return DBM_t::bottom();
@@ -1269,8 +1312,8 @@ namespace crab {
       }
     
       DBM_t operator&&(DBM_t o) {
-        crab::CrabStats::count (getDomainName() + ".count.narrowing");
-        crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
 
         if (is_bottom() || o.is_bottom())
           return DBM_t::bottom();
@@ -1321,8 +1364,8 @@ namespace crab {
       }
 
       void operator-=(variable_t v) {
-        crab::CrabStats::count (getDomainName() + ".count.forget");
-        crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.forget"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 
         if (is_bottom ())
           return;
@@ -1343,8 +1386,8 @@ namespace crab {
 
       // Assumption: state is currently feasible.
       void assign(variable_t x, linear_expression_t e) {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
         if(is_bottom())
           return;
@@ -1481,9 +1524,71 @@ namespace crab {
                  crab::outs() << "---"<< x<< ":="<< e<<"\n"<<*this<<"\n";);
       }
 
+      // Join of the state before and after x := e.
+      //
+      // The graph is closed and the assignment leaves the relations
+      // between the other variables unchanged so the join only needs
+      // to relax the edges of x: an edge is kept if it exists both
+      // before and after the assignment, with the maximum of the two
+      // weights. The result is weaker than the state after the
+      // assignment so its potential remains valid, and no closure is
+      // needed.
+      void weak_assign(variable_t x, linear_expression_t e) {
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.weak_assign"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".weak_assign"));
+
+        if(is_bottom())
+          return;
+        normalize();
+
+        auto it = vert_map.find(x);
+        // x is unconstrained before the assignment so it is after the
+        // join.
+        if(it == vert_map.end())
+          return;
+        wt_edges_t old_succs, old_preds;
+        edges_of(it->second, old_succs, old_preds);
+
+        assign(x, e);
+        normalize();
+        if(is_bottom())
+          return;
+        wt_edges_t new_succs, new_preds;
+        it = vert_map.find(x);
+        if(it != vert_map.end()) {
+          vert_id v = it->second;
+          edges_of(v, new_succs, new_preds);
+
+          wt_edges_t succs, preds;
+          join_edges(old_succs, new_succs, succs);
+          join_edges(old_preds, new_preds, preds);
+
+          // Replace the vertex of x with one holding only the joined edges
+          Wt pot = potential[v];
+          this->operator-=(x);
+          if(!succs.empty() || !preds.empty()) {
+            v = get_vert(x);
+            potential[v] = pot;
+            for(auto const& p : succs)
+              g.add_edge(v, p.second, p.first);
+            for(auto const& p : preds)
+              g.add_edge(p.first, p.second, v);
+          }
+        }
+        // As the join does, forget the vertices left without edges
+        forget_isolated(old_succs);
+        forget_isolated(old_preds);
+        forget_isolated(new_succs);
+        forget_isolated(new_preds);
+
+        assert(check_potential(g, potential));
+        CRAB_LOG("zones-sparse",
+                 crab::outs() << "---"<< x<< ":=(weak) "<< e<<"\n"<<*this<<"\n";);
+      }
+
       void apply(ikos::operation_t op, variable_t x, variable_t y, variable_t z){	
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         if(is_bottom()) {
           return;
@@ -1523,8 +1628,8 @@ namespace crab {
 
     
       void apply(ikos::operation_t op, variable_t x, variable_t y, number_t k) {	
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         if(is_bottom()) {
           return;
@@ -1564,8 +1669,8 @@ namespace crab {
       }
       
       void operator+=(linear_constraint_t cst) {
-        crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-        crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
 
 	// XXX: we do nothing with unsigned linear inequalities
 	if (cst.is_inequality() && cst.is_unsigned()) {
@@ -1644,8 +1749,8 @@ namespace crab {
       }
 
       interval_t operator[](variable_t x) { 
-        crab::CrabStats::count (getDomainName() + ".count.to_intervals");
-        crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.to_intervals"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_intervals"));
 
 	// if (is_top()) return interval_t::top();
         if (is_bottom()) {
@@ -1657,8 +1762,8 @@ namespace crab {
       }
 
       void set(variable_t x, interval_t intv) {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
         if(is_bottom()) {
           return;
@@ -1721,8 +1826,8 @@ namespace crab {
       // bitwise operators
       
       void apply(ikos::bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         // Convert to intervals and perform the operation
         normalize();
@@ -1763,8 +1868,8 @@ namespace crab {
       }
     
       void apply(ikos::bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         // Convert to intervals and perform the operation
         normalize();
@@ -1876,8 +1981,8 @@ namespace crab {
 
       
       void forget(const variable_vector_t& variables) {
-        crab::CrabStats::count (getDomainName() + ".count.forget");
-        crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.forget"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 	
         if (is_bottom () || is_top())
           return;
@@ -1891,8 +1996,8 @@ namespace crab {
       }
       
       void project(const variable_vector_t& variables) {
-        crab::CrabStats::count (getDomainName() + ".count.project");
-        crab::ScopedCrabStats __st__(getDomainName() + ".project");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.project"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
         if (is_bottom () || is_top()) {
           return;
@@ -1918,8 +2023,8 @@ namespace crab {
       }
 
       void expand (variable_t x, variable_t y) {
-        crab::CrabStats::count (getDomainName() + ".count.expand");
-        crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.expand"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
 
         if(is_bottom() || is_top()) {
           return;
@@ -1954,8 +2059,8 @@ namespace crab {
       
       void extract(const variable_t& x, linear_constraint_system_t& csts,
 		   bool only_equalities) {
-	crab::CrabStats::count (getDomainName() + ".count.extract");
-        crab::ScopedCrabStats __st__(getDomainName() + ".extract");
+	crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.extract"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".extract"));
 
         normalize ();
         if (is_bottom ()) {
@@ -2242,6 +2347,7 @@ namespace crab {
       void set(variable_t x, interval_t intv) { lock(); norm().set(x, intv); }
 
       void assign(variable_t x, linear_expression_t e) { lock(); norm().assign(x, e); }
+      void weak_assign(variable_t x, linear_expression_t e) { lock(); norm().weak_assign(x, e); }
       void apply(ikos::operation_t op, variable_t x, variable_t y, number_t k) {
         lock(); norm().apply(op, x, y, k);
       }
@@ -2367,6 +2473,20 @@ namespace crab {
 	dom.extract(x, csts, only_equalities);
       }
     };
+
+    template<typename Number, typename VariableName, typename Params>
+    class weak_update_domain_traits<SparseDBM<Number, VariableName, Params>> {
+    public:
+      typedef SparseDBM<Number, VariableName, Params> sdbm_domain_t;
+      typedef typename sdbm_domain_t::variable_t variable_t;
+      typedef typename sdbm_domain_t::linear_expression_t linear_expression_t;
+
+      // Only the edges of x are joined
+      static void weak_assign(sdbm_domain_t& dom, const variable_t& x,
+			      const linear_expression_t& e) {
+	dom.weak_assign(x, e);
+      }
+    };
   
 
   } // namespace domains
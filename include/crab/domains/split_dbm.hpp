@@ -31,6 +31,7 @@
 #include <crab/domains/abstract_domain.hpp>
 #include <crab/domains/abstract_domain_specialized_traits.hpp>
 
+#include <algorithm>
 #include <type_traits>
 
 #include <boost/optional.hpp>
@@ -86,6 +87,9 @@ namespace crab {
          enum { widen_restabilize = 1 };
          enum { special_assign = 1 };
          enum { close_bounds_inline = 0 };	 
+         // Closures of graphs with at most this number of vertices
+         // are computed on a dense matrix (0 disables it).
+         enum { dense_closure = 64 };
 
 	 /***********************************************************/
 	 // Use long as graph weights
@@ -120,6 +124,7 @@ namespace crab {
          enum { widen_restabilize = 0 };
          enum { special_assign = 0 };
          enum { close_bounds_inline = 1 };	 	 
+         enum { dense_closure = 64 };
 
 	 /***********************************************************/
 	 // Use long as graph weights
@@ -156,6 +161,8 @@ namespace crab {
          enum { widen_restabilize = 1 };
          enum { special_assign = 1 };
          enum { close_bounds_inline = 0 };	 	 
+         // Weights are not machine integers
+         enum { dense_closure = 0 };
 
 	 // Use Number as graph weights
          typedef Number Wt;
@@ -272,6 +279,89 @@ namespace crab {
         bool default_is_absorbing() { return false; }
       };
 
+      typedef std::vector<std::pair<vert_id, Wt>> wt_edges_t;
+
+      // Collect the edges of v sorted by vertex. The edges with
+      // vertex 0 are returned separately: ub is the weight of 0 -> v
+      // and lb the one of v -> 0.
+      void edges_of(vert_id v, wt_edges_t& succs, wt_edges_t& preds,
+		    boost::optional<Wt>& ub, boost::optional<Wt>& lb) {
+        for(auto e : g.e_succs(v)) {
+          if(e.vert == 0)
+            lb = e.val;
+          else
+            succs.push_back(std::make_pair(e.vert, e.val));
+        }
+        for(auto e : g.e_preds(v)) {
+          if(e.vert == 0)
+            ub = e.val;
+          else
+            preds.push_back(std::make_pair(e.vert, e.val));
+        }
+        std::sort(succs.begin(), succs.end());
+        std::sort(preds.begin(), preds.end());
+      }
+
+      static boost::optional<Wt> wt_max(boost::optional<Wt> x, boost::optional<Wt> y) {
+        if(x && y)
+          return std::max(*x, *y);
+        return boost::none;
+      }
+
+      static boost::optional<Wt> wt_min(boost::optional<Wt> x, boost::optional<Wt> y) {
+        if(x && y)
+          return std::min(*x, *y);
+        return x ? x : y;
+      }
+
+      // Join the edges between x and the other vertices before (olds)
+      // and after (news) an assignment to x. The edges go out of x if
+      // out_of_x holds, otherwise into x. x_old, x_new and x_join are
+      // the weights of the edge between x and 0 in the same direction
+      // before, after and in the join. Edges implied by the bounds in
+      // the join are not kept.
+      void join_edges(const wt_edges_t& olds, boost::optional<Wt> x_old,
+		      const wt_edges_t& news, boost::optional<Wt> x_new,
+		      boost::optional<Wt> x_join, bool out_of_x, wt_edges_t& res) {
+        typename graph_t::mut_val_ref_t w;
+        auto i = olds.begin();
+        auto j = news.begin();
+        while(i != olds.end() || j != news.end()) {
+          vert_id d;
+          boost::optional<Wt> w_old, w_new;
+          if(j == news.end() || (i != olds.end() && i->first < j->first)) {
+            d = i->first; w_old = i->second; ++i;
+          } else if(i == olds.end() || j->first < i->first) {
+            d = j->first; w_new = j->second; ++j;
+          } else {
+            d = i->first; w_old = i->second; w_new = j->second; ++i; ++j;
+          }
+          // the bound of d in the path between x and d through 0
+          boost::optional<Wt> d_bnd;
+          if(out_of_x ? g.lookup(0, d, &w) : g.lookup(d, 0, &w))
+            d_bnd = w.get();
+          boost::optional<Wt> via_old, via_new;
+          if(x_old && d_bnd)
+            via_old = *x_old + *d_bnd;
+          if(x_new && d_bnd)
+            via_new = *x_new + *d_bnd;
+          boost::optional<Wt> k = wt_max(wt_min(w_old, via_old), wt_min(w_new, via_new));
+          if(k && !(x_join && d_bnd && *x_join + *d_bnd <= *k))
+            res.push_back(std::make_pair(d, *k));
+        }
+      }
+
+      void forget_isolated(const wt_edges_t& edges) {
+        for(auto const& p : edges) {
+          vert_id v = p.first;
+          if(rev_map[v] && g.succs(v).size() == 0 && g.preds(v).size() == 0) {
+            g.forget(v);
+            vert_map.erase(*(rev_map[v]));
+            rev_map[v] = boost::none;
+          }
+        }
+      }
+
       vert_id get_vert(variable_t v) {
         auto it = vert_map.find(v);
         if(it != vert_map.end())
@@ -581,7 +671,10 @@ namespace crab {
       }
       
 
-      bool add_linear_leq(const linear_expression_t& exp)
+      // If restore_bounds is false then the variable bounds are not
+      // recovered after the difference constraints are added. The
+      // caller must call close_bounds() before the bounds are used.
+      bool add_linear_leq(const linear_expression_t& exp, bool restore_bounds = true)
       {
         CRAB_LOG("zones-split",
                  linear_expression_t exp_tmp (exp);
@@ -680,10 +773,8 @@ namespace crab {
       // Collect bounds
       // GKG: Now done in close_over_edge
 
-	if (!Params::close_bounds_inline) {	  
-	  edge_vector delta;
-	  GrOps::close_after_assign(g, potential, 0, delta);
-	  GrOps::apply_delta(g, delta);
+	if (!Params::close_bounds_inline && restore_bounds) {	  
+	  close_bounds();
 	}
 
         check_potential(g, potential, __LINE__);
@@ -691,6 +782,33 @@ namespace crab {
         return true;  
       }
 
+      // Recover variable bounds from the relational edges
+      void close_bounds() {
+	edge_vector delta;
+	GrOps::close_after_assign(g, potential, 0, delta);
+	GrOps::apply_delta(g, delta);
+      }
+
+      // Return true if cst is of the form x - y <= k, x - y = k, x <=
+      // k or x >= k. The difference constraints that add_linear_leq
+      // extracts from them do not depend on the current bounds.
+      static bool is_difference_constraint(linear_constraint_t cst) {
+	if (!(cst.is_inequality() || cst.is_equality()) ||
+	    (cst.is_inequality() && cst.is_unsigned())) {
+	  return false;
+	}
+	auto it = cst.begin();
+	if (cst.size() == 1) {
+	  return (it->first == 1 || it->first == -1);
+	} else if (cst.size() == 2) {
+	  number_t c1 = it->first;
+	  number_t c2 = (++it)->first;
+	  return ((c1 == 1 && c2 == -1) || (c1 == -1 && c2 == 1));
+	} else {
+	  return false;
+	}
+      }
+
       // x != n
       void add_univar_disequation(variable_t x, number_t n) {
 	interval_t i = get_interval(x);
@@ -854,7 +972,9 @@ namespace crab {
         for(auto edge : g_excl.e_preds(ii))
         {
           vert_id se = edge.vert;
-          Wt wt_sij = edge.val + c;
+          // edge.val may be invalidated by the edge insertions below
+          Wt wt_si = edge.val;
+          Wt wt_sij = wt_si + c;
 
           assert(g_excl.succs(se).begin() != g_excl.succs(se).end());
           if(se != jj)
@@ -869,7 +989,7 @@ namespace crab {
             } else {
               g_excl.add_edge(se, wt_sij, jj);
             }
-            src_dec.push_back(std::make_pair(se, edge.val));  
+            src_dec.push_back(std::make_pair(se, wt_si));  
 	    if (Params::close_bounds_inline) {	  		    
 	      if(g.lookup(0, se, &w))
 		g.update_edge(0, w.get() + wt_sij, jj, min_op);
@@ -908,7 +1028,8 @@ namespace crab {
         for(auto edge : g_excl.e_succs(jj))
         {
           vert_id de = edge.vert;
-          Wt wt_ijd = edge.val + c;
+          Wt wt_jd = edge.val;
+          Wt wt_ijd = wt_jd + c;
           if(de != ii)
           {
             if(g_excl.lookup(ii, de, &w))
@@ -919,7 +1040,7 @@ namespace crab {
             } else {
               g_excl.add_edge(ii, wt_ijd, de);
             }
-            dest_dec.push_back(std::make_pair(de, edge.val));
+            dest_dec.push_back(std::make_pair(de, wt_jd));
 	    if (Params::close_bounds_inline) {	  		    
 	      if(g.lookup(0,  ii, &w))
 		g.update_edge(0, w.get() + wt_ijd, de, min_op);
@@ -1008,8 +1129,8 @@ namespace crab {
 	, potential(o.potential)
 	, unstable(o.unstable)
 	, _is_bottom(false) {      
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
 
         if(o._is_bottom)
           set_to_bottom();
@@ -1025,8 +1146,8 @@ namespace crab {
 	, potential(std::move(o.potential))
 	, unstable(std::move(o.unstable))
         , _is_bottom(o._is_bottom) {
-	crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+	crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
       }
 
       // We should probably use the magical rvalue ownership semantics stuff.
@@ -1039,8 +1160,8 @@ namespace crab {
 	, unstable(_unstable)
 	, _is_bottom(false) {
 	
-	crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+	crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
 	
         CRAB_WARN("Non-moving constructor.");
         assert(g.size() > 0);
@@ -1055,8 +1176,8 @@ namespace crab {
 	, unstable(std::move(_unstable))
 	, _is_bottom(false) {
 
-	crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+	crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
 
 	CRAB_LOG("zones-split-size",
                  auto p = size();
@@ -1067,8 +1188,8 @@ namespace crab {
 
 
       SplitDBM_& operator=(const SplitDBM_& o) {     
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
 
         if(this != &o) {
           if(o._is_bottom) {
@@ -1087,8 +1208,8 @@ namespace crab {
       }
 
       SplitDBM_& operator=(SplitDBM_&& o) {
-        crab::CrabStats::count (getDomainName() + ".count.copy");
-        crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.copy"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
       
         if(o._is_bottom) {
           set_to_bottom();
@@ -1133,8 +1254,8 @@ namespace crab {
       }
     
       bool operator<=(DBM_t o)  {
-        crab::CrabStats::count (getDomainName() + ".count.leq");
-        crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.leq"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
 
         // cover all trivial cases to avoid allocating a dbm matrix
         if (is_bottom()) 
@@ -1209,8 +1330,8 @@ namespace crab {
       }
 
       DBM_t operator|(DBM_t o) {
-        crab::CrabStats::count (getDomainName() + ".count.join");
-        crab::ScopedCrabStats __st__(getDomainName() + ".join");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.join"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
 
         if (is_bottom() || o.is_top ())
           return o;
@@ -1416,8 +1537,8 @@ namespace crab {
       }
 
       DBM_t operator||(DBM_t o) {	
-        crab::CrabStats::count (getDomainName() + ".count.widening");
-        crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.widening"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
 
         if (is_bottom())
           return o;
@@ -1485,8 +1606,8 @@ namespace crab {
       }
 
       DBM_t operator&(DBM_t o) {
-        crab::CrabStats::count (getDomainName() + ".count.meet");
-        crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.meet"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
 
         if (is_bottom() || o.is_bottom())
           return DBM_t::bottom();
@@ -1571,7 +1692,10 @@ namespace crab {
             SubGraph<graph_t> meet_g_excl(meet_g, 0);
 	    // GrOps::close_after_meet(meet_g_excl, meet_pi, gx, gy, delta);
 
-            if(Params::chrome_dijkstra)
+            if(meet_g.size() <= Params::dense_closure &&
+	       GrOps::close_dense(meet_g_excl, delta)) {
+	      // small graph: closed on a dense matrix
+	    } else if(Params::chrome_dijkstra)
               GrOps::close_after_meet(meet_g_excl, meet_pi, gx, gy, delta);
             else
               GrOps::close_johnson(meet_g_excl, meet_pi, delta);
@@ -1606,8 +1730,8 @@ namespace crab {
       }
     
       DBM_t operator&&(DBM_t o) {
-        crab::CrabStats::count (getDomainName() + ".count.narrowing");
-        crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
 
         if (is_bottom() || o.is_bottom())
           return DBM_t::bottom();
@@ -1630,8 +1754,8 @@ namespace crab {
       }	
 
       void normalize() {
-        crab::CrabStats::count (getDomainName() + ".count.normalize");
-        crab::ScopedCrabStats __st__(getDomainName() + ".normalize");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.normalize"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".normalize"));
 	
         // dbm_canonical(_dbm);
         // Always maintained in normal form, except for widening
@@ -1645,7 +1769,10 @@ namespace crab {
 	// GrOps::close_after_widen(g, potential, vert_set_wrap_t(unstable), delta);
         // GKG: Check
         SubGraph<graph_t> g_excl(g, 0);
-        if(Params::widen_restabilize)
+        if(g.size() <= Params::dense_closure &&
+	   GrOps::close_dense(g_excl, delta)) {
+	  // small graph: closed on a dense matrix
+	} else if(Params::widen_restabilize)
           GrOps::close_after_widen(g_excl, potential, vert_set_wrap_t(unstable), delta);
         else
           GrOps::close_johnson(g_excl, potential, delta);
@@ -1658,8 +1785,8 @@ namespace crab {
       }
 
       void operator-=(variable_t v) {
-        crab::CrabStats::count (getDomainName() + ".count.forget");
-        crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.forget"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 	
         if (is_bottom ())
           return;
@@ -1677,8 +1804,8 @@ namespace crab {
       }
 
       void assign(variable_t x, linear_expression_t e) {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
         if(is_bottom()) {
           return;
@@ -1812,9 +1939,80 @@ namespace crab {
         CRAB_LOG("zones-split", crab::outs() << "---"<< x<< ":="<< e<<"\n"<<*this <<"\n");
       }
 
+      // Join of the state before and after x := e.
+      //
+      // The assignment leaves the relations between the other
+      // variables unchanged so the join only needs to relax the edges
+      // of x: each one takes the maximum of its closed weight before
+      // and after the assignment. Closed weights are the stored ones
+      // or, if missing, the ones implied by the bounds. The result
+      // is weaker than the state after the assignment so its
+      // potential remains valid, and no closure is needed.
+      void weak_assign(variable_t x, linear_expression_t e) {
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.weak_assign"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".weak_assign"));
+
+        if(is_bottom()) {
+          return;
+	}
+        normalize();
+
+        auto it = vert_map.find(x);
+        if(it == vert_map.end()) {
+	  // x is unconstrained before the assignment so it is after
+	  // the join.
+          return;
+	}
+        wt_edges_t old_succs, old_preds;
+        boost::optional<Wt> old_ub, old_lb;
+        edges_of(it->second, old_succs, old_preds, old_ub, old_lb);
+
+        assign(x, e);
+        normalize();
+        if(is_bottom()) {
+          return;
+	}
+        wt_edges_t new_succs, new_preds;
+        it = vert_map.find(x);
+        if(it != vert_map.end()) {
+          vert_id v = it->second;
+          boost::optional<Wt> new_ub, new_lb;
+          edges_of(v, new_succs, new_preds, new_ub, new_lb);
+
+          boost::optional<Wt> ub = wt_max(old_ub, new_ub);
+          boost::optional<Wt> lb = wt_max(old_lb, new_lb);
+          wt_edges_t succs, preds;
+          join_edges(old_succs, old_lb, new_succs, new_lb, lb, true, succs);
+          join_edges(old_preds, old_ub, new_preds, new_ub, ub, false, preds);
+
+          // Replace the vertex of x with one holding only the joined edges
+          Wt pot = potential[v];
+          this->operator-=(x);
+          if(ub || lb || !succs.empty() || !preds.empty()) {
+            v = get_vert(x);
+            potential[v] = pot;
+            if(ub)
+              g.add_edge(0, *ub, v);
+            if(lb)
+              g.add_edge(v, *lb, 0);
+            for(auto const& p : succs)
+              g.add_edge(v, p.second, p.first);
+            for(auto const& p : preds)
+              g.add_edge(p.first, p.second, v);
+          }
+        }
+        // As the join does, forget the vertices left without edges
+        forget_isolated(old_succs);
+        forget_isolated(old_preds);
+        forget_isolated(new_succs);
+        forget_isolated(new_preds);
+        check_potential(g, potential, __LINE__);
+        CRAB_LOG("zones-split", crab::outs() << "---"<< x<< ":=(weak) "<< e<<"\n"<<*this <<"\n");
+      }
+
       void apply(operation_t op, variable_t x, variable_t y, variable_t z){	
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         if(is_bottom()) {
           return;
@@ -1855,8 +2053,8 @@ namespace crab {
 
     
       void apply(operation_t op, variable_t x, variable_t y, number_t k) {	
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         if(is_bottom()) {
           return;
@@ -1914,8 +2112,8 @@ namespace crab {
       }
       
       void operator+=(linear_constraint_t cst) {
-        crab::CrabStats::count (getDomainName() + ".count.add_constraints");
-        crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
 
 	// XXX: we do nothing with unsigned linear inequalities
 	if (cst.is_inequality() && cst.is_unsigned()) {
@@ -1987,14 +2185,47 @@ namespace crab {
       void operator+=(linear_constraint_system_t csts) {  
         if(is_bottom()) return;
 
+	if (Params::close_bounds_inline) {
+	  for(auto cst: csts) {
+	    operator+=(cst);
+	  }
+	  return;
+	}
+
+	// Variable bounds are recovered once for each run of
+	// difference constraints rather than after each one of them.
+	normalize();
+	bool pending_bounds = false;
         for(auto cst: csts) {
-          operator+=(cst);
+	  if (is_bottom()) return;
+	  if (is_difference_constraint(cst)) {
+	    crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+	    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
+	    linear_expression_t exp = cst.expression();
+	    if (!add_linear_leq(exp, false) ||
+		(cst.is_equality() && !add_linear_leq(-exp, false))) {
+	      set_to_bottom();
+	      return;
+	    }
+	    pending_bounds = true;
+	    CRAB_LOG("zones-split",
+		     crab::outs() << "--- "<< cst<< " (bounds not closed)\n"<< *this <<"\n");
+	  } else {
+	    if (pending_bounds) {
+	      close_bounds();
+	      pending_bounds = false;
+	    }
+	    operator+=(cst);
+	  }
         }
+	if (pending_bounds && !is_bottom()) {
+	  close_bounds();
+	}
       }
 
       interval_t operator[](variable_t x) { 
-        crab::CrabStats::count (getDomainName() + ".count.to_intervals");
-        crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.to_intervals"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_intervals"));
 
         // if (is_top())    return interval_t::top();
 
@@ -2006,8 +2237,8 @@ namespace crab {
       }
 
       void set(variable_t x, interval_t intv) {
-        crab::CrabStats::count (getDomainName() + ".count.assign");
-        crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.assign"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
         if(is_bottom())
           return;
@@ -2048,8 +2279,8 @@ namespace crab {
 
       // bitwise_operators_api      
       void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         // Convert to intervals and perform the operation
         normalize();
@@ -2090,8 +2321,8 @@ namespace crab {
       }
     
       void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k) {
-        crab::CrabStats::count (getDomainName() + ".count.apply");
-        crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.apply"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
         // Convert to intervals and perform the operation
         normalize();
@@ -2170,8 +2401,8 @@ namespace crab {
       /* End unimplemented operations */
 
       void project(const variable_vector_t& variables) {
-        crab::CrabStats::count (getDomainName() + ".count.project");
-        crab::ScopedCrabStats __st__(getDomainName() + ".project");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.project"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
         if (is_bottom() || is_top()) {
           return;
@@ -2198,8 +2429,8 @@ namespace crab {
 
       
       void forget(const variable_vector_t& variables) {
-        crab::CrabStats::count (getDomainName() + ".count.forget");
-        crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.forget"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 	
         if (is_bottom () || is_top()) {
           return;
@@ -2214,8 +2445,8 @@ namespace crab {
       }
       
       void expand (variable_t x, variable_t y) {
-        crab::CrabStats::count (getDomainName() + ".count.expand");
-        crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.expand"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
 
         if(is_bottom() || is_top()) {
           return;
@@ -2249,8 +2480,8 @@ namespace crab {
       }
 
       void rename(const variable_vector_t &from, const variable_vector_t &to) {
-        crab::CrabStats::count (getDomainName() + ".count.rename");
-        crab::ScopedCrabStats __st__(getDomainName() + ".rename");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.rename"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".rename"));
 	
 	if (is_top () || is_bottom()) return;
 	
@@ -2285,8 +2516,8 @@ namespace crab {
             
       void extract(const variable_t& x, linear_constraint_system_t& csts,
 		   bool only_equalities){
-        crab::CrabStats::count (getDomainName() + ".count.extract");
-        crab::ScopedCrabStats __st__(getDomainName() + ".extract");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.extract"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".extract"));
 
         normalize ();
         if (is_bottom ()) {
@@ -2469,8 +2700,8 @@ namespace crab {
       }
 
       linear_constraint_system_t to_linear_constraint_system () {
-        crab::CrabStats::count (getDomainName() + ".count.to_linear_constraints");
-        crab::ScopedCrabStats __st__(getDomainName() + ".to_linear_constraints");
+        crab::CrabStats::count (CRAB_STATS_ID(getDomainName() + ".count.to_linear_constraints"));
+        crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_linear_constraints"));
 
         normalize ();
 
@@ -2652,6 +2883,7 @@ namespace crab {
       void set(variable_t x, interval_t intv) { lock(); norm().set(x, intv); }
 
       void assign(variable_t x, linear_expression_t e) { lock(); norm().assign(x, e); }
+      void weak_assign(variable_t x, linear_expression_t e) { lock(); norm().weak_assign(x, e); }
       void apply(operation_t op, variable_t x, variable_t y, number_t k) {
         lock(); norm().apply(op, x, y, k);
       }
@@ -2776,7 +3008,33 @@ namespace crab {
 	dom.extract(x, csts, only_equalities);
       }
     };
+
+    template<typename Number, typename VariableName, typename SplitDBMParams>    
+    class block_domain_traits<SplitDBM<Number, VariableName, SplitDBMParams>> {
+    public:
+      typedef SplitDBM<Number, VariableName, SplitDBMParams> sdbm_domain_t;
+      typedef typename sdbm_domain_t::linear_constraint_system_t linear_constraint_system_t;
+
+      // The variable bounds are recovered once for the whole system
+      static void add_constraints(sdbm_domain_t& dom, const linear_constraint_system_t& csts) {
+	dom += csts;
+      }
+    };
   
+    template<typename Number, typename VariableName, typename SplitDBMParams>
+    class weak_update_domain_traits<SplitDBM<Number, VariableName, SplitDBMParams>> {
+    public:
+      typedef SplitDBM<Number, VariableName, SplitDBMParams> sdbm_domain_t;
+      typedef typename sdbm_domain_t::variable_t variable_t;
+      typedef typename sdbm_domain_t::linear_expression_t linear_expression_t;
+
+      // Only the edges of x are joined
+      static void weak_assign(sdbm_domain_t& dom, const variable_t& x,
+			      const linear_expression_t& e) {
+	dom.weak_assign(x, e);
+      }
+    };
+
     template<typename Number, typename VariableName, typename SplitDBMParams>
     struct array_sgraph_domain_helper_traits <SplitDBM<Number,VariableName, SplitDBMParams>> {
       typedef SplitDBM<Number,VariableName,SplitDBMParams> sdbm_domain_t;
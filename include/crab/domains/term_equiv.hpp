@@ -18,6 +18,8 @@
 
 #include <boost/range.hpp>
 #include "boost/range/algorithm/set_algorithm.hpp"
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/container/flat_map.hpp>
 #include <boost/container/flat_set.hpp>
 #include <boost/optional.hpp>
@@ -117,28 +119,73 @@ namespace crab {
        typedef boost::container::flat_map< term_id_t, var_set_t > rev_var_map_t;
        typedef term::NumSimplifier<number_t> simplifier_t;
 
+       // The term table and the maps are shared by the copies of a
+       // term domain and they are copied only when one of the copies
+       // modifies them (copy-on-write). Read-only accesses go
+       // through the pointers while modifications must use ttbl(),
+       // var_map(), rev_var_map() and term_map().
+       typedef boost::shared_ptr<ttbl_t> ttbl_ref_t;
+       typedef boost::shared_ptr<var_map_t> var_map_ref_t;
+       typedef boost::shared_ptr<rev_var_map_t> rev_var_map_ref_t;
+       typedef boost::shared_ptr<term_map_t> term_map_ref_t;
+       
        bool _is_bottom;
        // Uses a single state of the underlying domain.
-       ttbl_t _ttbl;
+       ttbl_ref_t _ttbl;
        dom_t _impl;
        dom_var_alloc_t _alloc;
-       var_map_t _var_map;
-       rev_var_map_t _rev_var_map; // to extract equalities efficiently
-       term_map_t _term_map;
+       var_map_ref_t _var_map;
+       rev_var_map_ref_t _rev_var_map; // to extract equalities efficiently
+       term_map_ref_t _term_map;
        term_set_t changed_terms; 
               
-       term_domain(bool is_top): _is_bottom(!is_top) { }
+       term_domain(bool is_top)
+	 : _is_bottom(!is_top),
+	   _ttbl(boost::make_shared<ttbl_t>()),
+	   _var_map(boost::make_shared<var_map_t>()),
+	   _rev_var_map(boost::make_shared<rev_var_map_t>()),
+	   _term_map(boost::make_shared<term_map_t>()) { }
        
        term_domain(dom_var_alloc_t alloc, var_map_t vm, rev_var_map_t rvm,
 		   ttbl_t tbl, term_map_t tmap, dom_t impl)
            : _is_bottom((impl.is_bottom())? true: false),
-	     _ttbl(tbl),
+	     _ttbl(boost::make_shared<ttbl_t>(std::move(tbl))),
 	     _impl(impl),
 	     _alloc(alloc), 
-             _var_map(vm),
-	     _rev_var_map(rvm),
-	     _term_map(tmap)
-       { check_terms(__LINE__); }
+             _var_map(boost::make_shared<var_map_t>(std::move(vm))),
+	     _rev_var_map(boost::make_shared<rev_var_map_t>(std::move(rvm))),
+	     _term_map(boost::make_shared<term_map_t>(std::move(tmap)))
+       {
+	 crab::CrabStats::count_max(CRAB_STATS_ID(getDomainName() + ".max.ttbl_size"),
+				    _ttbl->size());
+	 check_terms(__LINE__);
+       }
+
+       // Make ref the only owner of its object before modifying it
+       template<class T>
+       T& detach(boost::shared_ptr<T>& ref) {
+	 if (!ref.unique()) {
+	   crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.cow_copy"));
+	   ref = boost::make_shared<T>(*ref);
+	 }
+	 return *ref;
+       }
+       
+       ttbl_t& ttbl() { return detach(_ttbl); }
+       
+       var_map_t& var_map() { return detach(_var_map); }
+       
+       rev_var_map_t& rev_var_map() { return detach(_rev_var_map); }
+       
+       term_map_t& term_map() { return detach(_term_map); }
+
+       // Return true if this and o share the term table and all the
+       // maps. Then, the same terms are bound to the same variables
+       // in both and only the underlying domains differ.
+       bool shares_terms(const term_domain_t& o) const {
+	 return (_ttbl == o._ttbl && _var_map == o._var_map &&
+		 _rev_var_map == o._rev_var_map && _term_map == o._term_map);
+       }
        
        // x = y op [lb,ub]
        term_id_t term_of_itv(bound_t lb, bound_t ub) {
@@ -148,7 +195,7 @@ namespace crab {
          if (n_lb && n_ub && (*n_lb == *n_ub))
            return term_of_const(*n_lb);
          
-         term_id_t t_itv = _ttbl.fresh_var();
+         term_id_t t_itv = ttbl().fresh_var();
          dom_var_t dom_itv = domvar_of_term(t_itv);
          _impl.set(dom_itv, interval_t(lb, ub));
          return t_itv;
@@ -263,16 +310,16 @@ namespace crab {
 
        void check_terms(int line) const {
          #ifdef DEBUG_VARMAP
-         for(auto const p : _var_map) {
-	   if (!(p.second < _ttbl.size())) {
+         for(auto const p : *_var_map) {
+	   if (!(p.second < _ttbl->size())) {
 	     CRAB_ERROR("term_equiv.hpp at line=", line, ": ",
 			"term id is not the table term");
 	   }
 	 }
 	 
-	 for(auto kv: _rev_var_map) {
+	 for(auto kv: *_rev_var_map) {
 	   for(auto v: kv.second) {
-	     auto it = _var_map.find(v);
+	     auto it = _var_map->find(v);
 	     if (it->second != kv.first) {
 	       CRAB_ERROR("term_equiv.hpp at line=", line, ": ",
 			  v, " is mapped to t", it->second,
@@ -286,12 +333,14 @@ namespace crab {
 
        void deref(term_id_t t) {
          std::vector<term_id_t> forgotten;
-         _ttbl.deref(t, forgotten);
+         ttbl().deref(t, forgotten);
+         if (forgotten.empty()) return;
+         term_map_t& tmap = term_map();
          for(term_id_t f : forgotten) {
-           typename term_map_t::iterator it(_term_map.find(f));
-           if(it != _term_map.end()) {
+           typename term_map_t::iterator it(tmap.find(f));
+           if(it != tmap.end()) {
              _impl -= (*it).second;
-             _term_map.erase(it);
+             tmap.erase(it);
            }
          }
        }
@@ -309,27 +358,30 @@ namespace crab {
        }
        
        void remove_rev_var_map(term_id_t t, variable_t v) {
-	 auto it = _rev_var_map.find(t);
-	 if (it != _rev_var_map.end()) {
+	 rev_var_map_t& rvmap = rev_var_map();
+	 auto it = rvmap.find(t);
+	 if (it != rvmap.end()) {
 	   it->second.erase(v);
 	   if (it->second.empty()) {
-	     _rev_var_map.erase(it);
+	     rvmap.erase(it);
 	   }
 	 }	 
        }
        /* End manipulate the reverse variable map */
        
        void rebind_var(variable_t& x, term_id_t tx) {
-         _ttbl.add_ref(tx);
+         ttbl().add_ref(tx);
 	 
-         auto it(_var_map.find(x));
-         if(it != _var_map.end()) {
-	   remove_rev_var_map((*it).second, x);
-	   deref((*it).second);
-	   _var_map.erase(it);
+         var_map_t& vmap = var_map();
+         auto it(vmap.find(x));
+         if(it != vmap.end()) {
+	   term_id_t old_tx = (*it).second;
+	   vmap.erase(it);
+	   remove_rev_var_map(old_tx, x);
+	   deref(old_tx);
 	 } 
-	 _var_map.insert(std::make_pair(x, tx));
-	 add_rev_var_map(_rev_var_map, tx, x);
+	 vmap.insert(std::make_pair(x, tx));
+	 add_rev_var_map(rev_var_map(), tx, x);
        }
 
        // Build the tree for a linexpr, and ensure that
@@ -337,11 +389,11 @@ namespace crab {
 
        term_id_t term_of_const(const number_t& n) {
          dom_number dom_n(n);
-         boost::optional<term_id_t> opt_n(_ttbl.find_const(dom_n));
+         boost::optional<term_id_t> opt_n(_ttbl->find_const(dom_n));
          if(opt_n) {
            return *opt_n;
          } else {
-           term_id_t term_n(_ttbl.make_const(dom_n));
+           term_id_t term_n(ttbl().make_const(dom_n));
            dom_var_t v = domvar_of_term(term_n);
 
            dom_linexp_t exp(n);
@@ -368,7 +420,13 @@ namespace crab {
        }
        
        term_id_t term_of_var(variable_t v) {
-         return term_of_var(v, _var_map, _rev_var_map, _ttbl);
+         auto it(_var_map->find(v));
+         if(it != _var_map->end()) {
+           assert(_ttbl->size() > (*it).second);
+           return (*it).second;
+         } else {
+           return term_of_var(v, var_map(), rev_var_map(), ttbl());
+         }
        }
 
        term_id_t term_of_linterm(linterm_t term) {
@@ -386,12 +444,12 @@ namespace crab {
        term_id_t build_term(OpTy op, term_id_t ty, term_id_t tz) {
          // Check if the term already exists
          binary_operation_t binop = conv2binop(op);
-         boost::optional<term_id_t> eopt(_ttbl.find_ftor(binop, ty, tz));
+         boost::optional<term_id_t> eopt(_ttbl->find_ftor(binop, ty, tz));
          if(eopt) {
            return *eopt;
          } else {
            // Create the term
-           term_id_t tx = _ttbl.apply_ftor(binop, ty, tz);
+           term_id_t tx = ttbl().apply_ftor(binop, ty, tz);
            dom_var_t v(domvar_of_term(tx));
            dom_var_t y(domvar_of_term(ty));
            dom_var_t z(domvar_of_term(tz));
@@ -410,12 +468,12 @@ namespace crab {
        term_id_t build_function(term_id_t ty, term_id_t tz) {
 	 binary_operation_t op = BINOP_FUNCTION;
          // Check if the term already exists
-         boost::optional<term_id_t> eopt(_ttbl.find_ftor(op, ty, tz));
+         boost::optional<term_id_t> eopt(_ttbl->find_ftor(op, ty, tz));
          if(eopt) {
            return *eopt;
          } else {
            // Create the term
-           term_id_t tx = _ttbl.apply_ftor(op, ty, tz);
+           term_id_t tx = ttbl().apply_ftor(op, ty, tz);
            return tx;
          }
        }
@@ -445,13 +503,13 @@ namespace crab {
        }
 
        dom_var_t domvar_of_term(term_id_t id) {
-         typename term_map_t::iterator it(_term_map.find(id));
-         if(it != _term_map.end()) {
+         typename term_map_t::const_iterator it(_term_map->find(id));
+         if(it != _term_map->end()) {
            return(*it).second;
          } else {
            // Allocate a fresh variable
            dom_var_t dvar(_alloc.next());
-           _term_map.insert(std::make_pair(id, dvar));
+           term_map().insert(std::make_pair(id, dvar));
            return dvar;
          }
        }
@@ -556,6 +614,13 @@ namespace crab {
          else if(o.is_bottom()) {
            return *this;
          } 
+         else if (shares_terms(o)) {
+           crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening.shared"));
+           term_domain_t res(*this);
+           res._impl = widen_op.apply(_impl, o._impl);
+           res._is_bottom = (res._impl.is_bottom() ? true: false);
+           return res;
+         }
          else {
            // First, we need to compute the new term table.
            ttbl_t out_tbl;
@@ -567,13 +632,13 @@ namespace crab {
            dom_var_alloc_t palloc(_alloc, o._alloc);
            
            // For each program variable in state, compute a generalization
-           for(auto p : _var_map)
+           for(auto p : *_var_map)
            {
              variable_t v(p.first);
              term_id_t tx(term_of_var(v));
              term_id_t ty(o.term_of_var(v));
              
-             term_id_t tz = _ttbl.generalize(o._ttbl, tx, ty, out_tbl, gener_map);
+             term_id_t tz = _ttbl->generalize(*o._ttbl, tx, ty, out_tbl, gener_map);
              out_vmap[v] = tz;
 	     add_rev_var_map(out_rvmap, tz, v);
            }
@@ -724,7 +789,7 @@ namespace crab {
        // }
        
        
-       term_domain(): _is_bottom(false) { }
+       term_domain(): term_domain(true) { }
        
        term_domain(const term_domain_t& o): 
            _is_bottom(o._is_bottom), 
@@ -735,14 +800,14 @@ namespace crab {
 	   _term_map(o._term_map),
            changed_terms(o.changed_terms)
        { 
-         crab::CrabStats::count(getDomainName() + ".count.copy");
-         crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
          check_terms(__LINE__); 
        } 
        
        term_domain_t& operator=(const term_domain_t &o) {
-         crab::CrabStats::count(getDomainName() + ".count.copy");
-         crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
          
          o.check_terms(__LINE__);
          if (this != &o) {
@@ -764,7 +829,7 @@ namespace crab {
        }
        
        bool is_top() {
-         return !_var_map.size() && !is_bottom();
+         return !_var_map->size() && !is_bottom();
        }
        
        bool is_normalized(){
@@ -774,8 +839,8 @@ namespace crab {
        
        // Lattice operations
        bool operator<=(term_domain_t o)  {	
-         crab::CrabStats::count(getDomainName() + ".count.leq");
-         crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
 
          // Require normalization of the first argument
          this->normalize();
@@ -784,15 +849,36 @@ namespace crab {
            return true;
          } else if(o.is_bottom()) {
            return false;
+         } else if (shares_terms(o)) {
+           crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq.shared"));
+           // The mapping between the terms of this and o is the
+           // identity so there is no need to rename the underlying
+           // domains: only compare the variables of the reachable
+           // terms.
+           typename ttbl_t::term_map_t gen_map;
+           for(auto p : *_var_map)
+           {
+             _ttbl->map_leq(*_ttbl, p.second, p.second, gen_map);
+           }
+           std::vector<dom_var_t> out_varnames;
+           for(auto p : gen_map)
+           {
+             out_varnames.push_back(domvar_of_term(p.first));
+           }
+           dom_t x_impl(_impl);
+           dom_t y_impl(o._impl);
+	   x_impl.project(out_varnames);
+	   y_impl.project(out_varnames);
+           return x_impl <= y_impl;
          } else {
            typename ttbl_t::term_map_t gen_map;
            dom_var_alloc_t palloc(_alloc, o._alloc);
            
            // Build up the mapping of o onto this, variable by variable.
            // Assumption: the set of variables in x & o are common.
-           for(auto p : _var_map)
+           for(auto p : *_var_map)
            {
-             if(!_ttbl.map_leq(o._ttbl, term_of_var(p.first), o.term_of_var(p.first), gen_map))
+             if(!_ttbl->map_leq(*o._ttbl, term_of_var(p.first), o.term_of_var(p.first), gen_map))
                return false;
            }
            // We now have a mapping of reachable y-terms to x-terms.
@@ -825,8 +911,8 @@ namespace crab {
        
        // Optimized version of | that avoids some unnecessary copies
        void operator|=(term_domain_t o) {
-         crab::CrabStats::count(getDomainName() + ".count.join");
-         crab::ScopedCrabStats __st__(getDomainName() + ".join");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
          
          // Requires normalization of both operands
          normalize();
@@ -838,6 +924,11 @@ namespace crab {
          else if(o.is_bottom() || is_top()) {
            return;
          }       
+         else if (shares_terms(o)) {
+           crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join.shared"));
+           _impl |= o._impl;
+           _is_bottom = (_impl.is_bottom() ? true: false);
+         }
          else {
            // First, we need to compute the new term table.
            ttbl_t out_tbl;
@@ -850,13 +941,13 @@ namespace crab {
            dom_var_alloc_t palloc(_alloc, o._alloc);
            
            // For each program variable in state, compute a generalization
-           for(auto p : _var_map)
+           for(auto p : *_var_map)
            {
              variable_t v(p.first);
              term_id_t tx(term_of_var(v));
              term_id_t ty(o.term_of_var(v));
              
-             term_id_t tz = _ttbl.generalize(o._ttbl, tx, ty, out_tbl, gener_map);
+             term_id_t tz = _ttbl->generalize(*o._ttbl, tx, ty, out_tbl, gener_map);
              assert(tz < out_tbl.size());
              out_vmap[v] = tz;
 	     add_rev_var_map(out_rvmap, tz, v);
@@ -890,19 +981,21 @@ namespace crab {
            for(auto p : out_vmap)
              out_tbl.add_ref(p.second);
            
+           crab::CrabStats::count_max(CRAB_STATS_ID(getDomainName() + ".max.ttbl_size"),
+				      out_tbl.size());
            std::swap(_alloc, palloc);
-           std::swap(_var_map, out_vmap);
-	   std::swap(_rev_var_map, out_rvmap);
-           std::swap(_ttbl, out_tbl);
-           std::swap(_term_map, out_map);
+           _var_map = boost::make_shared<var_map_t>(std::move(out_vmap));
+	   _rev_var_map = boost::make_shared<rev_var_map_t>(std::move(out_rvmap));
+           _ttbl = boost::make_shared<ttbl_t>(std::move(out_tbl));
+           _term_map = boost::make_shared<term_map_t>(std::move(out_map));
            _is_bottom = (_impl.is_bottom() ? true: false);
            
          }
        }
 
        term_domain_t operator|(term_domain_t o) {
-         crab::CrabStats::count(getDomainName() + ".count.join");
-         crab::ScopedCrabStats __st__(getDomainName() + ".join");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
 	 
          // Requires normalization of both operands
          normalize();
@@ -914,6 +1007,13 @@ namespace crab {
          else if(o.is_bottom() || is_top()) {
            return *this;
          }       
+         else if (shares_terms(o)) {
+           crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join.shared"));
+           term_domain_t res(*this);
+           res._impl |= o._impl;
+           res._is_bottom = (res._impl.is_bottom() ? true: false);
+           return res;
+         }
          else {
            // First, we need to compute the new term table.
            ttbl_t out_tbl;
@@ -925,13 +1025,13 @@ namespace crab {
            dom_var_alloc_t palloc(_alloc, o._alloc);
            
            // For each program variable in state, compute a generalization
-           for(auto p : _var_map)
+           for(auto p : *_var_map)
            {
              variable_t v(p.first);
              term_id_t tx(term_of_var(v));
              term_id_t ty(o.term_of_var(v));
              
-             term_id_t tz = _ttbl.generalize(o._ttbl, tx, ty, out_tbl, gener_map);
+             term_id_t tz = _ttbl->generalize(*o._ttbl, tx, ty, out_tbl, gener_map);
              assert(tz < out_tbl.size());
              out_vmap[v] = tz;
 	     add_rev_var_map(out_rvmap, tz, v);
@@ -986,24 +1086,24 @@ namespace crab {
        }
 
        term_domain_t operator||(term_domain_t other) {
-         crab::CrabStats::count(getDomainName() + ".count.widening");
-         crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
          WidenOp op;
          return this->widening(other, op);
        }
        
        template<typename Thresholds>
        term_domain_t widening_thresholds(term_domain_t other, const Thresholds& ts) {
-         crab::CrabStats::count(getDomainName() + ".count.widening");
-         crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
          WidenWithThresholdsOp<Thresholds> op(ts);
          return this->widening(other, op);
        }
        
        // Meet
        term_domain_t operator&(term_domain_t o) {
-         crab::CrabStats::count(getDomainName() + ".count.meet");
-         crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
 
          // Does not require normalization of any of the two operands
          if (is_bottom() || o.is_bottom()) {
@@ -1012,23 +1112,29 @@ namespace crab {
            return o;
          } else if (o.is_top()) {
            return *this;
+         } else if (shares_terms(o)) {
+           crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet.shared"));
+           term_domain_t res(*this);
+           res._impl = _impl & o._impl;
+           res._is_bottom = (res._impl.is_bottom() ? true: false);
+           return res;
          } else {
 
-           ttbl_t out_ttbl(_ttbl);
+           ttbl_t out_ttbl(*_ttbl);
            std::map<term_id_t, term_id_t> copy_map;
            // bring all terms to one ttbl
-           for (auto p: o._var_map) {
+           for (auto p: *o._var_map) {
              variable_t v(p.first);
              term_id_t tx(o.term_of_var(v));
-             out_ttbl.copy_term(o._ttbl, tx, copy_map);
+             out_ttbl.copy_term(*o._ttbl, tx, copy_map);
            }
            
            // build unifications between terms from this and o
            std::vector<std::pair<term_id_t,term_id_t> > eqs;
-           for (auto p: _var_map) {
+           for (auto p: *_var_map) {
              variable_t v(p.first);
-             auto it = o._var_map.find(v);
-             if (it != o._var_map.end()) {
+             auto it = o._var_map->find(v);
+             if (it != o._var_map->end()) {
                term_id_t tx(term_of_var(v));
                eqs.push_back(std::make_pair(tx, copy_map [it->second]));
              }
@@ -1043,7 +1149,7 @@ namespace crab {
            var_map_t out_vmap;
 	   rev_var_map_t out_rvmap;
            // new map from variable to an acyclic term 
-           for(auto p : _var_map) {
+           for(auto p : *_var_map) {
              variable_t v(p.first);
              term_id_t t_old(term_of_var(v));
              term_id_t t_new = build_dag_term(out_ttbl, solver.get_class(t_old), 
@@ -1052,7 +1158,7 @@ namespace crab {
              out_vmap [v] = t_new;
 	     add_rev_var_map(out_rvmap, t_new, v);
            }
-           for(auto p : o._var_map) {
+           for(auto p : *o._var_map) {
              variable_t v(p.first);
              if (out_vmap.find(v) != out_vmap.end()) 
                continue;
@@ -1079,14 +1185,14 @@ namespace crab {
              dom_var_t vt(palloc.next());
              out_map.insert(std::make_pair(t_new, vt));
              // renaming this's base domain
-             auto xit = _var_map.find(v);
-             if (xit != _var_map.end()) {
+             auto xit = _var_map->find(v);
+             if (xit != _var_map->end()) {
                dom_var_t vx = domvar_of_term(xit->second);
                x_impl.assign(vt, vx);
              }
              // renaming o's base domain
-             auto yit = o._var_map.find(v);
-             if (yit != o._var_map.end()) {
+             auto yit = o._var_map->find(v);
+             if (yit != o._var_map->end()) {
                dom_var_t vy = o.domvar_of_term(yit->second);
                y_impl.assign(vt, vy);
              }
@@ -1110,8 +1216,8 @@ namespace crab {
     
        // Narrowing
        term_domain_t operator&&(term_domain_t o) {	
-         crab::CrabStats::count(getDomainName() + ".count.narrowing");
-         crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
 
          CRAB_WARN("Term narrowing operator replaced with meet");
          return *this & o; 
@@ -1119,14 +1225,14 @@ namespace crab {
 
        // Remove a variable from the scope
        void operator-=(variable_t v) {
-         crab::CrabStats::count(getDomainName() + ".count.forget");
-         crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
 
-         auto it(_var_map.find(v));
-         if(it != _var_map.end())
+         auto it(_var_map->find(v));
+         if(it != _var_map->end())
          {
            term_id_t t = (*it).second;
-           _var_map.erase(it); 
+           var_map().erase(v); 
 	   remove_rev_var_map(t, v);
            deref(t);
          }
@@ -1135,8 +1241,8 @@ namespace crab {
        }
        
        void assign(variable_t x, linear_expression_t e) {
-         crab::CrabStats::count(getDomainName() + ".count.assign");
-         crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
          if (this->is_bottom()) {
            return;
@@ -1157,8 +1263,8 @@ namespace crab {
 
        // x = y op z
        void apply(operation_t op, variable_t x, variable_t y, variable_t z){	
-         crab::CrabStats::count(getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
          check_terms(__LINE__);
          if (this->is_bottom()) {
            return;   
@@ -1174,8 +1280,8 @@ namespace crab {
     
        // x = y op k
        void apply(operation_t op, variable_t x, variable_t y, number_t k){	
-         crab::CrabStats::count(getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
          if (this->is_bottom()) {
            return;   
@@ -1211,8 +1317,8 @@ namespace crab {
        }
        
        void operator+=(linear_constraint_t cst) {  
-         crab::CrabStats::count(getDomainName() + ".count.add_constraints");
-         crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
 
          CRAB_LOG("term",
 		  crab::outs() << "*** Before assume " << cst << ":" << *this << "\n");
@@ -1234,7 +1340,8 @@ namespace crab {
              if (tx == ty) return; 
              
              // congruence closure to compute equivalence classes
-             term::congruence_closure_solver<ttbl_t> solver(&_ttbl);
+             ttbl_t& tbl = ttbl();
+             term::congruence_closure_solver<ttbl_t> solver(&tbl);
              std::vector<std::pair<term_id_t, term_id_t> > eqs = { std::make_pair(tx,ty) };
              solver.run(eqs);
 	     
@@ -1244,12 +1351,12 @@ namespace crab {
              std::vector<dom_var_t> out_varnames;
              // new map from variable to an acyclic term
              // and also renaming of the base domain
-             for(auto p : _var_map) {
+             for(auto p : var_map()) {
                variable_t v(p.first);
                term_id_t t_old(term_of_var(v));
-               term_id_t t_new = build_dag_term(_ttbl, solver.get_class(t_old), 
+               term_id_t t_new = build_dag_term(tbl, solver.get_class(t_old), 
                                                  solver, 
-                                                 _ttbl, stack, cache);
+                                                 tbl, stack, cache);
 
                dom_var_t vt = domvar_of_term(t_new);
                dom_var_t vx = domvar_of_term(t_old);
@@ -1308,16 +1415,16 @@ namespace crab {
        */
     
        interval_t operator[](variable_t x) { 
-         crab::CrabStats::count(getDomainName() + ".count.to_intervals");
-         crab::ScopedCrabStats __st__(getDomainName() + ".to_intervals");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.to_intervals"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".to_intervals"));
 
          // Needed for accuracy
          normalize();
 
          if (is_bottom()) return interval_t::bottom();
 
-         auto it = _var_map.find (x);
-         if (it == _var_map.end()) 
+         auto it = _var_map->find (x);
+         if (it == _var_map->end()) 
            return interval_t::top();
       
          dom_var_t dom_x = domvar_of_term(it->second);
@@ -1326,8 +1433,8 @@ namespace crab {
        } 
 
        void set(variable_t x, interval_t intv){
-         crab::CrabStats::count(getDomainName() + ".count.assign");
-         crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
 
          rebind_var(x, term_of_itv(intv.lb(), intv.ub()));
        }
@@ -1339,8 +1446,8 @@ namespace crab {
        }
 
        void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z){
-         crab::CrabStats::count(getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
          if (this->is_bottom()) {
            return;   
@@ -1355,8 +1462,8 @@ namespace crab {
        }
     
        void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k){
-         crab::CrabStats::count(getDomainName() + ".count.apply");
-         crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
 
          if (this->is_bottom()) {
            return;   
@@ -1386,8 +1493,8 @@ namespace crab {
        virtual void array_load(variable_t lhs,
 				variable_t a, linear_expression_t /*elem_size*/,
 				linear_expression_t i) override {
-	 crab::CrabStats::count(getDomainName() + ".count.load");
-	 crab::ScopedCrabStats __st__(getDomainName() + ".load");
+	 crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.load"));
+	 crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".load"));
 
 	 if (this->is_bottom()) {
 	   return;   
@@ -1406,8 +1513,8 @@ namespace crab {
        virtual void array_store(variable_t a, linear_expression_t /*elem_size*/,
 				 linear_expression_t i, linear_expression_t val, 
 				 bool /*is_singleton*/) override {
-	 crab::CrabStats::count(getDomainName() + ".count.store");
-	 crab::ScopedCrabStats __st__(getDomainName() + ".store");
+	 crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.store"));
+	 crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".store"));
 
 	 if (this->is_bottom()) {
 	   return;   
@@ -1480,7 +1587,7 @@ namespace crab {
 	
 	var_map_t new_var_map;
 	rev_var_map_t new_rev_var_map;
-	for (auto kv: _var_map) {
+	for (auto kv: *_var_map) {
 	  ptrdiff_t pos = std::distance(from.begin(),
 					std::find(from.begin(), from.end(), kv.first));
 	  if (pos < from.size()) {
@@ -1492,8 +1599,8 @@ namespace crab {
 	    add_rev_var_map(new_rev_var_map, kv.second, kv.first);
 	  }
 	}
-	std::swap(_var_map, new_var_map);
-	std::swap(_rev_var_map, new_rev_var_map);
+	_var_map = boost::make_shared<var_map_t>(std::move(new_var_map));
+	_rev_var_map = boost::make_shared<rev_var_map_t>(std::move(new_rev_var_map));
 	
 	CRAB_LOG("term",
 		 crab::outs() << "RESULT=" << *this << "\n");
@@ -1502,8 +1609,8 @@ namespace crab {
        // extract operation is used during reduction with other domains.       
        void extract(const variable_t& x, linear_constraint_system_t& csts,
 		    bool only_equalities /*unused*/) {
-         crab::CrabStats::count(getDomainName() + ".count.extract");
-         crab::ScopedCrabStats __st__(getDomainName() + ".extract");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.extract"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".extract"));
 
          if (!is_normalized()) normalize();
 
@@ -1519,16 +1626,20 @@ namespace crab {
 	 // would make the reduction very slow.
 	 
          // Extract equalities
-         auto it = _var_map.find(x);
-         if (it != _var_map.end()) {
+         auto it = _var_map->find(x);
+         if (it != _var_map->end()) {
            term_id_t tx = it->second;
-	   auto tx_ptr = _ttbl.get_term_ptr(tx);
+	   auto tx_ptr = _ttbl->get_term_ptr(tx);
 
 	   bool active_threshold = false;
 	   if(tx_ptr->kind() == term::TERM_CONST) {
 	     active_threshold = true;
 	   }
-	   auto &varset = _rev_var_map[tx];
+	   auto rit = _rev_var_map->find(tx);
+	   if (rit == _rev_var_map->end()) {
+	     return;
+	   }
+	   auto &varset = rit->second;
 	   unsigned num_eq = 0;
 	   for (auto var: varset) {
 	     if (active_threshold && num_eq > max_eq) {
@@ -1554,22 +1665,22 @@ namespace crab {
        }
 
        void project(const variable_vector_t& variables) {
-         crab::CrabStats::count(getDomainName() + ".count.project");
-         crab::ScopedCrabStats __st__(getDomainName() + ".project");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
          if (is_bottom() || is_top()) return;
          
          std::set<variable_t> s1,s2;
 	 variable_vector_t s3;
-         for (auto p: _var_map) s1.insert(p.first);
+         for (auto p: *_var_map) s1.insert(p.first);
          s2.insert(variables.begin(), variables.end());
          boost::set_difference(s1,s2,std::back_inserter(s3));
          forget(s3);
        }
 
        void expand(variable_t x, variable_t y) {
-         crab::CrabStats::count(getDomainName() + ".count.expand");
-         crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
 
          if (is_bottom() || is_top()) {
            return;
@@ -1585,8 +1696,8 @@ namespace crab {
        // Propagate information from tightened terms to
        // parents/children.
        void normalize() { 
-         crab::CrabStats::count(getDomainName() + ".count.normalize");
-         crab::ScopedCrabStats __st__(getDomainName() + ".normalize");
+         crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.normalize"));
+         crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".normalize"));
          TermNormalizer<Info, typename Info::domain_t>::normalize(*this); 
        }
        
@@ -1595,11 +1706,11 @@ namespace crab {
        /// arithmetic meaning to the functors
        bool simplify(variable_t x) 
        {
-         auto it = _var_map.find (x);
-         if(it != _var_map.end())
+         auto it = _var_map->find (x);
+         if(it != _var_map->end())
          {
            term_id_t t = it->second;
-           simplifier_t simp(_ttbl);
+           simplifier_t simp(ttbl());
            auto nt = simp.simplify_term(t);  
            if (nt) 
            {
@@ -1620,14 +1731,14 @@ namespace crab {
            o << "_|_";
            return;
          }
-         if(_var_map.empty()) {
+         if(_var_map->empty()) {
            o << "{}";
            return;
          }      
 
          bool first = true;
          o << "{" ;
-         for(auto p : _var_map)
+         for(auto p : *_var_map)
          {
            if(first)
              first = false;
@@ -1643,7 +1754,7 @@ namespace crab {
 
          #ifdef VERBOSE
          /// For debugging purposes     
-         o << " ttbl={" << _ttbl << "}\n";
+         o << " ttbl={" << *_ttbl << "}\n";
          #endif 
        }
 
@@ -1651,7 +1762,7 @@ namespace crab {
          // Collect the visible terms
          rev_map_t rev_map;
          std::vector< std::pair<variable_t, variable_t> > equivs;
-         for(auto p : _var_map)
+         for(auto p : *_var_map)
          {
            dom_var_t dv = domvar_of_term(p.second);
 
@@ -1668,7 +1779,7 @@ namespace crab {
 
          // Create a copy of _impl with only visible variables.
          dom_t d_vis(_impl);
-         for(auto p : _term_map) {
+         for(auto p : *_term_map) {
            dom_var_t dv = p.second;
            if(rev_map.find(dv) == rev_map.end())
              d_vis -= dv;
@@ -1740,7 +1851,7 @@ namespace crab {
         // First propagate down, then up.   
         std::vector< std::vector< term_id_t > > queue;
         
-        ttbl_t& ttbl(abs._ttbl);
+        ttbl_t& ttbl(*abs._ttbl);
         dom_t& impl = abs._impl;
         
         for(term_id_t t : abs.changed_terms)
@@ -1912,7 +2023,7 @@ namespace crab {
         // First propagate down, then up.
         std::vector< std::vector< term_id_t > > queue;
         
-        ttbl_t& ttbl(abs._ttbl);
+        ttbl_t& ttbl(*abs._ttbl);
         dom_t& impl = abs._impl;
         if(impl.is_bottom())
         {
@@ -1260,13 +1260,13 @@ public:
 
   wrapped_interval_domain(const wrapped_interval_domain_t& e): 
     _env(e._env) { 
-    crab::CrabStats::count(getDomainName() + ".count.copy");
-    crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
   }
   
   wrapped_interval_domain_t& operator=(const wrapped_interval_domain_t& o) {
-    crab::CrabStats::count(getDomainName() + ".count.copy");
-    crab::ScopedCrabStats __st__(getDomainName() + ".copy");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.copy"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".copy"));
     if (this != &o)
       this->_env = o._env;
     return *this;
@@ -1289,8 +1289,8 @@ public:
   }
 
   bool operator<=(wrapped_interval_domain_t e) {
-    crab::CrabStats::count(getDomainName() + ".count.leq");
-    crab::ScopedCrabStats __st__(getDomainName() + ".leq");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.leq"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".leq"));
     //CRAB_LOG("wrapped-int",
     //       crab::outs()<< *this << " <= " << e << "=";);
     bool res = (this->_env <= e._env);
@@ -1300,8 +1300,8 @@ public:
   }
   
   void operator|=(wrapped_interval_domain_t e) {
-    crab::CrabStats::count(getDomainName() + ".count.join");
-    crab::ScopedCrabStats __st__(getDomainName() + ".join");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
     CRAB_LOG("wrapped-int",
 	     crab::outs() << *this << " U " << e << " = ");
     this->_env = this->_env | e._env;
@@ -1309,8 +1309,8 @@ public:
   }
 
   wrapped_interval_domain_t operator|(wrapped_interval_domain_t e) {
-    crab::CrabStats::count(getDomainName() + ".count.join");
-    crab::ScopedCrabStats __st__(getDomainName() + ".join");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.join"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".join"));
     CRAB_LOG("wrapped-int",
 	     crab::outs() << *this << " U " << e << " = ");
     wrapped_interval_domain_t res(this->_env | e._env);
@@ -1319,8 +1319,8 @@ public:
   }
 
   wrapped_interval_domain_t operator&(wrapped_interval_domain_t e) {
-    crab::CrabStats::count(getDomainName() + ".count.meet");
-    crab::ScopedCrabStats __st__(getDomainName() + ".meet");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.meet"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".meet"));
     CRAB_LOG("wrapped-int",
 	     crab::outs() << *this << " n " << e << " = ");    
     wrapped_interval_domain_t res(this->_env & e._env);
@@ -1329,8 +1329,8 @@ public:
   }
 
   wrapped_interval_domain_t operator||(wrapped_interval_domain_t e) {
-    crab::CrabStats::count(getDomainName() + ".count.widening");
-    crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
     CRAB_LOG("wrapped-int",
 	     crab::outs() << "WIDENING " << *this << " and " << e << " = ");    
     wrapped_interval_domain_t res(this->_env || e._env);
@@ -1341,8 +1341,8 @@ public:
   template<typename Thresholds>
   wrapped_interval_domain_t widening_thresholds(wrapped_interval_domain_t e,
 						 const Thresholds &ts) {
-    crab::CrabStats::count(getDomainName() + ".count.widening");
-    crab::ScopedCrabStats __st__(getDomainName() + ".widening");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.widening"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".widening"));
     CRAB_LOG("wrapped-int",
 	     crab::outs() << "WIDENING " << *this << " and " << e << " = ");    
     wrapped_interval_domain_t res(this->_env.widening_thresholds(e._env, ts));
@@ -1351,29 +1351,29 @@ public:
   }
   
   wrapped_interval_domain_t operator&&(wrapped_interval_domain_t e) {
-    crab::CrabStats::count(getDomainName() + ".count.narrowing");
-    crab::ScopedCrabStats __st__(getDomainName() + ".narrowing");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.narrowing"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".narrowing"));
     return (this->_env && e._env);
     }
   
 
   void operator-=(variable_t v) {
-    crab::CrabStats::count(getDomainName() + ".count.forget");
-    crab::ScopedCrabStats __st__(getDomainName() + ".forget");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.forget"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".forget"));
     this->_env -= v;
   }
 
   void set(variable_t v, wrapped_interval_t i) {
-    crab::CrabStats::count(getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
     this->_env.set(v, i);
     CRAB_LOG("wrapped-int",
 	     crab::outs() << v << ":=" << i << "=" << _env[v] << "\n");    
   }
 
   void set(variable_t v, interval_t i) {
-    crab::CrabStats::count(getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
     if (i.lb().is_finite() && i.ub.is_finite()) {
       wrapped_interval_t rhs = wrapped_interval_t::mk_winterval(i.lb(), i.ub(),
 								v.get_bitwidth());
@@ -1387,8 +1387,8 @@ public:
   }
   
   void set(variable_t v, number_t n) {
-    crab::CrabStats::count(getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
     this->_env.set(v, wrapped_interval_t::mk_winterval(n, v.get_bitwidth()));
     CRAB_LOG("wrapped-int",
 	     crab::outs() << v << ":=" << n << "=" << _env[v] << "\n");    
@@ -1406,8 +1406,8 @@ public:
   }
   
   void assign(variable_t x, linear_expression_t e) {
-    crab::CrabStats::count(getDomainName() + ".count.assign");
-    crab::ScopedCrabStats __st__(getDomainName() + ".assign");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.assign"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".assign"));
     if (boost::optional<variable_t> v = e.get_variable()) {
       this->_env.set(x, this->_env [*v]);
     } else {
@@ -1419,8 +1419,8 @@ public:
   }
   
   void apply(operation_t op, variable_t x, variable_t y, variable_t z) {
-    crab::CrabStats::count(getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
     
     wrapped_interval_t yi = this->_env[y];
     wrapped_interval_t zi = this->_env[z];
@@ -1458,8 +1458,8 @@ public:
   }
   
   void apply(operation_t op, variable_t x, variable_t y, number_t k) {
-    crab::CrabStats::count(getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
     
     wrapped_interval_t yi = this->_env[y];
     wrapped_interval_t zi = wrapped_interval_t::mk_winterval(k, x.get_bitwidth());
@@ -1538,8 +1538,8 @@ public:
   // bitwise operations
   
   void apply(bitwise_operation_t op, variable_t x, variable_t y, variable_t z){
-    crab::CrabStats::count(getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
     
     wrapped_interval_t yi = this->_env[y];
     wrapped_interval_t zi = this->_env[z];
@@ -1577,8 +1577,8 @@ public:
   }
   
   void apply(bitwise_operation_t op, variable_t x, variable_t y, number_t k){
-    crab::CrabStats::count(getDomainName() + ".count.apply");
-    crab::ScopedCrabStats __st__(getDomainName() + ".apply");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.apply"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".apply"));
     
     wrapped_interval_t yi = this->_env[y];
     wrapped_interval_t zi = wrapped_interval_t::mk_winterval(k, x.get_bitwidth());
@@ -1615,8 +1615,8 @@ public:
   }
   
   void operator+=(linear_constraint_system_t csts) {
-    crab::CrabStats::count(getDomainName() + ".count.add_constraints");
-    crab::ScopedCrabStats __st__(getDomainName() + ".add_constraints");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.add_constraints"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".add_constraints"));
     this->add(csts);
     CRAB_LOG("wrapped-int",
 	     crab::outs() << "Added " << csts << " = " << *this << "\n");            
@@ -1706,8 +1706,8 @@ public:
   }
   
   void project(const variable_vector_t& variables) {
-    crab::CrabStats::count(getDomainName() + ".count.project");
-    crab::ScopedCrabStats __st__(getDomainName() + ".project");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
     
     if (is_bottom() || is_top()) {
       return;
@@ -1721,8 +1721,8 @@ public:
   }
 
   void expand(variable_t x, variable_t new_x) {
-    crab::CrabStats::count(getDomainName() + ".count.expand");
-    crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
     
     if (is_bottom() || is_top()) {
       return;
@@ -2469,8 +2469,8 @@ public:
   }
     
   void expand(variable_t x, variable_t new_x) {
-    crab::CrabStats::count(getDomainName() + ".count.expand");
-    crab::ScopedCrabStats __st__(getDomainName() + ".expand");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.expand"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".expand"));
 
     if (is_bottom() || is_top()) {
       return;
@@ -2484,8 +2484,8 @@ public:
   }
   
   void project(const variable_vector_t& vars) {
-    crab::CrabStats::count(getDomainName() + ".count.project");
-    crab::ScopedCrabStats __st__(getDomainName() + ".project");
+    crab::CrabStats::count(CRAB_STATS_ID(getDomainName() + ".count.project"));
+    crab::ScopedCrabStats __st__(CRAB_STATS_ID(getDomainName() + ".project"));
 
     if (is_bottom() || is_top()) {
       return;
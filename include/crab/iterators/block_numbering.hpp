@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+#include <crab/common/debug.hpp>
+#include <crab/common/stats.hpp>
+
+namespace crab {
+  namespace iterators {
+
+    /**
+       Number the blocks of a CFG with dense ids from 0 to size()-1.
+
+       The numbering is computed once per CFG so that the WTO and the
+       fixpoint iterators can keep their tables in flat vectors
+       indexed by id. The successors and predecessors of each block
+       are also stored as ids (in CSR form) so that traversing the CFG
+       does not require any lookup by label.
+
+       The numbering is not updated if the CFG changes.
+    **/
+    template< typename NodeName, typename CFG >
+    class block_numbering {
+
+    public:
+
+      typedef uint32_t id_t;
+      typedef typename std::vector<id_t>::const_iterator id_iterator;
+      typedef std::pair<id_iterator, id_iterator> id_range;
+
+    private:
+
+      std::vector<NodeName> _labels;
+      boost::unordered_map<NodeName, id_t> _ids;
+      // the successors of block i are
+      // _succs[_succ_offsets[i], _succ_offsets[i+1]), and similarly
+      // for predecessors.
+      std::vector<std::size_t> _succ_offsets;
+      std::vector<id_t> _succs;
+      std::vector<std::size_t> _pred_offsets;
+      std::vector<id_t> _preds;
+
+    public:
+
+      static id_t invalid_id() {
+	return std::numeric_limits<id_t>::max();
+      }
+
+      block_numbering(CFG cfg) {
+	crab::ScopedCrabStats __st__("Fixpo.block_numbering");
+
+	for (auto it = cfg.label_begin(), et = cfg.label_end(); it != et; ++it) {
+	  NodeName n = *it;
+	  _ids.insert(std::make_pair(n, (id_t) _labels.size()));
+	  _labels.push_back(n);
+	}
+	if (_labels.size() >= invalid_id()) {
+	  CRAB_ERROR("block numbering: too many blocks");
+	}
+
+	_succ_offsets.reserve(_labels.size() + 1);
+	_pred_offsets.reserve(_labels.size() + 1);
+	_succ_offsets.push_back(0);
+	_pred_offsets.push_back(0);
+	for (NodeName n: _labels) {
+	  for (NodeName next: cfg.next_nodes(n)) {
+	    _succs.push_back(id(next));
+	  }
+	  for (NodeName prev: cfg.prev_nodes(n)) {
+	    _preds.push_back(id(prev));
+	  }
+	  _succ_offsets.push_back(_succs.size());
+	  _pred_offsets.push_back(_preds.size());
+	}
+      }
+
+      std::size_t size() const {
+	return _labels.size();
+      }
+
+      //! Return the id of n or invalid_id() if n is not a block of
+      //! the CFG.
+      id_t find(NodeName n) const {
+	auto it = _ids.find(n);
+	if (it == _ids.end()) {
+	  return invalid_id();
+	}
+	return it->second;
+      }
+
+      id_t id(NodeName n) const {
+	auto it = _ids.find(n);
+	if (it == _ids.end()) {
+	  CRAB_ERROR("block numbering: node ", n, " not found");
+	}
+	return it->second;
+      }
+
+      NodeName label(id_t i) const {
+	return _labels[i];
+      }
+
+      id_range succs(id_t i) const {
+	return std::make_pair(_succs.begin() + _succ_offsets[i],
+			      _succs.begin() + _succ_offsets[i+1]);
+      }
+
+      id_range preds(id_t i) const {
+	return std::make_pair(_preds.begin() + _pred_offsets[i],
+			      _preds.begin() + _pred_offsets[i+1]);
+      }
+
+    }; // class block_numbering
+
+  } // end namespace iterators
+} // end namespace crab
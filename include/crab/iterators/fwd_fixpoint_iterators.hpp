@@ -44,12 +44,22 @@
 
 #pragma once 
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <vector>
+#include <limits>
 #include <boost/shared_ptr.hpp>
 #include <boost/unordered_map.hpp>
 
 #include <crab/common/types.hpp>
 #include <crab/common/debug.hpp>
 #include <crab/common/stats.hpp>
+#include <crab/common/thread_pool.hpp>
 #include <crab/iterators/wto.hpp>
 #include <crab/iterators/fixpoint_iterators_api.hpp>
 #include <crab/iterators/thresholds.hpp>
@@ -63,6 +73,9 @@ namespace ikos {
 
     template< typename NodeName, typename CFG, typename AbstractValue >
     class wto_processor;
+
+    template< typename NodeName, typename CFG >
+    class wto_nodes_collector;
     
   } // namespace interleaved_fwd_fixpoint_iterator_impl
          
@@ -71,6 +84,7 @@ namespace ikos {
       public fixpoint_iterator< NodeName, CFG, AbstractValue > {
 
     friend class interleaved_fwd_fixpoint_iterator_impl::wto_iterator<NodeName, CFG, AbstractValue>;
+    friend class interleaved_fwd_fixpoint_iterator_impl::wto_processor<NodeName, CFG, AbstractValue>;
 
   public:
     
@@ -78,10 +92,14 @@ namespace ikos {
     typedef boost::unordered_map<NodeName,AbstractValue> assumption_map_t;
     
   private:
-    
-    typedef boost::unordered_map<NodeName,AbstractValue> invariant_table_t;
+
+    typedef typename wto_t::block_numbering_t block_numbering_t;
+    typedef typename block_numbering_t::id_t id_t;
+    // indexed by block id. Unreachable blocks are bottom.
+    typedef std::vector<std::pair<NodeName,AbstractValue> > invariant_table_t;
     typedef interleaved_fwd_fixpoint_iterator_impl::wto_iterator<NodeName, CFG, AbstractValue> wto_iterator_t;
     typedef interleaved_fwd_fixpoint_iterator_impl::wto_processor<NodeName, CFG, AbstractValue> wto_processor_t;
+    typedef interleaved_fwd_fixpoint_iterator_impl::wto_nodes_collector<NodeName, CFG> wto_nodes_collector_t;
     typedef crab::iterators::thresholds_t thresholds_t;
     typedef crab::iterators::wto_thresholds<NodeName, CFG> wto_thresholds_t;
 
@@ -89,6 +107,13 @@ namespace ikos {
     
     typedef typename invariant_table_t::iterator iterator;
     typedef typename invariant_table_t::const_iterator const_iterator;
+
+    // Used in memory-saving mode to recompute the invariants at the
+    // exit of node from the ones at its entry. It must have the same
+    // effect as analyze.
+    virtual void replay(NodeName node, AbstractValue &inv) const {
+      CRAB_ERROR("the fixpoint iterator cannot recompute invariants");
+    }
     
     CFG _cfg;
     wto_t _wto;
@@ -107,44 +132,160 @@ namespace ikos {
     typename wto_thresholds_t::thresholds_map_t _jump_set;
     // enable post-processing of the invariants
     bool _enable_processor;
+    // number of threads used to analyze independent WTO components
+    // (<= 1 means sequential iteration)
+    unsigned int _num_threads;
+    // returned by lookups of nodes that are not in the CFG
+    AbstractValue _bottom;
+    // whether the invariants have been computed (needed by
+    // run_incremental)
+    bool _has_run;
+    // Memory-saving mode: only the invariants at the entry of the
+    // checkpoints are kept once the fixpoint does not need them
+    // anymore. The others are recomputed on demand.
+    bool _memory_saving;
+    std::set<NodeName> _extra_checkpoints;
+    // indexed by block id
+    std::vector<bool> _checkpoint;
+    // state of the entries of _pre and _post (indexed by block id)
+    enum { _NOT_SET = 0, _STORED = 1, _EVICTED = 2 };
+    std::vector<char> _pre_state, _post_state;
+    // number of stored invariants (only in memory-saving mode)
+    std::size_t _num_stored;
+    std::size_t _peak_stored;
 
   private:
+
+    // All the copies of abstract values made by the iterator go
+    // through here so that they can be counted. Everything else is
+    // either moved or accessed by reference.
+    static AbstractValue copy(const AbstractValue& v) {
+      crab::CrabStats::count (CRAB_STATS_ID("Fixpo.copies"));
+      return v;
+    }
     
-    void set(invariant_table_t& table, NodeName node, const AbstractValue& v) {
-      crab::CrabStats::count ("Fixpo.invariant_table.update");
-      crab::ScopedCrabStats __st__("Fixpo.invariant_table.update");
-      
-      std::pair<typename invariant_table_t::iterator, bool> res = 
-	table.emplace(std::make_pair(node, v));
-      if (!res.second) {
-        (res.first)->second = std::move(v);
+    const block_numbering_t& numbering() const {
+      return this->_wto.numbering();
+    }
+
+    void init_tables() {
+      std::size_t num_blocks = numbering().size();
+      this->_pre.clear();
+      this->_post.clear();
+      this->_pre.reserve(num_blocks);
+      this->_post.reserve(num_blocks);
+      for (id_t i = 0; i < num_blocks; ++i) {
+	this->_pre.emplace_back(numbering().label(i), AbstractValue::bottom());
+	this->_post.emplace_back(numbering().label(i), AbstractValue::bottom());
       }
+      this->_pre_state.assign(num_blocks, _NOT_SET);
+      this->_post_state.assign(num_blocks, _NOT_SET);
+      this->_num_stored = 0;
+      this->_peak_stored = 0;
+      this->_has_run = false;
     }
     
-    inline void set_pre(NodeName node, const AbstractValue& v) {
-      this->set(this->_pre, node, v);
+    // The tables have an entry for every block so updating them never
+    // modifies their structure. run_components_parallel relies on
+    // this.
+    void set(invariant_table_t& table, std::vector<char>& state,
+	     id_t node, AbstractValue&& v) {
+      crab::CrabStats::count (CRAB_STATS_ID("Fixpo.invariant_table.update"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.invariant_table.update"));
+      table[node].second = std::move(v);
+      if (_memory_saving && state[node] != _STORED) {
+	// memory-saving mode is always sequential
+	_peak_stored = std::max(_peak_stored, ++_num_stored);
+      }
+      state[node] = _STORED;
+    }
+    
+    inline void set_pre(id_t node, AbstractValue&& v) {
+      this->set(this->_pre, this->_pre_state, node, std::move(v));
     }
 
-    inline void set_post(NodeName node, const AbstractValue& v) {
-      this->set(this->_post, node, v);
+    inline void set_pre(id_t node, const AbstractValue& v) {
+      this->set(this->_pre, this->_pre_state, node, copy(v));
     }
 
-    AbstractValue get(invariant_table_t& table, NodeName n) {
-      crab::CrabStats::count ("Fixpo.invariant_table.lookup");
-      crab::ScopedCrabStats __st__("Fixpo.invariant_table.lookup");
-      
-      typename invariant_table_t::iterator it = table.find(n);
-      if (it != table.end()) {
-        return it->second;
+    inline void set_post(id_t node, AbstractValue&& v) {
+      this->set(this->_post, this->_post_state, node, std::move(v));
+    }
+
+    inline void set_post(id_t node, const AbstractValue& v) {
+      this->set(this->_post, this->_post_state, node, copy(v));
+    }
+
+    void evict(invariant_table_t& table, std::vector<char>& state, id_t node) {
+      if (state[node] == _STORED) {
+	crab::CrabStats::count (CRAB_STATS_ID("Fixpo.invariant_table.evict"));
+	table[node].second = AbstractValue::bottom();
+	state[node] = _EVICTED;
+	--_num_stored;
+      }
+    }
+
+    // Return the unique predecessor of a block whose invariants have
+    // been evicted. Only blocks with one predecessor can be evicted.
+    id_t evicted_pred(id_t node) const {
+      auto preds = numbering().preds(node);
+      assert(std::distance(preds.first, preds.second) == 1);
+      return *preds.first;
+    }
+    
+    // Recompute the invariants at the entry of node by replaying the
+    // blocks from the closest predecessor with stored invariants.
+    AbstractValue recompute_pre(id_t node) const {
+      crab::CrabStats::count (CRAB_STATS_ID("Fixpo.invariant_table.recompute"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.invariant_table.recompute"));
+      // pre(node) = post(p) where p is its only predecessor
+      std::vector<id_t> path;
+      id_t p = evicted_pred(node);
+      while (_post_state[p] == _EVICTED && _pre_state[p] == _EVICTED) {
+	path.push_back(p);
+	p = evicted_pred(p);
+      }
+      AbstractValue inv;
+      if (_post_state[p] != _EVICTED) {
+	inv = copy(lookup_post(p));
       } else {
-        return AbstractValue::bottom();
+	inv = copy(lookup_pre(p));
+	replay(numbering().label(p), inv);
       }
+      for (auto it = path.rbegin(); it != path.rend(); ++it) {
+	replay(numbering().label(*it), inv);
+      }
+      return inv;
+    }
+    
+    AbstractValue get_pre(id_t node) const {
+      if (_pre_state[node] == _EVICTED) {
+	return recompute_pre(node);
+      }
+      return copy(lookup_pre(node));
+    }
+
+    AbstractValue get_post(id_t node) const {
+      if (_post_state[node] == _EVICTED) {
+	AbstractValue inv = get_pre(node);
+	replay(numbering().label(node), inv);
+	return inv;
+      }
+      return copy(lookup_post(node));
+    }
+
+    inline const AbstractValue& lookup_pre(id_t node) const {
+      return this->_pre[node].second;
+    }
+
+    inline const AbstractValue& lookup_post(id_t node) const {
+      return this->_post[node].second;
     }
 
     AbstractValue extrapolate(NodeName node, unsigned int iteration, 
-                              AbstractValue before, AbstractValue after) {
-      crab::CrabStats::count ("Fixpo.extrapolate");
-      crab::ScopedCrabStats __st__("Fixpo.extrapolate");
+                              AbstractValue&& before, AbstractValue&& after) {
+      crab::CrabStats::count (CRAB_STATS_ID("Fixpo.extrapolate"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.extrapolate"));
 
       CRAB_VERBOSE_IF(1, crab::outs() << "Increasing iteration=" << iteration << "\n"
 		      << "Widening at " << crab::cfg_impl::get_label_str(node) << "\n";);      
@@ -155,8 +296,9 @@ namespace ikos {
                  crab::outs() << "Prev   : " << before << "\n"
                            << "Current: " << after << "\n"
                            << "Res    : " << widen_res << "\n");
-        return before | after; 
+        return before | std::move(after); 
       } else {
+        crab::CrabStats::count (CRAB_STATS_ID("Fixpo.widening"));
         CRAB_LOG("fixpo",
                  crab::outs() << "Prev   : " << before << "\n"
                            << "Current: " << after << "\n");
@@ -175,15 +317,15 @@ namespace ikos {
           CRAB_LOG("fixpo",
                    auto widen_res = before || after;
                    crab::outs() << "Res    : " << widen_res << "\n");
-          return before || after;
+          return before || std::move(after);
         }
       }
     }
 
     AbstractValue refine(NodeName node, unsigned int iteration, 
-                         AbstractValue before, AbstractValue after) {
-      crab::CrabStats::count ("Fixpo.refine");
-      crab::ScopedCrabStats __st__("Fixpo.refine");
+                         AbstractValue&& before, AbstractValue&& after) {
+      crab::CrabStats::count (CRAB_STATS_ID("Fixpo.refine"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.refine"));
 
       CRAB_VERBOSE_IF(2, 
 		      crab::outs() << "Decreasing iteration=" << iteration << "\n"
@@ -195,28 +337,209 @@ namespace ikos {
                  crab::outs() << "Prev   : " << before << "\n"
                               << "Current: " << after << "\n"
                               << "Res    : " << narrow_res << "\n");
-        return before & after; 
+        return before & std::move(after); 
       } else {
         CRAB_LOG("fixpo",
                  auto narrow_res = before && after;
                  crab::outs() << "Prev   : " << before << "\n"
                               << "Current: " << after << "\n"
                               << "Res    : " << narrow_res << "\n");
-        return before && after; 
+        return before && std::move(after); 
       }
     }
 
     void initialize_thresholds(size_t jump_set_size) {
       if (_use_widening_jump_set) {
-        crab::CrabStats::resume ("Fixpo");
+        crab::CrabStats::resume (CRAB_STATS_ID("Fixpo"));
         // select statically some widening points to jump to.
 	wto_thresholds_t wto_thresholds(_cfg, jump_set_size);
 	_wto.accept(&wto_thresholds);
 	_jump_set = wto_thresholds.get_thresholds_map();
 	CRAB_VERBOSE_IF(3, crab::outs () << "Thresholds\n" << wto_thresholds << "\n");
-        crab::CrabStats::stop ("Fixpo");
+        crab::CrabStats::stop (CRAB_STATS_ID("Fixpo"));
       }      
     }
+
+    // The checkpoints are the entry, the blocks with more than one
+    // predecessor (this includes the heads of the WTO cycles except
+    // possibly the entry), the blocks whose invariants are
+    // strengthened by assumptions and the extra checkpoints given by
+    // the user. Any other block has one predecessor so its
+    // invariants can be recomputed from its predecessor's.
+    template<typename Range>
+    void compute_checkpoints(NodeName entry, Range assumed) {
+      std::size_t num_blocks = numbering().size();
+      _checkpoint.assign(num_blocks, false);
+      _checkpoint[numbering().id(entry)] = true;
+      for (id_t n = 0; n < num_blocks; ++n) {
+	auto preds = numbering().preds(n);
+	if (std::distance(preds.first, preds.second) != 1) {
+	  _checkpoint[n] = true;
+	}
+      }
+      for (NodeName n : assumed) {
+	id_t i = numbering().find(n);
+	if (i != block_numbering_t::invalid_id()) _checkpoint[i] = true;
+      }
+      for (NodeName n : _extra_checkpoints) {
+	id_t i = numbering().find(n);
+	if (i != block_numbering_t::invalid_id()) _checkpoint[i] = true;
+      }
+    }
+
+    void record_peak_stored() {
+      std::size_t num_stored = _peak_stored;
+      if (!_memory_saving) {
+	num_stored = std::count(_pre_state.begin(), _pre_state.end(), (char) _STORED) +
+	             std::count(_post_state.begin(), _post_state.end(), (char) _STORED);
+      }
+      crab::CrabStats::count_max(CRAB_STATS_ID("Fixpo.invariants.peak"), num_stored);
+    }
+    
+    typedef typename wto_t::wto_component_t wto_component_t;
+    
+    // Top-level WTO components and the dependencies between them.
+    //
+    // A top-level component only depends on the top-level components
+    // that contain some predecessor of its nodes, and those always
+    // appear earlier in the WTO.
+    struct component_graph {
+      std::vector<wto_component_t*> components;
+      // indexed by block id (no_component() for unreachable blocks)
+      std::vector<unsigned> component_of;
+      // succs[i] are the components that depend on i
+      std::vector<std::vector<unsigned>> succs;
+
+      static unsigned no_component() {
+	return std::numeric_limits<unsigned>::max();
+      }
+    };
+
+    void build_component_graph(component_graph &g) {
+      g.component_of.assign(numbering().size(), component_graph::no_component());
+      for (typename wto_t::iterator it = _wto.begin(); it != _wto.end(); ++it) {
+	wto_nodes_collector_t collector;
+	it->accept(&collector);
+	for (id_t n : collector.nodes()) {
+	  g.component_of[n] = g.components.size();
+	}
+	g.components.push_back(&*it);
+      }
+      std::set<std::pair<unsigned, unsigned>> deps;
+      for (id_t n = 0; n < g.component_of.size(); ++n) {
+	unsigned c = g.component_of[n];
+	if (c == component_graph::no_component()) continue;
+	auto preds = numbering().preds(n);
+	for (auto it = preds.first; it != preds.second; ++it) {
+	  unsigned prev_c = g.component_of[*it];
+	  if (prev_c != component_graph::no_component() && prev_c != c) {
+	    deps.insert(std::make_pair(prev_c, c));
+	  }
+	}
+      }
+      g.succs.resize(g.components.size());
+      for (auto &d : deps) {
+	g.succs[d.first].push_back(d.second);
+      }
+    }
+
+    // Analyze the selected top-level components in WTO order. The
+    // successors of a selected component must be also selected.
+    void run_components(component_graph &g, const std::vector<bool> &selected) {
+      for (unsigned i = 0; i < g.components.size(); ++i) {
+	if (selected[i]) {
+	  wto_iterator_t iterator(this, false /*do not skip*/);
+	  g.components[i]->accept(&iterator);
+	}
+      }
+    }
+    
+    // Analyze the top-level components in WTO order as the iterator
+    // does, but once a component is done its invariants are
+    // post-processed and then evicted unless they are still needed:
+    // the invariants at the entry of checkpoints are always kept, and
+    // those at the exit of a block until all its successors have been
+    // analyzed.
+    void run_memory_saving(wto_iterator_t &iterator) {
+      component_graph g;
+      build_component_graph(g);
+      for (unsigned i = 0; i < g.components.size(); ++i) {
+	g.components[i]->accept(&iterator);
+	if (_enable_processor) {
+	  wto_processor_t processor(this);
+	  g.components[i]->accept(&processor);
+	}
+	wto_nodes_collector_t collector;
+	g.components[i]->accept(&collector);
+	auto is_done = [&g, i](id_t n) {
+	  unsigned c = g.component_of[n];
+	  return c == component_graph::no_component() || c <= i;
+	};
+	auto evict_post_if_done = [this, &is_done](id_t n) {
+	  auto succs = numbering().succs(n);
+	  if (std::all_of(succs.first, succs.second, is_done)) {
+	    evict(_post, _post_state, n);
+	  }
+	};
+	for (id_t n : collector.nodes()) {
+	  if (!_checkpoint[n]) {
+	    evict(_pre, _pre_state, n);
+	  }
+	  evict_post_if_done(n);
+	  auto preds = numbering().preds(n);
+	  for (auto it = preds.first; it != preds.second; ++it) {
+	    evict_post_if_done(*it);
+	  }
+	}
+      }
+    }
+    
+    // Same as run_components but in parallel.
+    //
+    // A component can be analyzed as soon as all the selected
+    // components it depends on are done, and it will see exactly the
+    // same invariants as in the sequential iteration.
+    //
+    // The tables have an entry for every block so they are only read
+    // or updated in place while running in parallel. Each entry is
+    // written by only one worker.
+    //
+    // The abstract domain must be thread-safe.
+    void run_components_parallel(component_graph &g, const std::vector<bool> &selected) {
+      unsigned num_components = g.components.size();
+      std::unique_ptr<std::atomic<unsigned>[]>
+	num_preds(new std::atomic<unsigned>[num_components]);
+      for (unsigned i = 0; i < num_components; ++i) {
+	num_preds[i] = 0;
+      }
+      for (unsigned i = 0; i < num_components; ++i) {
+	if (selected[i]) {
+	  for (unsigned j : g.succs[i]) {
+	    ++num_preds[j];
+	  }
+	}
+      }
+      
+      CRAB_VERBOSE_IF(1, crab::outs() << "Analyzing " << num_components
+		      << " WTO components with " << _num_threads << " threads\n";);
+      
+      crab::work_stealing_thread_pool pool(_num_threads);
+      std::function<void(unsigned)> analyze_component = [&](unsigned i) {
+	wto_iterator_t iterator(this, false /*do not skip*/);
+	g.components[i]->accept(&iterator);
+	for (unsigned j : g.succs[i]) {
+	  if (--num_preds[j] == 0) {
+	    pool.submit([&analyze_component, j] { analyze_component(j); });
+	  }
+	}
+      };
+      for (unsigned i = 0; i < num_components; ++i) {
+	if (selected[i] && num_preds[i] == 0) {
+	  pool.submit([&analyze_component, i] { analyze_component(i); });
+	}
+      }
+      pool.wait();
+    }
     
   public:
     
@@ -224,13 +547,19 @@ namespace ikos {
                                       unsigned int widening_delay,
                                       unsigned int descending_iterations,
                                       size_t jump_set_size,
-				      bool enable_processor = true)
+				      bool enable_processor = true,
+				      unsigned int num_threads = 1)
       : _cfg(cfg)
       , _wto(!wto ? cfg: *wto)
       , _widening_delay(widening_delay)
       , _descending_iterations(descending_iterations)
       , _use_widening_jump_set (jump_set_size > 0)
-      , _enable_processor(enable_processor) {
+      , _enable_processor(enable_processor)
+      , _num_threads(num_threads)
+      , _bottom(AbstractValue::bottom())
+      , _has_run(false)
+      , _memory_saving(false) {
+      init_tables();
       initialize_thresholds(jump_set_size);
     }
     
@@ -244,49 +573,170 @@ namespace ikos {
       return this->_wto;
     }
 
-    AbstractValue get_pre(NodeName node) {
-      return this->get(this->_pre, node);
+    unsigned int get_num_threads() const {
+      return this->_num_threads;
+    }
+
+    // Keep only the invariants at the entry of the WTO heads, the
+    // join points and the blocks in extra_checkpoints. The others are
+    // evicted as soon as the fixpoint does not need them and
+    // get_pre/get_post recompute them on demand by replaying the
+    // blocks from the closest checkpoint. The recomputed invariants
+    // can be more precise if there are no descending iterations. The
+    // WTO components are analyzed sequentially and run_incremental is
+    // not supported in this mode.
+    void set_memory_saving(bool v,
+			   const std::set<NodeName> &extra_checkpoints = std::set<NodeName>()) {
+      _memory_saving = v;
+      _extra_checkpoints = extra_checkpoints;
+    }
+    
+    // Return the invariants at the entry of node. In memory-saving
+    // mode they might be recomputed.
+    AbstractValue get_pre(NodeName node) const {
+      crab::CrabStats::count (CRAB_STATS_ID("Fixpo.invariant_table.lookup"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.invariant_table.lookup"));
+      id_t i = numbering().find(node);
+      if (i != block_numbering_t::invalid_id()) {
+	return this->get_pre(i);
+      } else {
+	return _bottom;
+      }
     }
     
-    AbstractValue get_post(NodeName node) {
-      return this->get(this->_post, node);
+    // Return the invariants at the exit of node. In memory-saving
+    // mode they might be recomputed.
+    AbstractValue get_post(NodeName node) const {
+      crab::CrabStats::count (CRAB_STATS_ID("Fixpo.invariant_table.lookup"));
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.invariant_table.lookup"));
+      id_t i = numbering().find(node);
+      if (i != block_numbering_t::invalid_id()) {
+	return this->get_post(i);
+      } else {
+	return _bottom;
+      }
     }
 
     void run(AbstractValue init) {
-      crab::ScopedCrabStats __st__("Fixpo");
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo"));
       CRAB_VERBOSE_IF(1, crab::outs() << "== Started fixpoint\n");
-      this->set_pre(this->_cfg.entry(), init);
-      wto_iterator_t iterator(this);
-      this->_wto.accept(&iterator);
-      if (_enable_processor) {
-	wto_processor_t processor(this);
-	this->_wto.accept(&processor);
+      if (_memory_saving) {
+	compute_checkpoints(this->_cfg.entry(), std::vector<NodeName>());
       }
+      this->set_pre(numbering().id(this->_cfg.entry()), std::move(init));
+      this->_has_run = true;
+      if (_memory_saving) {
+	wto_iterator_t iterator(this);
+	run_memory_saving(iterator);
+      } else {
+	if (_num_threads > 1) {
+	  component_graph g;
+	  build_component_graph(g);
+	  run_components_parallel(g, std::vector<bool>(g.components.size(), true));
+	} else {
+	  wto_iterator_t iterator(this);
+	  this->_wto.accept(&iterator);
+	}
+	if (_enable_processor) {
+	  wto_processor_t processor(this);
+	  this->_wto.accept(&processor);
+	}
+      }
+      record_peak_stored();
       CRAB_VERBOSE_IF(1, crab::outs() << "== Fixpoint reached.\n");
       CRAB_VERBOSE_IF(3, crab::outs() << "Wto:\n" << _wto << "\n");            
     }
 
     void run(NodeName entry, AbstractValue init, assumption_map_t &assumptions) {
-      crab::ScopedCrabStats __st__("Fixpo");
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo"));
       CRAB_VERBOSE_IF(1,
 	     crab::outs() << "== Started fixpoint at block "
 		          << crab::cfg_impl::get_label_str(entry)
 		          << " with initial value=" << init << "\n";);      
-      this->set_pre(entry, init);
+      if (_memory_saving) {
+	std::vector<NodeName> assumed;
+	for (auto &kv : assumptions) {
+	  assumed.push_back(kv.first);
+	}
+	compute_checkpoints(entry, assumed);
+      }
+      this->set_pre(numbering().id(entry), std::move(init));
+      this->_has_run = true;
       wto_iterator_t iterator(this, entry, &assumptions);
-      this->_wto.accept(&iterator);
+      if (_memory_saving) {
+	run_memory_saving(iterator);
+      } else {
+	this->_wto.accept(&iterator);
+	if (_enable_processor) {
+	  wto_processor_t processor(this);
+	  this->_wto.accept(&processor);
+	}
+      }
+      record_peak_stored();
+      CRAB_VERBOSE_IF(1, crab::outs() << "== Fixpoint reached.\n");
+      CRAB_VERBOSE_IF(3, crab::outs() << "Wto:\n" << _wto << "\n");      
+      
+    }
+
+    // Re-stabilize the invariants after the statements of the blocks
+    // in modified have changed. The structure of the CFG must be the
+    // same as in the previous call to run(init).
+    //
+    // Only the top-level WTO components that contain a modified
+    // block, and those that (transitively) depend on them, are
+    // analyzed again. They start from the invariants already stored
+    // for the components they depend on. The invariants of the other
+    // components are kept as they are.
+    void run_incremental(const std::set<NodeName> &modified) {
+      if (!_has_run) {
+	CRAB_ERROR("incremental fixpoint requires a previous run");
+      }
+      if (_memory_saving) {
+	CRAB_ERROR("incremental fixpoint is not supported in memory-saving mode");
+      }
+      
+      crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo"));
+      CRAB_VERBOSE_IF(1, crab::outs() << "== Started incremental fixpoint\n");
+      component_graph g;
+      build_component_graph(g);
+      std::vector<bool> dirty(g.components.size(), false);
+      for (NodeName n : modified) {
+	id_t i = numbering().find(n);
+	// unreachable blocks do not affect the invariants
+	if (i != block_numbering_t::invalid_id() &&
+	    g.component_of[i] != component_graph::no_component()) {
+	  dirty[g.component_of[i]] = true;
+	}
+      }
+      // dependencies go always forward in the WTO
+      unsigned num_dirty = 0;
+      for (unsigned i = 0; i < g.components.size(); ++i) {
+	if (dirty[i]) {
+	  num_dirty++;
+	  for (unsigned j : g.succs[i]) {
+	    dirty[j] = true;
+	  }
+	}
+      }
+      crab::CrabStats::uset("Fixpo.incremental.dirty_components", num_dirty);
+      CRAB_VERBOSE_IF(1, crab::outs() << "Re-analyzing " << num_dirty << " out of "
+		      << g.components.size() << " WTO components\n");
+      
+      if (_num_threads > 1) {
+	run_components_parallel(g, dirty);
+      } else {
+	run_components(g, dirty);
+      }
       if (_enable_processor) {
 	wto_processor_t processor(this);
 	this->_wto.accept(&processor);
       }
+      record_peak_stored();
       CRAB_VERBOSE_IF(1, crab::outs() << "== Fixpoint reached.\n");
-      CRAB_VERBOSE_IF(3, crab::outs() << "Wto:\n" << _wto << "\n");      
-      
     }
 
     void clear() {
-      this->_pre.clear();
-      this->_post.clear();      
+      init_tables();
     }
         
   }; // class interleaved_fwd_fixpoint_iterator
@@ -303,18 +753,20 @@ namespace ikos {
       typedef wto<NodeName, CFG> wto_t;
       typedef typename wto_t::wto_nesting_t wto_nesting_t;
       typedef typename interleaved_iterator_t::assumption_map_t assumption_map_t;
+      typedef typename wto_t::id_t id_t;
       
     private:
       interleaved_iterator_t *_iterator;
       // Initial entry point of the analysis
       NodeName _entry;      
+      id_t _entry_id;
       assumption_map_t *_assumptions;
       // Used to skip the analysis until _entry is found
       bool _skip; 
       
-      inline AbstractValue strengthen (NodeName n, AbstractValue inv) {
-	crab::CrabStats::count ("Fixpo.strengthen");
-	crab::ScopedCrabStats __st__("Fixpo.strengthen");
+      inline AbstractValue strengthen (NodeName n, AbstractValue&& inv) {
+	crab::CrabStats::count (CRAB_STATS_ID("Fixpo.strengthen"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.strengthen"));
 
 	if (_assumptions) {
 	  auto it = _assumptions->find(n);
@@ -323,13 +775,13 @@ namespace ikos {
 	    	      crab::outs() << "Before assumption at " << n << ":"
 		                   << inv << "\n");
 		                   
-	    inv = inv & it->second;
+	    inv = inv & interleaved_iterator_t::copy(it->second);
 	    CRAB_LOG ("fixpo",
 	    	      crab::outs() << "After assumption at " << n << ":"
 	    	                   << inv << "\n");
 	  }
 	}
-	return inv;
+	return std::move(inv);
       }
 
       // Simple visitor to check if node is a member of the wto component.
@@ -360,22 +812,43 @@ namespace ikos {
       }; 
       
     public:
-      wto_iterator(interleaved_iterator_t *iterator)
+      wto_iterator(interleaved_iterator_t *iterator, bool skip = true)
 	: _iterator(iterator),
 	  _entry(_iterator->get_cfg().entry()),	  
+	  _entry_id(_iterator->numbering().id(_entry)),
 	  _assumptions (nullptr),
-	  _skip(true) { }
+	  _skip(skip) { }
 
       wto_iterator(interleaved_iterator_t *iterator,
 		   NodeName entry,
 		   assumption_map_t *assumptions)
 	: _iterator(iterator),
 	  _entry(entry),	  
+	  _entry_id(_iterator->numbering().id(_entry)),
 	  _assumptions (assumptions),
 	  _skip(true) { }      
+
+      // join the invariants at the exit of the predecessors of node
+      // that satisfy f
+      template<typename Filter>
+      AbstractValue join_predecessors(id_t node, Filter f) {
+	AbstractValue pre = AbstractValue::bottom();
+	auto prev_nodes = this->_iterator->numbering().preds(node);
+	for (auto it = prev_nodes.first; it != prev_nodes.second; ++it) {
+	  if (f(*it)) {
+	    pre |= interleaved_iterator_t::copy(this->_iterator->lookup_post(*it));
+	  }
+	}
+	return pre;
+      }
+
+      AbstractValue join_predecessors(id_t node) {
+	return join_predecessors(node, [](id_t) { return true; });
+      }
       
       void visit(wto_vertex_t& vertex) {
         NodeName node = vertex.node();
+	id_t node_id = vertex.id();
 
 	/** decide whether skip vertex or not **/	
 	if (_skip && (node == _entry)) {
@@ -390,41 +863,39 @@ namespace ikos {
        
         AbstractValue pre;
         if (node == _entry) {
-          pre = this->_iterator->get_pre(node);
+          pre = interleaved_iterator_t::copy(this->_iterator->lookup_pre(node_id));
 	  if (_assumptions) { // no necessary but it might avoid copies
-	    pre = strengthen (node, pre);
+	    pre = strengthen (node, std::move(pre));
 	  }
         } else {
-          auto prev_nodes = this->_iterator->_cfg.prev_nodes(node);
-	  crab::CrabStats::resume("Fixpo.join_predecessors");		  	  
-          pre = AbstractValue::bottom();
+	  crab::CrabStats::resume(CRAB_STATS_ID("Fixpo.join_predecessors"));		  	  
           CRAB_VERBOSE_IF (2,
 		           crab::outs() << "Joining predecessors of "
 			   << crab::cfg_impl::get_label_str(node) << "\n");
-          for (NodeName prev : prev_nodes) {
-            pre |= this->_iterator->get_post(prev);  
-          }
-	  crab::CrabStats::stop("Fixpo.join_predecessors");
+          pre = join_predecessors(node_id);
+	  crab::CrabStats::stop(CRAB_STATS_ID("Fixpo.join_predecessors"));
 	  if (_assumptions) { //no necessary but it might avoid copies
-	    pre = strengthen (node, pre);
+	    pre = strengthen (node, std::move(pre));
 	  }
-          this->_iterator->set_pre(node, pre);
+          this->_iterator->set_pre(node_id, pre);
         }
 	
-        crab::CrabStats::resume ("Fixpo.analyze_block");
-	AbstractValue post(pre); 	
+        crab::CrabStats::resume (CRAB_STATS_ID("Fixpo.analyze_block"));
+	// pre is not needed anymore
+	AbstractValue post(std::move(pre));
         CRAB_VERBOSE_IF (1, crab::outs() << "Analyzing node "
 			                 << crab::cfg_impl::get_label_str(node);
 			 auto &n = this->_iterator->_cfg.get_node(node);
 			 crab::outs () << " size=" << n.size() << "\n";);
         this->_iterator->analyze(node, post);
-        crab::CrabStats::stop ("Fixpo.analyze_block");		
+        crab::CrabStats::stop (CRAB_STATS_ID("Fixpo.analyze_block"));		
 	
-        this->_iterator->set_post(node, post);
+        this->_iterator->set_post(node_id, std::move(post));
       }
       
       void visit(wto_cycle_t& cycle) {
         NodeName head = cycle.head();
+	id_t head_id = cycle.head_id();
 
 	/** decide whether skip cycle or not **/
 	bool entry_in_this_cycle = false;
@@ -449,29 +920,27 @@ namespace ikos {
 			 auto &n = this->_iterator->_cfg.get_node(head);
 			 crab::outs () << " size=" << n.size() << "\n";);
 	
-        auto prev_nodes = this->_iterator->_cfg.prev_nodes(head);
         AbstractValue pre = AbstractValue::bottom();
 
 	if (entry_in_this_cycle) {
 	  CRAB_VERBOSE_IF (2,
 		    crab::outs() << "Skipped predecessors of "
 		  	         << crab::cfg_impl::get_label_str(head) << "\n");
-	  pre = _iterator->get_pre(_entry);
+	  pre = interleaved_iterator_t::copy(_iterator->lookup_pre(_entry_id));
 	} else {
-	  crab::CrabStats::count ("Fixpo.join_predecessors");
-	  crab::ScopedCrabStats __st__("Fixpo.join_predecessors");
+	  crab::CrabStats::count (CRAB_STATS_ID("Fixpo.join_predecessors"));
+	  crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.join_predecessors"));
 	  CRAB_VERBOSE_IF (2,
 		    crab::outs() << "Joining predecessors of "
 		  	         << crab::cfg_impl::get_label_str(head) << "\n");
-	  wto_nesting_t cycle_nesting = this->_iterator->_wto.nesting(head);	
-	  for (NodeName prev : prev_nodes) {
-	    if (!(this->_iterator->_wto.nesting(prev) > cycle_nesting)) {
-	      pre |= this->_iterator->get_post(prev); 
-	    }
-	  }
+	  const wto_t &wto = this->_iterator->_wto;
+	  // skip the predecessors with nesting(prev) > nesting(head)
+	  pre = join_predecessors(head_id, [&wto, head_id](id_t prev) {
+	      return !wto.nesting_greater(prev, head_id);
+	    });
 	}
 	if (_assumptions) { //no necessary but it might avoid copies
-	  pre = strengthen (head, pre);
+	  pre = strengthen (head, std::move(pre));
 	}
 	
         for(unsigned int iteration = 1; ; ++iteration) {
@@ -479,38 +948,36 @@ namespace ikos {
 	  cycle.increment_fixpo_visits ();
 	  
           // Increasing iteration sequence with widening
-          this->_iterator->set_pre(head, pre);
-	  crab::CrabStats::resume("Fixpo.analyze_block");		  
-          AbstractValue post(pre); 
+          this->_iterator->set_pre(head_id, pre);
+	  crab::CrabStats::resume(CRAB_STATS_ID("Fixpo.analyze_block"));		  
+          AbstractValue post(interleaved_iterator_t::copy(pre));
           CRAB_VERBOSE_IF(1, crab::outs() << "Analyzing node "
 			                  << crab::cfg_impl::get_label_str(head);
 			  auto &n = this->_iterator->_cfg.get_node(head);
 			  crab::outs () << " size=" << n.size() << "\n";);
           this->_iterator->analyze(head, post);
-	  crab::CrabStats::stop("Fixpo.analyze_block");		  	  
+	  crab::CrabStats::stop(CRAB_STATS_ID("Fixpo.analyze_block"));		  	  
 	  
-          this->_iterator->set_post(head, post);
+          this->_iterator->set_post(head_id, std::move(post));
           for (typename wto_cycle_t::iterator it = cycle.begin();
 	       it != cycle.end(); ++it) {
             it->accept(this);
           }
-	  crab::CrabStats::resume("Fixpo.join_predecessors");
-          AbstractValue new_pre = AbstractValue::bottom();
-          for (NodeName prev : prev_nodes) {
-            new_pre |= this->_iterator->get_post(prev); 
-          }
-	  crab::CrabStats::stop("Fixpo.join_predecessors");
-	  crab::CrabStats::resume("Fixpo.check_fixpoint");	  	  
-	  bool fixpoint_reached = new_pre <= pre;
-	  crab::CrabStats::stop("Fixpo.check_fixpoint");	  	  
+	  crab::CrabStats::resume(CRAB_STATS_ID("Fixpo.join_predecessors"));
+          AbstractValue new_pre = join_predecessors(head_id);
+	  crab::CrabStats::stop(CRAB_STATS_ID("Fixpo.join_predecessors"));
+	  crab::CrabStats::resume(CRAB_STATS_ID("Fixpo.check_fixpoint"));	  	  
+	  bool fixpoint_reached = new_pre <= interleaved_iterator_t::copy(pre);
+	  crab::CrabStats::stop(CRAB_STATS_ID("Fixpo.check_fixpoint"));	  	  
           if (fixpoint_reached) {
             // Post-fixpoint reached
             CRAB_VERBOSE_IF(1, crab::outs() << "post-fixpoint reached\n");
-            this->_iterator->set_pre(head, new_pre);
-            pre = new_pre;
+            this->_iterator->set_pre(head_id, new_pre);
+            pre = std::move(new_pre);
             break;
           } else {
-            pre = this->_iterator->extrapolate(head, iteration, pre, new_pre);
+            pre = this->_iterator->extrapolate(head, iteration,
+					       std::move(pre), std::move(new_pre));
           }
         }
 
@@ -524,37 +991,35 @@ namespace ikos {
         for(unsigned int iteration = 1; ; ++iteration) {
           // Decreasing iteration sequence with narrowing
 
-	  crab::CrabStats::resume("Fixpo.analyze_block");		  
-          AbstractValue post(pre); 
+	  crab::CrabStats::resume(CRAB_STATS_ID("Fixpo.analyze_block"));		  
+          AbstractValue post(interleaved_iterator_t::copy(pre));
           CRAB_VERBOSE_IF(1,crab::outs() << "Analyzing node "
 			  << crab::cfg_impl::get_label_str(head);
 			  auto &n = this->_iterator->_cfg.get_node(head);
 			  crab::outs () << " size=" << n.size() << "\n";);
           this->_iterator->analyze(head, post);
-          this->_iterator->set_post(head, post);
-	  crab::CrabStats::stop("Fixpo.analyze_block");	
+          this->_iterator->set_post(head_id, std::move(post));
+	  crab::CrabStats::stop(CRAB_STATS_ID("Fixpo.analyze_block"));	
 	  
           for (typename wto_cycle_t::iterator it = cycle.begin();
 	       it != cycle.end(); ++it) {
             it->accept(this);
           }
-	  crab::CrabStats::resume("Fixpo.join_predecessors");	  
-          AbstractValue new_pre = AbstractValue::bottom();
-          for (NodeName prev : prev_nodes) {
-            new_pre |= this->_iterator->get_post(prev); 
-          }
-	  crab::CrabStats::stop("Fixpo.join_predecessors");
-	  crab::CrabStats::resume("Fixpo.check_fixpoint");
-	  bool no_more_refinement = pre <= new_pre;
-	  crab::CrabStats::stop("Fixpo.check_fixpoint");	  
+	  crab::CrabStats::resume(CRAB_STATS_ID("Fixpo.join_predecessors"));
+          AbstractValue new_pre = join_predecessors(head_id);
+	  crab::CrabStats::stop(CRAB_STATS_ID("Fixpo.join_predecessors"));
+	  crab::CrabStats::resume(CRAB_STATS_ID("Fixpo.check_fixpoint"));
+	  bool no_more_refinement = pre <= interleaved_iterator_t::copy(new_pre);
+	  crab::CrabStats::stop(CRAB_STATS_ID("Fixpo.check_fixpoint"));	  
           if (no_more_refinement) {
             CRAB_VERBOSE_IF(1, crab::outs() << "No more refinement possible.\n");
             // No more refinement possible (pre == new_pre)
             break;
           } else {
             if (iteration > this->_iterator->_descending_iterations) break; 
-            pre = this->_iterator->refine(head, iteration, pre, new_pre);
-            this->_iterator->set_pre(head, pre);
+            pre = this->_iterator->refine(head, iteration,
+					  std::move(pre), std::move(new_pre));
+            this->_iterator->set_pre(head_id, pre);
           }
         }
         CRAB_VERBOSE_IF (1,
@@ -580,27 +1045,57 @@ namespace ikos {
       wto_processor(interleaved_iterator_t *iterator): _iterator(iterator) { }
       
       void visit(wto_vertex_t& vertex) {
-	crab::CrabStats::count ("Fixpo.process_invariants");
-	crab::ScopedCrabStats __st__("Fixpo.process_invariants");
+	crab::CrabStats::count (CRAB_STATS_ID("Fixpo.process_invariants"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.process_invariants"));
 
         NodeName node = vertex.node();
-        this->_iterator->process_pre(node, this->_iterator->get_pre(node));
-        this->_iterator->process_post(node, this->_iterator->get_post(node));
+        this->_iterator->process_pre(node, interleaved_iterator_t::copy(this->_iterator->lookup_pre(vertex.id())));
+        this->_iterator->process_post(node, interleaved_iterator_t::copy(this->_iterator->lookup_post(vertex.id())));
       }
       
       void visit(wto_cycle_t& cycle) {
-	crab::CrabStats::count ("Fixpo.process_invariants");
-	crab::ScopedCrabStats __st__("Fixpo.process_invariants");
+	crab::CrabStats::count (CRAB_STATS_ID("Fixpo.process_invariants"));
+	crab::ScopedCrabStats __st__(CRAB_STATS_ID("Fixpo.process_invariants"));
 	
         NodeName head = cycle.head();
-        this->_iterator->process_pre(head, this->_iterator->get_pre(head));
-        this->_iterator->process_post(head, this->_iterator->get_post(head));
+        this->_iterator->process_pre(head, interleaved_iterator_t::copy(this->_iterator->lookup_pre(cycle.head_id())));
+        this->_iterator->process_post(head, interleaved_iterator_t::copy(this->_iterator->lookup_post(cycle.head_id())));
         for (typename wto_cycle_t::iterator it = cycle.begin(); it != cycle.end(); ++it) {
           it->accept(this);
         }	
       }
       
     }; // class wto_processor
+
+    // Collect the ids of all the nodes of a wto component
+    template< typename NodeName, typename CFG >
+    class wto_nodes_collector: public wto_component_visitor< NodeName, CFG > {
+
+    public:
+      typedef wto_vertex< NodeName, CFG > wto_vertex_t;
+      typedef wto_cycle< NodeName, CFG > wto_cycle_t;
+      typedef typename wto_vertex_t::id_t id_t;
+
+    private:
+      std::vector<id_t> _nodes;
+      
+    public:
+      void visit(wto_vertex_t& vertex) {
+	_nodes.push_back(vertex.id());
+      }
+      
+      void visit(wto_cycle_t& cycle) {
+	_nodes.push_back(cycle.head_id());
+        for (typename wto_cycle_t::iterator it = cycle.begin(); it != cycle.end(); ++it) {
+          it->accept(this);
+        }	
+      }
+
+      const std::vector<id_t>& nodes() const {
+	return _nodes;
+      }
+      
+    }; // class wto_nodes_collector
     
   } // interleaved_fwd_fixpoint_iterator_impl  
 } // namespace ikos
@@ -45,6 +45,9 @@
 
 #pragma once 
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <set>
 #include <boost/shared_ptr.hpp>
@@ -56,6 +59,7 @@
 #include <crab/common/stats.hpp>
 #include <crab/common/debug.hpp>
 #include <crab/domains/interval.hpp>
+#include <crab/iterators/block_numbering.hpp>
 
 
 // Define RECURSIVE_WTO to use older, recursive version.  It is
@@ -233,17 +237,25 @@ namespace ikos {
 
     friend class wto< NodeName, CFG >;
 
+  public:
+    typedef typename crab::iterators::block_numbering< NodeName, CFG >::id_t id_t;
+
   private:
     NodeName _node;
+    id_t _id;
 
   private:
-    wto_vertex(NodeName node): _node(node) { }
+    wto_vertex(NodeName node, id_t id): _node(node), _id(id) { }
 
   public:
     NodeName node() {
       return this->_node;
     }
 
+    id_t id() const {
+      return this->_id;
+    }
+
     void accept(wto_component_visitor< NodeName, CFG > *v) {
       v->visit(*this);
     }
@@ -261,6 +273,7 @@ namespace ikos {
     
   public:
     typedef wto_component< NodeName, CFG > wto_component_t;
+    typedef typename crab::iterators::block_numbering< NodeName, CFG >::id_t id_t;
     
   private:
     typedef boost::shared_ptr< wto_component_t > wto_component_ptr;
@@ -269,14 +282,15 @@ namespace ikos {
 
   private:
     NodeName _head;
+    id_t _head_id;
     wto_component_list_ptr _wto_components;
     // number of times the wto cycle is analyzed by the fixpoint iterator
     unsigned _num_fixpo;
     
   private:
-    wto_cycle(NodeName head, 
+    wto_cycle(NodeName head, id_t head_id,
               wto_component_list_ptr wto_components): 
-      _head(head), _wto_components(wto_components), _num_fixpo(0) { }
+      _head(head), _head_id(head_id), _wto_components(wto_components), _num_fixpo(0) { }
     
   public:
     class iterator: public boost::iterator_facade< iterator,
@@ -318,6 +332,10 @@ namespace ikos {
     NodeName head() {
       return this->_head;
     }
+
+    id_t head_id() const {
+      return this->_head_id;
+    }
     
     void accept(wto_component_visitor< NodeName, CFG > *v) {
       v->visit(*this);
@@ -382,6 +400,8 @@ namespace ikos {
     typedef wto_vertex< NodeName, CFG > wto_vertex_t;
     typedef wto_cycle< NodeName, CFG > wto_cycle_t;
     typedef wto< NodeName, CFG > wto_t;
+    typedef crab::iterators::block_numbering< NodeName, CFG > block_numbering_t;
+    typedef typename block_numbering_t::id_t id_t;
   
   private:
     typedef boost::shared_ptr< wto_component_t > wto_component_ptr;
@@ -389,20 +409,53 @@ namespace ikos {
     typedef boost::shared_ptr< wto_cycle_t > wto_cycle_ptr;
     typedef boost::container::slist< wto_component_ptr > wto_component_list_t;
     typedef boost::shared_ptr< wto_component_list_t > wto_component_list_ptr;
+    typedef boost::shared_ptr< const block_numbering_t > block_numbering_ptr;
     typedef bound< z_number > dfn_t;
-    typedef boost::unordered_map< NodeName, dfn_t > dfn_table_t;
+    // indexed by block id
+    typedef std::vector< dfn_t > dfn_table_t;
     typedef boost::shared_ptr< dfn_table_t > dfn_table_ptr;
-    typedef std::vector< NodeName > stack_t;
+    typedef std::vector< id_t > stack_t;
     typedef boost::shared_ptr< stack_t > stack_ptr;
-    typedef boost::unordered_map< NodeName, wto_nesting_t > nesting_table_t;
-    typedef boost::shared_ptr< nesting_table_t > nesting_table_ptr;
+
+    // The nesting of a block is the list of heads of the cycles that
+    // contain it. The cycles are numbered in preorder starting from
+    // 1, and 0 stands for the outermost level, so a nesting is
+    // represented by the number of its innermost cycle. The nesting
+    // of c1 is a strict prefix of the nesting of c2 iff c1 is a strict
+    // ancestor of c2, that is c1 < c2 <= last(c1).
+    struct nesting_info {
+      id_t _head;        // not used for the outermost level
+      uint32_t _parent;
+      uint32_t _depth;   // length of the nesting
+      uint32_t _last;    // last cycle nested in this one
+      nesting_info(id_t head, uint32_t parent, uint32_t depth)
+	: _head(head), _parent(parent), _depth(depth), _last(0) { }
+    };
+    // indexed by cycle number
+    typedef std::vector< nesting_info > cycle_table_t;
+    // indexed by block id: the innermost cycle that contains the
+    // block. For a head, this is the cycle that contains its own
+    // cycle.
+    typedef std::vector< uint32_t > nesting_table_t;
     
   private:
+    block_numbering_ptr _numbering;
     wto_component_list_ptr _wto_components;
     dfn_table_ptr _dfn_table;
     dfn_t _num;
     stack_ptr _stack;
-    nesting_table_ptr _nesting_table;
+    cycle_table_t _cycles;
+    nesting_table_t _nesting_table;
+    #ifndef RECURSIVE_WTO
+    // _loop_nodes[i] == _visit_epoch if a loop to block i was found
+    // in the current call to visit
+    std::vector< uint32_t > _loop_nodes;
+    uint32_t _visit_epoch;
+    #endif
+
+    static uint32_t no_nesting() {
+      return std::numeric_limits< uint32_t >::max();
+    }
 
   private:
     class nesting_builder: public wto_component_visitor< NodeName, CFG > {
@@ -412,104 +465,105 @@ namespace ikos {
       typedef wto_cycle< NodeName, CFG > wto_cycle_t;
       
     private:
-      wto_nesting_t _nesting;
-      nesting_table_ptr _nesting_table;
+      wto_t &_wto;
+      uint32_t _nesting;
       
     public:
-      nesting_builder(nesting_table_ptr nesting_table): 
-	_nesting_table(nesting_table) { }
+      nesting_builder(wto_t &wto): _wto(wto), _nesting(0) { }
 
       void visit(wto_cycle_t& cycle) {
-        NodeName head = cycle.head();
-        wto_nesting_t previous_nesting = this->_nesting;
-        this->_nesting_table->insert(std::make_pair(head, this->_nesting));
-        this->_nesting += head;
+	uint32_t previous_nesting = this->_nesting;
+	uint32_t c = this->_wto._cycles.size();
+	this->_wto._nesting_table[cycle.head_id()] = previous_nesting;
+	this->_wto._cycles.push_back
+	  (nesting_info(cycle.head_id(), previous_nesting,
+			this->_wto._cycles[previous_nesting]._depth + 1));
+        this->_nesting = c;
         for (typename wto_cycle_t::iterator it = cycle.begin(); it != cycle.end(); ++it) {
           it->accept(this);
         }
+	this->_wto._cycles[c]._last = this->_wto._cycles.size() - 1;
         this->_nesting = previous_nesting;
       }
       
       void visit(wto_vertex_t& vertex) {
-        this->_nesting_table->insert(std::make_pair(vertex.node(), this->_nesting));
+	this->_wto._nesting_table[vertex.id()] = this->_nesting;
       }
       
     }; // class nesting_builder
 
   private:
-    dfn_t get_dfn(NodeName n) {
-      typename dfn_table_t::iterator it = this->_dfn_table->find(n);
-      if (it == this->_dfn_table->end()) {
-        return 0;
-      } else {
-        return it->second;
-      }
+    dfn_t get_dfn(id_t n) {
+      return (*this->_dfn_table)[n];
     }
     
-    void set_dfn(NodeName n, dfn_t dfn) {
-      std::pair< typename dfn_table_t::iterator, bool > res = 
-	this->_dfn_table->insert(std::make_pair(n, dfn));
-      if (!res.second) {
-        (res.first)->second = dfn;
-      }
+    void set_dfn(id_t n, dfn_t dfn) {
+      (*this->_dfn_table)[n] = dfn;
     }
     
-    NodeName pop() {
+    id_t pop() {
       if (this->_stack->empty()) {
         CRAB_ERROR("WTO computation: empty stack");
       } else {
-        NodeName top = this->_stack->back();
+        id_t top = this->_stack->back();
         this->_stack->pop_back();
         return top;
       }
     }
 
-    void push(NodeName n) {
+    void push(id_t n) {
       this->_stack->push_back(n);
     }
 
-    wto_cycle_ptr component(CFG cfg, NodeName vertex) {
+    NodeName label(id_t n) const {
+      return this->_numbering->label(n);
+    }
+
+    wto_cycle_ptr component(id_t vertex) {
       auto partition = boost::make_shared<wto_component_list_t>();
-      auto next_nodes = cfg.next_nodes(vertex);
-      for (NodeName succ : next_nodes) {
+      auto next_nodes = this->_numbering->succs(vertex);
+      for (auto it = next_nodes.first; it != next_nodes.second; ++it) {
+	id_t succ = *it;
         if (this->get_dfn(succ) == 0) {
-          this->visit(cfg, succ, partition);
+          this->visit(succ, partition);
         }
       }
-      return wto_cycle_ptr(new wto_cycle_t(vertex, partition));
+      return wto_cycle_ptr(new wto_cycle_t(label(vertex), vertex, partition));
     }
     
     #ifndef RECURSIVE_WTO
     struct visit_stack_elem {
-      typedef typename CFG::succ_range succ_range;
-      typedef typename CFG::succ_iterator succ_iterator;      
-      NodeName _node;
+      typedef typename block_numbering_t::id_range succ_range;
+      typedef typename block_numbering_t::id_iterator succ_iterator;
+      id_t _node;
       succ_iterator _it; // begin iterator for node's successors
       succ_iterator _et; // end iterator for node's successors
       dfn_t _min;        // smallest dfn number of any (direct or
 			 // indirect) node's successor through node's
 			 // DFS subtree, included node.
       
-      visit_stack_elem(NodeName node, succ_range succs, dfn_t min)
+      visit_stack_elem(id_t node, succ_range succs, dfn_t min)
 	: _node(node)
-	, _it(succs.begin())
-	, _et(succs.end())
+	, _it(succs.first)
+	, _et(succs.second)
 	, _min(min) {}
     };
     
-    void visit(CFG cfg, NodeName vertex, wto_component_list_ptr partition) {
+    void visit(id_t vertex, wto_component_list_ptr partition) {
       typedef std::vector<visit_stack_elem> visit_stack_t;      
       visit_stack_t visit_stack;
-      std::set<NodeName> loop_nodes;
+      // each call gets a new epoch so that _loop_nodes does not need
+      // to be cleared
+      uint32_t epoch = ++_visit_epoch;
       
       /* discover vertex */
       push(vertex);
       _num += 1;
       set_dfn(vertex, _num);
       
-      visit_stack.push_back(visit_stack_elem(vertex, cfg.next_nodes(vertex), _num));
+      visit_stack.push_back(visit_stack_elem(vertex, _numbering->succs(vertex), _num));
       CRAB_LOG("wto-nonrec",
-	       crab::outs() << "WTO: Node " << vertex << ": dfs num=" << _num << "\n";);      
+	       crab::outs() << "WTO: Node " << label(vertex) << ": dfs num=" << _num << "\n";);
       while (!visit_stack.empty()) {
 	/*
 	 * Perform dfs.
@@ -519,31 +573,31 @@ namespace ikos {
 	 * visit_stack one more descendant.
 	 */
 	while (visit_stack.back()._it != visit_stack.back()._et) {
-	  NodeName child = *visit_stack.back()._it++;
+	  id_t child = *visit_stack.back()._it++;
 	  dfn_t child_dfn = get_dfn(child);
 	  if (child_dfn == 0) {
 	    /* discover new vertex */
 	    push(child);
 	    _num += 1;
 	    set_dfn(child, _num);
-	    visit_stack.push_back(visit_stack_elem(child,cfg.next_nodes(child), _num));
+	    visit_stack.push_back(visit_stack_elem(child, _numbering->succs(child), _num));
 	    CRAB_LOG("wto-nonrec",
-		     crab::outs() << "WTO: Node " << child << ": dfs num=" << _num << "\n";);
+		     crab::outs() << "WTO: Node " << label(child) << ": dfs num=" << _num << "\n";);
 	  } else {
 	    if (child_dfn <= visit_stack.back()._min) {
 	      visit_stack.back()._min = child_dfn;
 	      CRAB_LOG("wto-nonrec",
-		       crab::outs() << "WTO: loop found " << child << "\n";);
-	      loop_nodes.insert(child);
+		       crab::outs() << "WTO: loop found " << label(child) << "\n";);
+	      _loop_nodes[child] = epoch;
 	    }
 	  }
 	}
 	
 
 	// propagate min from child to parent
-	NodeName visiting_node = visit_stack.back()._node;
+	id_t visiting_node = visit_stack.back()._node;
 	dfn_t min_visiting_node = visit_stack.back()._min;
-	bool is_loop = loop_nodes.count(visiting_node) > 0;
+	bool is_loop = (_loop_nodes[visiting_node] == epoch);
 	visit_stack.pop_back();
 	if (!visit_stack.empty() && visit_stack.back()._min > min_visiting_node) {
 	  visit_stack.back()._min = min_visiting_node;
@@ -551,33 +605,34 @@ namespace ikos {
 
 	auto dfn_visiting_node = get_dfn(visiting_node);
 	CRAB_LOG("wto-nonrec",
-	    crab::outs() << "WTO: popped node " << visiting_node
+	    crab::outs() << "WTO: popped node " << label(visiting_node)
 	                 << " dfs num= " <<  dfn_visiting_node 
 	                 << ": min=" << min_visiting_node << "\n";);
 	
 	if (min_visiting_node == get_dfn(visiting_node)) {
 	  CRAB_LOG("wto-nonrec",
 		   crab::outs() << "WTO: BEGIN building partition for node "
-	                        << visiting_node << "\n";);
+	                        << label(visiting_node) << "\n";);
 	  set_dfn(visiting_node, dfn_t::plus_infinity());
-	  NodeName element = pop();
+	  id_t element = pop();
 	  if (is_loop) {
 	    while (!(element == visiting_node)) {
 	      set_dfn(element, 0);
 	      CRAB_LOG("wto-nonrec",
-		       crab::outs () << "\tWTO: node " << element << ": dfn num=0\n";);
+		       crab::outs () << "\tWTO: node " << label(element) << ": dfn num=0\n";);
 	      element = pop();
 	    }
 	    CRAB_LOG("wto-nonrec",
 		     crab::outs() << "\tWTO: adding component starting from "
-		                 << visiting_node << "\n";);
+		                 << label(visiting_node) << "\n";);
 	    partition->push_front(boost::static_pointer_cast<wto_component_t,wto_cycle_t> 
-				  (component(cfg, visiting_node)));
+				  (component(visiting_node)));
 	  } else {
 	    CRAB_LOG("wto-nonrec",
-		     crab::outs() << "\tWTO: adding vertex " << visiting_node << "\n";);
+		     crab::outs() << "\tWTO: adding vertex " << label(visiting_node) << "\n";);
 	    partition->push_front(boost::static_pointer_cast< wto_component_t, wto_vertex_t>
-				  (wto_vertex_ptr(new wto_vertex_t(visiting_node))));
+				  (wto_vertex_ptr(new wto_vertex_t(label(visiting_node),
+								   visiting_node))));
 	  }
 	  CRAB_LOG("wto-nonrec", crab::outs() << "WTO: END building partition\n";);
 	}
@@ -585,21 +640,22 @@ namespace ikos {
     }
     
     #else
-    dfn_t visit(CFG cfg, NodeName vertex, wto_component_list_ptr partition) {
+    dfn_t visit(id_t vertex, wto_component_list_ptr partition) {
       dfn_t head = 0, min = 0;
       bool loop;
-      NodeName element;
+      id_t element;
 
       this->push(vertex);
       this->_num += 1;
       head = this->_num;
       this->set_dfn(vertex, head);
       loop = false;
-      auto next_nodes = cfg.next_nodes(vertex);
-      for (NodeName succ: next_nodes) {
+      auto next_nodes = this->_numbering->succs(vertex);
+      for (auto it = next_nodes.first; it != next_nodes.second; ++it) {
+	id_t succ = *it;
         dfn_t succ_dfn = this->get_dfn(succ);
         if (succ_dfn == 0) {
-          min = this->visit(cfg, succ, partition);
+          min = this->visit(succ, partition);
         } else {
           min = succ_dfn;
         }
@@ -617,10 +673,11 @@ namespace ikos {
             element = this->pop();
           }
           partition->push_front(boost::static_pointer_cast< wto_component_t, 
-                                wto_cycle_t >(this->component(cfg, vertex)));
+                                wto_cycle_t >(this->component(vertex)));
         } else {
           partition->push_front(boost::static_pointer_cast< wto_component_t, 
-                                wto_vertex_t >(wto_vertex_ptr(new wto_vertex_t(vertex))));
+                                wto_vertex_t >(wto_vertex_ptr(new wto_vertex_t(label(vertex),
+									       vertex))));
 	}
       }
       return head;
@@ -628,10 +685,23 @@ namespace ikos {
     #endif
     
     void build_nesting() {
-      nesting_builder builder(this->_nesting_table);
+      this->_nesting_table.assign(this->_numbering->size(), no_nesting());
+      // the outermost level
+      this->_cycles.push_back(nesting_info(block_numbering_t::invalid_id(), 0, 0));
+      nesting_builder builder(*this);
       for (iterator it = this->begin(); it != this->end(); ++it) {
         it->accept(&builder);
       }
+      this->_cycles[0]._last = this->_cycles.size() - 1;
+    }
+
+    uint32_t get_nesting(id_t n) const {
+      uint32_t c = (n < this->_nesting_table.size() ?
+		    this->_nesting_table[n] : no_nesting());
+      if (c == no_nesting()) {
+        CRAB_ERROR("WTO nesting: node ", label(n)," not found");
+      }
+      return c;
     }
 
   public:
@@ -671,15 +741,24 @@ namespace ikos {
     
   public:
     wto(CFG cfg): 
+      _numbering(boost::make_shared<block_numbering_t>(cfg)),
       _wto_components(boost::make_shared<wto_component_list_t>()), 
-      _dfn_table(boost::make_shared<dfn_table_t>()), 
-      _num(0), _stack(boost::make_shared<stack_t>()), 
-      _nesting_table(boost::make_shared<nesting_table_t>()) {
+      _dfn_table(boost::make_shared<dfn_table_t>(_numbering->size(), dfn_t(0))), 
+      _num(0), _stack(boost::make_shared<stack_t>())
+      #ifndef RECURSIVE_WTO
+      , _loop_nodes(_numbering->size(), 0)
+      , _visit_epoch(0)
+      #endif
+    {
       crab::ScopedCrabStats __st__("Fixpo.WTO");
 
-      this->visit(cfg, cfg.entry(), this->_wto_components);
+      this->visit(_numbering->id(cfg.entry()), this->_wto_components);
       this->_dfn_table.reset();
       this->_stack.reset();
+      #ifndef RECURSIVE_WTO
+      this->_loop_nodes.clear();
+      this->_loop_nodes.shrink_to_fit();
+      #endif
       this->build_nesting();
     }
 
@@ -692,7 +771,10 @@ namespace ikos {
     //   _nesting_table(other._nesting_table) { }
 
     // deep copy
+    // 
+    // The block numbering cannot be modified so it is always shared.
     wto(const wto_t &other):
+      _numbering(other._numbering),
       _wto_components(boost::make_shared<wto_component_list_t>(*other._wto_components)),
       _dfn_table(other._dfn_table ?
 		 boost::make_shared<dfn_table_t>(*other._dfn_table):
@@ -701,21 +783,34 @@ namespace ikos {
       _stack(other._stack ?
 	     boost::make_shared<stack_t>(*other._stack):
 	     nullptr),
-      _nesting_table(boost::make_shared<nesting_table_t>(*other._nesting_table)) { }
+      _cycles(other._cycles),
+      _nesting_table(other._nesting_table)
+      #ifndef RECURSIVE_WTO
+      , _visit_epoch(other._visit_epoch)
+      #endif
+    { }
 
     wto(const wto_t &&other):
+      _numbering(boost::move(other._numbering)),
       _wto_components(boost::move(other._wto_components)),
       _dfn_table(boost::move(other._dfn_table)),
       _num(other._num),
       _stack(boost::move(other._stack)),
-      _nesting_table(boost::move(other._nesting_table)) { }      
+      _cycles(boost::move(other._cycles)),
+      _nesting_table(boost::move(other._nesting_table))
+      #ifndef RECURSIVE_WTO
+      , _visit_epoch(other._visit_epoch)
+      #endif
+    { }
       
     wto_t& operator=(const wto_t &other) {
       if (this != &other) {
+	this->_numbering = other._numbering;
 	this->_wto_components = other._wto_components;
 	this->_dfn_table = other._dfn_table;
 	this->_num = other._num;
 	this->_stack = other._stack;
+	this->_cycles = other._cycles;
 	this->_nesting_table = other._nesting_table;
       }
       return *this;
@@ -729,13 +824,37 @@ namespace ikos {
       return iterator(this->_wto_components, false);
     }
 
+    //! Return the numbering of the blocks of the CFG used by the
+    //! WTO. It contains also the unreachable blocks.
+    const block_numbering_t& numbering() const {
+      return *(this->_numbering);
+    }
+
     wto_nesting_t nesting(NodeName n) {
-      typename nesting_table_t::iterator it = this->_nesting_table->find(n);
-      if (it == this->_nesting_table->end()) {
+      id_t i = this->_numbering->find(n);
+      if (i == block_numbering_t::invalid_id()) {
         CRAB_ERROR("WTO nesting: node ", n," not found");
-      } else {
-        return it->second;
       }
+      uint32_t c = get_nesting(i);
+      wto_nesting_t res;
+      res._nodes->reserve(this->_cycles[c]._depth);
+      for (; c != 0; c = this->_cycles[c]._parent) {
+	res._nodes->push_back(label(this->_cycles[c]._head));
+      }
+      std::reverse(res._nodes->begin(), res._nodes->end());
+      return res;
+    }
+
+    //! Same as nesting(n) > nesting(m) but in constant time.
+    bool nesting_greater(id_t n, id_t m) const {
+      uint32_t cn = get_nesting(n);
+      uint32_t cm = get_nesting(m);
+      return cm < cn && cn <= this->_cycles[cm]._last;
+    }
+
+    //! Return the number of cycles that contain n
+    std::size_t nesting_depth(id_t n) const {
+      return this->_cycles[get_nesting(n)]._depth;
     }
 
     void accept(wto_component_visitor< NodeName, CFG > *v) {
@@ -765,4 +884,3 @@ namespace ikos {
   }; // class wto
 
 } // namespace ikos
-
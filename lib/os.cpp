@@ -2,6 +2,7 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
@@ -29,77 +30,114 @@ namespace crab {
     return m_cerr;
   }
 
-  crab_os::crab_os(std::ostream* os): m_os(os) { }
+  void crab_os::set_cout(boost::shared_ptr<crab_os> os) {
+    if (m_cout) m_cout->flush();
+    m_cout = os;
+  }
+
+  crab_os::crab_os(std::ostream* os, bool buffered)
+    : m_os(os), m_buffered(buffered) { }
+
+  crab_os::crab_os(): m_os(nullptr), m_buffered(false) {}
+
+  crab_os::~crab_os() { flush(); }
 
-  crab_os::crab_os(): m_os(nullptr) {}
+  void crab_os::set_buffered(bool b) {
+    m_buffered = b;
+    if (!m_buffered) flush();
+  }
+
+  void crab_os::flush() {
+    if (m_os) m_os->flush();
+  }
 
-  crab_os::~crab_os() { }
+  void crab_os::write_done() {
+    if (!m_buffered) m_os->flush();
+  }
   
   crab_os& crab_os::operator<<(char C) {
-    *m_os << C; m_os->flush ();
+    *m_os << C; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(unsigned char C) {
-    *m_os << C; m_os->flush ();
+    *m_os << C; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(signed char C) {
-    *m_os << C; m_os->flush ();
+    *m_os << C; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(const char* C) {
-    *m_os << C; m_os->flush ();
+    *m_os << C; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(const std::string& Str) {
-    *m_os << Str; m_os->flush ();
+    *m_os << Str; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(unsigned long N) {
-    *m_os << N; m_os->flush ();
+    *m_os << N; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(long N) {
-    *m_os << N; m_os->flush ();
+    *m_os << N; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(unsigned long long N) {
-    *m_os << N; m_os->flush ();
+    *m_os << N; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(long long N) {
-    *m_os << N; m_os->flush ();
+    *m_os << N; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(const void *P) {
-    *m_os << P; m_os->flush ();
+    *m_os << P; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(unsigned int N) {
-    *m_os << N; m_os->flush ();
+    *m_os << N; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(int N) {
-    *m_os << N; m_os->flush ();
+    *m_os << N; write_done();
     return *this;
   }
 
   crab_os& crab_os::operator<<(double N) {
-    *m_os << N; m_os->flush ();
+    *m_os << N; write_done();
     return *this;
   }
 
+  /// crab_file_os adaptor
+
+  crab_file_os::crab_file_os(std::ofstream* os)
+    : crab_os(os, true), m_file_os(os) { }
+
+  crab_file_os::crab_file_os(const std::string& filename)
+    : crab_file_os(new std::ofstream(filename.c_str())) { }
+
+  crab_file_os::~crab_file_os() {
+    flush();
+    m_os = nullptr;
+    delete m_file_os;
+  }
+
+  bool crab_file_os::is_open() const {
+    return m_file_os->is_open();
+  }
+
   /// crab_string_os adaptor
 
   crab_string_os::crab_string_os ()
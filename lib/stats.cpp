@@ -3,87 +3,605 @@
 #ifdef HAVE_STATS
 #include "crab/common/stats.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace crab
 {
-  std::map<std::string,unsigned> CrabStats::counters;
-  std::map<std::string,Stopwatch> CrabStats::sw;
-  std::map<std::string,Averager> CrabStats::av;
-  std::map<std::string,std::string> CrabStats::ss;
+  namespace stats_impl {
+
+    // nanoseconds from a monotonic clock (a vDSO call on Linux)
+    inline int64_t now () {
+      struct timespec ts;
+      clock_gettime (CLOCK_MONOTONIC, &ts);
+      return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    const unsigned chunk_size = 256;
+    const unsigned max_chunks = 256;
+    const unsigned max_ids = chunk_size * max_chunks;
+    const unsigned no_id = max_ids;
+
+    /*
+       Storage that grows by chunks so that other threads can read
+       the elements already published while the owner adds new ones.
+    */
+    template<typename T>
+    class chunked_array {
+      std::atomic<T*> m_chunks[max_chunks];
+    public:
+      chunked_array () {
+	for (unsigned i=0; i < max_chunks; ++i) {
+	  m_chunks[i].store (nullptr, std::memory_order_relaxed);
+	}
+      }
+      ~chunked_array () {
+	for (unsigned i=0; i < max_chunks; ++i) {
+	  delete[] m_chunks[i].load (std::memory_order_relaxed);
+	}
+      }
+      // only called by the owner thread
+      T& get_or_create (unsigned i) {
+	std::atomic<T*> &c = m_chunks[i / chunk_size];
+	T* chunk = c.load (std::memory_order_relaxed);
+	if (!chunk) {
+	  chunk = new T[chunk_size];
+	  c.store (chunk, std::memory_order_release);
+	}
+	return chunk[i % chunk_size];
+      }
+      // can be called by any thread
+      T* get (unsigned i) const {
+	T* chunk = m_chunks[i / chunk_size].load (std::memory_order_acquire);
+	return (chunk ? &chunk[i % chunk_size] : nullptr);
+      }
+    };
+
+    // All fields are written only by the owner thread. They are
+    // atomic so that they can be read while printing.
+    struct slot {
+      std::atomic<uint64_t> count;
+      std::atomic<int64_t> elapsed;
+      std::atomic<int64_t> started;
+      std::atomic<bool> running;
+      std::atomic<bool> is_timer;
+      slot (): count(0), elapsed(0), started(0), running(false), is_timer(false) {}
+    };
+
+    // Node of the timer tree. id and parent never change once the
+    // node is published.
+    struct tree_node {
+      unsigned id;
+      unsigned parent;
+      // only accessed by the owner thread
+      unsigned first_child;
+      unsigned next_sibling;
+      int64_t started;
+      std::atomic<int64_t> elapsed;
+      std::atomic<uint64_t> calls;
+      tree_node (): id(no_id), parent(0), first_child(0), next_sibling(0),
+		    started(0), elapsed(0), calls(0) {}
+    };
+
+    inline void add (std::atomic<uint64_t> &x, uint64_t v) {
+      x.store (x.load (std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    inline void add (std::atomic<int64_t> &x, int64_t v) {
+      x.store (x.load (std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    struct thread_stats {
+      chunked_array<slot> m_slots;
+      chunked_array<tree_node> m_nodes;
+      std::atomic<unsigned> m_num_nodes;
+      // path from the root to the innermost active timer
+      std::vector<unsigned> m_stack;
+      // avoid the global table when interning the same string again
+      std::unordered_map<std::string, stats_id_t> m_cache;
+
+      thread_stats (): m_num_nodes(1) {
+	m_nodes.get_or_create (0); // root
+	m_stack.push_back (0);
+      }
+
+      slot& get_slot (stats_id_t id) { return m_slots.get_or_create (id); }
+
+      void enter (stats_id_t id, int64_t t) {
+	unsigned p = m_stack.back ();
+	tree_node &parent = m_nodes.get_or_create (p);
+	unsigned n = parent.first_child;
+	for (; n != 0; n = m_nodes.get (n)->next_sibling) {
+	  if (m_nodes.get (n)->id == id) break;
+	}
+	if (n == 0) {
+	  n = m_num_nodes.load (std::memory_order_relaxed);
+	  if (n >= max_ids) return; // tree is full
+	  tree_node &child = m_nodes.get_or_create (n);
+	  child.id = id;
+	  child.parent = p;
+	  child.next_sibling = parent.first_child;
+	  parent.first_child = n;
+	  m_num_nodes.store (n + 1, std::memory_order_release);
+	}
+	tree_node &node = *m_nodes.get (n);
+	node.started = t;
+	add (node.calls, 1);
+	m_stack.push_back (n);
+      }
+
+      void leave (stats_id_t id, int64_t t) {
+	// Close id and any timer that was started after it but not
+	// stopped yet.
+	for (unsigned i = m_stack.size () - 1; i > 0; --i) {
+	  if (m_nodes.get (m_stack[i])->id == id) {
+	    while (m_stack.size () > i) {
+	      tree_node &node = *m_nodes.get (m_stack.back ());
+	      add (node.elapsed, t - node.started);
+	      m_stack.pop_back ();
+	    }
+	    return;
+	  }
+	}
+      }
+    };
+
+    // Values of all threads added together
+    struct snapshot {
+      std::vector<uint64_t> counts;
+      std::vector<int64_t> elapsed;
+      std::vector<bool> is_timer;
+      struct node {
+	stats_id_t id;
+	int64_t elapsed;
+	uint64_t calls;
+	std::vector<unsigned> children;
+      };
+      std::vector<node> tree;
+
+      snapshot () {
+	node root;
+	root.id = no_id; root.elapsed = 0; root.calls = 0;
+	tree.push_back (root);
+      }
+
+      void resize (unsigned num_ids) {
+	if (counts.size () < num_ids) {
+	  counts.resize (num_ids, 0);
+	  elapsed.resize (num_ids, 0);
+	  is_timer.resize (num_ids, false);
+	}
+      }
+
+      unsigned child (unsigned p, stats_id_t id) {
+	for (unsigned c: tree[p].children) {
+	  if (tree[c].id == id) return c;
+	}
+	node n;
+	n.id = id; n.elapsed = 0; n.calls = 0;
+	tree.push_back (n);
+	tree[p].children.push_back (tree.size () - 1);
+	return tree.size () - 1;
+      }
+
+      void add (const thread_stats &t, unsigned num_ids, int64_t now) {
+	resize (num_ids);
+	for (unsigned i=0; i < num_ids; ++i) {
+	  const slot* s = t.m_slots.get (i);
+	  if (!s) {
+	    i += chunk_size - 1 - (i % chunk_size);
+	    continue;
+	  }
+	  counts[i] += s->count.load (std::memory_order_relaxed);
+	  int64_t e = s->elapsed.load (std::memory_order_relaxed);
+	  if (s->running.load (std::memory_order_relaxed)) {
+	    e += now - s->started.load (std::memory_order_relaxed);
+	  }
+	  elapsed[i] += e;
+	  if (s->is_timer.load (std::memory_order_relaxed)) {
+	    is_timer[i] = true;
+	  }
+	}
+	unsigned num_nodes = t.m_num_nodes.load (std::memory_order_acquire);
+	// nodes are created after their parents
+	std::vector<unsigned> map (num_nodes, 0);
+	for (unsigned i=1; i < num_nodes; ++i) {
+	  const tree_node &n = *t.m_nodes.get (i);
+	  map[i] = child (map[n.parent], n.id);
+	  tree[map[i]].elapsed += n.elapsed.load (std::memory_order_relaxed);
+	  tree[map[i]].calls += n.calls.load (std::memory_order_relaxed);
+	}
+      }
+
+      void add (const snapshot &o, unsigned p, unsigned op) {
+	for (unsigned oc: o.tree[op].children) {
+	  unsigned c = child (p, o.tree[oc].id);
+	  tree[c].elapsed += o.tree[oc].elapsed;
+	  tree[c].calls += o.tree[oc].calls;
+	  add (o, c, oc);
+	}
+      }
+
+      void add (const snapshot &o) {
+	resize (o.counts.size ());
+	for (unsigned i=0, e=o.counts.size (); i < e; ++i) {
+	  counts[i] += o.counts[i];
+	  elapsed[i] += o.elapsed[i];
+	  if (o.is_timer[i]) is_timer[i] = true;
+	}
+	add (o, 0, 0);
+      }
+    };
+
+    struct registry {
+      std::mutex m_mutex;
+      std::vector<std::string> m_names;
+      std::unordered_map<std::string, stats_id_t> m_ids;
+      // values set by uset and count_max
+      std::vector<uint64_t> m_base;
+      std::vector<thread_stats*> m_threads;
+      // values of the threads that already finished
+      snapshot m_finished;
+      std::map<std::string,Averager> m_av;
+      std::map<std::string,std::string> m_ss;
+    };
+
+    // never destroyed so that it can be used while threads exit
+    inline registry& get_registry () {
+      static registry* r = new registry ();
+      return *r;
+    }
+
+    class thread_stats_owner {
+      thread_stats *m_stats;
+    public:
+      thread_stats_owner (): m_stats (new thread_stats ()) {
+	registry &r = get_registry ();
+	std::lock_guard<std::mutex> lock (r.m_mutex);
+	r.m_threads.push_back (m_stats);
+      }
+      ~thread_stats_owner () {
+	registry &r = get_registry ();
+	std::lock_guard<std::mutex> lock (r.m_mutex);
+	r.m_finished.add (*m_stats, r.m_names.size (), now ());
+	r.m_threads.erase (std::find (r.m_threads.begin (), r.m_threads.end (), m_stats));
+	delete m_stats;
+      }
+      thread_stats& get () { return *m_stats; }
+    };
+
+    inline thread_stats& local () {
+      static thread_local thread_stats_owner owner;
+      return owner.get ();
+    }
+
+    // Caller must hold the registry lock
+    snapshot merge (registry &r) {
+      snapshot s;
+      unsigned num_ids = r.m_names.size ();
+      s.resize (num_ids);
+      s.add (r.m_finished);
+      int64_t t = now ();
+      for (thread_stats* ts: r.m_threads) {
+	s.add (*ts, num_ids, t);
+      }
+      for (unsigned i=0; i < num_ids; ++i) {
+	s.counts[i] += r.m_base[i];
+      }
+      return s;
+    }
+
+    // Caller must hold the registry lock. Increments done by other
+    // threads at the same time can be lost.
+    void clear_count (registry &r, stats_id_t id) {
+      r.m_base[id] = 0;
+      if (id < r.m_finished.counts.size ()) {
+	r.m_finished.counts[id] = 0;
+      }
+      for (thread_stats* ts: r.m_threads) {
+	if (slot* s = ts->m_slots.get (id)) {
+	  s->count.store (0, std::memory_order_relaxed);
+	}
+      }
+    }
+
+    // time in microseconds in the format used by Stopwatch::Print
+    void print_time (crab_os &out, long time) {
+      long h = time/3600000000L;
+      long m = time/60000000L - h*60;
+      float s = ((float)time/1000000L) - m*60 - h*3600;
+
+      if (h > 0) out << h << "h";
+      if (m > 0) out << m << "m";
+      out << s << "s";
+    }
+
+    void print_tree (crab_os &OS, const snapshot &s, registry &r,
+		     unsigned n, unsigned depth) {
+      std::vector<unsigned> children (s.tree[n].children);
+      std::sort (children.begin (), children.end (),
+		 [&](unsigned a, unsigned b) {
+		   return r.m_names[s.tree[a].id] < r.m_names[s.tree[b].id];
+		 });
+      for (unsigned c: children) {
+	for (unsigned i=0; i < depth; ++i) OS << "  ";
+	OS << r.m_names[s.tree[c].id] << ": ";
+	print_time (OS, s.tree[c].elapsed / 1000);
+	OS << " (" << s.tree[c].calls << ")\n";
+	print_tree (OS, s, r, c, depth + 1);
+      }
+    }
+
+    template<typename T>
+    std::vector<std::pair<std::string, T>>
+    sorted (const std::vector<T> &vals, const std::vector<bool> &select, registry &r) {
+      std::vector<std::pair<std::string, T>> res;
+      for (unsigned i=0, e=r.m_names.size (); i < e; ++i) {
+	if (select[i]) {
+	  res.push_back (std::make_pair (r.m_names[i], vals[i]));
+	}
+      }
+      std::sort (res.begin (), res.end (),
+		 [](const std::pair<std::string, T> &a, const std::pair<std::string, T> &b) {
+		   return a.first < b.first;
+		 });
+      return res;
+    }
+
+    std::vector<bool> is_counter (const snapshot &s, const registry &r) {
+      std::vector<bool> res (r.m_names.size (), false);
+      for (unsigned i=0, e=r.m_names.size (); i < e; ++i) {
+	res[i] = (s.counts[i] > 0);
+      }
+      return res;
+    }
+
+  } // end namespace stats_impl
+
+  using namespace stats_impl;
+
+  stats_id_t CrabStats::intern (const std::string &name) {
+    thread_stats &t = local ();
+    auto it = t.m_cache.find (name);
+    if (it != t.m_cache.end ()) {
+      return it->second;
+    }
+    registry &r = get_registry ();
+    stats_id_t id;
+    {
+      std::lock_guard<std::mutex> lock (r.m_mutex);
+      auto rit = r.m_ids.find (name);
+      if (rit != r.m_ids.end ()) {
+	id = rit->second;
+      } else {
+	if (r.m_names.size () >= max_ids) {
+	  CRAB_ERROR ("too many statistics names");
+	}
+	id = r.m_names.size ();
+	r.m_names.push_back (name);
+	r.m_base.push_back (0);
+	r.m_ids.insert (std::make_pair (name, id));
+      }
+    }
+    t.m_cache.insert (std::make_pair (name, id));
+    return id;
+  }
+
+  std::string CrabStats::name (stats_id_t id) {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    return r.m_names[id];
+  }
 
   void CrabStats::reset () {
-    counters.clear();
-    sw.clear();
-    av.clear();
-    ss.clear();
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    // Values updated by other threads at the same time can be lost
+    for (thread_stats* ts: r.m_threads) {
+      for (unsigned i=0, e=r.m_names.size (); i < e; ++i) {
+	if (slot* s = ts->m_slots.get (i)) {
+	  s->count.store (0, std::memory_order_relaxed);
+	  s->elapsed.store (0, std::memory_order_relaxed);
+	  s->is_timer.store (s->running.load (std::memory_order_relaxed),
+			     std::memory_order_relaxed);
+	}
+      }
+      for (unsigned i=1, e=ts->m_num_nodes.load (std::memory_order_acquire); i < e; ++i) {
+	if (tree_node* n = ts->m_nodes.get (i)) {
+	  n->elapsed.store (0, std::memory_order_relaxed);
+	  n->calls.store (0, std::memory_order_relaxed);
+	}
+      }
+    }
+    std::fill (r.m_base.begin (), r.m_base.end (), 0);
+    r.m_finished = snapshot ();
+    r.m_av.clear ();
+    r.m_ss.clear ();
+  }
+
+  void CrabStats::count (stats_id_t id) {
+    add (local ().get_slot (id).count, 1);
+  }
+
+  void CrabStats::count (const std::string &name) { count (intern (name)); }
+
+  unsigned CrabStats::get (stats_id_t id) {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    uint64_t v = r.m_base[id];
+    if (id < r.m_finished.counts.size ()) {
+      v += r.m_finished.counts[id];
+    }
+    for (thread_stats* ts: r.m_threads) {
+      if (const slot* s = ts->m_slots.get (id)) {
+	v += s->count.load (std::memory_order_relaxed);
+      }
+    }
+    return v;
+  }
+
+  unsigned CrabStats::get (const std::string &n) { return get (intern (n)); }
+
+  unsigned CrabStats::uset (stats_id_t id, unsigned v) {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    clear_count (r, id);
+    r.m_base[id] = v;
+    return v;
+  }
+
+  unsigned CrabStats::uset (const std::string &n, unsigned v) { return uset (intern (n), v); }
+
+  void CrabStats::count_max (stats_id_t id, unsigned v) {
+    if (v > get (id)) {
+      uset (id, v);
+    }
   }
 
-  void CrabStats::count (const std::string &name) { ++counters[name]; }
   void CrabStats::count_max (const std::string &name, unsigned v) {
-      counters[name] = std::max (counters[name], v);
+    count_max (intern (name), v);
+  }
+
+  double CrabStats::avg (const std::string &n, double v) {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    return r.m_av[n].add (v);
+  }
+
+  void CrabStats::sset (const std::string &n, std::string v) {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    r.m_ss[n] = v;
   }
 
-  double CrabStats::avg (const std::string &n, double v) { return av[n].add (v); }
-  unsigned CrabStats::uset (const std::string &n, unsigned v)
-  { return counters [n] = v; }
-  unsigned CrabStats::get (const std::string &n) { return counters [n]; }
+  std::string& CrabStats::sget (const std::string &n) {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    return r.m_ss[n];
+  }
 
-  void CrabStats::sset (const std::string &n, std::string v) {ss [n] = v;}
-  std::string& CrabStats::sget (const std::string &n) {return ss[n];}
-  
-  void CrabStats::start (const std::string &name) { sw[name].start (); }
-  void CrabStats::stop (const std::string &name) { sw[name].stop (); }
-  void CrabStats::resume (const std::string &name) { sw[name].resume (); }
+  void CrabStats::start (stats_id_t id) {
+    int64_t t = now ();
+    thread_stats &ts = local ();
+    slot &s = ts.get_slot (id);
+    if (s.running.load (std::memory_order_relaxed)) {
+      ts.leave (id, t);
+    }
+    s.is_timer.store (true, std::memory_order_relaxed);
+    s.elapsed.store (0, std::memory_order_relaxed);
+    s.started.store (t, std::memory_order_relaxed);
+    s.running.store (true, std::memory_order_relaxed);
+    ts.enter (id, t);
+  }
+
+  void CrabStats::stop (stats_id_t id) {
+    int64_t t = now ();
+    thread_stats &ts = local ();
+    slot &s = ts.get_slot (id);
+    if (s.running.load (std::memory_order_relaxed)) {
+      add (s.elapsed, t - s.started.load (std::memory_order_relaxed));
+      s.running.store (false, std::memory_order_relaxed);
+      ts.leave (id, t);
+    }
+  }
+
+  void CrabStats::resume (stats_id_t id) {
+    thread_stats &ts = local ();
+    slot &s = ts.get_slot (id);
+    if (!s.running.load (std::memory_order_relaxed)) {
+      int64_t t = now ();
+      s.is_timer.store (true, std::memory_order_relaxed);
+      s.started.store (t, std::memory_order_relaxed);
+      s.running.store (true, std::memory_order_relaxed);
+      ts.enter (id, t);
+    }
+  }
+
+  void CrabStats::start (const std::string &name) { start (intern (name)); }
+  void CrabStats::stop (const std::string &name) { stop (intern (name)); }
+  void CrabStats::resume (const std::string &name) { resume (intern (name)); }
 
   /** Outputs all statistics to std output */
   void CrabStats::Print (crab_os &OS) {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    snapshot s = merge (r);
+
     OS << "\n\n************** STATS ***************** \n";
-    for (auto &kv : ss)
+    for (auto &kv : r.m_ss)
       OS << kv.first << ": " << kv.second << "\n";
-    for (auto &kv : counters)
+    for (auto &kv : sorted (s.counts, is_counter (s, r), r))
       OS << kv.first << ": " << kv.second << "\n";
 
-    for (auto &kv : sw)
-      OS << kv.first << ": " << kv.second << "\n";
+    for (auto &kv : sorted (s.elapsed, s.is_timer, r)) {
+      OS << kv.first << ": ";
+      print_time (OS, kv.second / 1000);
+      OS << "\n";
+    }
 
-    for (auto &kv : av)
+    for (auto &kv : r.m_av)
       OS << kv.first << ": " << kv.second << "\n";
 
+    if (!s.tree[0].children.empty ()) {
+      OS << "************** TIMER TREE ***************** \n";
+      print_tree (OS, s, r, 0, 0);
+    }
 
     OS << "************** STATS END ***************** \n";
   }
 
   void CrabStats::PrintBrunch (crab_os &OS)
   {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    snapshot s = merge (r);
+
     OS << "\n\n************** BRUNCH STATS ***************** \n";
-    for (auto &kv : ss) 
+    for (auto &kv : r.m_ss)
       OS << "BRUNCH_STAT " << kv.first << " " << kv.second << "\n";
-    
-    for (auto &kv : counters)
+
+    for (auto &kv : sorted (s.counts, is_counter (s, r), r))
       OS << "BRUNCH_STAT " << kv.first << " " << kv.second << "\n";
 
-    for (auto &kv : sw)
-      OS << "BRUNCH_STAT " << kv.first << " " 
-         << (kv.second).toSeconds() << "\n";
+    for (auto &kv : sorted (s.elapsed, s.is_timer, r))
+      OS << "BRUNCH_STAT " << kv.first << " "
+         << ((double) kv.second / 1000000000) << "\n";
 
-    for (auto &kv : av)
+    for (auto &kv : r.m_av)
       OS << "BRUNCH_STAT " << kv.first << " " << kv.second << "\n";
 
     OS << "************** BRUNCH STATS END ***************** \n";
   }
 
+  void CrabStats::get_all (std::map<std::string, unsigned> &counters,
+			   std::map<std::string, double> &timers,
+			   std::map<std::string, double> &averages,
+			   std::map<std::string, std::string> &strings) {
+    registry &r = get_registry ();
+    std::lock_guard<std::mutex> lock (r.m_mutex);
+    snapshot s = merge (r);
+
+    for (auto &kv : sorted (s.counts, is_counter (s, r), r))
+      counters[kv.first] = kv.second;
+    for (auto &kv : sorted (s.elapsed, s.is_timer, r))
+      timers[kv.first] = (double) kv.second / 1000000000;
+    for (auto &kv : r.m_av)
+      averages[kv.first] = kv.second.get ();
+    for (auto &kv : r.m_ss)
+      strings[kv.first] = kv.second;
+  }
+
 
   void Stopwatch::Print (crab_os &out) const
   {
-    long time = getTimeElapsed ();
-    long h = time/3600000000L;
-    long m = time/60000000L - h*60;
-    float s = ((float)time/1000000L) - m*60 - h*3600;
-
-    if (h > 0) out << h << "h";
-    if (m > 0) out << m << "m";
-    out << s << "s";
-  }  
-    
+    print_time (out, getTimeElapsed ());
+  }
+
   void Averager::Print (crab_os &out) const { out << avg; }
 }
-#endif 
+#endif
@@ -64,7 +64,7 @@ void backward_run_internal (CFG* cfg,
     crab::CrabStats::Print(crab::outs());
     crab::CrabStats::reset();
   }
-
+  crab::outs().flush();
 }
 
 // To run abstract domains defined over integers
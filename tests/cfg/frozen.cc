@@ -0,0 +1,110 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/cfg/cfg_frozen.hpp>
+#include <crab/analysis/fwd_analyzer.hpp>
+#include <crab/analysis/dataflow/liveness.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+/* Check that the analyses give the same results on a frozen CFG */
+
+typedef cfg_frozen<z_cfg_t> z_cfg_frozen_t;
+
+z_cfg_t* prog (variable_factory_t &vfac)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var j (vfac ["j"], crab::INT_TYPE, 32);
+  z_var k (vfac ["k"], crab::INT_TYPE, 32);
+  z_var nd (vfac ["nd"], crab::INT_TYPE, 32);
+  z_var b (vfac ["b"], crab::BOOL_TYPE, 1);
+  z_var c (vfac ["c"], crab::BOOL_TYPE, 1);
+  z_var a (vfac ["a"], crab::ARR_INT_TYPE);
+  auto cfg = new z_cfg_t("entry","ret", ARR);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& bb1   = cfg->insert ("bb1");
+  z_basic_block_t& bb1_t = cfg->insert ("bb1_t");
+  z_basic_block_t& bb1_f = cfg->insert ("bb1_f");
+  z_basic_block_t& bb2   = cfg->insert ("bb2");
+  z_basic_block_t& bb3   = cfg->insert ("bb3");
+  z_basic_block_t& bb3_t = cfg->insert ("bb3_t");
+  z_basic_block_t& bb3_f = cfg->insert ("bb3_f");
+  z_basic_block_t& ret   = cfg->insert ("ret");
+  entry >> bb1;
+  bb1 >> bb1_t; bb1 >> bb1_f;
+  bb1_t >> bb2; bb2 >> bb3;
+  bb3 >> bb3_t; bb3 >> bb3_f;
+  bb3_t >> bb1; bb3_f >> bb1;
+  bb1_f >> ret;
+  entry.assign (i, 0);
+  entry.assign (j, 10);
+  entry.array_init (a, 1, 0, 99, 0);
+  bb1_t.assume (i <= 99);
+  bb1_f.assume (i >= 100);
+  bb2.havoc (nd);
+  bb2.select (k, nd, 1, 2);
+  bb2.array_store (a, i, k, 1);
+  bb2.bool_assign (b, z_lin_cst_t (i <= j));
+  bb2.bool_assign (c, b, true);
+  bb3_t.bool_assume (c);
+  bb3_t.add (i, i, k);
+  bb3_f.bool_not_assume (c);
+  bb3_f.add (i, i, 1);
+  bb3_f.sub (j, j, 1);
+  ret.array_load (k, a, i, 1);
+  ret.assertion (z_lin_cst_t (i >= 100));
+  return cfg;
+}
+
+template<typename CFG>
+static string print_results(CFG cfg, const liveness<CFG> *live) {
+  typedef intra_fwd_analyzer<CFG, z_interval_domain_t> analyzer_t;
+  analyzer_t a (cfg, z_interval_domain_t::top(), live, 1, 2, 20);
+  a.run ();
+  // sort the labels to get a deterministic output
+  std::set<basic_block_label_t> labels (cfg.label_begin (), cfg.label_end ());
+  crab::crab_string_os o;
+  for (auto l : labels) {
+    auto pre = a.get_pre (l);
+    auto post = a.get_post (l);
+    o << get_label_str (l) << "=" << pre << " ==> " << post << "\n";
+    if (live) {
+      auto dead = live->dead_exit (l);
+      o << "  dead=" << dead << "\n";
+    }
+  }
+  return o.str ();
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac);
+  z_cfg_frozen_t frozen (*cfg);
+
+  crab::crab_string_os s1, s2;
+  s1 << *cfg;
+  s2 << frozen;
+  crab::outs() << frozen << "\n";
+  bool ok = (s1.str () == s2.str ());
+
+  // the statements are copies so the original can go away
+  z_cfg_ref_t cfg_ref (*cfg);
+  liveness<z_cfg_ref_t> live (cfg_ref);
+  live.exec ();
+  string res1 = print_results<z_cfg_ref_t> (cfg_ref, &live);
+  delete cfg;
+
+  liveness<z_cfg_frozen_t> frozen_live (frozen);
+  frozen_live.exec ();
+  string res2 = print_results<z_cfg_frozen_t> (frozen, &frozen_live);
+  crab::outs() << res2;
+  ok &= (res1 == res2);
+
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+#include <boost/make_shared.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+
+/* Print a CFG to a string and to a file */
+
+z_cfg_t* prog (variable_factory_t &vfac)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& bb1   = cfg->insert ("bb1");
+  z_basic_block_t& bb1_t = cfg->insert ("bb1_t");
+  z_basic_block_t& bb1_f = cfg->insert ("bb1_f");
+  z_basic_block_t& ret   = cfg->insert ("ret");
+  entry >> bb1;
+  bb1 >> bb1_t; bb1 >> bb1_f;
+  bb1_t >> bb1; bb1_f >> ret;
+  entry.assign (i, 0);
+  bb1_t.assume (i <= 99);
+  bb1_t.add (i, i, 1);
+  bb1_f.assume (i >= 100);
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac);
+  bool ok = true;
+
+  crab::crab_string_os s;
+  s << *cfg;
+
+  // redirect outs() to a file
+  const string filename = "crab_print_test.txt";
+  {
+    auto f = boost::make_shared<crab::crab_file_os> (filename);
+    ok &= f->is_open ();
+    crab::crab_os::set_cout (f);
+    crab::outs() << *cfg;
+    crab::crab_os::set_cout (nullptr);
+  }
+  ifstream in (filename.c_str ());
+  stringstream content;
+  content << in.rdbuf ();
+  std::remove (filename.c_str ());
+  ok &= (content.str () == s.str ());
+
+  // outs() is again the standard output
+  crab::outs() << s.str ();
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  delete cfg;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+using namespace std;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+
+/* Simplification of large CFGs */
+
+static string bb_name (string prefix, unsigned i) {
+  return prefix + std::to_string (i);
+}
+
+// A long chain of blocks that can be merged into the entry
+z_cfg_t* chain (variable_factory_t &vfac, unsigned n)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t* prev = &cfg->insert ("entry");
+  prev->assign (i, 0);
+  for (unsigned k = 0; k < n; ++k) {
+    z_basic_block_t& bb = cfg->insert (bb_name ("bb", k));
+    bb.add (i, i, 1);
+    *prev >> bb;
+    prev = &bb;
+  }
+  z_basic_block_t& ret = cfg->insert ("ret");
+  *prev >> ret;
+  return cfg;
+}
+
+// A join block with many predecessors: half of them are reachable
+// and the other half are not.
+z_cfg_t* fan_in (variable_factory_t &vfac, unsigned n)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& join = cfg->insert ("join");
+  z_basic_block_t& ret = cfg->insert ("ret");
+  for (unsigned k = 0; k < n; ++k) {
+    z_basic_block_t& bb = cfg->insert (bb_name ("bb", k));
+    bb.assume (i >= k);
+    bb >> join;
+    if (k % 2 == 0) {
+      entry >> bb;
+    }
+  }
+  // useless: cannot reach ret
+  z_basic_block_t& sink = cfg->insert ("sink");
+  join >> sink;
+  sink >> sink;
+  join >> ret;
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  bool ok = true;
+  {
+    z_cfg_t* cfg = chain (vfac, 100000);
+    cfg->simplify ();
+    crab::outs() << "chain: " << cfg->size () << " blocks after simplification\n";
+    ok &= (cfg->size () == 2);
+    ok &= (cfg->get_node ("entry").size () == 100001);
+    delete cfg;
+  }
+  {
+    z_cfg_t* cfg = fan_in (vfac, 20000);
+    cfg->simplify ();
+    crab::outs() << "fan-in: " << cfg->size () << " blocks after simplification\n";
+    auto preds = cfg->prev_nodes ("join");
+    ok &= (cfg->size () == 10003);
+    ok &= (std::distance (preds.begin (), preds.end ()) == 10000);
+    ok &= (bb_name ("bb", 0) == *preds.begin ());
+    ok &= (bb_name ("bb", 19998) == *(preds.begin () + 9999));
+    delete cfg;
+  }
+  {
+    z_cfg_t* cfg = fan_in (vfac, 4);
+    cfg->simplify ();
+    crab::outs() << *cfg << "\n";
+    delete cfg;
+  }
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/checkers/base_property.hpp>
+#include <crab/checkers/div_zero.hpp>
+#include <crab/checkers/assertion.hpp>
+#include <crab/checkers/checker.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::checker;
+
+/* Check the properties while the fixpoint post-processes the invariants */
+
+z_cfg_t* prog (variable_factory_t &vfac)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var x (vfac ["x"], crab::INT_TYPE, 32);
+  z_var y (vfac ["y"], crab::INT_TYPE, 32);
+  z_var z (vfac ["z"], crab::INT_TYPE, 32);
+  z_cfg_t* cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& head  = cfg->insert ("head");
+  z_basic_block_t& body  = cfg->insert ("body");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  z_basic_block_t& ret   = cfg->insert ("ret");
+  entry >> head; head >> body; body >> head; head >> exit; exit >> ret;
+  entry.assign (i, 0);
+  entry.assign (x, 1);
+  entry.havoc (z);
+  body.assume (i <= 99);
+  body.div (y, x, z);           // warning
+  body.assertion (i >= 0);      // safe
+  body.assertion (z >= 0);      // warning
+  body.add (i, i, 1);
+  exit.assume (i >= 100);
+  exit.assertion (i == 100);    // safe after narrowing
+  exit.div (y, x, i);           // safe
+  ret.assign (i, 0);
+  ret.div (y, x, i);            // error
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  typedef intra_fwd_analyzer<z_cfg_ref_t, z_dbm_domain_t> analyzer_t;
+  typedef intra_checker<analyzer_t> checker_t;
+  typedef div_zero_property_checker<analyzer_t> div_zero_checker_t;
+  typedef assert_property_checker<analyzer_t> assert_checker_t;
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac);
+  crab::outs() << *cfg << "\n";
+
+  checks_db after_db, during_db;
+  {
+    // check after the analysis
+    analyzer_t a (*cfg, z_dbm_domain_t::top (), nullptr);
+    a.run ();
+    checker_t::prop_checker_ptr prop1 (new div_zero_checker_t ());
+    checker_t::prop_checker_ptr prop2 (new assert_checker_t ());
+    checker_t checker (a, {prop1, prop2});
+    checker.run ();
+    checker.show (crab::outs());
+    after_db = checker.get_all_checks ();
+  }
+  {
+    // check during the analysis
+    analyzer_t a (*cfg, z_dbm_domain_t::top (), nullptr);
+    checker_t::prop_checker_ptr prop1 (new div_zero_checker_t ());
+    checker_t::prop_checker_ptr prop2 (new assert_checker_t ());
+    checker_t checker (a, {prop1, prop2});
+    checker.check_during_fixpoint ();
+    a.run ();
+    during_db = checker.get_all_checks ();
+  }
+  bool same = (after_db.get_total_safe () == during_db.get_total_safe () &&
+	       after_db.get_total_warning () == during_db.get_total_warning () &&
+	       after_db.get_total_error () == during_db.get_total_error ());
+  crab::outs() << "Checks during and after the fixpoint "
+	       << (same ? "are the same" : "differ") << "\n";
+
+  delete cfg;
+  return (same ? 0 : 1);
+}
@@ -0,0 +1,90 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/checkers/base_property.hpp>
+#include <crab/checkers/div_zero.hpp>
+#include <crab/checkers/assertion.hpp>
+#include <crab/checkers/checker.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::checker;
+
+/* Check the properties of the blocks in parallel */
+
+// A chain of diamonds with assertions and divisions in each block
+z_cfg_t* prog (variable_factory_t &vfac, unsigned n)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var x (vfac ["x"], crab::INT_TYPE, 32);
+  z_var y (vfac ["y"], crab::INT_TYPE, 32);
+  z_var nd (vfac ["nd"], crab::INT_TYPE, 32);
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t* prev = &cfg->insert ("entry");
+  prev->assign (i, 0);
+  prev->assign (x, 1);
+  for (unsigned k = 0; k < n; ++k) {
+    string s = std::to_string (k);
+    z_basic_block_t& left  = cfg->insert ("left" + s);
+    z_basic_block_t& right = cfg->insert ("right" + s);
+    z_basic_block_t& join  = cfg->insert ("join" + s);
+    *prev >> left; *prev >> right;
+    left >> join; right >> join;
+    left.havoc (nd);
+    left.assume (nd >= 1);
+    left.div (y, x, nd);         // safe
+    left.assertion (i >= 0);     // safe
+    left.assertion (nd <= 10);   // warning
+    right.assign (nd, k % 3);
+    right.div (y, x, nd);        // error if k % 3 == 0
+    right.assertion (i <= k);    // safe
+    join.add (i, i, 1);
+    join.assertion (i <= k + 1); // safe
+    join.div (y, i, x);          // safe
+    prev = &join;
+  }
+  z_basic_block_t& ret = cfg->insert ("ret");
+  *prev >> ret;
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  typedef intra_fwd_analyzer<z_cfg_ref_t, z_interval_domain_t> analyzer_t;
+  typedef intra_checker<analyzer_t> checker_t;
+  typedef div_zero_property_checker<analyzer_t> div_zero_checker_t;
+  typedef assert_property_checker<analyzer_t> assert_checker_t;
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac, 100);
+  analyzer_t a (*cfg, z_interval_domain_t::top (), nullptr);
+  a.run ();
+
+  checks_db seq_db, par_db;
+  {
+    checker_t::prop_checker_ptr prop1 (new div_zero_checker_t ());
+    checker_t::prop_checker_ptr prop2 (new assert_checker_t ());
+    checker_t checker (a, {prop1, prop2});
+    checker.run ();
+    checker.show (crab::outs());
+    seq_db = checker.get_all_checks ();
+  }
+  {
+    checker_t::prop_checker_ptr prop1 (new div_zero_checker_t ());
+    checker_t::prop_checker_ptr prop2 (new assert_checker_t ());
+    checker_t checker (a, {prop1, prop2}, 4);
+    checker.run ();
+    par_db = checker.get_all_checks ();
+  }
+  bool same = (seq_db.get_total_safe () == par_db.get_total_safe () &&
+	       seq_db.get_total_warning () == par_db.get_total_warning () &&
+	       seq_db.get_total_error () == par_db.get_total_error ());
+  crab::outs() << "Parallel and sequential checks "
+	       << (same ? "are the same" : "differ") << "\n";
+
+  delete cfg;
+  return (same ? 0 : 1);
+}
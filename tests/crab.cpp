@@ -78,7 +78,7 @@ void intra_run_impl (CFG* cfg,
     crab::CrabStats::Print(crab::outs());
     crab::CrabStats::reset();
   }
-
+  crab::outs().flush();
 }
 
 // To run abstract domains defined over integers
@@ -0,0 +1,91 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+/* Run the same DBM analysis on several threads at the same time */
+
+z_cfg_t* prog (variable_factory_t &vfac) 
+{
+  z_cfg_t* cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& bb1   = cfg->insert ("bb1");
+  z_basic_block_t& bb1_t = cfg->insert ("bb1_t");
+  z_basic_block_t& bb1_f = cfg->insert ("bb1_f");
+  z_basic_block_t& bb2   = cfg->insert ("bb2");
+  z_basic_block_t& ret   = cfg->insert ("ret");
+
+  entry >> bb1;
+  bb1 >> bb1_t; bb1 >> bb1_f;
+  bb1_t >> bb2; bb2 >> bb1; bb1_f >> ret;
+
+  z_var i(vfac["i"], crab::INT_TYPE, 32);
+  z_var j(vfac["j"], crab::INT_TYPE, 32);
+  z_var k(vfac["k"], crab::INT_TYPE, 32);
+
+  entry.assign (i, 0);
+  entry.assign (j, 0);
+  entry.assign (k, 30);
+  bb1_t.assume (i <= 99);
+  bb1_f.assume (i >= 100);
+  bb2.add (i, i, 1);
+  bb2.add (j, j, 1);
+  bb2.sub (k, k, 1);
+  return cfg;
+}
+
+// Each thread uses its own CFG and variable factory
+template<typename Dom>
+std::string analyze () {
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac);
+  typedef intra_fwd_analyzer<z_cfg_ref_t, Dom> analyzer_t;
+  analyzer_t a (*cfg, Dom::top(), nullptr, 1, 2, 20);
+  a.run ();
+  crab::crab_string_os o;
+  for (auto &b : *cfg) {
+    auto inv = a.get_post (b.label());
+    o << get_label_str (b.label()) << "=" << inv << "\n";
+  }
+  delete cfg;
+  return o.str ();
+}
+
+template<typename Dom>
+bool run_threads (unsigned num_threads) {
+  std::string expected = analyze<Dom> ();
+  crab::outs() << "Invariants using " << Dom::getDomainName() << "\n" << expected;
+  std::vector<std::string> results (num_threads);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < num_threads; ++t) {
+    threads.emplace_back ([&results, t] () { results[t] = analyze<Dom> (); });
+  }
+  for (auto &t : threads) {
+    t.join ();
+  }
+  bool same = true;
+  for (auto &r : results) {
+    same &= (r == expected);
+  }
+  crab::outs() << "Results of " << num_threads << " threads are "
+	       << (same ? "the same" : "different") << "\n";
+  return same;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  bool same = true;
+  same &= run_threads<z_sdbm_domain_t> (4);
+  same &= run_threads<z_dbm_domain_t> (4);
+  return (same ? 0 : 1);
+}
@@ -0,0 +1,111 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/domains/separate_domains.hpp>
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace ikos;
+
+/* Check that the hash-consed separate domain gives the same results */
+
+typedef interval<z_number> z_interval_t;
+typedef separate_domain<z_var, z_interval_t> env_t;
+typedef hc_separate_domain<z_var, z_interval_t> hc_env_t;
+
+template<typename Env1, typename Env2>
+static bool same(Env1 e1, Env2 e2) {
+  crab::crab_string_os s1, s2;
+  e1.write(s1);
+  e2.write(s2);
+  if (s1.str() != s2.str()) {
+    crab::outs() << "MISMATCH: " << s1.str() << " and " << s2.str() << "\n";
+    return false;
+  }
+  return true;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<z_var> vars;
+  for (unsigned i=0; i < 64; ++i) {
+    vars.push_back(z_var(vfac[string("v") + to_string(i)], crab::INT_TYPE, 32));
+  }
+
+  bool ok = true;
+  { // lattice operations on small environments
+    env_t e1, e2;
+    hc_env_t h1, h2;
+    z_interval_t a(z_bound(0), z_bound(10));
+    z_interval_t b(z_bound(5), z_bound(20));
+    z_interval_t c(z_bound(1), z_bound::plus_infinity());
+    e1.set(vars[0], a); h1.set(vars[0], a);
+    e1.set(vars[1], b); h1.set(vars[1], b);
+    e2.set(vars[1], a); h2.set(vars[1], a);
+    e2.set(vars[2], c); h2.set(vars[2], c);
+    // insertion order does not matter
+    e2.set(vars[0], b); h2.set(vars[0], b);
+
+    ok &= same(e1 | e2, h1 | h2);
+    ok &= same(e1 & e2, h1 & h2);
+    ok &= same(e1 || e2, h1 || h2);
+    ok &= same(e1 && e2, h1 && h2);
+    ok &= ((e1 <= e2) == (h1 <= h2));
+    ok &= ((e1 <= (e1 | e2)) == (h1 <= (h1 | h2)));
+    hc_env_t join = h1 | h2;
+    hc_env_t meet = h1 & h2;
+    hc_env_t widen = h1 || h2;
+    crab::outs() << "Join=" << join << "\n"
+		 << "Meet=" << meet << "\n"
+		 << "Widening=" << widen << "\n";
+
+    hc_env_t h3;
+    h3.set(vars[1], b);
+    h3.set(vars[0], a);
+    crab::outs() << "Same environment built in a different order: "
+		 << (h1 == h3) << "\n";
+    ok &= (h1 == h3);
+  }
+
+  { // long sequence of updates, joins and widenings
+    env_t e = env_t::top(), acc = env_t::bottom();
+    hc_env_t h = hc_env_t::top(), hacc = hc_env_t::bottom();
+    unsigned seed = 12345;
+    for (unsigned it = 0; it < 2000; ++it) {
+      seed = seed * 1103515245 + 12345;
+      unsigned v = (seed >> 8) % vars.size();
+      long lb = (seed >> 16) % 50;
+      z_interval_t i(z_bound(lb), z_bound(lb + (seed >> 4) % 7));
+      switch ((seed >> 24) % 6) {
+      case 0:
+      case 1:
+	e.set(vars[v], i); h.set(vars[v], i);
+	break;
+      case 2:
+	e -= vars[v]; h -= vars[v];
+	break;
+      case 3:
+	acc = acc | e; hacc = hacc | h;
+	break;
+      case 4:
+	if (it % 7 == 0) {
+	  acc = acc || e; hacc = hacc || h;
+	} else {
+	  acc = e; hacc = h;
+	}
+	break;
+      default:
+	ok &= ((e <= acc) == (h <= hacc));
+	ok &= ((acc <= e) == (hacc <= h));
+      }
+      ok &= same(e, h);
+      ok &= same(acc, hacc);
+    }
+    crab::outs() << "Accumulated=" << hacc << "\n";
+  }
+
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+using namespace std;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace ikos;
+
+/* Check that computing all the residuals of a constraint in one pass
+   gives the same result as computing each residual from scratch */
+
+namespace {
+  // Same as z_interval_t but the solver does not know that its bounds
+  // are independent so it computes each residual from scratch.
+  class slow_interval: public interval<z_number> {
+  public:
+    typedef interval<z_number> z_interval_t;
+    slow_interval(const z_interval_t& i): z_interval_t(i) {}
+    slow_interval(z_number n): z_interval_t(n) {}
+    slow_interval(): z_interval_t(z_interval_t::top()) {}
+    static slow_interval top() { return z_interval_t::top(); }
+    static slow_interval bottom() { return z_interval_t::bottom(); }
+  };
+}
+
+namespace ikos {
+  namespace linear_interval_solver_impl {
+    template<>
+    inline slow_interval trim_interval(slow_interval i, slow_interval j) {
+      return trim_interval<z_interval>(i, j);
+    }
+    template<>
+    inline slow_interval lower_half_line(slow_interval i, bool is_signed) {
+      return lower_half_line<z_interval>(i, is_signed);
+    }
+    template<>
+    inline slow_interval upper_half_line(slow_interval i, bool is_signed) {
+      return upper_half_line<z_interval>(i, is_signed);
+    }
+  }
+}
+
+typedef separate_domain<z_var, z_interval_t> env_t;
+typedef separate_domain<z_var, slow_interval> slow_env_t;
+typedef linear_interval_solver<z_number, varname_t, env_t> solver_t;
+typedef linear_interval_solver<z_number, varname_t, slow_env_t> slow_solver_t;
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<z_var> vars;
+  for (unsigned i=0; i < 12; ++i) {
+    vars.push_back(z_var(vfac[string("x") + to_string(i)], crab::INT_TYPE, 32));
+  }
+
+  bool ok = true;
+  unsigned num_bottom = 0;
+  // the same solver is reused for all systems
+  solver_t solver(10);
+  unsigned seed = 777;
+  for (unsigned it = 0; it < 300; ++it) {
+    env_t env;
+    slow_env_t slow_env;
+    for (unsigned i = 0; i < vars.size(); ++i) {
+      seed = seed * 1103515245 + 12345;
+      if ((seed >> 20) % 3 == 0) continue;
+      long lb = (long) ((seed >> 8) % 50) - 25;
+      z_interval_t i_v(z_bound(lb), (seed >> 16) % 4 == 0 ?
+		     z_bound::plus_infinity() : z_bound(lb + (long) ((seed >> 4) % 30)));
+      env.set(vars[i], i_v);
+      slow_env.set(vars[i], i_v);
+    }
+    z_lin_cst_sys_t csts;
+    unsigned num_csts = 1 + (seed >> 24) % 8;
+    for (unsigned c = 0; c < num_csts; ++c) {
+      z_lin_t e;
+      unsigned num_terms = 1 + (seed >> 12) % 6;
+      for (unsigned t = 0; t < num_terms; ++t) {
+	seed = seed * 1103515245 + 12345;
+	long coeff = (long) ((seed >> 8) % 7) - 3;
+	if (coeff == 0) coeff = 1;
+	e = e + coeff * vars[(seed >> 16) % vars.size()];
+      }
+      seed = seed * 1103515245 + 12345;
+      e = e - (long) ((seed >> 8) % 40);
+      switch ((seed >> 20) % 4) {
+      case 0: csts += z_lin_cst_t(e == 0); break;
+      case 1: csts += z_lin_cst_t(e != 0); break;
+      default: csts += z_lin_cst_t(e <= 0);
+      }
+    }
+
+    solver.reset(csts, 10);
+    solver.run(env);
+    slow_solver_t slow_solver(csts, 10);
+    slow_solver.run(slow_env);
+
+    if (env.is_bottom()) ++num_bottom;
+    if (env.is_bottom() != slow_env.is_bottom()) {
+      crab::outs() << "MISMATCH on " << csts << "\n";
+      ok = false;
+      continue;
+    }
+    if (env.is_bottom()) continue;
+    for (auto v: vars) {
+      z_interval_t i1 = env[v];
+      z_interval_t i2 = slow_env[v];
+      if (!(i1 == i2)) {
+	crab::outs() << "MISMATCH on " << csts << ": " << v << " -> "
+		     << i1 << " and " << i2 << "\n";
+	ok = false;
+      }
+    }
+  }
+
+  { // a large guard-heavy system
+    env_t env;
+    z_lin_cst_sys_t csts;
+    csts += z_lin_cst_t(vars[0] >= 0);
+    for (unsigned i = 1; i < vars.size(); ++i) {
+      csts += z_lin_cst_t(vars[i] - vars[i-1] >= 1);
+    }
+    z_lin_t sum;
+    for (auto v: vars) {
+      sum = sum + v;
+    }
+    csts += z_lin_cst_t(sum <= 100);
+    solver.reset(csts, 10);
+    solver.run(env);
+    crab::outs() << csts << "\n" << env << "\n";
+  }
+
+  crab::outs() << "Bottom results: " << num_bottom << "\n";
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
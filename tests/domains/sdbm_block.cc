@@ -0,0 +1,124 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::domains;
+
+/* Check that adding a run of constraints to SplitDBM at once gives
+   the same result as adding them one by one */
+
+typedef typename z_sdbm_domain_t::linear_constraint_t z_lin_cst_t;
+typedef typename z_sdbm_domain_t::linear_constraint_system_t z_lin_cst_sys_t;
+
+z_cfg_t* prog (variable_factory_t &vfac)
+{
+  z_cfg_t* cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry     = cfg->insert ("entry");
+  z_basic_block_t& loop      = cfg->insert ("loop");
+  z_basic_block_t& loop_t    = cfg->insert ("loop_t");
+  z_basic_block_t& loop_f    = cfg->insert ("loop_f");
+  z_basic_block_t& ret       = cfg->insert ("ret");
+
+  entry >> loop;
+  loop >> loop_t; loop >> loop_f;
+  loop_t >> loop;
+  loop_f >> ret;
+
+  z_var i(vfac["i"], crab::INT_TYPE, 32);
+  z_var j(vfac["j"], crab::INT_TYPE, 32);
+  z_var k(vfac["k"], crab::INT_TYPE, 32);
+  z_var n(vfac["n"], crab::INT_TYPE, 32);
+  z_var x(vfac["x"], crab::INT_TYPE, 32);
+
+  entry.assume (n >= 1);
+  entry.assume (n <= 100);
+  entry.assume (k >= n);
+  entry.assume (k <= n + 5);
+  entry.assign (i, 0);
+  entry.assign (j, 0);
+  loop_t.assume (i <= n - 1);
+  loop_t.assume (j <= i);
+  loop_t.assume (x == i + 3);
+  loop_t.assume (2*x <= k + 7);
+  loop_t.assume (x >= j);
+  loop_t.add (i, i, 1);
+  loop_t.add (j, j, 1);
+  loop_f.assume (i >= n);
+  loop_f.assume (j <= k);
+  loop_f.assume (i != 50);
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  bool ok = true;
+
+  { // runs of constraints on the domain
+    vector<z_var> vars;
+    for (unsigned i=0; i < 8; ++i) {
+      vars.push_back(z_var(vfac[string("v") + to_string(i)], crab::INT_TYPE, 32));
+    }
+    unsigned seed = 4242;
+    for (unsigned it = 0; it < 200; ++it) {
+      z_sdbm_domain_t one = z_sdbm_domain_t::top();
+      z_sdbm_domain_t all = z_sdbm_domain_t::top();
+      z_lin_cst_sys_t csts;
+      for (unsigned c = 0; c < 6; ++c) {
+	seed = seed * 1103515245 + 12345;
+	z_var x = vars[(seed >> 8) % vars.size()];
+	z_var y = vars[(seed >> 12) % vars.size()];
+	long k = (long) ((seed >> 16) % 40) - 10;
+	z_lin_cst_t cst;
+	switch ((seed >> 24) % 6) {
+	case 0: cst = z_lin_cst_t(x - y <= k); break;
+	case 1: cst = z_lin_cst_t(x <= k); break;
+	case 2: cst = z_lin_cst_t(x >= k); break;
+	case 3: cst = z_lin_cst_t(x == y + k); break;
+	case 4: cst = z_lin_cst_t(x + y <= k); break;
+	default: cst = z_lin_cst_t(x != k);
+	}
+	csts += cst;
+      }
+      for (auto const& cst: csts) {
+	one += cst;
+      }
+      all += csts;
+      crab::crab_string_os s1, s2;
+      s1 << one;
+      s2 << all;
+      if (s1.str() != s2.str()) {
+	crab::outs() << "MISMATCH after " << csts << ": " << s1.str()
+		     << " and " << s2.str() << "\n";
+	ok = false;
+      }
+    }
+  }
+
+  { // whole analysis
+    z_cfg_t* cfg = prog (vfac);
+    crab::outs() << *cfg << "\n";
+    typedef intra_fwd_analyzer<z_cfg_ref_t, z_sdbm_domain_t> analyzer_t;
+    analyzer_t a (*cfg, z_sdbm_domain_t::top(), nullptr, 1, 2, 20);
+    a.run ();
+    std::set<basic_block_label_t> labels;
+    for (auto &b : *cfg) {
+      labels.insert (b.label ());
+    }
+    for (auto l : labels) {
+      auto inv = a.get_post (l);
+      crab::outs() << get_label_str (l) << "=" << inv << "\n";
+    }
+    delete cfg;
+  }
+
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::domains;
+
+/* Check that the dense closure of SplitDBM gives the same results */
+
+namespace {
+  // Same as the default parameters but closures are always sparse
+  class sparse_params: public SDBM_impl::DefaultParams<ikos::z_number> {
+  public:
+    enum { dense_closure = 0 };
+  };
+}
+typedef SplitDBM<ikos::z_number, varname_t, sparse_params> z_sparse_sdbm_domain_t;
+
+z_cfg_t* prog (variable_factory_t &vfac) 
+{
+  z_cfg_t* cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry     = cfg->insert ("entry");
+  z_basic_block_t& loop1     = cfg->insert ("loop1");
+  z_basic_block_t& loop1_t   = cfg->insert ("loop1_t");
+  z_basic_block_t& loop1_f   = cfg->insert ("loop1_f");
+  z_basic_block_t& loop2     = cfg->insert ("loop2");
+  z_basic_block_t& loop2_t   = cfg->insert ("loop2_t");
+  z_basic_block_t& loop2_f   = cfg->insert ("loop2_f");
+  z_basic_block_t& then_bb   = cfg->insert ("then");
+  z_basic_block_t& else_bb   = cfg->insert ("else");
+  z_basic_block_t& join_bb   = cfg->insert ("join");
+  z_basic_block_t& ret       = cfg->insert ("ret");
+
+  entry >> loop1;
+  loop1 >> loop1_t; loop1 >> loop1_f;
+  loop1_t >> loop2;
+  loop2 >> loop2_t; loop2 >> loop2_f;
+  loop2_t >> then_bb; loop2_t >> else_bb;
+  then_bb >> join_bb; else_bb >> join_bb;
+  join_bb >> loop2;
+  loop2_f >> loop1;
+  loop1_f >> ret;
+
+  z_var i(vfac["i"], crab::INT_TYPE, 32);
+  z_var j(vfac["j"], crab::INT_TYPE, 32);
+  z_var k(vfac["k"], crab::INT_TYPE, 32);
+  z_var n(vfac["n"], crab::INT_TYPE, 32);
+  z_var x(vfac["x"], crab::INT_TYPE, 32);
+  z_var y(vfac["y"], crab::INT_TYPE, 32);
+
+  entry.assume (n >= 1);
+  entry.assign (i, 0);
+  entry.assign (x, 0);
+  entry.assign (y, 0);
+  loop1_t.assume (i <= n - 1);
+  loop1_t.assign (j, i);
+  loop1_f.assume (i >= n);
+  loop2_t.assume (j <= n - 1);
+  loop2_f.assume (j >= n);
+  loop2_f.add (i, i, 1);
+  then_bb.add (x, x, 1);
+  then_bb.assign (k, j + 2);
+  else_bb.add (y, y, 1);
+  else_bb.assign (k, j + 1);
+  join_bb.assume (k <= n + 1);
+  join_bb.add (j, j, 1);
+  return cfg;
+}
+
+template<typename Dom>
+std::string analyze (z_cfg_t *cfg) {
+  typedef intra_fwd_analyzer<z_cfg_ref_t, Dom> analyzer_t;
+  analyzer_t a (*cfg, Dom::top(), nullptr, 1, 2, 20);
+  a.run ();
+  crab::crab_string_os o;
+  std::set<basic_block_label_t> labels;
+  for (auto &b : *cfg) {
+    labels.insert (b.label ());
+  }
+  for (auto l : labels) {
+    auto inv = a.get_post (l);
+    o << get_label_str (l) << "=" << inv << "\n";
+  }
+  return o.str ();
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac);
+  crab::outs() << *cfg << "\n";
+
+  std::string dense = analyze<z_sdbm_domain_t> (cfg);
+  std::string sparse = analyze<z_sparse_sdbm_domain_t> (cfg);
+  crab::outs() << dense;
+  crab::outs() << "Dense and sparse closures "
+	       << (dense == sparse ? "are the same" : "differ") << "\n";
+  delete cfg;
+  return (dense == sparse ? 0 : 1);
+}
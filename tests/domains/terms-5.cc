@@ -0,0 +1,75 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+/* Copies of a term domain share the term table until one of them
+   modifies it */
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  typedef interval< z_number> interval_t;
+
+  z_var x(vfac["x"], crab::INT_TYPE, 32);
+  z_var y(vfac["y"], crab::INT_TYPE, 32);
+  z_var w(vfac["w"], crab::INT_TYPE, 32);
+  z_var z(vfac["z"], crab::INT_TYPE, 32);
+
+  bool ok = true;
+  {
+    z_term_domain_t dom = z_term_domain_t::top ();
+    dom.set (x, interval_t (0,10));
+    dom.set (z, interval_t (1,1));
+    dom.apply(OP_ADDITION, y, x, z);
+    dom.assign (w, x);
+
+    // Two copies that only refine the underlying domain
+    z_term_domain_t left (dom);
+    z_term_domain_t right (dom);
+    left += (z_lin_t(x) <= 4);
+    right += (z_lin_t(x) >= 7);
+    crab::outs() << "Left=" << left << "\n";
+    crab::outs() << "Right=" << right << "\n";
+    // the original state is not modified
+    crab::outs() << "Original=" << dom << "\n";
+    ok &= (dom[x] == interval_t (0,10));
+
+    z_term_domain_t l_join_r = left | right;
+    crab::outs() << "Join=" << l_join_r << "\n";
+    ok &= (l_join_r[y] == interval_t (1,11));
+    ok &= (left <= l_join_r);
+    ok &= (right <= l_join_r);
+    ok &= !(l_join_r <= left);
+
+    z_term_domain_t l_meet_r = left & right;
+    crab::outs() << "Meet=" << l_meet_r << "\n";
+    ok &= l_meet_r.is_bottom ();
+
+    z_term_domain_t l_widen_r = left || right;
+    crab::outs() << "Widening=" << l_widen_r << "\n";
+    ok &= (right <= l_widen_r);
+
+    left |= right;
+    ok &= (left <= l_join_r && l_join_r <= left);
+
+    // A copy that modifies the term table
+    z_term_domain_t other (dom);
+    other.apply(OP_MULTIPLICATION, w, y, y);
+    crab::outs() << "Other=" << other << "\n";
+    crab::outs() << "Original=" << dom << "\n";
+    ok &= (dom[w] == interval_t (0,10));
+    z_term_domain_t o_join_d = other | dom;
+    crab::outs() << "Join=" << o_join_d << "\n";
+    ok &= (dom <= o_join_d);
+    ok &= (other <= o_join_d);
+  }
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::domains;
+
+/* Check that a weak assignment gives the same result as joining the
+   state before and after a strong one */
+
+typedef typename z_sdbm_domain_t::linear_constraint_t z_lin_cst_t;
+typedef typename z_sdbm_domain_t::linear_expression_t z_lin_exp_t;
+
+template<typename Dom>
+bool check_weak_assign (const vector<z_var>& vars) {
+  bool ok = true;
+  unsigned seed = 2424;
+  for (unsigned it = 0; it < 200; ++it) {
+    Dom inv = Dom::top();
+    for (unsigned c = 0; c < 6; ++c) {
+      seed = seed * 1103515245 + 12345;
+      z_var x = vars[(seed >> 8) % vars.size()];
+      z_var y = vars[(seed >> 12) % vars.size()];
+      long k = (long) ((seed >> 16) % 40) - 10;
+      switch ((seed >> 24) % 4) {
+      case 0: inv += z_lin_cst_t(x - y <= k); break;
+      case 1: inv += z_lin_cst_t(x <= k); break;
+      case 2: inv += z_lin_cst_t(x >= k - 20); break;
+      default: inv.assign (x, y + k);
+      }
+    }
+    seed = seed * 1103515245 + 12345;
+    z_var x = vars[(seed >> 8) % vars.size()];
+    z_var y = vars[(seed >> 12) % vars.size()];
+    long k = (long) ((seed >> 16) % 40) - 10;
+    z_lin_exp_t e;
+    switch ((seed >> 24) % 4) {
+    case 0: e = z_lin_exp_t(k); break;
+    case 1: e = y + k; break;
+    case 2: e = x + 1; break;
+    default: e = 2*y + k;
+    }
+    Dom other (inv);
+    other.assign (x, e);
+    Dom join = inv | other;
+    Dom weak (inv);
+    weak_update_domain_traits<Dom>::weak_assign (weak, x, e);
+    // Compare the constraints since <= is sensitive to the variables
+    // without constraints in the DBM-based domains
+    Dom c1 = Dom::top();
+    c1 += join.to_linear_constraint_system();
+    Dom c2 = Dom::top();
+    c2 += weak.to_linear_constraint_system();
+    if (!(c1 <= c2 && c2 <= c1)) {
+      crab::outs() << "MISMATCH " << x << ":=" << e << " in " << inv << ": "
+		   << join << " and " << weak << "\n";
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+// Fill an array with relational values in a loop
+z_cfg_t* prog (variable_factory_t &vfac)
+{
+  z_var n(vfac["n"], crab::INT_TYPE, 32);
+  z_var i(vfac["i"], crab::INT_TYPE, 32);
+  z_var x(vfac["x"], crab::INT_TYPE, 32);
+  z_var a(vfac["A"], crab::ARR_INT_TYPE, 32);
+  z_var tmp(vfac["tmp"], crab::INT_TYPE, 32);
+
+  z_cfg_t* cfg = new z_cfg_t("entry","ret", ARR);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& loop  = cfg->insert ("loop");
+  z_basic_block_t& body  = cfg->insert ("body");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  z_basic_block_t& ret   = cfg->insert ("ret");
+  entry >> loop; loop >> body; body >> loop; loop >> exit; exit >> ret;
+
+  uint64_t elem_size = 1;
+  entry.assume (n >= 1);
+  entry.assign (i, 0);
+  entry.assign (x, 0);
+  entry.array_init (a, elem_size, 0, 9, x);
+  body.assume (i <= n - 1);
+  body.array_store (a, i, i, elem_size);
+  body.add (i, i, 1);
+  exit.assume (i >= n);
+  ret.array_load (tmp, a, i, elem_size);
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<z_var> vars;
+  for (unsigned i=0; i < 6; ++i) {
+    vars.push_back(z_var(vfac[string("v") + to_string(i)], crab::INT_TYPE, 32));
+  }
+  bool ok = true;
+  ok &= check_weak_assign<z_interval_domain_t> (vars);
+  ok &= check_weak_assign<z_dbm_domain_t> (vars);
+  ok &= check_weak_assign<z_sdbm_domain_t> (vars);
+
+  { // array smashing
+    z_cfg_t* cfg = prog (vfac);
+    crab::outs() << *cfg << "\n";
+    run<z_as_sdbm_t>(cfg, cfg->entry(), false, 1, 2, 20, stats_enabled);
+    delete cfg;
+  }
+
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include <crab/config.h>
+#include <crab/common/types.hpp>
+#include <crab/common/bignums.hpp>
+
+#include <climits>
+#include <vector>
+
+using namespace std;
+using namespace ikos;
+
+/* Check the inline representation of z_number against GMP,
+   especially around the boundaries of a signed long */
+
+static bool check(const char* op, z_number a, z_number b, z_number res, mpz_class expected) {
+  if (res.get_str() != expected.get_str()) {
+    crab::outs() << "MISMATCH: " << a << " " << op << " " << b << " = " << res
+		 << " but expected " << expected.get_str() << "\n";
+    return false;
+  }
+  return true;
+}
+
+int main (int argc, char *argv[]) {
+
+  vector<z_number> nums;
+  vector<long> smalls = {0, 1, -1, 2, -2, 3, 7, -7, 62, 63, 64, 100, -100,
+			 INT_MAX, INT_MIN, LONG_MAX, LONG_MIN, LONG_MAX - 1, LONG_MIN + 1,
+			 LONG_MAX / 2, LONG_MIN / 2, 3037000499L, -3037000500L};
+  for (long n: smalls) {
+    nums.push_back(z_number((signed long long) n));
+  }
+  nums.push_back(z_number(string("18446744073709551616"))); // 2^64
+  nums.push_back(z_number(string("-9223372036854775809"))); // LONG_MIN - 1
+  nums.push_back(z_number(string("9223372036854775808"))); // LONG_MAX + 1
+
+  bool ok = true;
+  for (auto &a: nums) {
+    for (auto &b: nums) {
+      mpz_class x = (mpz_class) a;
+      mpz_class y = (mpz_class) b;
+      ok &= check("+", a, b, a + b, x + y);
+      ok &= check("-", a, b, a - b, x - y);
+      ok &= check("*", a, b, a * b, x * y);
+      ok &= check("&", a, b, a & b, x & y);
+      ok &= check("|", a, b, a | b, x | y);
+      ok &= check("^", a, b, a ^ b, x ^ y);
+      if (y != 0) {
+	ok &= check("/", a, b, a / b, x / y);
+	ok &= check("%", a, b, a % b, x % y);
+      }
+      if (y >= 0 && y <= 100) {
+	mpz_class l, r;
+	mpz_mul_2exp(l.get_mpz_t(), x.get_mpz_t(), y.get_ui());
+	mpz_fdiv_q_2exp(r.get_mpz_t(), x.get_mpz_t(), y.get_ui());
+	ok &= check("<<", a, b, a << b, l);
+	ok &= check(">>", a, b, a >> b, r);
+      }
+      ok &= ((a < b) == (x < y)) && ((a <= b) == (x <= y)) &&
+	    ((a == b) == (x == y)) && ((a != b) == (x != y));
+      ok &= ((hash_value(a) == hash_value(b)) || (x != y));
+    }
+    mpz_class x = (mpz_class) a;
+    z_number inc(a), dec(a);
+    ++inc; --dec;
+    ok &= check("+", a, 1, inc, x + 1);
+    ok &= check("-", a, 1, dec, x - 1);
+    ok &= check("-", 0, a, -a, -x);
+    ok &= (a.fits_slong() == x.fits_slong_p());
+  }
+
+  // promotion and demotion
+  z_number big = z_number((signed long long) LONG_MAX) + 1;
+  z_number back = big - 1;
+  crab::outs() << "LONG_MAX+1=" << big << " fits_slong=" << big.fits_slong() << "\n";
+  crab::outs() << "LONG_MAX+1-1=" << back << " fits_slong=" << back.fits_slong() << "\n";
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
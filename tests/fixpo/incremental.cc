@@ -0,0 +1,96 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+/* Two loops in sequence */
+z_cfg_t* prog (variable_factory_t &vfac)  {
+
+  // Defining program variables
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var j (vfac ["j"], crab::INT_TYPE, 32);
+  // entry and exit block
+  auto cfg = new z_cfg_t("entry","ret");
+  // adding blocks
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& loop1 = cfg->insert ("loop1");
+  z_basic_block_t& loop1_body = cfg->insert ("loop1_body");
+  z_basic_block_t& loop1_exit = cfg->insert ("loop1_exit");
+  z_basic_block_t& loop2 = cfg->insert ("loop2");
+  z_basic_block_t& loop2_body = cfg->insert ("loop2_body");
+  z_basic_block_t& loop2_exit = cfg->insert ("loop2_exit");
+  z_basic_block_t& ret = cfg->insert ("ret");
+  // adding control flow
+  entry >> loop1; loop1 >> loop1_body; loop1_body >> loop1; loop1 >> loop1_exit;
+  loop1_exit >> loop2; loop2 >> loop2_body; loop2_body >> loop2; loop2 >> loop2_exit;
+  loop2_exit >> ret;
+  // adding statements
+  entry.assign (i, 0);
+  loop1_body.assume (i <= 99);
+  loop1_body.add (i, i, 1);
+  loop1_exit.assume (i >= 100);
+  loop1_exit.assign (j, 0);
+  loop2_body.assume (j <= 9);
+  loop2_body.add (j, j, 1);
+  loop2_exit.assume (j >= 10);
+  return cfg;
+}
+
+template<typename Analyzer>
+void print (z_cfg_t* cfg, Analyzer &a) {
+  // Print invariants in a fixed order
+  std::set<basic_block_label_t> labels;
+  for (auto &b : *cfg) {
+    labels.insert(b.label());
+  }
+  for (auto l : labels) {
+    auto pre = a[l];
+    crab::outs() << get_label_str(l) << "=" << pre << "\n";
+  }
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog(vfac);
+  crab::outs() << *cfg << "\n";
+
+  typedef intra_fwd_analyzer<z_cfg_ref_t, z_sdbm_domain_t> analyzer_t;
+  analyzer_t a(*cfg, z_sdbm_domain_t::top(), nullptr, 1, 2, 20);
+  a.run();
+  print(cfg, a);
+
+  // modify the block before the second loop
+  z_var j (vfac ["j"], crab::INT_TYPE, 32);
+  z_basic_block_t& loop1_exit = cfg->get_node("loop1_exit");
+  loop1_exit.assign (j, 5);
+  crab::outs() << "Modified ";
+  loop1_exit.write(crab::outs());
+
+  std::set<basic_block_label_t> modified;
+  modified.insert("loop1_exit");
+  a.run_incremental(modified);
+  print(cfg, a);
+
+  // compare with a full analysis
+  analyzer_t b(*cfg, z_sdbm_domain_t::top(), nullptr, 1, 2, 20);
+  b.run();
+  bool same = true;
+  for (auto &bb : *cfg) {
+    auto a_pre = a[bb.label()];
+    auto b_pre = b[bb.label()];
+    same &= (a_pre <= b_pre && b_pre <= a_pre);
+  }
+  crab::outs() << "Incremental and full analyses "
+	       << (same ? "are the same" : "differ") << "\n";
+  
+  delete cfg;
+  return (same ? 0 : 1);
+}
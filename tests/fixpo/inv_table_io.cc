@@ -0,0 +1,124 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+#include <crab/analysis/inv_table_io.hpp>
+#include <cstdio>
+#include <fstream>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+/* Write the invariants to a file and read them back */
+
+z_cfg_t* prog (variable_factory_t &vfac)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var x (vfac ["x"], crab::INT_TYPE, 32);
+  z_var y (vfac ["y"], crab::INT_TYPE, 32);
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& loop = cfg->insert ("loop");
+  z_basic_block_t& body = cfg->insert ("body");
+  z_basic_block_t& then_b = cfg->insert ("then");
+  z_basic_block_t& else_b = cfg->insert ("else");
+  z_basic_block_t& latch = cfg->insert ("latch");
+  z_basic_block_t& loop_exit = cfg->insert ("loop_exit");
+  z_basic_block_t& dead = cfg->insert ("dead");
+  z_basic_block_t& ret = cfg->insert ("ret");
+  entry >> loop; loop >> body; body >> then_b; body >> else_b;
+  then_b >> latch; else_b >> latch; latch >> loop;
+  loop >> loop_exit; loop_exit >> dead; loop_exit >> ret; dead >> ret;
+  entry.assign (i, 0);
+  entry.assign (x, 0);
+  entry.assign (y, 0);
+  body.assume (i <= 99);
+  then_b.add (x, x, 1);
+  else_b.add (x, x, 2);
+  latch.add (i, i, 1);
+  latch.add (y, y, 1);
+  loop_exit.assume (i >= 100);
+  dead.assume (i <= 50);
+  ret.sub (x, x, y);
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog(vfac);
+  crab::outs() << *cfg << "\n";
+
+  typedef intra_fwd_analyzer<z_cfg_ref_t, z_dbm_domain_t> analyzer_t;
+  analyzer_t a(*cfg, z_dbm_domain_t::top(), nullptr, 1, 2, 20);
+  a.run();
+
+  const string filename = "crab_inv_table_test.bin";
+  bool ok = true;
+  {
+    inv_table_writer<analyzer_t> writer(a);
+    ok &= writer.write(filename);
+    // some invariants are stored as deltas
+    ok &= (crab::CrabStats::get("InvTable.delta_records") > 0);
+  }
+  {
+    inv_table_reader<z_dbm_domain_t, variable_factory_t> reader(filename, vfac);
+    ok &= reader.is_open();
+    ok &= (reader.size() == 9);
+    // Print invariants in a fixed order
+    std::set<basic_block_label_t> labels;
+    for (auto &bb : *cfg) {
+      labels.insert(bb.label());
+    }
+    for (auto l : labels) {
+      string s = get_label_str(l);
+      z_dbm_domain_t pre, post;
+      ok &= reader.get_pre(s, pre);
+      ok &= reader.get_post(s, post);
+      crab::outs() << s << "=" << pre << "\n";
+      auto a_pre = a.get_pre(l);
+      auto a_post = a.get_post(l);
+      ok &= (pre <= a_pre && a_pre <= pre);
+      ok &= (post <= a_post && a_post <= post);
+    }
+  }
+  {
+    // a record with an invalid kind is rejected when it is decoded
+    ifstream in(filename.c_str(), ios::binary);
+    string buf((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    const char *footer = buf.data() + buf.size() - 40;
+    uint64_t records = inv_table_impl::get_u64(footer + 24);
+    uint64_t first = inv_table_impl::get_u64(buf.data() + records + 8);
+    buf[first] = 9;
+    ofstream out(filename.c_str(), ios::binary | ios::trunc);
+    out.write(buf.data(), buf.size());
+    out.close();
+    inv_table_reader<z_dbm_domain_t, variable_factory_t> reader(filename, vfac);
+    ok &= reader.is_open();
+    bool all_read = true;
+    for (auto &bb : *cfg) {
+      z_dbm_domain_t inv;
+      all_read &= reader.get_pre(get_label_str(bb.label()), inv);
+    }
+    ok &= !all_read && !reader.is_open();
+  }
+  {
+    // a truncated file is rejected
+    ifstream in(filename.c_str(), ios::binary);
+    string buf((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    ofstream out(filename.c_str(), ios::binary | ios::trunc);
+    out.write(buf.data(), buf.size() / 2);
+    out.close();
+    inv_table_reader<z_dbm_domain_t, variable_factory_t> reader(filename, vfac);
+    ok &= !reader.is_open();
+  }
+  std::remove(filename.c_str());
+
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  delete cfg;
+  return (ok ? 0 : 1);
+}
@@ -0,0 +1,133 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/dataflow/liveness.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+
+/* Check that the bit-vector liveness solver and the kill-gen one
+   compute the same dead variables */
+
+typedef liveness<z_cfg_ref_t> liveness_t;
+
+z_cfg_t* prog (variable_factory_t &vfac)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var j (vfac ["j"], crab::INT_TYPE, 32);
+  z_var k (vfac ["k"], crab::INT_TYPE, 32);
+  z_var n (vfac ["n"], crab::INT_TYPE, 32);
+  z_var t (vfac ["t"], crab::INT_TYPE, 32);
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry   = cfg->insert ("entry");
+  z_basic_block_t& l1      = cfg->insert ("l1");
+  z_basic_block_t& l1_body = cfg->insert ("l1_body");
+  z_basic_block_t& l2      = cfg->insert ("l2");
+  z_basic_block_t& l2_body = cfg->insert ("l2_body");
+  z_basic_block_t& l2_exit = cfg->insert ("l2_exit");
+  z_basic_block_t& l1_exit = cfg->insert ("l1_exit");
+  z_basic_block_t& ret     = cfg->insert ("ret");
+  entry >> l1;
+  l1 >> l1_body; l1 >> l1_exit;
+  l1_body >> l2;
+  l2 >> l2_body; l2_body >> l2; l2 >> l2_exit;
+  l2_exit >> l1;
+  l1_exit >> ret;
+  entry.assign (i, 0);
+  entry.assign (n, 10);
+  entry.assign (t, 5);
+  l1_body.assume (i <= n);
+  l1_body.assign (j, 0);
+  l2_body.assume (j <= 9);
+  l2_body.add (j, j, 1);
+  l2_body.add (k, j, i);
+  l2_exit.assume (j >= 10);
+  l2_exit.add (i, i, 1);
+  l1_exit.assume (i >= n + 1);
+  ret.assign (k, i);
+  return cfg;
+}
+
+// A sequence of diamonds where each block defines and uses several
+// variables so that the bit vectors need more than one word.
+z_cfg_t* diamonds (variable_factory_t &vfac, unsigned n, unsigned vars)  {
+  vector<z_var> xs;
+  for (unsigned v = 0; v < vars; ++v) {
+    xs.push_back (z_var (vfac ["x" + std::to_string (v)], crab::INT_TYPE, 32));
+  }
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t* prev = &cfg->insert ("entry");
+  for (unsigned v = 0; v < vars; ++v) {
+    prev->assign (xs [v], v);
+  }
+  for (unsigned d = 0; d < n; ++d) {
+    string s = std::to_string (d);
+    z_basic_block_t& left  = cfg->insert ("left" + s);
+    z_basic_block_t& right = cfg->insert ("right" + s);
+    z_basic_block_t& join  = cfg->insert ("join" + s);
+    *prev >> left; *prev >> right;
+    left >> join; right >> join;
+    left.add (xs [(3*d) % vars], xs [(3*d + 1) % vars], 1);
+    right.assume (xs [(5*d + 2) % vars] >= 0);
+    join.add (xs [(7*d) % vars], xs [(7*d + 3) % vars], xs [(2*d) % vars]);
+    if (d % 4 == 3) {
+      // back edge
+      join >> *prev;
+    }
+    prev = &join;
+  }
+  z_basic_block_t& ret = cfg->insert ("ret");
+  *prev >> ret;
+  ret.add (xs [0], xs [1], xs [2]);
+  return cfg;
+}
+
+bool same (z_cfg_ref_t cfg, const liveness_t &l1, const liveness_t &l2) {
+  bool res = true;
+  for (auto &b: boost::make_iterator_range (cfg.begin (), cfg.end ())) {
+    auto d1 = l1.dead_exit (b.label ());
+    auto d2 = l2.dead_exit (b.label ());
+    res &= (d1 == d2);
+  }
+  return res;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  bool ok = true;
+  {
+    z_cfg_t* cfg = prog (vfac);
+    z_cfg_ref_t cfg_ref (*cfg);
+    liveness_t bv (cfg_ref);
+    bv.exec ();
+    // no budget: always use the kill-gen solver
+    liveness_t kg (cfg_ref, 0);
+    kg.exec ();
+    std::set<basic_block_label_t> labels (cfg_ref.label_begin (), cfg_ref.label_end ());
+    for (auto n : labels) {
+      auto dead = bv.dead_exit (n);
+      crab::outs() << n << ": dead=" << dead << "\n";
+    }
+    ok &= same (cfg_ref, bv, kg);
+    unsigned total1, max1, avg1, total2, max2, avg2;
+    bv.get_stats (total1, max1, avg1);
+    kg.get_stats (total2, max2, avg2);
+    ok &= (total1 == total2 && max1 == max2 && avg1 == avg2);
+    delete cfg;
+  }
+  {
+    z_cfg_t* cfg = diamonds (vfac, 200, 150);
+    z_cfg_ref_t cfg_ref (*cfg);
+    liveness_t bv (cfg_ref);
+    bv.exec ();
+    liveness_t kg (cfg_ref, 0);
+    kg.exec ();
+    ok &= same (cfg_ref, bv, kg);
+    delete cfg;
+  }
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
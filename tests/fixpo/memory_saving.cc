@@ -0,0 +1,86 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+/* Keep only some invariants and recompute the others on demand */
+
+// A chain of blocks followed by a loop whose body is a chain too
+z_cfg_t* prog (variable_factory_t &vfac)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var x (vfac ["x"], crab::INT_TYPE, 32);
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& a1 = cfg->insert ("a1");
+  z_basic_block_t& a2 = cfg->insert ("a2");
+  z_basic_block_t& a3 = cfg->insert ("a3");
+  z_basic_block_t& loop = cfg->insert ("loop");
+  z_basic_block_t& body1 = cfg->insert ("body1");
+  z_basic_block_t& body2 = cfg->insert ("body2");
+  z_basic_block_t& body3 = cfg->insert ("body3");
+  z_basic_block_t& loop_exit = cfg->insert ("loop_exit");
+  z_basic_block_t& ret = cfg->insert ("ret");
+  entry >> a1; a1 >> a2; a2 >> a3; a3 >> loop;
+  loop >> body1; body1 >> body2; body2 >> body3; body3 >> loop;
+  loop >> loop_exit; loop_exit >> ret;
+  entry.assign (i, 0);
+  entry.assign (x, 0);
+  a1.add (x, x, 1);
+  a2.add (x, x, 2);
+  a3.add (x, x, 3);
+  body1.assume (i <= 99);
+  body2.add (i, i, 1);
+  body3.add (x, x, 2);
+  loop_exit.assume (i >= 100);
+  ret.sub (x, x, i);
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog(vfac);
+  crab::outs() << *cfg << "\n";
+
+  typedef intra_fwd_analyzer<z_cfg_ref_t, z_sdbm_domain_t> analyzer_t;
+  crab::CrabStats::reset();
+  analyzer_t a(*cfg, z_sdbm_domain_t::top(), nullptr, 1, 2, 20);
+  a.run();
+  unsigned a_peak = crab::CrabStats::get("Fixpo.invariants.peak");
+  crab::CrabStats::reset();
+  analyzer_t b(*cfg, z_sdbm_domain_t::top(), nullptr, 1, 2, 20);
+  b.set_memory_saving(true);
+  b.run();
+  unsigned b_peak = crab::CrabStats::get("Fixpo.invariants.peak");
+  crab::outs() << "Peak number of stored invariants: " << a_peak
+	       << " (all kept) " << b_peak << " (memory saving)\n";
+
+  // Print invariants in a fixed order
+  std::set<basic_block_label_t> labels;
+  for (auto &bb : *cfg) {
+    labels.insert(bb.label());
+  }
+  bool same = true;
+  for (auto l : labels) {
+    auto a_pre = a.get_pre(l);
+    auto b_pre = b.get_pre(l);
+    auto a_post = a.get_post(l);
+    auto b_post = b.get_post(l);
+    crab::outs() << get_label_str(l) << "=" << b_pre << "\n";
+    same &= (a_pre <= b_pre && b_pre <= a_pre);
+    same &= (a_post <= b_post && b_post <= a_post);
+  }
+  same &= (b_peak <= a_peak);
+  crab::outs() << "Invariants with and without memory saving "
+	       << (same ? "are the same" : "differ") << "\n";
+
+  delete cfg;
+  return (same ? 0 : 1);
+}
@@ -0,0 +1,86 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/analysis/fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+/* Two independent loops after a branch */
+z_cfg_t* prog (variable_factory_t &vfac)  {
+
+  // Defining program variables
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var j (vfac ["j"], crab::INT_TYPE, 32);
+  z_var nd (vfac ["nd"], crab::INT_TYPE, 32);
+  // entry and exit block
+  auto cfg = new z_cfg_t("entry","ret");
+  // adding blocks
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& then_bb = cfg->insert ("then");
+  z_basic_block_t& else_bb = cfg->insert ("else");
+  z_basic_block_t& loop1 = cfg->insert ("loop1");
+  z_basic_block_t& loop1_body = cfg->insert ("loop1_body");
+  z_basic_block_t& loop1_exit = cfg->insert ("loop1_exit");
+  z_basic_block_t& loop2 = cfg->insert ("loop2");
+  z_basic_block_t& loop2_body = cfg->insert ("loop2_body");
+  z_basic_block_t& loop2_exit = cfg->insert ("loop2_exit");
+  z_basic_block_t& ret = cfg->insert ("ret");
+  // adding control flow
+  entry >> then_bb; entry >> else_bb;
+  then_bb >> loop1; loop1 >> loop1_body; loop1_body >> loop1; loop1 >> loop1_exit;
+  else_bb >> loop2; loop2 >> loop2_body; loop2_body >> loop2; loop2 >> loop2_exit;
+  loop1_exit >> ret; loop2_exit >> ret;
+  // adding statements
+  entry.havoc (nd);
+  then_bb.assume (nd >= 1);
+  then_bb.assign (i, 0);
+  loop1_body.assume (i <= 99);
+  loop1_body.add (i, i, 1);
+  loop1_exit.assume (i >= 100);
+  else_bb.assume (nd <= 0);
+  else_bb.assign (j, 10);
+  loop2_body.assume (j >= 1);
+  loop2_body.sub (j, j, 1);
+  loop2_exit.assume (j <= 0);
+  ret.assign (nd, 0);
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog(vfac);
+  crab::outs() << *cfg << "\n";
+
+  typedef intra_fwd_analyzer<z_cfg_ref_t, z_interval_domain_t> analyzer_t;
+  analyzer_t seq(*cfg, z_interval_domain_t::top(), nullptr, 1, 2, 20, 1);
+  seq.run();
+  analyzer_t par(*cfg, z_interval_domain_t::top(), nullptr, 1, 2, 20, 4);
+  par.run();
+
+  // Print invariants in a fixed order
+  std::set<basic_block_label_t> labels;
+  for (auto &b : *cfg) {
+    labels.insert(b.label());
+  }
+  bool same = true;
+  for (auto l : labels) {
+    auto seq_pre = seq[l];
+    auto par_pre = par[l];
+    crab::outs() << get_label_str(l) << "=" << par_pre << "\n";
+    same &= (seq_pre <= par_pre && par_pre <= seq_pre);
+    auto seq_post = seq.get_post(l);
+    auto par_post = par.get_post(l);
+    same &= (seq_post <= par_post && par_post <= seq_post);
+  }
+  crab::outs() << "Parallel and sequential invariants "
+	       << (same ? "are the same" : "differ") << "\n";
+
+  delete cfg;
+  return (same ? 0 : 1);
+}
@@ -0,0 +1,101 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+#include <crab/iterators/wto.hpp>
+#include <crab/analysis/fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+
+/* Check the nesting of the WTO blocks computed from dense block ids */
+
+typedef ikos::wto<basic_block_label_t, z_cfg_ref_t> wto_t;
+
+z_cfg_t* prog (variable_factory_t &vfac)  {
+  z_var i (vfac ["i"], crab::INT_TYPE, 32);
+  z_var j (vfac ["j"], crab::INT_TYPE, 32);
+  z_var k (vfac ["k"], crab::INT_TYPE, 32);
+  auto cfg = new z_cfg_t("entry","ret");
+  z_basic_block_t& entry   = cfg->insert ("entry");
+  // outer loop with two inner loops in sequence
+  z_basic_block_t& l1      = cfg->insert ("l1");
+  z_basic_block_t& l1_body = cfg->insert ("l1_body");
+  z_basic_block_t& l2      = cfg->insert ("l2");
+  z_basic_block_t& l2_body = cfg->insert ("l2_body");
+  z_basic_block_t& l2_exit = cfg->insert ("l2_exit");
+  z_basic_block_t& l3      = cfg->insert ("l3");
+  z_basic_block_t& l3_body = cfg->insert ("l3_body");
+  z_basic_block_t& l3_exit = cfg->insert ("l3_exit");
+  z_basic_block_t& l1_exit = cfg->insert ("l1_exit");
+  z_basic_block_t& ret     = cfg->insert ("ret");
+  // never reached
+  z_basic_block_t& dead    = cfg->insert ("dead");
+  entry >> l1;
+  l1 >> l1_body; l1 >> l1_exit;
+  l1_body >> l2;
+  l2 >> l2_body; l2_body >> l2; l2 >> l2_exit;
+  l2_exit >> l3;
+  l3 >> l3_body; l3_body >> l3; l3 >> l3_exit;
+  l3_exit >> l1;
+  l1_exit >> ret;
+  dead >> ret;
+  entry.assign (i, 0);
+  l1_body.assume (i <= 9);
+  l1_body.assign (j, 0);
+  l2_body.assume (j <= 9);
+  l2_body.add (j, j, 1);
+  l2_exit.assume (j >= 10);
+  l2_exit.assign (k, 0);
+  l3_body.assume (k <= 9);
+  l3_body.add (k, k, 1);
+  l3_exit.assume (k >= 10);
+  l3_exit.add (i, i, 1);
+  l1_exit.assume (i >= 10);
+  dead.assign (i, 5);
+  return cfg;
+}
+
+int main (int argc, char** argv )
+{
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* cfg = prog (vfac);
+  z_cfg_ref_t cfg_ref (*cfg);
+  wto_t wto (cfg_ref);
+  crab::outs() << wto << "\n";
+
+  // sort the labels to get a deterministic output
+  std::set<basic_block_label_t> labels (cfg_ref.label_begin (), cfg_ref.label_end ());
+  labels.erase ("dead");
+  bool ok = true;
+  for (auto n : labels) {
+    auto nesting = wto.nesting (n);
+    crab::outs() << n << ": nesting=" << nesting << "\n";
+    ok &= (wto.nesting_depth (wto.numbering ().id (n)) ==
+	   (size_t) std::distance (nesting.begin (), nesting.end ()));
+    for (auto m : labels) {
+      bool expected = (wto.nesting (n) > wto.nesting (m));
+      bool res = wto.nesting_greater (wto.numbering ().id (n), wto.numbering ().id (m));
+      ok &= (expected == res);
+    }
+  }
+
+  // the numbering contains also unreachable blocks and their
+  // invariants are bottom
+  typedef intra_fwd_analyzer<z_cfg_ref_t, z_interval_domain_t> analyzer_t;
+  analyzer_t a (cfg_ref, z_interval_domain_t::top(), nullptr, 1, 2, 20);
+  a.run ();
+  for (auto n : labels) {
+    auto pre = a.get_pre (n);
+    crab::outs() << n << "=" << pre << "\n";
+  }
+  ok &= (wto.numbering ().size () == cfg->size ());
+  ok &= a.get_pre ("dead").is_bottom ();
+
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  delete cfg;
+  return ok ? 0 : 1;
+}
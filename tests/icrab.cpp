@@ -34,6 +34,7 @@ void inter_run_impl (CG* cg,
         crab::outs() <<  crab::cfg_impl::get_label_str (b.label ()) << "=" << inv << "\n";
     }
       crab::outs() << "=================================\n";
+      crab::outs().flush();
   }
   
   // Print summaries
@@ -49,6 +50,7 @@ void inter_run_impl (CG* cg,
     crab::CrabStats::Print(crab::outs());
     crab::CrabStats::reset();
   }  
+  crab::outs().flush();
 }
 
 // To run abstract domains defined over integers
@@ -0,0 +1,118 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+#include <crab/cg/cg_bgl.hpp>
+#include <crab/analysis/graphs/sccg_bgl.hpp>
+#include <crab/analysis/inter_fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::cg;
+
+/* Context-sensitive top-down analysis */
+
+typedef call_graph<z_cfg_ref_t> callgraph_t;
+typedef call_graph_ref<callgraph_t> callgraph_ref_t;
+typedef inter_fwd_analyzer<callgraph_ref_t,
+			   z_dbm_domain_t, z_interval_domain_t> inter_analyzer_t;
+typedef interval<z_number> interval_t;
+
+z_cfg_t* foo (variable_factory_t &vfac) {
+  z_var a (vfac ["a"], crab::INT_TYPE, 32);
+  z_var b (vfac ["b"], crab::INT_TYPE, 32);
+  z_var c (vfac ["c"], crab::INT_TYPE, 32);
+  function_decl<z_number, varname_t> decl ("foo", {a, b}, {c});
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  entry >> exit;
+  entry.div (c, a, b);
+  exit.ret (c);
+  return cfg;
+}
+
+z_cfg_t* m (variable_factory_t &vfac)  {
+  z_var x (vfac ["x"], crab::INT_TYPE, 32);
+  z_var y (vfac ["y"], crab::INT_TYPE, 32);
+  z_var r1 (vfac ["r1"], crab::INT_TYPE, 32);
+  z_var r2 (vfac ["r2"], crab::INT_TYPE, 32);
+  z_var r3 (vfac ["r3"], crab::INT_TYPE, 32);
+  function_decl<z_number, varname_t> decl ("main", {}, {r3});
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  entry >> exit;
+  // three incomparable calling contexts for foo
+  entry.assign (x, 2);
+  entry.assign (y, 1);
+  entry.callsite ("foo", {r1}, {x, y});
+  entry.assign (x, 10);
+  entry.assign (y, 5);
+  entry.callsite ("foo", {r2}, {x, y});
+  exit.assign (x, 6);
+  exit.assign (y, 3);
+  exit.callsite ("foo", {r3}, {x, y});
+  exit.ret (r3);
+  return cfg;
+}
+
+interval_t foo_result (inter_analyzer_t &a, z_cfg_ref_t cfg, variable_factory_t &vfac) {
+  z_var c (vfac ["c"], crab::INT_TYPE, 32);
+  auto inv = a.get_post (cfg, "exit");
+  crab::outs() << "  foo: " << a.get_num_call_ctxs (cfg) << " contexts, "
+	       << "exit=" << inv << "\n";
+  return inv [c];
+}
+
+int main (int argc, char** argv ) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  z_cfg_t* t1 = foo (vfac);
+  z_cfg_t* t2 = m (vfac);
+  vector<z_cfg_ref_t> cfgs;
+  cfgs.push_back(*t1);
+  cfgs.push_back(*t2);
+  callgraph_t cg (cfgs);
+  callgraph_ref_t cg_ref (cg);
+  bool ok = true;
+
+  {
+    crab::outs() << "Context-insensitive\n";
+    inter_analyzer_t a (cg_ref, nullptr, 1, 2, 20);
+    a.Run ();
+    interval_t c = foo_result (a, *t1, vfac);
+    ok &= (a.get_num_call_ctxs (*t1) == 1);
+    ok &= interval_t (2,2) <= c;
+    ok &= !(c <= interval_t (2,2));
+  }
+  {
+    crab::outs() << "Context-sensitive with 4 contexts\n";
+    inter_analyzer_t a (cg_ref, nullptr, 1, 2, 20, 4);
+    a.Run ();
+    interval_t c = foo_result (a, *t1, vfac);
+    ok &= (a.get_num_call_ctxs (*t1) == 3);
+    ok &= (c == interval_t (2,2));
+    // the second run reuses the results of the first one
+    a.Run ();
+    c = foo_result (a, *t1, vfac);
+    ok &= (a.get_num_call_ctxs (*t1) == 3);
+    ok &= (c == interval_t (2,2));
+  }
+  {
+    crab::outs() << "Context-sensitive with 2 contexts\n";
+    inter_analyzer_t a (cg_ref, nullptr, 1, 2, 20, 2);
+    a.Run ();
+    interval_t c = foo_result (a, *t1, vfac);
+    ok &= (a.get_num_call_ctxs (*t1) == 2);
+    ok &= interval_t (2,2) <= c;
+  }
+
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  delete t1;
+  delete t2;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+#include <crab/cg/cg_bgl.hpp>
+#include <crab/analysis/graphs/sccg_bgl.hpp>
+#include <crab/analysis/inter_fwd_analyzer.hpp>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::cg;
+
+/* Analyze independent SCCs of the call graph in parallel */
+
+typedef call_graph<z_cfg_ref_t> callgraph_t;
+typedef call_graph_ref<callgraph_t> callgraph_ref_t;
+typedef inter_fwd_analyzer<callgraph_ref_t,
+			   z_dbm_domain_t, z_interval_domain_t> inter_analyzer_t;
+
+// leaf(a) returns a+k after a loop
+z_cfg_t* leaf (variable_factory_t &vfac, string name, int k) {
+  z_var a (vfac [name + "_a"], crab::INT_TYPE, 32);
+  z_var i (vfac [name + "_i"], crab::INT_TYPE, 32);
+  z_var r (vfac [name + "_r"], crab::INT_TYPE, 32);
+  function_decl<z_number, varname_t> decl (name, {a}, {r});
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& head  = cfg->insert ("head");
+  z_basic_block_t& body  = cfg->insert ("body");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  entry >> head; head >> body; body >> head; head >> exit;
+  entry.assign (i, 0);
+  body.assume (i <= k - 1);
+  body.add (i, i, 1);
+  exit.assume (i >= k);
+  exit.add (r, a, i);
+  exit.ret (r);
+  return cfg;
+}
+
+// mid(a) calls two leaves
+z_cfg_t* mid (variable_factory_t &vfac, string name, string l1, string l2) {
+  z_var a (vfac [name + "_a"], crab::INT_TYPE, 32);
+  z_var t (vfac [name + "_t"], crab::INT_TYPE, 32);
+  z_var r (vfac [name + "_r"], crab::INT_TYPE, 32);
+  function_decl<z_number, varname_t> decl (name, {a}, {r});
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  entry >> exit;
+  entry.callsite (l1, {t}, {a});
+  exit.callsite (l2, {r}, {t});
+  exit.ret (r);
+  return cfg;
+}
+
+z_cfg_t* m (variable_factory_t &vfac)  {
+  z_var x (vfac ["x"], crab::INT_TYPE, 32);
+  z_var y (vfac ["y"], crab::INT_TYPE, 32);
+  z_var z (vfac ["z"], crab::INT_TYPE, 32);
+  function_decl<z_number, varname_t> decl ("main", {}, {z});
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  entry >> exit;
+  entry.assign (x, 1);
+  entry.callsite ("mid1", {y}, {x});
+  exit.callsite ("mid2", {z}, {y});
+  exit.ret (z);
+  return cfg;
+}
+
+int main (int argc, char** argv ) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  vector<z_cfg_t*> fs;
+  fs.push_back (leaf (vfac, "leaf1", 10));
+  fs.push_back (leaf (vfac, "leaf2", 20));
+  fs.push_back (leaf (vfac, "leaf3", 30));
+  fs.push_back (leaf (vfac, "leaf4", 40));
+  fs.push_back (mid (vfac, "mid1", "leaf1", "leaf2"));
+  fs.push_back (mid (vfac, "mid2", "leaf3", "leaf4"));
+  fs.push_back (m (vfac));
+  vector<z_cfg_ref_t> cfgs;
+  for (auto f: fs) {
+    cfgs.push_back (*f);
+  }
+  callgraph_t cg (cfgs);
+  callgraph_ref_t cg_ref (cg);
+
+  inter_analyzer_t seq (cg_ref, nullptr, 1, 2, 20, 0, 1);
+  seq.Run ();
+  inter_analyzer_t par (cg_ref, nullptr, 1, 2, 20, 0, 4);
+  par.Run ();
+
+  bool same = true;
+  for (auto f: fs) {
+    z_cfg_ref_t cfg (*f);
+    crab::outs() << *(cfg.get_func_decl ()) << "\n";
+    for (auto &b : cfg) {
+      auto seq_post = seq.get_post (cfg, b.label ());
+      auto par_post = par.get_post (cfg, b.label ());
+      crab::outs() << "  " << get_label_str (b.label ()) << "=" << par_post << "\n";
+      same &= (seq_post <= par_post && par_post <= seq_post);
+    }
+    if (seq.has_summary (cfg)) {
+      auto seq_sum = seq.get_summary (cfg)->get_sum ();
+      auto par_sum = par.get_summary (cfg)->get_sum ();
+      same &= (seq_sum <= par_sum && par_sum <= seq_sum);
+    }
+  }
+  crab::outs() << "Parallel and sequential invariants "
+	       << (same ? "are the same" : "differ") << "\n";
+
+  for (auto f: fs) {
+    delete f;
+  }
+  return (same ? 0 : 1);
+}
@@ -0,0 +1,163 @@
+#include "../program_options.hpp"
+#include "../common.hpp"
+
+#include <crab/cg/cg_bgl.hpp>
+#include <crab/analysis/graphs/sccg_bgl.hpp>
+#include <crab/analysis/inter_fwd_analyzer.hpp>
+#include <crab/common/binary_io.hpp>
+#include <cstdio>
+#include <fstream>
+
+using namespace std;
+using namespace crab::analyzer;
+using namespace crab::cfg;
+using namespace crab::cfg_impl;
+using namespace crab::domain_impl;
+using namespace crab::cg;
+
+/* Reuse summaries stored in a file by a previous analysis */
+
+typedef call_graph<z_cfg_ref_t> callgraph_t;
+typedef call_graph_ref<callgraph_t> callgraph_ref_t;
+typedef inter_fwd_analyzer<callgraph_ref_t,
+			   z_dbm_domain_t, z_interval_domain_t> inter_analyzer_t;
+typedef inter_analyzer_t::summ_cache_t summ_cache_t;
+
+// leaf(a) returns a+k after a loop
+z_cfg_t* leaf (variable_factory_t &vfac, string name, int k) {
+  z_var a (vfac [name + "_a"], crab::INT_TYPE, 32);
+  z_var i (vfac [name + "_i"], crab::INT_TYPE, 32);
+  z_var r (vfac [name + "_r"], crab::INT_TYPE, 32);
+  function_decl<z_number, varname_t> decl (name, {a}, {r});
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& head  = cfg->insert ("head");
+  z_basic_block_t& body  = cfg->insert ("body");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  entry >> head; head >> body; body >> head; head >> exit;
+  entry.assign (i, 0);
+  body.assume (i <= k - 1);
+  body.add (i, i, 1);
+  exit.assume (i >= k);
+  exit.add (r, a, i);
+  exit.ret (r);
+  return cfg;
+}
+
+// mid(a) returns leaf1(a) - a
+z_cfg_t* mid (variable_factory_t &vfac) {
+  z_var a (vfac ["mid_a"], crab::INT_TYPE, 32);
+  z_var t (vfac ["mid_t"], crab::INT_TYPE, 32);
+  z_var r (vfac ["mid_r"], crab::INT_TYPE, 32);
+  function_decl<z_number, varname_t> decl ("mid", {a}, {r});
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  entry >> exit;
+  entry.callsite ("leaf1", {t}, {a});
+  exit.sub (r, t, a);
+  exit.ret (r);
+  return cfg;
+}
+
+z_cfg_t* m (variable_factory_t &vfac)  {
+  z_var x (vfac ["x"], crab::INT_TYPE, 32);
+  z_var y (vfac ["y"], crab::INT_TYPE, 32);
+  z_var z (vfac ["z"], crab::INT_TYPE, 32);
+  function_decl<z_number, varname_t> decl ("main", {}, {z});
+  z_cfg_t* cfg = new z_cfg_t("entry", "exit", decl);
+  z_basic_block_t& entry = cfg->insert ("entry");
+  z_basic_block_t& exit  = cfg->insert ("exit");
+  entry >> exit;
+  entry.assign (x, 5);
+  entry.callsite ("mid", {y}, {x});
+  exit.callsite ("leaf2", {z}, {y});
+  exit.ret (z);
+  return cfg;
+}
+
+// Analyze the program where leaf1 adds k using the cache. Return
+// the invariants at the exit of main.
+z_interval_domain_t analyze (variable_factory_t &vfac, int k, summ_cache_t &cache) {
+  vector<z_cfg_t*> fs;
+  fs.push_back (leaf (vfac, "leaf1", k));
+  fs.push_back (leaf (vfac, "leaf2", 20));
+  fs.push_back (mid (vfac));
+  fs.push_back (m (vfac));
+  vector<z_cfg_ref_t> cfgs;
+  for (auto f: fs) {
+    cfgs.push_back (*f);
+  }
+  callgraph_t cg (cfgs);
+  callgraph_ref_t cg_ref (cg);
+  inter_analyzer_t a (cg_ref, nullptr, 1, 2, 20, 0, 1, &cache);
+  a.Run ();
+  z_interval_domain_t res = a.get_post (*fs.back (), "exit");
+  crab::outs() << "  main exit=" << res << "\n"
+	       << "  " << cache.get_num_hits () << " summaries reused, "
+	       << cache.get_num_misses () << " computed\n";
+  for (auto f: fs) {
+    delete f;
+  }
+  return res;
+}
+
+int main (int argc, char** argv ) {
+  SET_TEST_OPTIONS(argc,argv)
+
+  variable_factory_t vfac;
+  const string filename = "crab_summary_cache_test.bin";
+  std::remove (filename.c_str ());
+  bool ok = true;
+  z_interval_domain_t inv1, inv2;
+  {
+    crab::outs() << "First run\n";
+    summ_cache_t cache (filename);
+    inv1 = analyze (vfac, 10, cache);
+    ok &= (cache.get_num_hits () == 0 && cache.get_num_misses () == 3);
+  }
+  {
+    crab::outs() << "Second run\n";
+    summ_cache_t cache (filename);
+    ok &= (cache.size () == 3);
+    inv2 = analyze (vfac, 10, cache);
+    ok &= (cache.get_num_hits () == 3 && cache.get_num_misses () == 0);
+    ok &= (inv1 <= inv2 && inv2 <= inv1);
+  }
+  {
+    crab::outs() << "Third run after changing leaf1\n";
+    summ_cache_t cache (filename);
+    analyze (vfac, 15, cache);
+    // leaf1 and its caller mid are analyzed again
+    ok &= (cache.get_num_hits () == 1 && cache.get_num_misses () == 2);
+  }
+  {
+    crab::outs() << "Corrupted cache\n";
+    // a summary with one input and one output whose constraint uses
+    // the variable with index 2
+    string buf ("CRABSUMM");
+    crab::binary_io::put_varint (buf, 1);  // version
+    crab::binary_io::put_varint (buf, 1);  // number of summaries
+    crab::binary_io::put_varint (buf, 42); // key
+    crab::binary_io::put_varint (buf, 1);  // inputs
+    crab::binary_io::put_varint (buf, 1);  // outputs
+    crab::binary_io::put_varint (buf, 1);  // constraints
+    crab::binary_io::put_varint (buf, 0);  // equality
+    crab::binary_io::put_varint (buf, 1);
+    crab::binary_io::put_string (buf, "0");
+    crab::binary_io::put_varint (buf, 1);  // terms
+    crab::binary_io::put_string (buf, "1");
+    crab::binary_io::put_varint (buf, 2);
+    {
+      ofstream out (filename.c_str (), ios::binary | ios::trunc);
+      out.write (buf.data (), buf.size ());
+    }
+    // the cache is dropped instead of failing when it is used
+    summ_cache_t cache (filename);
+    ok &= (cache.size () == 0);
+  }
+  std::remove (filename.c_str ());
+
+  crab::outs() << (ok ? "OK" : "FAILED") << "\n";
+  return ok ? 0 : 1;
+}
@@ -49,7 +49,8 @@ namespace {
   }									                              \
   if (vm.count("sanity")) {						                              \
     crab::CrabEnableSanityChecks(true);					                              \
-  }	  
+  }									                              \
+  crab::outs().set_buffered(true);
   
 } //end namespace
 #endif